@@ -27,6 +27,7 @@
 
 #include <gtkmm2ext/gtk_ui.h>
 
+#include "ardour/analyser.h"
 #include "ardour/playlist.h"
 #include "ardour/audioregion.h"
 #include "ardour/audiosource.h"
@@ -195,6 +196,11 @@ AudioRegionView::init (bool wfd)
 
 	create_waves ();
 
+	/* sources that can be seen are analysed first */
+	for (uint32_t n = 0; n < _region->n_channels(); ++n) {
+		Analyser::raise_priority (_region->source (n), Analyser::Visible);
+	}
+
 	if (!_recregion) {
 		fade_in_handle = new ArdourCanvas::Rectangle (group);
 		CANVAS_DEBUG_NAME (fade_in_handle, string_compose ("fade in handle for %1", region()->name()));
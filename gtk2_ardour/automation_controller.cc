@@ -117,7 +117,7 @@ AutomationController::AutomationController(boost::shared_ptr<AutomationControl>
 	_screen_update_connection = Timers::rapid_connect (
 			sigc::mem_fun (*this, &AutomationController::display_effective_value));
 
-	ac->Changed.connect (_changed_connection, invalidator (*this), boost::bind (&AutomationController::display_effective_value, this), gui_context());
+	ac->Changed.connect_coalesced (_changed_connection, invalidator (*this), boost::bind (&AutomationController::display_effective_value, this), gui_context());
 
 	add(*_widget);
 	show_all();
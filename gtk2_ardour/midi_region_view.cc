@@ -3926,7 +3926,7 @@ MidiRegionView::selection_as_notelist (Notes& selected, bool allow_all_if_none_s
 {
 	bool had_selected = false;
 
-	/* we previously time sorted events here, but Notes is a multiset sorted by time */
+	/* we previously time sorted events here, but Notes is kept sorted by time */
 
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		if (i->second->selected()) {
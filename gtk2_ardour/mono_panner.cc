@@ -83,7 +83,7 @@ MonoPanner::MonoPanner (boost::shared_ptr<ARDOUR::PannerShell> p)
 		have_font = true;
 	}
 
-	position_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&MonoPanner::value_change, this), gui_context());
+	position_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&MonoPanner::value_change, this), gui_context());
 
 	_panner_shell->Changed.connect (panshell_connections, invalidator (*this), boost::bind (&MonoPanner::bypass_handler, this), gui_context());
 	_panner_shell->PannableChanged.connect (panshell_connections, invalidator (*this), boost::bind (&MonoPanner::pannable_handler, this), gui_context());
@@ -513,7 +513,7 @@ MonoPanner::pannable_handler ()
 	panvalue_connections.drop_connections();
 	position_control = _panner->pannable()->pan_azimuth_control;
 	position_binder.set_controllable(position_control);
-	position_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&MonoPanner::value_change, this), gui_context());
+	position_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&MonoPanner::value_change, this), gui_context());
 	queue_draw ();
 }
 
@@ -59,7 +59,7 @@ MonoPannerEditor::MonoPannerEditor (MonoPanner* p)
 	_right.set_increments (1, 10);
 	_right.set_range (0, 100);
 
-	_panner->get_controllable()->Changed.connect (_connections, invalidator (*this), boost::bind (&MonoPannerEditor::update_editor, this), gui_context ());
+	_panner->get_controllable()->Changed.connect_coalesced (_connections, invalidator (*this), boost::bind (&MonoPannerEditor::update_editor, this), gui_context ());
 	_panner->DropReferences.connect (_connections, invalidator (*this), boost::bind (&MonoPannerEditor::panner_going_away, this), gui_context ());
 	_left.signal_value_changed().connect (sigc::mem_fun (*this, &MonoPannerEditor::left_changed));
 	_right.signal_value_changed().connect (sigc::mem_fun (*this, &MonoPannerEditor::right_changed));
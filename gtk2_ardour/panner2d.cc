@@ -913,7 +913,7 @@ Panner2dWindow::Panner2dWindow (boost::shared_ptr<PannerShell> p, int32_t h, uin
 	p->Changed.connect (panshell_connections, invalidator (*this), boost::bind (&Panner2dWindow::set_bypassed, this), gui_context());
 	/* needed for the width-spinbox in the main window */
 	p->PannableChanged.connect (panshell_connections, invalidator (*this), boost::bind (&Panner2dWindow::pannable_handler, this), gui_context());
-	p->pannable()->pan_width_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&Panner2dWindow::set_width, this), gui_context());
+	p->pannable()->pan_width_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&Panner2dWindow::set_width, this), gui_context());
 
 
 	button_box.set_spacing (6);
@@ -980,7 +980,7 @@ void
 Panner2dWindow::pannable_handler ()
 {
 	panvalue_connections.drop_connections();
-	widget.get_panner_shell()->pannable()->pan_width_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&Panner2dWindow::set_width, this), gui_context());
+	widget.get_panner_shell()->pannable()->pan_width_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&Panner2dWindow::set_width, this), gui_context());
 	set_width();
 }
 
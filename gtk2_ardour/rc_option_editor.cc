@@ -2157,6 +2157,17 @@ RCOptionEditor::RCOptionEditor ()
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("General"), procs);
+
+		bo = new BoolOption (
+				"graph-work-stealing",
+				_("Use work-stealing DSP scheduler"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_work_stealing),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_work_stealing)
+				);
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("When enabled, each DSP thread keeps its own queue of routes that are ready to be processed and idle threads take work from busy ones. This reduces contention on large sessions with many processors."));
+		bo->set_note (_("This setting will only take effect when the audio engine is restarted."));
+		add_option (_("General"), bo);
 	}
 
 	/* Image cache size */
@@ -2683,6 +2694,15 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("Audio"), new BufferingOptions (_rc_config));
 
+	add_option (_("Audio"),
+	     new SpinOption<uint32_t> (
+		     "butler-io-threads",
+		     _("Disk I/O threads (0: single threaded)"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_butler_io_threads),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_butler_io_threads),
+		     0, 64, 1, 4
+		     ));
+
 	add_option (_("Audio"), new OptionEditorHeading (_("Denormals")));
 
 	add_option (_("Audio"),
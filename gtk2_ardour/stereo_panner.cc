@@ -91,8 +91,8 @@ StereoPanner::StereoPanner (boost::shared_ptr<PannerShell> p)
 		have_font = true;
 	}
 
-	position_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
-	width_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
+	position_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
+	width_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
 
 	_panner_shell->Changed.connect (panshell_connections, invalidator (*this), boost::bind (&StereoPanner::bypass_handler, this), gui_context());
 	_panner_shell->PannableChanged.connect (panshell_connections, invalidator (*this), boost::bind (&StereoPanner::pannable_handler, this), gui_context());
@@ -714,8 +714,8 @@ StereoPanner::pannable_handler ()
 	position_binder.set_controllable(position_control);
 	width_binder.set_controllable(width_control);
 
-	position_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
-	width_control->Changed.connect (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
+	position_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
+	width_control->Changed.connect_coalesced (panvalue_connections, invalidator(*this), boost::bind (&StereoPanner::value_change, this), gui_context());
 	queue_draw ();
 }
 
@@ -107,12 +107,17 @@ Amp::run (BufferSet& bufs, framepos_t /*start_frame*/, framepos_t /*end_frame*/,
 			const double a = 156.825 / _session.nominal_frame_rate(); // 25 Hz LPF; see Amp::apply_gain for details
 			double lpf = _current_gain;
 
-			for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-				Sample* const sp = i->data();
-				lpf = _current_gain;
+			if (bufs.count().n_audio() > 0) {
+				/* the smoothed gain is the same for every channel: filter
+				 * the automation curve once, in place, then apply it.
+				 */
 				for (pframes_t nx = 0; nx < nframes; ++nx) {
-					sp[nx] *= lpf;
-					lpf += a * (gab[nx] - lpf);
+					const gain_t g = gab[nx];
+					gab[nx] = lpf;
+					lpf += a * (g - lpf);
+				}
+				for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
+					apply_gain_curve (i->data(), gab, nframes);
 				}
 			}
 
@@ -210,13 +215,7 @@ Amp::apply_gain (BufferSet& bufs, framecnt_t sample_rate, framecnt_t nframes, ga
 	const double a = 156.825 / sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		const gain_t lpf = apply_gain_lpf (i->data(), nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -285,14 +284,9 @@ Amp::apply_gain (AudioBuffer& buf, framecnt_t sample_rate, framecnt_t nframes, g
 		return target;
 	}
 
-        Sample* const buffer = buf.data();
 	const double a = 156.825 / sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	double lpf = initial;
-        for (pframes_t nx = 0; nx < nframes; ++nx) {
-                buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
-        }
+	const gain_t lpf = apply_gain_lpf (buf.data(), nframes, initial, target, a);
 
 	if (fabs (lpf - target) < GAIN_COEFF_TINY) return target;
 	if (fabs (lpf) < GAIN_COEFF_TINY) return GAIN_COEFF_ZERO;
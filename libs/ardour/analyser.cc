@@ -17,14 +17,29 @@
 
 */
 
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+
 #include "ardour/analyser.h"
 #include "ardour/audiofilesource.h"
+#include "ardour/filesystem_paths.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/session_event.h"
 #include "ardour/transient_detector.h"
 
 #include "pbd/compose.h"
+#include "pbd/cpus.h"
 #include "pbd/error.h"
+#include "pbd/file_utils.h"
 #include "pbd/i18n.h"
 
 using namespace std;
@@ -32,10 +47,15 @@ using namespace ARDOUR;
 using namespace PBD;
 
 Analyser* Analyser::the_analyser = 0;
-Glib::Threads::Mutex Analyser::analysis_active_lock;
+Glib::Threads::RWLock Analyser::analysis_active_lock;
 Glib::Threads::Mutex Analyser::analysis_queue_lock;
 Glib::Threads::Cond  Analyser::SourcesToAnalyse;
-list<boost::weak_ptr<Source> > Analyser::analysis_queue;
+Analyser::AnalysisQueue Analyser::analysis_queue;
+Glib::Threads::Mutex Analyser::cache_lock;
+size_t Analyser::cache_added = 0;
+
+/* loading and unloading Vamp plugins is not thread-safe */
+static Glib::Threads::Mutex plugin_lock;
 
 Analyser::Analyser ()
 {
@@ -55,11 +75,21 @@ analyser_work ()
 void
 Analyser::init ()
 {
-	Glib::Threads::Thread::create (sigc::ptr_fun (analyser_work));
+	uint32_t n_threads = Config->get_analysis_threads ();
+
+	if (n_threads == 0) {
+		n_threads = max (1U, min (8U, hardware_concurrency ()));
+	}
+
+	trim_cache ();
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
+		Glib::Threads::Thread::create (sigc::ptr_fun (analyser_work));
+	}
 }
 
 void
-Analyser::queue_source_for_analysis (boost::shared_ptr<Source> src, bool force)
+Analyser::queue_source_for_analysis (boost::shared_ptr<Source> src, bool force, Priority p)
 {
 	if (!src->can_be_analysed()) {
 		return;
@@ -70,8 +100,37 @@ Analyser::queue_source_for_analysis (boost::shared_ptr<Source> src, bool force)
 	}
 
 	Glib::Threads::Mutex::Lock lm (analysis_queue_lock);
-	analysis_queue.push_back (boost::weak_ptr<Source>(src));
-	SourcesToAnalyse.broadcast ();
+
+	/* a source is only queued once, at the highest priority asked for */
+
+	for (AnalysisQueue::iterator i = analysis_queue.begin(); i != analysis_queue.end(); ++i) {
+		if (i->second.lock() == src) {
+			if (i->first >= p) {
+				return;
+			}
+			analysis_queue.erase (i);
+			break;
+		}
+	}
+
+	analysis_queue.insert (make_pair ((int) p, boost::weak_ptr<Source>(src)));
+	SourcesToAnalyse.signal ();
+}
+
+void
+Analyser::raise_priority (boost::shared_ptr<Source> src, Priority p)
+{
+	Glib::Threads::Mutex::Lock lm (analysis_queue_lock);
+
+	for (AnalysisQueue::iterator i = analysis_queue.begin(); i != analysis_queue.end(); ++i) {
+		if (i->second.lock() == src) {
+			if (i->first < p) {
+				analysis_queue.erase (i);
+				analysis_queue.insert (make_pair ((int) p, boost::weak_ptr<Source>(src)));
+			}
+			return;
+		}
+	}
 }
 
 void
@@ -91,43 +150,194 @@ Analyser::work ()
 			goto wait;
 		}
 
-		boost::shared_ptr<Source> src (analysis_queue.front().lock());
-		analysis_queue.pop_front();
+		boost::shared_ptr<Source> src (analysis_queue.begin()->second.lock());
+		analysis_queue.erase (analysis_queue.begin());
 		analysis_queue_lock.unlock ();
 
 		boost::shared_ptr<AudioFileSource> afs = boost::dynamic_pointer_cast<AudioFileSource> (src);
 
 		if (afs && afs->length(afs->timeline_position())) {
-			Glib::Threads::Mutex::Lock lm (analysis_active_lock);
+			Glib::Threads::RWLock::ReaderLock lm (analysis_active_lock);
 			analyse_audio_file_source (afs);
 		}
 	}
 }
 
+/** @return the path at which the transients found in @param src are kept
+ *  for use by any session, or an empty string if @param src can not be read.
+ *  The name is made from a hash of the decoded audio (so not of any headers
+ *  or metadata in the file) and the analysis parameters, so that the same
+ *  audio is only ever analysed once.
+ */
+string
+Analyser::cache_path (boost::shared_ptr<AudioFileSource> src)
+{
+	const framecnt_t len = src->length (src->timeline_position());
+	const framecnt_t bufsize = 65536;
+	boost::scoped_array<Sample> buf (new Sample[bufsize]);
+
+	GChecksum* sum = g_checksum_new (G_CHECKSUM_SHA1);
+	framecnt_t pos = 0;
+
+	while (pos < len) {
+		const framecnt_t n = src->read (buf.get(), pos, min (bufsize, len - pos));
+		if (n <= 0) {
+			break;
+		}
+		g_checksum_update (sum, (guchar const *) buf.get(), n * sizeof (Sample));
+		pos += n;
+	}
+
+	string hash;
+	if (pos == len) {
+		hash = g_checksum_get_string (sum);
+	}
+
+	g_checksum_free (sum);
+
+	if (hash.empty ()) {
+		return string ();
+	}
+
+	const string dir = cache_dir ();
+
+	if (g_mkdir_with_parents (dir.c_str(), 0755)) {
+		return string ();
+	}
+
+	return Glib::build_filename (dir, string_compose (X_("%1-%2.%3-%4"), hash, src->sample_rate(),
+	                                                  TransientDetector::operational_identifier(),
+	                                                  Config->get_transient_sensitivity()));
+}
+
+string
+Analyser::cache_dir ()
+{
+	return Glib::build_filename (user_cache_directory (), X_("analysis"));
+}
+
+/** Remove the least recently used entries from the cache until it is no
+ *  larger than the "analysis-cache-size" RC variable.
+ */
+void
+Analyser::trim_cache ()
+{
+	Glib::Threads::Mutex::Lock lm (cache_lock);
+
+	vector<string> paths;
+	get_paths (paths, cache_dir (), true, false);
+
+	multimap<time_t, pair<string, off_t> > entries;
+	size_t total = 0;
+
+	for (vector<string>::const_iterator i = paths.begin(); i != paths.end(); ++i) {
+		GStatBuf statbuf;
+		if (g_stat (i->c_str(), &statbuf)) {
+			continue;
+		}
+		entries.insert (make_pair (statbuf.st_mtime, make_pair (*i, statbuf.st_size)));
+		total += statbuf.st_size;
+	}
+
+	const size_t limit = (size_t) Config->get_analysis_cache_size () * 1048576;
+
+	for (multimap<time_t, pair<string, off_t> >::const_iterator i = entries.begin(); i != entries.end() && total > limit; ++i) {
+		if (::g_unlink (i->second.first.c_str()) == 0) {
+			total -= i->second.second;
+		}
+	}
+
+	cache_added = 0;
+}
+
 void
 Analyser::analyse_audio_file_source (boost::shared_ptr<AudioFileSource> src)
 {
 	AnalysisFeatureList results;
+	const string path = src->get_transients_path ();
+
+	/* the session already has results for this source */
+
+	if (Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		src->set_been_analysed (true);
+		if (src->has_been_analysed ()) {
+			return;
+		}
+	}
+
+	const string cached = cache_path (src);
+
+	if (!cached.empty() && copy_file (cached, path)) {
+		src->set_been_analysed (true);
+		if (src->has_been_analysed ()) {
+			/* mark the entry as recently used */
+			g_utime (cached.c_str(), 0);
+			return;
+		}
+	}
+
+	boost::scoped_ptr<TransientDetector> td;
 
 	try {
-		TransientDetector td (src->sample_rate());
-		td.set_sensitivity (3, Config->get_transient_sensitivity()); // "General purpose"
-		if (td.run (src->get_transients_path(), src.get(), 0, results) == 0) {
+		{
+			Glib::Threads::Mutex::Lock lm (plugin_lock);
+			td.reset (new TransientDetector (src->sample_rate()));
+		}
+
+		td->set_sensitivity (3, Config->get_transient_sensitivity()); // "General purpose"
+
+		const int rv = td->run (path, src.get(), 0, results);
+
+		{
+			Glib::Threads::Mutex::Lock lm (plugin_lock);
+			td.reset ();
+		}
+
+		if (rv == 0) {
 			src->set_been_analysed (true);
 		} else {
 			src->set_been_analysed (false);
 		}
 	} catch (...) {
+		{
+			Glib::Threads::Mutex::Lock lm (plugin_lock);
+			td.reset ();
+		}
 		error << string_compose(_("Transient Analysis failed for %1."), _("Audio File Source")) << endmsg;;
 		src->set_been_analysed (false);
 		return;
 	}
+
+	if (!cached.empty() && src->has_been_analysed ()) {
+		/* write under another name first, so that other threads
+		   never see a partial file.
+		*/
+		const string tmp = string_compose (X_("%1.%2"), cached, Glib::Threads::Thread::self ());
+		if (!copy_file (path, tmp) || g_rename (tmp.c_str(), cached.c_str())) {
+			::g_unlink (tmp.c_str());
+			return;
+		}
+
+		GStatBuf statbuf;
+		if (g_stat (cached.c_str(), &statbuf) == 0) {
+			bool trim;
+			{
+				Glib::Threads::Mutex::Lock lm (cache_lock);
+				cache_added += statbuf.st_size;
+				/* rescan once a tenth of the limit has been added */
+				trim = cache_added > (size_t) Config->get_analysis_cache_size () * 104858;
+			}
+			if (trim) {
+				trim_cache ();
+			}
+		}
+	}
 }
 
 void
 Analyser::flush ()
 {
 	Glib::Threads::Mutex::Lock lq (analysis_queue_lock);
-	Glib::Threads::Mutex::Lock la (analysis_active_lock);
+	Glib::Threads::RWLock::WriterLock la (analysis_active_lock);
 	analysis_queue.clear();
 }
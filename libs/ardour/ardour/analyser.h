@@ -20,8 +20,13 @@
 #ifndef __ardour_analyser_h__
 #define __ardour_analyser_h__
 
+#include <functional>
+#include <map>
+#include <string>
+
 #include <glibmm/threads.h>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include "ardour/libardour_visibility.h"
 
@@ -34,22 +39,41 @@ class TransientDetector;
 class LIBARDOUR_API Analyser {
 
   public:
+	/** Sources with a higher priority are analysed first; sources with
+	 *  the same priority in the order in which they were queued.
+	 */
+	enum Priority {
+		Background = 0, ///< newly recorded or imported
+		Visible = 1     ///< shown in an editor
+	};
+
 	Analyser();
 	~Analyser ();
 
 	static void init ();
-	static void queue_source_for_analysis (boost::shared_ptr<Source>, bool force);
+	static void queue_source_for_analysis (boost::shared_ptr<Source>, bool force, Priority p = Background);
+	/** If @param src is waiting to be analysed, make sure that its
+	 *  priority is at least @param p.
+	 */
+	static void raise_priority (boost::shared_ptr<Source> src, Priority p);
 	static void work ();
 	static void flush ();
 
   private:
+	typedef std::multimap<int, boost::weak_ptr<Source>, std::greater<int> > AnalysisQueue;
+
 	static Analyser* the_analyser;
-	static Glib::Threads::Mutex analysis_active_lock;
+	static Glib::Threads::RWLock analysis_active_lock;
 	static Glib::Threads::Mutex analysis_queue_lock;
 	static Glib::Threads::Cond  SourcesToAnalyse;
-	static std::list<boost::weak_ptr<Source> > analysis_queue;
+	static AnalysisQueue analysis_queue;
+	static Glib::Threads::Mutex cache_lock;
+	static size_t cache_added; ///< bytes written to the cache since it was last trimmed
 
 	static void analyse_audio_file_source (boost::shared_ptr<AudioFileSource>);
+	static std::string cache_path (boost::shared_ptr<AudioFileSource>);
+	static std::string cache_dir ();
+	static void trim_cache ();
 };
 
 
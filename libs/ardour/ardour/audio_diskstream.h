@@ -149,6 +149,7 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
   protected:
 	friend class Auditioner;
 	friend class AudioTrack;
+	friend class Butler;
 	int  seek (framepos_t which_sample, bool complete_refill = false);
 
         int  process (BufferSet&, framepos_t transport_frame, pframes_t nframes, framecnt_t &, bool need_disk_signal);
@@ -211,7 +212,7 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 
 	/* The two central butler operations */
 	int do_flush (RunContext context, bool force = false);
-	int do_refill () { return _do_refill(_mixdown_buffer, _gain_buffer, 0); }
+	int do_refill ();
 
 
 	int read (Sample* buf, Sample* mixdown_buffer, float* gain_buffer,
@@ -251,6 +252,11 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 	static void allocate_working_buffers();
 	static void free_working_buffers();
 
+	/* Working buffers for do_refill in butler I/O worker threads;
+	 * freed automatically when the thread exits.
+	 */
+	static void allocate_thread_working_buffers ();
+
 	static Sample* _mixdown_buffer;
 	static gain_t* _gain_buffer;
 
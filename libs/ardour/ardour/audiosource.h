@@ -25,6 +25,7 @@
 #include <boost/enable_shared_from_this.hpp>
 
 #include <time.h>
+#include <sys/types.h>
 
 #include <glibmm/threads.h>
 #include <boost/function.hpp>
@@ -106,6 +107,12 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	static void allocate_working_buffers (framecnt_t framerate);
 
+	/** Give the calling thread its own working buffers for reading
+	 *  nested sources, so that it can read concurrently with others
+	 *  (e.g. butler I/O workers); freed when the thread exits.
+	 */
+	static void allocate_thread_working_buffers ();
+
   protected:
 	static bool _build_missing_peakfiles;
 	static bool _build_peakfiles;
@@ -113,7 +120,9 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	/* these collections of working buffers for supporting
 	   playlist's reading from potentially nested/recursive
 	   sources assume SINGLE THREADED reads by the butler
-	   thread, or a lock around calls that use them.
+	   thread, or a lock around calls that use them. Threads
+	   which read concurrently get their own copies; see
+	   allocate_thread_working_buffers().
 	*/
 
 	static std::vector<boost::shared_array<Sample> > _mixdown_buffers;
@@ -122,6 +131,7 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	static void ensure_buffers_for_level (uint32_t, framecnt_t);
 	static void ensure_buffers_for_level_locked (uint32_t, framecnt_t);
+	static void get_buffers_for_level (uint32_t, framecnt_t, boost::shared_array<Sample>&, boost::shared_array<gain_t>&);
 
 	framecnt_t           _length;
 	std::string         _peakpath;
@@ -169,6 +179,34 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* read-only mapping of the whole peakfile, kept from one call of
+	 * read_peaks_with_fpp() to the next until the file changes size or
+	 * is replaced.  Protected by _lock.
+	 */
+	mutable char*  _peak_map;
+	mutable size_t _peak_map_length;
+	mutable ino_t  _peak_map_inode;
+	mutable void*  _peak_map_handle; // Windows file mapping object
+
+	/* A peakfile may be followed by coarser copies of its peaks, for
+	 * drawing long sources when zoomed far out.  Level 0 is the peakfile
+	 * proper, at the frames-per-peak it was written with.
+	 */
+	struct PeakLevel {
+		framecnt_t fpp;
+		off_t      offset;
+		framecnt_t npeaks;
+	};
+
+	mutable std::vector<PeakLevel> _peak_levels; // of the mapped peakfile
+
+	const char* map_peakfile (off_t size, ino_t inode) const;
+	void unmap_peakfile () const;
+
+	off_t finest_peak_bytes (off_t size) const;
+	int write_peak_levels ();
+	static bool peak_levels_from_tail (const char* tail, size_t tail_length, off_t file_size, std::vector<PeakLevel>&);
 };
 
 }
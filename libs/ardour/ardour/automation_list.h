@@ -41,6 +41,7 @@ namespace ARDOUR {
 
 class AutomationList;
 class DoubleBeatsFramesConverter;
+class StateSidecar;
 
 /** A SharedStatefulProperty for AutomationLists */
 class LIBARDOUR_API AutomationListProperty : public PBD::SharedStatefulProperty<AutomationList>
@@ -112,6 +113,7 @@ public:
 	int set_state (const XMLNode &, int version);
 	XMLNode& state (bool full);
 	XMLNode& serialize_events ();
+	XMLNode& serialize_events (StateSidecar&);
 
 	Command* memento_command (XMLNode* before, XMLNode* after);
 
@@ -125,6 +127,7 @@ public:
 private:
 	void create_curve_if_necessary ();
 	int deserialize_events (const XMLNode&);
+	int deserialize_events (uint64_t sidecar_offset);
 
 	void maybe_signal_changed ();
 
@@ -134,6 +137,11 @@ private:
 	bool operator== (const AutomationList&) const { /* not called */ abort(); return false; }
 	XMLNode* _before; //used for undo of touch start/stop pairs.
 
+	/* text of the events as of _serialized_events_version, see serialize_events() */
+	std::string _serialized_events;
+	int         _serialized_events_version;
+	bool        _serialized_events_valid;
+
 };
 
 } // namespace
@@ -21,12 +21,16 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <map>
+#include <vector>
 
 #include <glibmm/threads.h>
 
 #include "pbd/crossthread.h"
+#include "pbd/id.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/pool.h"
+#include "pbd/semutils.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/session_handle.h"
@@ -35,6 +39,9 @@
 
 namespace ARDOUR {
 
+class Playlist;
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -92,6 +99,30 @@ private:
 	void config_changed (std::string);
 
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
+	bool refill_tracks_normal (RouteList const &);
+
+	/* Optional pool of disk I/O threads (see "butler-io-threads").
+	 * Tracks are grouped by the filesystem their data lives on, and
+	 * each group is serviced by its own worker(s), so that one slow
+	 * disk does not hold up reads and writes on the others.
+	 */
+	class IOWorker;
+	std::vector<IOWorker*> _io_workers;
+	PBD::Semaphore         _io_done;
+
+	struct IOGroup {
+		boost::weak_ptr<Playlist> playlist;
+		uint64_t                  filesystem;
+	};
+	typedef std::map<PBD::ID, IOGroup> IOGroups;
+	IOGroups _io_groups;
+
+	uint64_t io_group (boost::shared_ptr<Track>);
+	void reset_io_workers (uint32_t);
+	void partition_io_work (RouteList const &, bool refill);
+	bool refill_tracks_parallel (RouteList const &);
+	bool flush_tracks_to_disk_parallel (boost::shared_ptr<RouteList>, uint32_t& errors);
+	bool run_io_workers (uint32_t& errors);
 
 	/**
 	 * Add request to butler thread request queue
@@ -24,10 +24,13 @@
 #include "ardour/export_handler.h"
 #include "ardour/export_analysis.h"
 
-#include "audiographer/utils/identity_vertex.h"
+#include "audiographer/sink.h"
+
+#include <vector>
 
 #include <boost/ptr_container/ptr_list.hpp>
 #include <glibmm/threadpool.h>
+#include <glibmm/threads.h>
 
 namespace AudioGrapher {
 	class SampleRateConverter;
@@ -57,9 +60,9 @@ class LIBARDOUR_API ExportGraphBuilder
 	typedef ExportHandler::FileSpec FileSpec;
 
 	typedef boost::shared_ptr<AudioGrapher::Sink<Sample> > FloatSinkPtr;
-	typedef boost::shared_ptr<AudioGrapher::IdentityVertex<Sample> > IdentityVertexPtr;
 	typedef boost::shared_ptr<AudioGrapher::Analyser> AnalysisPtr;
-	typedef std::map<ExportChannelPtr,  IdentityVertexPtr> ChannelMap;
+	typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
+	typedef std::map<ExportChannelPtr, Sample const *> ChannelMap; // data read this cycle
 	typedef std::map<std::string, AnalysisPtr> AnalysisMap;
 
   public:
@@ -87,6 +90,20 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	void add_split_config (FileSpec const & config);
 
+	/* Lets a Threader run several ChannelConfigs or Intermediates at
+	 * once, one per output.  The context only carries the number of
+	 * frames and the EndOfInput flag.
+	 */
+	template<typename T>
+	class Job : public AudioGrapher::Sink<Sample> {
+	    public:
+		Job (T & target) : target (target) {}
+		void process (AudioGrapher::ProcessContext<Sample> const & c) { target.run (c); }
+		using AudioGrapher::Sink<Sample>::process;
+	    private:
+		T & target;
+	};
+
 	class Encoder {
             public:
 		template <typename T> boost::shared_ptr<AudioGrapher::Sink<T> > init (FileSpec const & new_config);
@@ -160,12 +177,14 @@ class LIBARDOUR_API ExportGraphBuilder
 		/// Returns true when finished
 		bool process ();
 
+		void run (AudioGrapher::ProcessContext<Sample> const &) { finished = process (); }
+		bool finished;
+
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::PeakReader> PeakReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::Normalizer> NormalizerPtr;
 		typedef boost::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
-		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
 		void prepare_post_processing ();
@@ -239,6 +258,9 @@ class LIBARDOUR_API ExportGraphBuilder
 		void remove_children (bool remove_out_files);
 		bool operator== (FileSpec const & other_config) const;
 
+		/// Pushes this cycle's data of our channels through the tree
+		void run (AudioGrapher::ProcessContext<Sample> const & c);
+
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::Interleaver<Sample> > InterleaverPtr;
 		typedef boost::shared_ptr<AudioGrapher::Chunker<Sample> > ChunkerPtr;
@@ -249,6 +271,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		InterleaverPtr            interleaver;
 		ChunkerPtr                chunker;
 		framecnt_t                max_frames_out;
+		std::vector<ChannelMap::const_iterator> inputs;
 	};
 
 	Session const & session;
@@ -264,12 +287,19 @@ class LIBARDOUR_API ExportGraphBuilder
 	framecnt_t process_buffer_frames;
 
 	std::list<Intermediate *> intermediates;
+	Glib::Threads::Mutex      intermediates_lock; // taken by Intermediates finishing in parallel
 
 	AnalysisMap analysis_map;
 
 	bool _realtime;
 
+	/* whole trees (ChannelConfigs, or Intermediates when post-processing)
+	 * run in parallel on job_pool; a Threader within a tree fans out on
+	 * thread_pool.  Jobs wait for the stages, so they need their own pool.
+	 */
+	Glib::ThreadPool job_pool;
 	Glib::ThreadPool thread_pool;
+	ThreaderPtr channel_config_threader;
 };
 
 } // namespace ARDOUR
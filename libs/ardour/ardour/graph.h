@@ -31,6 +31,7 @@
 #include <glib.h>
 
 #include "pbd/semutils.h"
+#include "pbd/work_stealing_deque.h"
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
@@ -57,13 +58,19 @@ class LIBARDOUR_API Graph : public SessionHandleRef
 public:
 	Graph (Session & session);
 
-	void trigger (GraphNode * n);
+	void trigger (GraphNode * n, uint32_t worker);
+
+	/* jobs are nodes outside of the chain, run on behalf of a node
+	 * that is already being processed, see PipelineStage.
+	 */
+	void trigger_job (GraphNode * n);
+	bool retract_job (GraphNode * n);
 	void rechain (boost::shared_ptr<RouteList>, GraphEdges const &);
 
 	void dump (int chain);
-	void dec_ref();
+	void dec_ref (uint32_t worker);
 
-	void helper_thread();
+	void helper_thread (uint32_t worker);
 
 	int silent_process_routes (pframes_t nframes, framepos_t start_frame, framepos_t end_frame,
 	                           bool& need_butler);
@@ -80,6 +87,15 @@ public:
 
 	bool in_process_thread () const;
 
+	/* profiling: time spent by each process thread running nodes */
+	void set_collect_thread_stats (bool yn) { _collect_thread_stats = yn; }
+	void reset_thread_stats ();
+	/** @param busy_usecs set to the time (in microseconds) that each process
+	 *  thread spent running nodes since the last reset_thread_stats(),
+	 *  while collecting was enabled.
+	 */
+	void thread_stats (std::vector<gint64>& busy_usecs) const;
+
 protected:
 	virtual void session_going_away ();
 
@@ -88,10 +104,15 @@ private:
 
 	void reset_thread_list ();
 	void drop_threads ();
-	void restart_cycle();
-	bool run_one();
+	void restart_cycle (uint32_t worker);
+	bool run_one (uint32_t worker);
+	bool run_one_work_stealing (uint32_t worker);
+	GraphNode* steal_work (uint32_t worker);
+	void wake_idle_worker ();
+	bool retract_idle_token ();
 	void main_thread();
-	void prep();
+	void prep (uint32_t worker);
+	void run_node (GraphNode*, uint32_t worker);
 
 	node_list_t _nodes_rt[2];
 
@@ -100,6 +121,21 @@ private:
 	std::vector<GraphNode *> _trigger_queue;
 	pthread_mutex_t          _trigger_mutex;
 
+	/** true if nodes are scheduled using per-thread work-stealing deques
+	 *  rather than the shared, mutex-protected _trigger_queue
+	 */
+	bool _work_stealing;
+
+	typedef PBD::WorkStealingDeque<GraphNode> WorkQueue;
+	/** One work-stealing deque per process thread, indexed by worker id
+	 *  (0 is the main graph thread).
+	 */
+	std::vector<WorkQueue*> _work_queues;
+	/** The number of nodes that did not fit into a work queue and were put
+	 *  on _trigger_queue instead (work-stealing mode only).
+	 */
+	volatile gint _trigger_overflow;
+
 	PBD::Semaphore _execution_sem;
 
 	/** Signalled to start a run of the graph for a process callback */
@@ -115,6 +151,9 @@ private:
 
 	bool _graph_empty;
 
+	volatile bool       _collect_thread_stats;
+	std::vector<gint64> _busy_usecs; ///< indexed by worker id, each written only by its own thread
+
 	// chain swapping
 	Glib::Threads::Mutex  _swap_mutex;
         Glib::Threads::Cond   _cleanup_cond;
@@ -45,8 +45,8 @@ class LIBARDOUR_API GraphNode
 	virtual ~GraphNode();
 
 	void prep( int chain );
-	void dec_ref();
-	void finish( int chain );
+	void dec_ref (uint32_t worker);
+	virtual void finish (int chain, uint32_t worker);
 
 	virtual void process();
 
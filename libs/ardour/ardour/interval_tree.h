@@ -0,0 +1,311 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_interval_tree_h__
+#define __ardour_interval_tree_h__
+
+#include <map>
+#include <stdint.h>
+
+namespace ARDOUR {
+
+/** An index of items which each cover a closed interval [start, end].
+ *
+ *  This is an augmented, randomly balanced binary search tree (a treap)
+ *  ordered by start position and, for equal start positions, by order of
+ *  insertion. Every node also records the greatest end position found in
+ *  its subtree, which allows overlap queries in O(log n + k) time.
+ *
+ *  The tree remembers the interval each item was inserted with; if an
+ *  item's extent changes it must be erase()d and insert()ed again.
+ *
+ *  T must be usable as a std::map key. Not thread safe.
+ */
+template<typename T, typename Pos>
+class IntervalTree
+{
+  public:
+	IntervalTree () : _root (0), _seq (0), _rand (2463534242U) {}
+	~IntervalTree () { clear (); }
+
+	void clear () {
+		destroy (_root);
+		_root = 0;
+		_nodes.clear ();
+		_seq = 0;
+	}
+
+	size_t size () const { return _nodes.size (); }
+	bool empty () const { return _nodes.empty (); }
+	bool contains (T const & item) const { return _nodes.find (item) != _nodes.end (); }
+
+	/** Add @a item, covering [start, end]. It is ordered after any items
+	 *  which are already present and have the same start. An item which is
+	 *  already present is moved to its new interval.
+	 */
+	void insert (T const & item, Pos start, Pos end) {
+		erase (item);
+
+		Node* n = new Node (item, start, end, _seq++, next_priority ());
+		Node* l;
+		Node* r;
+
+		split (_root, n, l, r);
+		_root = merge (merge (l, n), r);
+		_nodes.insert (std::make_pair (item, n));
+	}
+
+	/** Remove @a item.
+	 *  @return false if it was not present.
+	 */
+	bool erase (T const & item) {
+		typename NodeMap::iterator i = _nodes.find (item);
+
+		if (i == _nodes.end ()) {
+			return false;
+		}
+
+		Node* n = i->second;
+		_nodes.erase (i);
+		_root = erase (_root, n);
+		delete n;
+		return true;
+	}
+
+	/** Append to @a out all items whose interval overlaps [start, end],
+	 *  in order.
+	 */
+	template<typename Container>
+	void find_overlapping (Pos start, Pos end, Container& out) const {
+		find_overlapping (_root, start, end, out);
+	}
+
+	size_t count_overlapping (Pos start, Pos end) const {
+		return count_overlapping (_root, start, end);
+	}
+
+	/** Find the first item, in order, which starts after @a pos.
+	 *  @return false if there is none.
+	 */
+	bool first_starting_after (Pos pos, T& item) const {
+		Node* best = 0;
+		for (Node* n = _root; n; ) {
+			if (n->start > pos) {
+				best = n;
+				n = n->left;
+			} else {
+				n = n->right;
+			}
+		}
+		if (best) {
+			item = best->item;
+		}
+		return best != 0;
+	}
+
+	/** Find the first item, in order, of those with the greatest start
+	 *  position before @a pos.
+	 *  @return false if there is none.
+	 */
+	bool last_starting_before (Pos pos, T& item) const {
+		Node* best = 0;
+		for (Node* n = _root; n; ) {
+			if (n->start < pos) {
+				best = n;
+				n = n->right;
+			} else {
+				n = n->left;
+			}
+		}
+		if (!best) {
+			return false;
+		}
+		/* now find the first one starting there */
+		Pos const start = best->start;
+		for (Node* n = _root; n; ) {
+			if (n->start >= start) {
+				best = n;
+				n = n->left;
+			} else {
+				n = n->right;
+			}
+		}
+		item = best->item;
+		return true;
+	}
+
+	/** Find the first item, in order, which ends after @a pos.
+	 *  @return false if there is none.
+	 */
+	bool first_ending_after (Pos pos, T& item) const {
+		Node* n = _root;
+		while (n) {
+			if (n->left && n->left->max_end > pos) {
+				n = n->left;
+			} else if (n->end > pos) {
+				item = n->item;
+				return true;
+			} else if (n->right && n->right->max_end > pos) {
+				n = n->right;
+			} else {
+				break;
+			}
+		}
+		return false;
+	}
+
+  private:
+	IntervalTree (IntervalTree const &);
+	IntervalTree& operator= (IntervalTree const &);
+
+	struct Node {
+		Node (T const & i, Pos s, Pos e, uint64_t sq, uint32_t p)
+			: item (i), start (s), end (e), max_end (e), seq (sq), priority (p), left (0), right (0) {}
+
+		T        item;
+		Pos      start;
+		Pos      end;
+		Pos      max_end;
+		uint64_t seq;
+		uint32_t priority;
+		Node*    left;
+		Node*    right;
+
+		bool before (Node const * other) const {
+			return start < other->start || (start == other->start && seq < other->seq);
+		}
+
+		void update () {
+			max_end = end;
+			if (left && left->max_end > max_end) {
+				max_end = left->max_end;
+			}
+			if (right && right->max_end > max_end) {
+				max_end = right->max_end;
+			}
+		}
+	};
+
+	typedef std::map<T, Node*> NodeMap;
+
+	Node*    _root;
+	NodeMap  _nodes;
+	uint64_t _seq;
+	uint32_t _rand;
+
+	uint32_t next_priority () {
+		/* xorshift32 */
+		_rand ^= _rand << 13;
+		_rand ^= _rand >> 17;
+		_rand ^= _rand << 5;
+		return _rand;
+	}
+
+	static void destroy (Node* n) {
+		if (n) {
+			destroy (n->left);
+			destroy (n->right);
+			delete n;
+		}
+	}
+
+	/** split @a t into nodes ordered before @a key and the rest */
+	static void split (Node* t, Node const * key, Node*& l, Node*& r) {
+		if (!t) {
+			l = r = 0;
+		} else if (t->before (key)) {
+			split (t->right, key, t->right, r);
+			l = t;
+			t->update ();
+		} else {
+			split (t->left, key, l, t->left);
+			r = t;
+			t->update ();
+		}
+	}
+
+	/** join two trees, where all of @a l is ordered before all of @a r */
+	static Node* merge (Node* l, Node* r) {
+		if (!l) {
+			return r;
+		}
+		if (!r) {
+			return l;
+		}
+		if (l->priority > r->priority) {
+			l->right = merge (l->right, r);
+			l->update ();
+			return l;
+		}
+		r->left = merge (l, r->left);
+		r->update ();
+		return r;
+	}
+
+	static Node* erase (Node* t, Node const * n) {
+		if (!t) {
+			return 0;
+		}
+		if (t == n) {
+			return merge (t->left, t->right);
+		}
+		if (n->before (t)) {
+			t->left = erase (t->left, n);
+		} else {
+			t->right = erase (t->right, n);
+		}
+		t->update ();
+		return t;
+	}
+
+	template<typename Container>
+	static void find_overlapping (Node const * n, Pos start, Pos end, Container& out) {
+		if (!n || n->max_end < start) {
+			/* nothing in this subtree reaches @a start */
+			return;
+		}
+		find_overlapping (n->left, start, end, out);
+		if (n->start > end) {
+			/* neither this node nor anything to its right can overlap */
+			return;
+		}
+		if (n->end >= start) {
+			out.push_back (n->item);
+		}
+		find_overlapping (n->right, start, end, out);
+	}
+
+	static size_t count_overlapping (Node const * n, Pos start, Pos end) {
+		if (!n || n->max_end < start) {
+			return 0;
+		}
+		size_t cnt = count_overlapping (n->left, start, end);
+		if (n->start > end) {
+			return cnt;
+		}
+		if (n->end >= start) {
+			++cnt;
+		}
+		return cnt + count_overlapping (n->right, start, end);
+	}
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_interval_tree_h__ */
@@ -217,6 +217,22 @@ namespace ARDOUR { namespace LuaAPI {
 	 */
 	int timecode_to_sample_lua (lua_State *L);
 
+	/**
+	 * Call a function while route graph changes are deferred (see
+	 * Session::GraphChangeBlocker), so that a batch of connection or
+	 * processor changes is followed by a single re-sort and latency update.
+	 * The graph is unblocked even if the function raises an error.
+	 *
+	 * @code
+	 * Session:batch_graph_changes (function ()
+	 *   for r in Session:get_routes ():iter () do
+	 *     -- add sends, reconnect ports ...
+	 *   end
+	 * end)
+	 * @endcode
+	 */
+	int batch_graph_changes_lua (lua_State *L);
+
 	class Vamp {
 	/** Vamp Plugin Interface
 	 *
@@ -25,10 +25,7 @@
 #include "ardour/processor.h"
 #include "pbd/fastlog.h"
 
-#include "ardour/kmeterdsp.h"
-#include "ardour/iec1ppmdsp.h"
-#include "ardour/iec2ppmdsp.h"
-#include "ardour/vumeterdsp.h"
+#include "ardour/multi_meterdsp.h"
 
 namespace ARDOUR {
 
@@ -99,10 +96,12 @@ private:
 	std::vector<float> _max_peak_signal; // dB calculation is done on demand
 	float _combined_peak; // Mackie surfaces expect the highest peak of all track channels
 
-	std::vector<Kmeterdsp *> _kmeter;
-	std::vector<Iec1ppmdsp *> _iec1meter;
-	std::vector<Iec2ppmdsp *> _iec2meter;
-	std::vector<Vumeterdsp *> _vumeter;
+	/* audio-only meter types, all channels are processed at once */
+	MultiKmeterdsp     _kmeter;
+	MultiIec1ppmdsp    _iec1meter;
+	MultiIec2ppmdsp    _iec2meter;
+	MultiVumeterdsp    _vumeter;
+	std::vector<float const*> _audio_data; // per-channel buffers for the above
 
 	MeterType _meter_type;
 };
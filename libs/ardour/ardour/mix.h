@@ -45,6 +45,34 @@ extern "C" {
 LIBARDOUR_API void  x86_sse_find_peaks                 (const float * buf, uint32_t nsamples, float *min, float *max);
 LIBARDOUR_API void  x86_sse_avx_find_peaks             (const float * buf, uint32_t nsamples, float *min, float *max);
 
+/* AVX2 + FMA functions */
+
+LIBARDOUR_API float x86_avx2_compute_peak              (const float * buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_avx2_find_peaks                (const float * buf, uint32_t nsamples, float *min, float *max);
+LIBARDOUR_API void  x86_avx2_apply_gain_to_buffer      (float * buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx2_mix_buffers_with_gain     (float * dst, const float * src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx2_mix_buffers_no_gain       (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx2_copy_vector               (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx2_apply_gain_ramp           (float * buf, uint32_t nframes, float g0, float g1);
+LIBARDOUR_API void  x86_avx2_interleave_channel        (float * dst, const float * src, uint32_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  x86_avx2_deinterleave_channel      (float * dst, const float * src, uint32_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  x86_avx2_apply_gain_curve          (float * buf, const float * gain, uint32_t nframes);
+LIBARDOUR_API float x86_avx2_apply_gain_lpf            (float * buf, uint32_t nframes, float g0, float g1, float a);
+
+/* AVX-512F functions */
+
+LIBARDOUR_API float x86_avx512f_compute_peak           (const float * buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_avx512f_find_peaks             (const float * buf, uint32_t nsamples, float *min, float *max);
+LIBARDOUR_API void  x86_avx512f_apply_gain_to_buffer   (float * buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain  (float * dst, const float * src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain    (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_copy_vector            (float * dst, const float * src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_apply_gain_ramp        (float * buf, uint32_t nframes, float g0, float g1);
+LIBARDOUR_API void  x86_avx512f_interleave_channel     (float * dst, const float * src, uint32_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  x86_avx512f_deinterleave_channel   (float * dst, const float * src, uint32_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  x86_avx512f_apply_gain_curve       (float * buf, const float * gain, uint32_t nframes);
+LIBARDOUR_API float x86_avx512f_apply_gain_lpf         (float * buf, uint32_t nframes, float g0, float g1, float a);
+
 /* debug wrappers for SSE functions */
 
 LIBARDOUR_API float debug_compute_peak               (const ARDOUR::Sample * buf, ARDOUR::pframes_t nsamples, float current);
@@ -65,6 +93,22 @@ LIBARDOUR_API void  veclib_mix_buffers_no_gain       (ARDOUR::Sample * dst, cons
 
 #endif
 
+#if defined (__aarch64__) && defined (BUILD_NEON_OPTIMIZATIONS)
+
+LIBARDOUR_API float arm_neon_compute_peak              (const ARDOUR::Sample * buf, ARDOUR::pframes_t nsamples, float current);
+LIBARDOUR_API void  arm_neon_find_peaks                (const ARDOUR::Sample * buf, ARDOUR::pframes_t nsamples, float *min, float *max);
+LIBARDOUR_API void  arm_neon_apply_gain_to_buffer      (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float gain);
+LIBARDOUR_API void  arm_neon_mix_buffers_with_gain     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float gain);
+LIBARDOUR_API void  arm_neon_mix_buffers_no_gain       (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  arm_neon_copy_vector               (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  arm_neon_apply_gain_ramp           (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float g0, float g1);
+LIBARDOUR_API void  arm_neon_interleave_channel        (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  arm_neon_deinterleave_channel      (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  arm_neon_apply_gain_curve          (ARDOUR::Sample * buf, const ARDOUR::gain_t * gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float arm_neon_apply_gain_lpf            (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float g0, float g1, float a);
+
+#endif
+
 /* non-optimized functions */
 
 LIBARDOUR_API float default_compute_peak              (const ARDOUR::Sample * buf, ARDOUR::pframes_t nsamples, float current);
@@ -73,5 +117,10 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample * buf, ARD
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector				  (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_apply_gain_ramp           (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float g0, float g1);
+LIBARDOUR_API void  default_interleave_channel        (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  default_deinterleave_channel      (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, uint32_t nchannels);
+LIBARDOUR_API void  default_apply_gain_curve          (ARDOUR::Sample * buf, const ARDOUR::gain_t * gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float default_apply_gain_lpf            (ARDOUR::Sample * buf, ARDOUR::pframes_t nframes, float g0, float g1, float a);
 
 #endif /* __ardour_mix_h__ */
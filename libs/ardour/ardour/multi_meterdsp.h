@@ -0,0 +1,133 @@
+/*
+    Copyright (C) 2008-2012 Fons Adriaensen <fons@linuxaudio.org>
+    Adopted for Ardour 2013 by Robin Gareus <robin@gareus.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef __MULTI_METERDSP_H
+#define	__MULTI_METERDSP_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+
+/* Multi-channel versions of Kmeterdsp, Iec1ppmdsp, Iec2ppmdsp and
+ * Vumeterdsp. The filter state of all channels is kept in
+ * struct-of-arrays form, and channels are processed in groups of
+ * MultiMeterdsp::lanes so that the (inherently serial) per-sample
+ * ballistics filters of several channels run side by side in one
+ * SIMD register. The ballistics are identical to the single-channel
+ * implementations.
+ */
+
+class LIBARDOUR_API MultiMeterdsp
+{
+public:
+#if defined __AVX512F__
+    static const uint32_t lanes = 16;
+#elif defined __AVX__
+    static const uint32_t lanes = 8;
+#else
+    static const uint32_t lanes = 4;
+#endif
+
+    MultiMeterdsp (void);
+    virtual ~MultiMeterdsp (void);
+
+    void set_channels (uint32_t n);
+    uint32_t n_channels () const { return _z1.size (); }
+
+    void reset ();
+
+protected:
+    std::vector<float>  _z1;          // filter state
+    std::vector<float>  _z2;          // filter state
+    std::vector<float>  _m;           // max value since last read()
+    std::vector<int>    _res;         // flag set by read(), resets _m
+};
+
+class LIBARDOUR_API MultiKmeterdsp : public MultiMeterdsp
+{
+public:
+    /** @param p per channel sample buffers
+     *  @param n_chan number of channels to process, <= n_channels()
+     *  @param n number of samples to process
+     */
+    void process (float const * const *p, uint32_t n_chan, int n);
+    float read (uint32_t c);
+
+    static void init (int fsamp);
+
+private:
+    static float   _omega;       // ballistics filter constant.
+};
+
+class LIBARDOUR_API MultiIecppmdsp : public MultiMeterdsp
+{
+protected:
+    void process (float const * const *p, uint32_t n_chan, int n, float w1, float w2, float w3);
+    float read (uint32_t c, float g);
+};
+
+class LIBARDOUR_API MultiIec1ppmdsp : public MultiIecppmdsp
+{
+public:
+    void process (float const * const *p, uint32_t n_chan, int n) {
+        MultiIecppmdsp::process (p, n_chan, n, _w1, _w2, _w3);
+    }
+    float read (uint32_t c) { return MultiIecppmdsp::read (c, _g); }
+
+    static void init (float fsamp);
+
+private:
+    static float   _w1;          // attack filter coefficient
+    static float   _w2;          // attack filter coefficient
+    static float   _w3;          // release filter coefficient
+    static float   _g;           // gain factor
+};
+
+class LIBARDOUR_API MultiIec2ppmdsp : public MultiIecppmdsp
+{
+public:
+    void process (float const * const *p, uint32_t n_chan, int n) {
+        MultiIecppmdsp::process (p, n_chan, n, _w1, _w2, _w3);
+    }
+    float read (uint32_t c) { return MultiIecppmdsp::read (c, _g); }
+
+    static void init (float fsamp);
+
+private:
+    static float   _w1;          // attack filter coefficient
+    static float   _w2;          // attack filter coefficient
+    static float   _w3;          // release filter coefficient
+    static float   _g;           // gain factor
+};
+
+class LIBARDOUR_API MultiVumeterdsp : public MultiMeterdsp
+{
+public:
+    void process (float const * const *p, uint32_t n_chan, int n);
+    float read (uint32_t c);
+
+    static void init (float fsamp);
+
+private:
+    static float   _w;           // lowpass filter coefficient
+    static float   _g;           // gain factor
+};
+
+#endif
@@ -0,0 +1,141 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef __ardour_pipeline_stage_h__
+#define __ardour_pipeline_stage_h__
+
+#include <list>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/shared_array.hpp>
+
+#include "pbd/semutils.h"
+
+#include "ardour/buffer_set.h"
+#include "ardour/graphnode.h"
+#include "ardour/processor.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class Graph;
+class Session;
+
+/** Splits a route's processor chain in two pipeline stages.
+ *
+ * The processors after this one (the `stage', a run of plugins) process
+ * the previous cycle's output of the processors before it, so that both
+ * halves of the chain can run concurrently on different DSP threads.
+ * This adds one cycle of latency, which is reported by signal_latency()
+ * and hence compensated like any other processor latency.
+ *
+ * If the stage was not start()ed for a cycle, this is a plain delay-line
+ * and the route runs the stage's processors itself.
+ */
+class LIBARDOUR_API PipelineStage : public Processor
+{
+  public:
+	typedef std::list<boost::shared_ptr<Processor> > ProcessorList;
+
+	PipelineStage (Session&, const std::string& name);
+	~PipelineStage ();
+
+	bool display_to_user () const { return false; }
+
+	/** Set the processors that follow this one and may be run by it.
+	 *  Must be called with the owning route's processor lock held.
+	 */
+	void set_stage (ProcessorList const& procs) { _stage = procs; }
+	ProcessorList const& stage () const { return _stage; }
+
+	/** Allocate buffers for the stage's processors, and decide whether
+	 *  they can be pipelined. Called after the stage's processors have
+	 *  been configured.
+	 */
+	void configure_stage (ChanCount const& max_streams);
+
+	/** @return true if the stage's processors can run concurrently */
+	bool pipelined () const { return _pipelined; }
+
+	/** Queue the stage's processors to run on the previous cycle's data.
+	 *  @param start_frame start position for the first processor of the stage
+	 *  @return true if queued, in which case the next run() completes
+	 *  the stage's processing and leaves its output in the buffers.
+	 */
+	bool start (framepos_t start_frame, framepos_t end_frame, double speed, pframes_t nframes);
+
+	void run (BufferSet&, framepos_t, framepos_t, double, pframes_t, bool);
+	framecnt_t signal_latency () const;
+	int set_block_size (pframes_t);
+
+	bool configure_io (ChanCount in, ChanCount out);
+	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
+
+	void flush ();
+	void realtime_handle_transport_stopped () { flush (); }
+	void realtime_locate () { flush (); }
+
+	XMLNode& state (bool full);
+
+  private:
+	/** The stage's processing, as a job for the graph's process threads */
+	class Job : public GraphNode
+	{
+	  public:
+		Job (boost::shared_ptr<Graph>, PipelineStage&);
+
+		void process ();
+		void finish (int chain, uint32_t worker);
+
+		PBD::Semaphore done;
+
+	  private:
+		PipelineStage& _stage;
+	};
+
+	void realloc_buffers ();
+	void process_stage ();
+	void read_delayed (BufferSet&, pframes_t);
+	void write (BufferSet const&, pframes_t);
+
+	ProcessorList _stage;
+	boost::shared_ptr<Graph> _graph;
+	Job*          _job;
+	bool          _armed;
+	bool          _pipelined;
+	bool          _pending_flush;
+
+	framecnt_t    _block_size;
+	ChanCount     _max_streams;
+	BufferSet     _buffers;
+
+	/* per channel ring-buffers of 2 * _block_size samples */
+	boost::shared_array<Sample> _buf;
+	framecnt_t    _bsiz;
+	framecnt_t    _woff;
+
+	/* parameters of the queued cycle */
+	framepos_t    _start_frame;
+	framepos_t    _end_frame;
+	double        _speed;
+	pframes_t     _nframes;
+};
+
+} // namespace ARDOUR
+
+#endif // __ardour_pipeline_stage_h__
@@ -44,6 +44,7 @@
 #include "ardour/region.h"
 #include "ardour/session_object.h"
 #include "ardour/data_type.h"
+#include "ardour/interval_tree.h"
 
 namespace ARDOUR  {
 
@@ -375,6 +376,13 @@ public:
 	bool add_region_internal (boost::shared_ptr<Region>, framepos_t position, int32_t sub_num = 0, double quarter_note = 0.0, bool for_music = false);
 
 	int remove_region_internal (boost::shared_ptr<Region>);
+
+	/* maintain the positional index of `regions'; the caller must hold
+	   the region lock if it modifies `regions' at the same time.
+	*/
+	void index_region (boost::shared_ptr<Region>);
+	void unindex_region (boost::shared_ptr<Region>);
+	void clear_region_index ();
 	void copy_regions (RegionList&) const;
 	void partition_internal (framepos_t start, framepos_t end, bool cutting, RegionList& thawlist);
 
@@ -408,6 +416,15 @@ public:
 	friend class RegionWriteLock;
 	mutable Glib::Threads::RWLock region_lock;
 
+	/** Index of `regions' by the range each one covers, used to answer
+	 *  positional queries without walking the whole list. Region
+	 *  property change handlers update it without necessarily holding
+	 *  region_lock, so it has its own lock.
+	 */
+	typedef IntervalTree<boost::shared_ptr<Region>, framepos_t> RegionIndex;
+	mutable Glib::Threads::Mutex _region_index_lock;
+	RegionIndex _region_index;
+
   private:
 	void setup_layering_indices (RegionList const &);
 	void coalesce_and_check_crossfades (std::list<Evoral::Range<framepos_t> >);
@@ -434,6 +434,7 @@ class LIBARDOUR_API PluginInfo {
 
   protected:
 	friend class PluginManager;
+	friend class PluginCache;
 	uint32_t index;
 };
 
@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_plugin_cache_h__
+#define __ardour_plugin_cache_h__
+
+#include <map>
+#include <string>
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/plugin.h"
+#include "ardour/plugin_types.h"
+
+namespace ARDOUR {
+
+/** A record of the plugins found in each plugin file by earlier scans, for
+ *  every type of plugin that is discovered by loading files (LADSPA and the
+ *  VST flavours), so that files which have not changed need not be loaded
+ *  again.
+ *
+ *  A file counts as unchanged if its modification time and size are those
+ *  it had when it was scanned or, failing that, if its contents are the
+ *  same, as after reinstalling a package.
+ */
+class LIBARDOUR_API PluginCache
+{
+  public:
+	PluginCache ();
+
+	/** If @param path has not changed since it was stored, add the
+	 *  plugins that were found in it to @param plugins.
+	 *  @return true if @param path was found in the cache.
+	 */
+	bool lookup (std::string const & path, PluginType, PluginInfoList& plugins);
+
+	/** Remember that @param plugins, which may be none, were found in @param path */
+	void store (std::string const & path, PluginType, PluginInfoList const & plugins);
+
+	/** Forget all files of the given type */
+	void clear (PluginType);
+
+	/** Forget files of the given type which have not been looked up or
+	 *  stored since load(), presumably because they have gone away.
+	 */
+	void forget_unused (PluginType);
+
+	int load ();
+	int save ();
+
+  private:
+	struct File {
+		PluginType     type;
+		int64_t        mtime;
+		int64_t        size;
+		std::string    hash;
+		PluginInfoList plugins;
+		bool           used;
+	};
+
+	typedef std::map<std::string, File> Files;
+
+	Files _files;
+	bool  _dirty;
+
+	static std::string cache_path ();
+	static bool file_stat (std::string const & path, int64_t& mtime, int64_t& size);
+	static std::string file_hash (std::string const & path);
+	static PluginInfoPtr new_plugin_info (PluginType);
+};
+
+} /* namespace ARDOUR */
+
+#endif /* __ardour_plugin_cache_h__ */
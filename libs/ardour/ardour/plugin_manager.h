@@ -33,6 +33,7 @@
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/plugin.h"
+#include "ardour/plugin_cache.h"
 
 namespace ARDOUR {
 
@@ -125,6 +126,11 @@ class LIBARDOUR_API PluginManager : public boost::noncopyable {
 	bool _cancel_scan;
 	bool _cancel_timeout;
 
+	/** what was found in LADSPA and VST plugin files by earlier scans */
+	PluginCache _cache;
+	/** the VST blacklist, as read at the start of the current scan */
+	std::set<std::string> _vst_blacklist;
+
 	void ladspa_refresh ();
 	void lua_refresh ();
 	void lua_refresh_cb ();
@@ -152,6 +158,8 @@ class LIBARDOUR_API PluginManager : public boost::noncopyable {
 	int lxvst_discover_from_path (std::string path, bool cache_only = false);
 	int lxvst_discover (std::string path, bool cache_only = false);
 
+	void vst_scan_with_app (std::vector<std::string> const & plugin_objects, ARDOUR::PluginType);
+
 	int ladspa_discover (std::string path);
 
 	std::string get_ladspa_category (uint32_t id);
@@ -77,6 +77,7 @@ class InternalReturn;
 class MonitorProcessor;
 class Pannable;
 class CapturingProcessor;
+class PipelineStage;
 class InternalSend;
 class VCA;
 class SoloIsolateControl;
@@ -282,6 +283,12 @@ public:
 
 	bool strict_io () const { return _strict_io; }
 	bool set_strict_io (bool);
+
+	/** @return true if the route's longest run of plugins is split in two
+	 *  halves which run concurrently, at the cost of one cycle of latency.
+	 */
+	bool processor_pipelining () const { return _pipeline.get () != 0; }
+	void set_processor_pipelining (bool);
 	/** reset plugin-insert configuration to default, disable customizations.
 	 *
 	 * This is equivalent to calling
@@ -726,11 +733,13 @@ private:
 	framecnt_t update_port_latencies (PortSet& ports, PortSet& feeders, bool playback, framecnt_t) const;
 
 	void setup_invisible_processors ();
+	bool start_pipeline (framepos_t start_frame, framepos_t end_frame, double speed, pframes_t nframes);
 	void unpan ();
 
 	void set_plugin_state_dir (boost::weak_ptr<Processor>, const std::string&);
 
 	boost::shared_ptr<CapturingProcessor> _capturing_processor;
+	boost::shared_ptr<PipelineStage> _pipeline;
 
 	/** A handy class to keep processor state while we attempt a reconfiguration
 	 *  that may fail.
@@ -31,6 +31,11 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)		(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)			    (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef void  (*apply_gain_ramp_t)          (ARDOUR::Sample *, pframes_t, float, float);
+	typedef void  (*interleave_channel_t)       (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, uint32_t);
+	typedef void  (*deinterleave_channel_t)     (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, uint32_t);
+	typedef void  (*apply_gain_curve_t)         (ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+	typedef float (*apply_gain_lpf_t)           (ARDOUR::Sample *, pframes_t, float, float, float);
 
 	LIBARDOUR_API extern compute_peak_t		compute_peak;
 	LIBARDOUR_API extern find_peaks_t               find_peaks;
@@ -38,6 +43,23 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t	mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t	mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t			copy_vector;
+
+	/** multiply buf[i] by a gain moving linearly from @a g0 (at i = 0)
+	 *  towards @a g1 (reached at i = nframes)
+	 */
+	LIBARDOUR_API extern apply_gain_ramp_t      apply_gain_ramp;
+	/** copy src[i] to dst[i * nchannels], for i in [0, nframes) */
+	LIBARDOUR_API extern interleave_channel_t   interleave_channel;
+	/** copy src[i * nchannels] to dst[i], for i in [0, nframes) */
+	LIBARDOUR_API extern deinterleave_channel_t deinterleave_channel;
+	/** multiply buf[i] by gain[i], for i in [0, nframes) */
+	LIBARDOUR_API extern apply_gain_curve_t     apply_gain_curve;
+	/** multiply buf[i] by a gain that moves from @a g0 towards @a g1
+	 *  through a one-pole low-pass filter with coefficient @a a:
+	 *  g[0] = g0, g[i+1] = g[i] + a * (g1 - g[i]).
+	 *  @return g[nframes], the gain to start the next cycle with
+	 */
+	LIBARDOUR_API extern apply_gain_lpf_t       apply_gain_lpf;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
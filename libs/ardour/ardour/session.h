@@ -150,6 +150,7 @@ class SessionPlaylists;
 class Slave;
 class Source;
 class Speakers;
+class StateSidecar;
 class TempoMap;
 class Track;
 class VCAManager;
@@ -281,6 +282,9 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	Butler* butler() { return _butler; }
 	void butler_transport_work ();
 
+	/** @return the graph used to process routes in parallel, or 0 if there is just one DSP thread */
+	boost::shared_ptr<Graph> process_graph () const { return _process_graph; }
+
 	void refresh_disk_space ();
 
 	int load_diskstreams_2X (XMLNode const &, int);
@@ -622,6 +626,26 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 			bool _reconfigure_on_delete;
 	};
 
+	/** Defer re-sorting the route graph and recomputing latencies while
+	 *  any blocker exists, so that a batch of connection changes is
+	 *  followed by a single update instead of one per change.
+	 */
+	class GraphChangeBlocker {
+		public:
+			GraphChangeBlocker (Session* s)
+				: _session (s)
+			{
+				g_atomic_int_inc (&s->_ignore_graph_changes);
+			}
+			~GraphChangeBlocker () {
+				if (g_atomic_int_dec_and_test (&_session->_ignore_graph_changes)) {
+					_session->graph_changes_unblocked ();
+				}
+			}
+		private:
+			Session* _session;
+	};
+
 	RouteGroup* new_route_group (const std::string&);
 	void add_route_group (RouteGroup *);
 	void remove_route_group (RouteGroup* rg) { if (rg) remove_route_group (*rg); }
@@ -675,6 +699,9 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	void resort_routes ();
 	void resort_routes_using (boost::shared_ptr<RouteList>);
 
+	/** @return the edges of the route graph found by the last successful sort */
+	GraphEdges const & current_route_graph () const { return _current_route_graph; }
+
 	AudioEngine & engine() { return _engine; }
 	AudioEngine const & engine () const { return _engine; }
 
@@ -1420,6 +1447,46 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	Glib::Threads::Mutex save_state_lock;
 	Glib::Threads::Mutex peak_cleanup_lock;
 
+	/* Writing a state file (and its sidecar), possibly in the background;
+	 * see save_state().
+	 */
+	struct StateWrite {
+		StateWrite () : tree (0), sidecar (0), event_loop (0), mark_as_clean (false), dirty_generation (0) {}
+		~StateWrite ();
+
+		XMLTree*      tree;
+		StateSidecar* sidecar;
+		std::string   xml_path;
+		std::string   tmp_path;
+		std::string   sidecar_path;
+		std::string   snapshot_name;
+
+		/* for background writes: where and how to complete the save */
+		PBD::EventLoop* event_loop;
+		std::string     saved_name;
+		bool            mark_as_clean;
+		gint            dirty_generation;
+	};
+
+	static int write_state (StateWrite&);
+	static void* state_writer_thread (void*);
+	void wait_for_state_writer ();
+	void state_saved (std::string const& snapshot_name, bool mark_as_clean);
+	static void state_write_done (boost::shared_ptr<bool> alive, Session*, std::string snapshot_name, bool mark_as_clean, gint dirty_generation, int result);
+
+	/** incremented by every set_dirty(), to tell if the session was
+	 *  modified while its state was written in the background.
+	 */
+	gint _dirty_generation;
+	/** set to false when the session is destroyed, for background
+	 *  write completions that are still queued in the saving thread.
+	 */
+	boost::shared_ptr<bool> _state_write_alive;
+
+	StateWrite*     _state_write;
+	pthread_t       _state_writer_thread;
+	bool            _state_writer_running;
+
 	int      load_options (const XMLNode&);
 	int      load_state (std::string snapshot_name);
 
@@ -1750,7 +1817,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	boost::shared_ptr<Route> XMLRouteFactory (const XMLNode&, int);
 	boost::shared_ptr<Route> XMLRouteFactory_2X (const XMLNode&, int);
 
-	void route_processors_changed (RouteProcessorChange);
+	void route_processors_changed (RouteProcessorChange, boost::weak_ptr<Route> r = boost::weak_ptr<Route> ());
 
 	bool find_route_name (std::string const &, uint32_t& id, std::string& name, bool);
 	void count_existing_track_channels (ChanCount& in, ChanCount& out);
@@ -2062,6 +2129,29 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	    and solo/mute computations.
 	*/
 	GraphEdges _current_route_graph;
+	/** number of routes that _current_route_graph was built from */
+	RouteList::size_type _current_route_graph_size;
+
+	/* routes whose processors or IO have changed since the route graph
+	   was last sorted; if _route_graph_all_dirty is set, any route may
+	   have changed.
+	*/
+	Glib::Threads::Mutex _route_graph_dirty_lock;
+	std::set<boost::weak_ptr<Route> > _route_graph_dirty;
+	bool _route_graph_all_dirty;
+
+	void mark_route_graph_dirty (boost::shared_ptr<Route>);
+	void resort_dirty_routes ();
+	void resort_routes_using (boost::shared_ptr<RouteList>, std::set<GraphVertex> const *);
+
+	friend class    GraphChangeBlocker;
+	gint            _ignore_graph_changes; /* atomic */
+	gint            _graph_change_pending; /* atomic */
+	gint            _resort_pending; /* atomic */
+	gint            _latency_change_pending; /* atomic */
+
+	bool graph_change_deferred (gint*);
+	void graph_changes_unblocked ();
 
 	void ensure_route_presentation_info_gap (PresentationInfo::order_t, uint32_t gap_size);
 
@@ -145,7 +145,7 @@ public:
 
 private:
 	static PerThreadPool* pool;
-	CrossThreadPool* own_pool;
+	CrossThreadPool* own_pool; ///< 0 if the event came from the thread's RTArena
 
 	friend class Butler;
 };
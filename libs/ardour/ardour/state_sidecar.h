@@ -0,0 +1,87 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_state_sidecar_h__
+#define __ardour_state_sidecar_h__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <glibmm/threads.h>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** A binary file written next to a session state file, holding bulk data
+ *  (such as long automation lists) which is slow to format as XML text.
+ *
+ *  The state file refers to each block of data by its offset in the
+ *  sidecar.  While a session's state is being built or restored, the
+ *  sidecar for it is made available to the state()/set_state() methods in
+ *  the calling thread with a StateSidecar::Use object; objects which find
+ *  none fall back to plain XML.
+ */
+class LIBARDOUR_API StateSidecar
+{
+  public:
+	/** @param min_values Smallest number of values worth moving out of the XML */
+	StateSidecar (size_t min_values = 0);
+
+	size_t min_values () const { return _min_values; }
+	bool empty () const { return _blocks.empty (); }
+
+	/** Append a block of values.
+	 *  @return offset to pass to get() to retrieve them.
+	 */
+	uint64_t add (std::vector<double> const & values);
+
+	/** @return true if a block was found at @param offset, in which case
+	 *  @param values is set to its contents.
+	 */
+	bool get (uint64_t offset, std::vector<double>& values) const;
+
+	int read (std::string const & path);
+	int write (std::string const & path) const;
+
+	/** @return the sidecar in use by the calling thread, or 0 */
+	static StateSidecar* in_this_thread ();
+
+	/** Makes a sidecar the one in use by the calling thread
+	 *  for the lifetime of this object.
+	 */
+	class LIBARDOUR_API Use {
+	  public:
+		Use (StateSidecar*);
+		~Use ();
+	  private:
+		StateSidecar* _previous;
+	};
+
+  private:
+	size_t _min_values;
+	std::vector<double> _blocks; ///< each block is its length, then its values
+
+	static Glib::Threads::Private<StateSidecar> _in_this_thread;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_state_sidecar_h__ */
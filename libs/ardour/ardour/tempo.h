@@ -24,10 +24,12 @@
 #include <string>
 #include <vector>
 #include <cmath>
+#include <boost/shared_ptr.hpp>
 #include <glibmm/threads.h>
 
 #include "pbd/undo.h"
 #include "pbd/enum_convert.h"
+#include "pbd/rcu.h"
 
 #include "pbd/stateful.h"
 #include "pbd/statefuldestructible.h"
@@ -286,6 +288,68 @@ class LIBARDOUR_API TempoSection : public MetricSection, public Tempo {
 
 typedef std::list<MetricSection*> Metrics;
 
+/** An immutable copy of the active tempo sections and the meter sections
+ *  of a tempo map, with their positions held in arrays so that lookups are
+ *  binary searches instead of walks along the metric list.
+ *
+ *  The methods mirror TempoMap's *_locked() methods and give the same
+ *  results for the metrics the object was built from.
+ */
+class LIBARDOUR_API TempoMapPoints {
+  public:
+	TempoMapPoints ();
+	TempoMapPoints (const Metrics&);
+
+	const TempoSection& tempo_section_at_minute (double minute) const;
+	const TempoSection& tempo_section_at_beat (double beat) const;
+	const MeterSection& meter_section_at_minute (double minute) const;
+	const MeterSection& meter_section_at_beat (double beat) const;
+
+	double pulse_at_minute (double minute) const;
+	double minute_at_pulse (double pulse) const;
+
+	double beat_at_minute (double minute) const;
+	double minute_at_beat (double beat) const;
+
+	double pulse_at_beat (double beat) const;
+	double beat_at_pulse (double pulse) const;
+
+	Tempo tempo_at_minute (double minute) const;
+	Tempo tempo_at_pulse (double pulse) const;
+
+	double beat_at_bbt (const Timecode::BBT_Time&) const;
+	double pulse_at_bbt (const Timecode::BBT_Time&) const;
+	Timecode::BBT_Time bbt_at_beat (double beat) const;
+	Timecode::BBT_Time bbt_at_pulse (double pulse) const;
+	Timecode::BBT_Time bbt_at_minute (double minute) const;
+
+	double quarter_notes_between_frames (framecnt_t start, framecnt_t end) const;
+
+  private:
+	/* sections are copies made when the object is built and never
+	   modified afterwards. Every published version has its own copies,
+	   nothing is shared with the previous version.
+	*/
+	std::vector<boost::shared_ptr<const TempoSection> > _tempos;
+	std::vector<double>     _tempo_minute;
+	std::vector<double>     _tempo_pulse;
+	std::vector<framepos_t> _tempo_frame;
+
+	std::vector<boost::shared_ptr<const MeterSection> > _meters;
+	std::vector<double> _meter_minute;
+	std::vector<double> _meter_pulse;
+	std::vector<double> _meter_beat;
+	std::vector<double> _meter_bars;  /* bar position as seen from the previous meter */
+	std::vector<double> _meter_bbt_bars;
+
+	/* false if positions are not in order, in which case lookups fall
+	   back to a linear search.
+	*/
+	bool _sorted;
+
+	size_t tempo_index_at_beat (const MeterSection&, double beat) const;
+};
+
 /** Helper class to keep track of the Meter *AND* Tempo in effect
     at a given point in time.
 */
@@ -594,6 +658,25 @@ private:
 	framecnt_t                    _frame_rate;
 	mutable Glib::Threads::RWLock lock;
 
+	/* a lock-free copy of _metrics for readers, republished every time
+	   the write lock is released.
+	*/
+	SerializedRCUManager<TempoMapPoints> _points;
+
+	class WriteLock;
+	friend class WriteLock;
+
+	class WriteLock {
+	  public:
+		WriteLock (TempoMap& map) : _map (map), _lm (map.lock) {}
+		~WriteLock () { _map.publish_points (); }
+	  private:
+		TempoMap& _map;
+		Glib::Threads::RWLock::WriterLock _lm;
+	};
+
+	void publish_points ();
+
 	void recompute_tempi (Metrics& metrics);
 	void recompute_meters (Metrics& metrics);
 	void recompute_map (Metrics& metrics, framepos_t end = -1);
@@ -200,10 +200,35 @@ class LIBARDOUR_API Track : public Route, public Recordable, public PublicDiskst
 	PBD::Signal0<void> SpeedChanged;
 	PBD::Signal0<void> AlignmentStyleChanged;
 
+	/** Wallclock time spent by do_refill() and do_flush(), in microseconds.
+	 *  Updated by whichever butler thread services this track; readers
+	 *  from other threads get an approximate snapshot.
+	 */
+	struct DiskIOStats {
+		DiskIOStats ()
+			: n_reads (0), n_writes (0)
+			, total_read_usecs (0), total_write_usecs (0)
+			, max_read_usecs (0), max_write_usecs (0)
+			, last_read_usecs (0), last_write_usecs (0) {}
+
+		uint64_t n_reads;
+		uint64_t n_writes;
+		uint64_t total_read_usecs;
+		uint64_t total_write_usecs;
+		uint64_t max_read_usecs;
+		uint64_t max_write_usecs;
+		uint64_t last_read_usecs;
+		uint64_t last_write_usecs;
+	};
+
+	DiskIOStats disk_io_stats () const { return _disk_io_stats; }
+	void reset_disk_io_stats () { _disk_io_stats = DiskIOStats (); }
+
   protected:
 	XMLNode& state (bool full);
 
 	boost::shared_ptr<Diskstream> _diskstream;
+	DiskIOStats   _disk_io_stats;
 	MeterPoint    _saved_meter_point;
 	TrackMode     _mode;
 	bool          _needs_butler;
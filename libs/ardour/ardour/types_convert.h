@@ -71,6 +71,7 @@ DEFINE_ENUM_CONVERT(ARDOUR::VUMeterStandard)
 DEFINE_ENUM_CONVERT(ARDOUR::MeterLineUp)
 
 DEFINE_ENUM_CONVERT(ARDOUR::MidiPortFlags)
+DEFINE_ENUM_CONVERT(ARDOUR::PluginType)
 
 DEFINE_ENUM_CONVERT(MusicalMode::Type)
 
@@ -22,7 +22,10 @@
 #define __vst_info_file_h__
 
 #include "ardour/libardour_visibility.h"
+#include "ardour/plugin_types.h"
 #include "ardour/vst_types.h"
+#include <set>
+#include <string>
 #include <vector>
 
 /* Cache File extensions */
@@ -65,6 +68,15 @@ LIBARDOUR_API extern std::vector<VSTInfo*> * vstfx_get_info_mac (char *, enum VS
 #endif
 
 #ifndef VST_SCANNER_APP
+/** Run the external scanner on those of the given plugins which have neither
+ *  an up-to-date info file nor a blacklist entry, with up to @param jobs
+ *  scanners running at once.  The results are picked up by vstfx_get_info_*().
+ */
+LIBARDOUR_API extern void vstfx_scan_with_app (std::vector<std::string> const & dllpaths, enum ARDOUR::PluginType type, int jobs);
+
+/** Read the paths of all blacklisted plugins into @param dllpaths */
+LIBARDOUR_API extern void vstfx_get_blacklist (std::set<std::string>& dllpaths);
+
 } // namespace
 #endif
 
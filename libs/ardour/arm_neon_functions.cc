@@ -0,0 +1,240 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* NEON versions of the runtime mix functions, for 64 bit ARM (where NEON
+ * is always present).
+ */
+
+#include <arm_neon.h>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+using namespace ARDOUR;
+
+float
+arm_neon_compute_peak (const Sample * buf, pframes_t nsamples, float current)
+{
+	float32x4_t vmax0 = vdupq_n_f32 (current);
+	float32x4_t vmax1 = vmax0;
+
+	while (nsamples >= 8) {
+		vmax0 = vmaxq_f32 (vmax0, vabsq_f32 (vld1q_f32 (buf)));
+		vmax1 = vmaxq_f32 (vmax1, vabsq_f32 (vld1q_f32 (buf + 4)));
+		buf += 8;
+		nsamples -= 8;
+	}
+
+	current = vmaxvq_f32 (vmaxq_f32 (vmax0, vmax1));
+
+	while (nsamples--) {
+		current = std::max (current, fabsf (*buf));
+		++buf;
+	}
+
+	return current;
+}
+
+void
+arm_neon_find_peaks (const Sample * buf, pframes_t nframes, float *min, float *max)
+{
+	float32x4_t vmin = vdupq_n_f32 (*min);
+	float32x4_t vmax = vdupq_n_f32 (*max);
+
+	while (nframes >= 4) {
+		const float32x4_t work = vld1q_f32 (buf);
+		vmin = vminq_f32 (vmin, work);
+		vmax = vmaxq_f32 (vmax, work);
+		buf += 4;
+		nframes -= 4;
+	}
+
+	float a = vmaxvq_f32 (vmax);
+	float b = vminvq_f32 (vmin);
+
+	while (nframes--) {
+		a = std::max (a, *buf);
+		b = std::min (b, *buf);
+		++buf;
+	}
+
+	*max = a;
+	*min = b;
+}
+
+void
+arm_neon_apply_gain_to_buffer (Sample * buf, pframes_t nframes, float gain)
+{
+	while (nframes >= 4) {
+		vst1q_f32 (buf, vmulq_n_f32 (vld1q_f32 (buf), gain));
+		buf += 4;
+		nframes -= 4;
+	}
+
+	while (nframes--) {
+		*buf++ *= gain;
+	}
+}
+
+void
+arm_neon_mix_buffers_with_gain (Sample * dst, const Sample * src, pframes_t nframes, float gain)
+{
+	const float32x4_t vgain = vdupq_n_f32 (gain);
+
+	while (nframes >= 4) {
+		vst1q_f32 (dst, vfmaq_f32 (vld1q_f32 (dst), vld1q_f32 (src), vgain));
+		dst += 4;
+		src += 4;
+		nframes -= 4;
+	}
+
+	while (nframes--) {
+		*dst++ += *src++ * gain;
+	}
+}
+
+void
+arm_neon_mix_buffers_no_gain (Sample * dst, const Sample * src, pframes_t nframes)
+{
+	while (nframes >= 4) {
+		vst1q_f32 (dst, vaddq_f32 (vld1q_f32 (dst), vld1q_f32 (src)));
+		dst += 4;
+		src += 4;
+		nframes -= 4;
+	}
+
+	while (nframes--) {
+		*dst++ += *src++;
+	}
+}
+
+void
+arm_neon_copy_vector (Sample * dst, const Sample * src, pframes_t nframes)
+{
+	/* the C library already has the best copy for the platform */
+	memcpy (dst, src, nframes * sizeof (Sample));
+}
+
+void
+arm_neon_apply_gain_ramp (Sample * buf, pframes_t nframes, float g0, float g1)
+{
+	const float step = (g1 - g0) / nframes;
+	const float32x4_t vstep = vdupq_n_f32 (step);
+	const float32x4_t vg0 = vdupq_n_f32 (g0);
+	const float32x4_t four = vdupq_n_f32 (4.f);
+	static const float lanes[4] = { 0.f, 1.f, 2.f, 3.f };
+	float32x4_t vidx = vld1q_f32 (lanes);
+	pframes_t i = 0;
+
+	for (; i + 4 <= nframes; i += 4) {
+		const float32x4_t g = vfmaq_f32 (vg0, vidx, vstep);
+		vst1q_f32 (buf + i, vmulq_f32 (vld1q_f32 (buf + i), g));
+		vidx = vaddq_f32 (vidx, four);
+	}
+
+	for (; i < nframes; ++i) {
+		buf[i] *= g0 + step * i;
+	}
+}
+
+void
+arm_neon_interleave_channel (Sample * dst, const Sample * src, pframes_t nframes, uint32_t nchannels)
+{
+	if (nchannels == 1) {
+		arm_neon_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	/* NEON has no scatter, and a read-modify-write of whole frames could
+	 * race with another thread writing a different channel.
+	 */
+	default_interleave_channel (dst, src, nframes, nchannels);
+}
+
+void
+arm_neon_deinterleave_channel (Sample * dst, const Sample * src, pframes_t nframes, uint32_t nchannels)
+{
+	if (nchannels == 1) {
+		arm_neon_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	if (nchannels == 2) {
+		/* vld2q reads 8 floats from src, one beyond our 4th sample, so
+		 * stop while there is still another frame to come.
+		 */
+		while (nframes > 4) {
+			vst1q_f32 (dst, vld2q_f32 (src).val[0]);
+			dst += 4;
+			src += 8;
+			nframes -= 4;
+		}
+	}
+
+	default_deinterleave_channel (dst, src, nframes, nchannels);
+}
+
+void
+arm_neon_apply_gain_curve (Sample * buf, const gain_t * gain, pframes_t nframes)
+{
+	while (nframes >= 4) {
+		vst1q_f32 (buf, vmulq_f32 (vld1q_f32 (buf), vld1q_f32 (gain)));
+		buf += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	while (nframes--) {
+		*buf++ *= *gain++;
+	}
+}
+
+float
+arm_neon_apply_gain_lpf (Sample * buf, pframes_t nframes, float g0, float g1, float a)
+{
+	/* g[i] = g1 + (g0 - g1) * r^i, with r = 1 - a; see default_apply_gain_lpf() */
+	const double r = 1.0 - a;
+	float rk[4];
+	double r4 = 1.0;
+	for (int k = 0; k < 4; ++k) {
+		rk[k] = r4;
+		r4 *= r;
+	}
+
+	const float32x4_t vrk = vld1q_f32 (rk);
+	const float32x4_t vg1 = vdupq_n_f32 (g1);
+	double d = (double) g0 - g1;
+
+	while (nframes >= 4) {
+		const float32x4_t g = vfmaq_f32 (vg1, vdupq_n_f32 ((float) d), vrk);
+		vst1q_f32 (buf, vmulq_f32 (vld1q_f32 (buf), g));
+		d *= r4;
+		buf += 4;
+		nframes -= 4;
+	}
+
+	while (nframes--) {
+		*buf++ *= g1 + d;
+		d *= r;
+	}
+
+	return g1 + d;
+}
@@ -66,6 +66,25 @@ using namespace PBD;
 Sample* AudioDiskstream::_mixdown_buffer       = 0;
 gain_t* AudioDiskstream::_gain_buffer          = 0;
 
+namespace {
+	struct RefillBuffers {
+		Sample* mixdown_buffer;
+		gain_t* gain_buffer;
+
+		RefillBuffers () {
+			mixdown_buffer = new Sample[2*1048576];
+			gain_buffer    = new gain_t[2*1048576];
+		}
+
+		~RefillBuffers () {
+			delete [] mixdown_buffer;
+			delete [] gain_buffer;
+		}
+	};
+}
+
+static Glib::Threads::Private<RefillBuffers> thread_refill_buffers;
+
 AudioDiskstream::AudioDiskstream (Session &sess, const string &name, Diskstream::Flag flag)
 	: Diskstream(sess, name, flag)
 	, channels (new ChannelList)
@@ -151,6 +170,14 @@ AudioDiskstream::free_working_buffers()
 	_gain_buffer          = 0;
 }
 
+void
+AudioDiskstream::allocate_thread_working_buffers ()
+{
+	if (thread_refill_buffers.get () == 0) {
+		thread_refill_buffers.set (new RefillBuffers);
+	}
+}
+
 void
 AudioDiskstream::non_realtime_input_change ()
 {
@@ -1104,6 +1131,19 @@ AudioDiskstream::_do_refill_with_alloc (bool partial_fill)
 	return ret;
 }
 
+int
+AudioDiskstream::do_refill ()
+{
+	/* butler I/O workers run concurrently, each needs its own buffers */
+	RefillBuffers* rb = thread_refill_buffers.get ();
+
+	if (rb) {
+		return _do_refill (rb->mixdown_buffer, rb->gain_buffer, 0);
+	}
+
+	return _do_refill (_mixdown_buffer, _gain_buffer, 0);
+}
+
 /** Get some more data from disk and put it in our channels' playback_bufs,
  *  if there is suitable space in them.
  *
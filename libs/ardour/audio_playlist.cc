@@ -298,6 +298,7 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 
 			if ((*i) == region) {
 				regions.erase (i);
+				unindex_region (region);
 				changed = true;
 			}
 
@@ -140,16 +140,7 @@ AudioPlaylistSource::read_unlocked (Sample* dst, framepos_t start, framecnt_t cn
 		to_zero = 0;
 	}
 
-	{
-		/* Don't need to hold the lock for the actual read, and
-		   actually, we cannot, but we do want to interlock
-		   with any changes to the list of buffers caused
-		   by creating new nested playlists/sources
-		*/
-		Glib::Threads::Mutex::Lock lm (_level_buffer_lock);
-		sbuf = _mixdown_buffers[_level-1];
-		gbuf = _gain_buffers[_level-1];
-	}
+	get_buffers_for_level (_level, _session.frame_rate(), sbuf, gbuf);
 
 	boost::dynamic_pointer_cast<AudioPlaylist>(_playlist)->read (dst, sbuf.get(), gbuf.get(), start+_playlist_offset, to_read, _playlist_channel);
 
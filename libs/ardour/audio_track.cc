@@ -17,10 +17,9 @@
 
 */
 
-#include <boost/scoped_array.hpp>
-
 #include "pbd/enumwriter.h"
 #include "pbd/error.h"
+#include "pbd/rt_arena.h"
 
 #include "evoral/Curve.hpp"
 
@@ -402,8 +401,8 @@ int
 AudioTrack::export_stuff (BufferSet& buffers, framepos_t start, framecnt_t nframes,
 			  boost::shared_ptr<Processor> endpoint, bool include_endpoint, bool for_export, bool for_freeze)
 {
-	boost::scoped_array<gain_t> gain_buffer (new gain_t[nframes]);
-	boost::scoped_array<Sample> mix_buffer (new Sample[nframes]);
+	PBD::RTScratch<gain_t> gain_buffer (nframes);
+	PBD::RTScratch<Sample> mix_buffer (nframes);
 	boost::shared_ptr<AudioDiskstream> diskstream = audio_diskstream();
 
 	Glib::Threads::RWLock::ReaderLock rlock (_processor_lock);
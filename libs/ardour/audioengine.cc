@@ -32,6 +32,7 @@
 #include "pbd/epa.h"
 #include "pbd/file_utils.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/rt_arena.h"
 #include "pbd/stacktrace.h"
 #include "pbd/unknown_type.h"
 
@@ -65,6 +66,10 @@ using namespace PBD;
 AudioEngine* AudioEngine::_instance = 0;
 
 static gint audioengine_thread_cnt = 1;
+static gint process_thread_cnt = 1;
+
+/** Size of the realtime memory arena given to each process thread */
+static const size_t process_thread_arena_size = 2 * 1024 * 1024;
 
 #ifdef SILENCE_AFTER
 #define SILENCE_AFTER_SECONDS 600
@@ -1126,13 +1131,24 @@ AudioEngine::get_sync_offset (pframes_t& offset) const
 	return _backend->get_sync_offset (offset);
 }
 
+static void
+process_thread_main (boost::function<void()> func)
+{
+	const int thread_num = g_atomic_int_add (&process_thread_cnt, 1);
+	RTArena::create_per_thread_arena (string_compose (X_("Process %1"), thread_num), process_thread_arena_size);
+
+	func ();
+
+	RTArena::drop_per_thread_arena ();
+}
+
 int
 AudioEngine::create_process_thread (boost::function<void()> func)
 {
 	if (!_backend) {
 		return -1;
 	}
-	return _backend->create_process_thread (func);
+	return _backend->create_process_thread (boost::bind (&process_thread_main, func));
 }
 
 int
@@ -1256,6 +1272,7 @@ AudioEngine::thread_init_callback (void* arg)
 	const string thread_name = string_compose (X_("AudioEngine %1"), thread_num);
 
 	SessionEvent::create_per_thread_pool (thread_name, 512);
+	RTArena::create_per_thread_arena (thread_name, process_thread_arena_size);
 	PBD::notify_event_loops_about_thread_creation (pthread_self(), thread_name, 4096);
 	AsyncMIDIPort::set_process_thread (pthread_self());
 
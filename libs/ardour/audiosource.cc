@@ -71,11 +71,71 @@ vector<boost::shared_array<Sample> > AudioSource::_mixdown_buffers;
 vector<boost::shared_array<gain_t> > AudioSource::_gain_buffers;
 bool AudioSource::_build_missing_peakfiles = false;
 
+namespace {
+	struct LevelBuffers {
+		std::vector<boost::shared_array<Sample> > mixdown_buffers;
+		std::vector<boost::shared_array<gain_t> > gain_buffers;
+		framecnt_t nframes;
+
+		LevelBuffers () : nframes (0) {}
+	};
+}
+
+static Glib::Threads::Private<LevelBuffers> thread_level_buffers;
+
 /** true if we want peakfiles (e.g. if we are displaying a GUI) */
 bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
 
+/* Coarser peak levels are appended to a peakfile once it is complete,
+ * followed by a table of all levels (including the original one) and
+ * then a trailer:
+ *
+ *   [level 0 peaks][padding][level 1 peaks]...[PeakFileLevel x n][PeakFileTrailer]
+ *
+ * Level 0 still starts at the beginning of the file, so versions which
+ * know nothing of the levels keep reading it as before, and a peakfile
+ * without the trailer is simply a single level.
+ */
+
+namespace {
+
+struct PeakFileLevel {
+	uint32_t fpp;
+	uint32_t reserved;
+	uint64_t offset;
+	uint64_t npeaks;
+};
+
+struct PeakFileTrailer {
+	uint32_t nlevels;
+	uint32_t version;
+	char     magic[8];
+};
+
+const char     peakfile_magic[8] = { 'A', 'R', 'D', 'O', 'U', 'R', 'P', 'K' };
+const uint32_t peakfile_version = 2;
+const uint32_t max_peak_levels = 3;       // 256, 4096 and 65536 frames per peak
+const framecnt_t peak_level_ratio = 16;   // peaks of one level per peak of the next
+const size_t   max_peak_levels_tail = max_peak_levels * sizeof (PeakFileLevel) + sizeof (PeakFileTrailer);
+
+void
+reduce_peaks (const PeakData* peaks, framecnt_t npeaks, std::vector<PeakData>& coarse)
+{
+	for (framecnt_t n = 0; n < npeaks; n += peak_level_ratio) {
+		const framecnt_t end = min (npeaks, n + peak_level_ratio);
+		PeakData p = peaks[n];
+		for (framecnt_t i = n + 1; i < end; ++i) {
+			p.max = max (p.max, peaks[i].max);
+			p.min = min (p.min, peaks[i].min);
+		}
+		coarse.push_back (p);
+	}
+}
+
+}
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _length (0)
@@ -89,6 +149,10 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_map (0)
+	, _peak_map_length (0)
+	, _peak_map_inode (0)
+	, _peak_map_handle (0)
 {
 }
 
@@ -105,6 +169,10 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_map (0)
+	, _peak_map_length (0)
+	, _peak_map_inode (0)
+	, _peak_map_handle (0)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -124,6 +192,8 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	unmap_peakfile ();
+
 	delete [] peak_leftovers;
 }
 
@@ -218,6 +288,9 @@ AudioSource::rename_peakfile (string newpath)
 
 	string oldpath = _peakpath;
 
+	/* Windows cannot rename a mapped file */
+	unmap_peakfile ();
+
 	if (Glib::file_test (oldpath, Glib::FILE_TEST_EXISTS)) {
 		if (g_rename (oldpath.c_str(), newpath.c_str()) != 0) {
 			error << string_compose (_("cannot rename peakfile for %1 from %2 to %3 (%4)"), _name, oldpath, newpath, strerror (errno)) << endmsg;
@@ -282,7 +355,7 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 				DEBUG_TRACE(DEBUG::Peaks, string_compose("Error when calling stat on Peakfile %1\n", _peakpath));
 
 				_peaks_built = true;
-				_peak_byte_max = statbuf.st_size;
+				_peak_byte_max = finest_peak_bytes (statbuf.st_size);
 
 			} else {
 
@@ -295,7 +368,7 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 					_peak_byte_max = 0;
 				} else {
 					_peaks_built = true;
-					_peak_byte_max = statbuf.st_size;
+					_peak_byte_max = finest_peak_bytes (statbuf.st_size);
 				}
 			}
 		}
@@ -346,13 +419,6 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 	PeakData::PeakDatum xmax;
 	PeakData::PeakDatum xmin;
 	int32_t to_read;
-#ifdef PLATFORM_WINDOWS
-	SYSTEM_INFO system_info;
-        GetSystemInfo (&system_info);
-	const int bufsize = system_info.dwAllocationGranularity;;
-#else
-	const int bufsize = sysconf(_SC_PAGESIZE);
-#endif
 	framecnt_t read_npeaks = npeaks;
 	framecnt_t zero_fill = 0;
 
@@ -395,13 +461,29 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 		}
 	}
 
-	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+	const char* peakfile = map_peakfile (statbuf.st_size, statbuf.st_ino);
 
-	if (sfd < 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
+	if (!peakfile) {
 		return -1;
 	}
 
+	/* read from the coarsest level that still has at least one stored
+	 * peak per visual peak.
+	 */
+
+	size_t peakfile_length = _peak_levels[0].npeaks * sizeof (PeakData);
+
+	for (size_t n = _peak_levels.size() - 1; n > 0; --n) {
+		if (_peak_levels[n].fpp <= samples_per_visual_peak) {
+			DEBUG_TRACE (DEBUG::Peaks, string_compose ("using peak level %1 (%2 frames per peak)\n", n, _peak_levels[n].fpp));
+			peakfile += _peak_levels[n].offset;
+			peakfile_length = _peak_levels[n].npeaks * sizeof (PeakData);
+			samples_per_file_peak = _peak_levels[n].fpp;
+			expected_peaks = (cnt / (double) samples_per_file_peak);
+			break;
+		}
+	}
+
 	scale = npeaks/expected_peaks;
 
 
@@ -447,68 +529,23 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 	if (scale == 1.0) {
 		off_t first_peak_byte = (start / samples_per_file_peak) * sizeof (PeakData);
 		size_t bytes_to_read = sizeof (PeakData) * read_npeaks;
-		/* open, read, close */
 
 		DEBUG_TRACE (DEBUG::Peaks, "DIRECT PEAKS\n");
 
-		off_t  map_off =  first_peak_byte;
-		off_t  read_map_off = map_off & ~(bufsize - 1);
-		off_t  map_delta = map_off - read_map_off;
-		size_t map_length = bytes_to_read + map_delta;
-
-		if (_first_run  || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length  < bytes_to_read)) {
-			peak_cache.reset (new PeakData[npeaks]);
-			char* addr;
-#ifdef PLATFORM_WINDOWS
-			HANDLE file_handle = (HANDLE) _get_osfhandle(int(sfd));
-			HANDLE map_handle;
-			LPVOID view_handle;
-			bool err_flag;
-
-			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			addr = (char*) view_handle;
-
-			memcpy ((void*)peak_cache.get(), (void*)(addr + map_delta), bytes_to_read);
+		/* straight out of the mapped file, nothing worth caching */
 
-			err_flag = UnmapViewOfFile (view_handle);
-			err_flag = CloseHandle(map_handle);
-			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-#else
-			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+		if (first_peak_byte >= (off_t) peakfile_length) {
+			bytes_to_read = 0;
+		} else {
+			bytes_to_read = min (bytes_to_read, (size_t) (peakfile_length - first_peak_byte));
+		}
 
-			memcpy ((void*)peak_cache.get(), (void*)(addr + map_delta), bytes_to_read);
-			munmap (addr, map_length);
-#endif
-			if (zero_fill) {
-				memset (&peak_cache[read_npeaks], 0, sizeof (PeakData) * zero_fill);
-			}
+		memcpy ((void*)peaks, (void*)(peakfile + first_peak_byte), bytes_to_read);
 
-			_first_run = false;
-			_last_scale = samples_per_visual_peak;
-			_last_map_off = map_off;
-			_last_raw_map_length = bytes_to_read;
+		if (bytes_to_read < sizeof (PeakData) * npeaks) {
+			memset ((char*) peaks + bytes_to_read, 0, sizeof (PeakData) * npeaks - bytes_to_read);
 		}
 
-		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
-
 		return 0;
 	}
 
@@ -541,63 +578,23 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 
 		current_stored_peak = min (current_stored_peak, stored_peak_before_next_visual_peak);
 
-		/* open ... close during out: handling */
-
 		off_t  map_off =  (uint32_t) (ceil (start / (double) samples_per_file_peak)) * sizeof(PeakData);
-		off_t  read_map_off = map_off & ~(bufsize - 1);
-		off_t  map_delta = map_off - read_map_off;
 		size_t raw_map_length = chunksize * sizeof(PeakData);
-		size_t map_length = (chunksize * sizeof(PeakData)) + map_delta;
 
 		if (_first_run || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length < raw_map_length)) {
 			peak_cache.reset (new PeakData[npeaks]);
-			boost::scoped_array<PeakData> staging (new PeakData[chunksize]);
 
-			char* addr;
-#ifdef PLATFORM_WINDOWS
-			HANDLE file_handle =  (HANDLE) _get_osfhandle(int(sfd));
-			HANDLE map_handle;
-			LPVOID view_handle;
-			bool err_flag;
-
-			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+			/* stored peaks beyond the end of the file read as silence */
 
-			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+			const PeakData* staging = (const PeakData*) (peakfile + min ((size_t) map_off, peakfile_length));
+			const framecnt_t nstaged = min ((framecnt_t) chunksize, (framecnt_t) ((peakfile_length - min ((size_t) map_off, peakfile_length)) / sizeof (PeakData)));
 
-			addr = (char *) view_handle;
-
-			memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
-
-			err_flag = UnmapViewOfFile (view_handle);
-			err_flag = CloseHandle(map_handle);
-			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-#else
-			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
-			munmap (addr, map_length);
-#endif
 			while (nvisual_peaks < read_npeaks) {
 
 				xmax = -1.0;
 				xmin = 1.0;
 
-				while ((current_stored_peak <= stored_peak_before_next_visual_peak) && (i < chunksize)) {
+				while ((current_stored_peak <= stored_peak_before_next_visual_peak) && (i < nstaged)) {
 
 					xmax = max (xmax, staging[i].max);
 					xmin = min (xmin, staging[i].min);
@@ -605,6 +602,11 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 					++current_stored_peak;
 				}
 
+				if (xmax < xmin) {
+					/* past the end of the peakfile */
+					xmax = xmin = 0;
+				}
+
 				peak_cache[nvisual_peaks].max = xmax;
 				peak_cache[nvisual_peaks].min = xmin;
 				++nvisual_peaks;
@@ -712,6 +714,303 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, framecnt_t npeaks, framepos_t
 	return 0;
 }
 
+/** @return the contents of the peakfile, which has size @param size
+ *  and inode @param inode, or 0 on error.  _lock MUST be held by caller.
+ */
+const char*
+AudioSource::map_peakfile (off_t size, ino_t inode) const
+{
+	if (_peak_map && _peak_map_length == (size_t) size && _peak_map_inode == inode) {
+		return _peak_map;
+	}
+
+	unmap_peakfile ();
+
+	if (size <= 0) {
+		error << string_compose (_("peakfile %1 is empty"), _peakpath) << endmsg;
+		return 0;
+	}
+
+	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
+		return 0;
+	}
+
+	char* addr;
+
+#ifdef PLATFORM_WINDOWS
+	HANDLE file_handle = (HANDLE) _get_osfhandle(int(sfd));
+	HANDLE map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (map_handle == NULL) {
+		error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
+		return 0;
+	}
+
+	addr = (char*) MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, size);
+
+	if (addr == NULL) {
+		error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
+		CloseHandle (map_handle);
+		return 0;
+	}
+
+	_peak_map_handle = map_handle;
+#else
+	/* shared, so that peaks written later (e.g. while capturing)
+	 * show up without mapping the file again.
+	 */
+	addr = (char*) mmap (0, size, PROT_READ, MAP_SHARED, sfd, 0);
+
+	if (addr == MAP_FAILED) {
+		error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
+		return 0;
+	}
+#endif
+
+	_peak_map = addr;
+	_peak_map_length = size;
+	_peak_map_inode = inode;
+
+	_peak_levels.clear ();
+
+	const size_t tail = min (_peak_map_length, max_peak_levels_tail);
+
+	if (!peak_levels_from_tail (_peak_map + _peak_map_length - tail, tail, size, _peak_levels)) {
+		/* written by an older version, or not complete yet */
+		PeakLevel l;
+		l.fpp = _FPP;
+		l.offset = 0;
+		l.npeaks = _peak_map_length / sizeof (PeakData);
+		_peak_levels.push_back (l);
+	}
+
+	/* what peak_cache was computed from may have changed */
+	_first_run = true;
+
+	return _peak_map;
+}
+
+void
+AudioSource::unmap_peakfile () const
+{
+	if (!_peak_map) {
+		return;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	if (!UnmapViewOfFile (_peak_map) || !CloseHandle ((HANDLE) _peak_map_handle)) {
+		error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
+	}
+	_peak_map_handle = 0;
+#else
+	munmap (_peak_map, _peak_map_length);
+#endif
+
+	_peak_map = 0;
+	_peak_map_length = 0;
+	_peak_map_inode = 0;
+	_peak_levels.clear ();
+}
+
+/** @return true if the last @param tail_length bytes of a peakfile of size
+ *  @param file_size, at @param tail, hold a valid table of peak levels, in
+ *  which case @param levels is set from it.
+ */
+bool
+AudioSource::peak_levels_from_tail (const char* tail, size_t tail_length, off_t file_size, std::vector<PeakLevel>& levels)
+{
+	PeakFileTrailer trailer;
+
+	if (tail_length < sizeof (trailer)) {
+		return false;
+	}
+
+	memcpy (&trailer, tail + tail_length - sizeof (trailer), sizeof (trailer));
+
+	if (memcmp (trailer.magic, peakfile_magic, sizeof (trailer.magic)) ||
+	    trailer.version != peakfile_version ||
+	    trailer.nlevels == 0 || trailer.nlevels > max_peak_levels ||
+	    tail_length < sizeof (trailer) + trailer.nlevels * sizeof (PeakFileLevel)) {
+		return false;
+	}
+
+	const char* table = tail + tail_length - sizeof (trailer) - trailer.nlevels * sizeof (PeakFileLevel);
+	const uint64_t table_offset = file_size - sizeof (trailer) - trailer.nlevels * sizeof (PeakFileLevel);
+	std::vector<PeakLevel> l;
+
+	for (uint32_t n = 0; n < trailer.nlevels; ++n) {
+
+		PeakFileLevel fl;
+		memcpy (&fl, table + n * sizeof (fl), sizeof (fl));
+
+		if (fl.fpp == 0 ||
+		    (n == 0 && fl.offset != 0) ||
+		    (n > 0 && fl.fpp <= (uint64_t) l.back().fpp) ||
+		    fl.offset > table_offset ||
+		    fl.npeaks > (table_offset - fl.offset) / sizeof (PeakData)) {
+			return false;
+		}
+
+		PeakLevel pl;
+		pl.fpp = fl.fpp;
+		pl.offset = fl.offset;
+		pl.npeaks = fl.npeaks;
+		l.push_back (pl);
+	}
+
+	levels.swap (l);
+	return true;
+}
+
+/** @return the size of the level 0 peaks in the peakfile, which is
+ *  @param size bytes long.
+ */
+off_t
+AudioSource::finest_peak_bytes (off_t size) const
+{
+	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return size;
+	}
+
+	char tail[max_peak_levels_tail];
+	const size_t tail_length = min ((size_t) size, max_peak_levels_tail);
+	std::vector<PeakLevel> levels;
+
+	if (lseek (sfd, size - tail_length, SEEK_SET) != (off_t) (size - tail_length) ||
+	    ::read (sfd, tail, tail_length) != (ssize_t) tail_length ||
+	    !peak_levels_from_tail (tail, tail_length, size, levels)) {
+		return size;
+	}
+
+	return levels[0].npeaks * sizeof (PeakData);
+}
+
+/** Append coarser levels of the peaks written so far to the peakfile.
+ *  The peakfile must be open for writing.
+ */
+int
+AudioSource::write_peak_levels ()
+{
+	const framecnt_t npeaks = _peak_byte_max / sizeof (PeakData);
+
+	if (npeaks < peak_level_ratio * peak_level_ratio) {
+		/* too short for a coarser level to be worth having */
+		return 0;
+	}
+
+	const off_t end = lseek (_peakfile_fd, 0, SEEK_END);
+
+	if (end < 0) {
+		error << string_compose(_("%1: could not seek in peak file data (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	/* nothing to do if the levels were already written for these peaks */
+
+	{
+		char tail[max_peak_levels_tail];
+		const size_t tail_length = min ((size_t) end, max_peak_levels_tail);
+		std::vector<PeakLevel> levels;
+
+		if (lseek (_peakfile_fd, end - tail_length, SEEK_SET) == (off_t) (end - tail_length) &&
+		    ::read (_peakfile_fd, tail, tail_length) == (ssize_t) tail_length &&
+		    peak_levels_from_tail (tail, tail_length, end, levels) &&
+		    levels[0].npeaks == npeaks) {
+			return 0;
+		}
+	}
+
+	/* read level 0 back and reduce it to level 1, a chunk at a time */
+
+	std::vector<std::vector<PeakData> > coarse (1);
+	const framecnt_t chunksize = 4096 * peak_level_ratio;
+	boost::scoped_array<PeakData> buf (new PeakData[chunksize]);
+
+	coarse[0].reserve (npeaks / peak_level_ratio + 1);
+
+	if (lseek (_peakfile_fd, 0, SEEK_SET) != 0) {
+		error << string_compose(_("%1: could not seek in peak file data (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	for (framecnt_t done = 0; done < npeaks; ) {
+		const framecnt_t n = min (chunksize, npeaks - done);
+		if (::read (_peakfile_fd, buf.get(), n * sizeof (PeakData)) != (ssize_t) (n * sizeof (PeakData))) {
+			error << string_compose(_("%1: could not read peak file data (%2)"), _name, strerror (errno)) << endmsg;
+			return -1;
+		}
+		reduce_peaks (buf.get(), n, coarse[0]);
+		done += n;
+	}
+
+	while (coarse.size() + 1 < max_peak_levels && coarse.back().size() >= (size_t) (peak_level_ratio * peak_level_ratio)) {
+		std::vector<PeakData> next;
+		next.reserve (coarse.back().size() / peak_level_ratio + 1);
+		reduce_peaks (&coarse.back()[0], coarse.back().size(), next);
+		coarse.push_back (std::vector<PeakData>());
+		coarse.back().swap (next);
+	}
+
+	/* the levels go after whatever the file already holds (the peakfile
+	 * may be padded), followed by the table and trailer, in one write.
+	 */
+
+	std::vector<PeakFileLevel> table;
+	PeakFileLevel fl;
+
+	fl.fpp = _FPP;
+	fl.reserved = 0;
+	fl.offset = 0;
+	fl.npeaks = npeaks;
+	table.push_back (fl);
+
+	uint64_t offset = end;
+	size_t bytes = 0;
+
+	for (size_t n = 0; n < coarse.size(); ++n) {
+		fl.fpp = table.back().fpp * peak_level_ratio;
+		fl.offset = offset;
+		fl.npeaks = coarse[n].size();
+		table.push_back (fl);
+		offset += coarse[n].size() * sizeof (PeakData);
+		bytes += coarse[n].size() * sizeof (PeakData);
+	}
+
+	PeakFileTrailer trailer;
+	trailer.nlevels = table.size();
+	trailer.version = peakfile_version;
+	memcpy (trailer.magic, peakfile_magic, sizeof (trailer.magic));
+
+	bytes += table.size() * sizeof (PeakFileLevel) + sizeof (trailer);
+
+	boost::scoped_array<char> out (new char[bytes]);
+	char* p = out.get();
+
+	for (size_t n = 0; n < coarse.size(); ++n) {
+		memcpy (p, &coarse[n][0], coarse[n].size() * sizeof (PeakData));
+		p += coarse[n].size() * sizeof (PeakData);
+	}
+
+	memcpy (p, &table[0], table.size() * sizeof (PeakFileLevel));
+	p += table.size() * sizeof (PeakFileLevel);
+	memcpy (p, &trailer, sizeof (trailer));
+
+	if (lseek (_peakfile_fd, end, SEEK_SET) != end ||
+	    ::write (_peakfile_fd, out.get(), bytes) != (ssize_t) bytes) {
+		error << string_compose(_("%1: could not write peak file data (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Wrote %1 coarser peak levels to %2\n", coarse.size(), _peakpath));
+
+	return 0;
+}
+
 int
 AudioSource::build_peaks_from_scratch ()
 {
@@ -780,6 +1079,10 @@ AudioSource::build_peaks_from_scratch ()
   out:
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
+		{
+			Glib::Threads::Mutex::Lock lp (_lock);
+			unmap_peakfile ();
+		}
 		::g_unlink (_peakpath.c_str());
 	}
 
@@ -794,6 +1097,7 @@ AudioSource::close_peakfile ()
 		close (_peakfile_fd);
 		_peakfile_fd = -1;
 	}
+	unmap_peakfile ();
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
 	}
@@ -831,6 +1135,9 @@ AudioSource::done_with_peakfile_writes (bool done)
 	}
 
 	if (done) {
+		/* a peakfile without its levels is still usable */
+		write_peak_levels ();
+
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
 		PeaksReady (); /* EMIT SIGNAL */
@@ -1051,6 +1358,10 @@ AudioSource::truncate_peakfile ()
 
 	if (end > _peak_byte_max) {
 		DEBUG_TRACE(DEBUG::Peaks, string_compose ("Truncating Peakfile  %1\n", _peakpath));
+		/* Windows cannot shrink a mapped file; elsewhere the mapping
+		 * would be left pointing past the end of it.
+		 */
+		unmap_peakfile ();
 		if (ftruncate (_peakfile_fd, _peak_byte_max)) {
 			error << string_compose (_("could not truncate peakfile %1 to %2 (error: %3)"),
 						 _peakpath, _peak_byte_max, errno) << endmsg;
@@ -1103,6 +1414,50 @@ AudioSource::allocate_working_buffers (framecnt_t framerate)
 	}
 }
 
+void
+AudioSource::allocate_thread_working_buffers ()
+{
+	if (thread_level_buffers.get () == 0) {
+		thread_level_buffers.set (new LevelBuffers);
+	}
+}
+
+/** Find the working buffers to use for reading a source at nesting
+ *  level @param level: the calling thread's own ones if it has them,
+ *  otherwise those shared by all threads.
+ */
+void
+AudioSource::get_buffers_for_level (uint32_t level, framecnt_t frame_rate, boost::shared_array<Sample>& sbuf, boost::shared_array<gain_t>& gbuf)
+{
+	LevelBuffers* lb = thread_level_buffers.get ();
+
+	if (!lb) {
+		/* we do want to interlock with any changes to the list of
+		   buffers caused by creating new nested playlists/sources
+		*/
+		Glib::Threads::Mutex::Lock lm (_level_buffer_lock);
+		sbuf = _mixdown_buffers[level-1];
+		gbuf = _gain_buffers[level-1];
+		return;
+	}
+
+	framecnt_t nframes = (framecnt_t) floor (Config->get_audio_playback_buffer_seconds() * frame_rate);
+
+	if (lb->nframes != nframes) {
+		lb->mixdown_buffers.clear ();
+		lb->gain_buffers.clear ();
+		lb->nframes = nframes;
+	}
+
+	while (lb->mixdown_buffers.size() < level) {
+		lb->mixdown_buffers.push_back (boost::shared_array<Sample> (new Sample[nframes]));
+		lb->gain_buffers.push_back (boost::shared_array<gain_t> (new gain_t[nframes]));
+	}
+
+	sbuf = lb->mixdown_buffers[level-1];
+	gbuf = lb->gain_buffers[level-1];
+}
+
 void
 AudioSource::ensure_buffers_for_level (uint32_t level, framecnt_t frame_rate)
 {
@@ -28,6 +28,7 @@
 #include "ardour/event_type_map.h"
 #include "ardour/parameter_descriptor.h"
 #include "ardour/parameter_types.h"
+#include "ardour/state_sidecar.h"
 #include "ardour/evoral_types_convert.h"
 #include "ardour/types_convert.h"
 #include "evoral/Curve.hpp"
@@ -57,6 +58,8 @@ static void dumpit (const AutomationList& al, string prefix = "")
 AutomationList::AutomationList (const Evoral::Parameter& id, const Evoral::ParameterDescriptor& desc)
 	: ControlList(id, desc)
 	, _before (0)
+	, _serialized_events_version (0)
+	, _serialized_events_valid (false)
 {
 	_state = Off;
 	g_atomic_int_set (&_touching, 0);
@@ -71,6 +74,8 @@ AutomationList::AutomationList (const Evoral::Parameter& id, const Evoral::Param
 AutomationList::AutomationList (const Evoral::Parameter& id)
 	: ControlList(id, ARDOUR::ParameterDescriptor(id))
 	, _before (0)
+	, _serialized_events_version (0)
+	, _serialized_events_valid (false)
 {
 	_state = Off;
 	g_atomic_int_set (&_touching, 0);
@@ -86,6 +91,8 @@ AutomationList::AutomationList (const AutomationList& other)
 	: ControlList(other)
 	, StatefulDestructible()
 	, _before (0)
+	, _serialized_events_version (0)
+	, _serialized_events_valid (false)
 {
 	_state = other._state;
 	g_atomic_int_set (&_touching, other.touching());
@@ -99,6 +106,8 @@ AutomationList::AutomationList (const AutomationList& other)
 AutomationList::AutomationList (const AutomationList& other, double start, double end)
 	: ControlList(other, start, end)
 	, _before (0)
+	, _serialized_events_version (0)
+	, _serialized_events_valid (false)
 {
 	_state = other._state;
 	g_atomic_int_set (&_touching, other.touching());
@@ -115,6 +124,8 @@ AutomationList::AutomationList (const AutomationList& other, double start, doubl
 AutomationList::AutomationList (const XMLNode& node, Evoral::Parameter id)
 	: ControlList(id, ARDOUR::ParameterDescriptor(id))
 	, _before (0)
+	, _serialized_events_version (0)
+	, _serialized_events_valid (false)
 {
 	g_atomic_int_set (&_touching, 0);
 	_interpolation = default_interpolation ();
@@ -382,7 +393,13 @@ AutomationList::state (bool full)
 	}
 
 	if (!_events.empty()) {
-		root->add_child_nocopy (serialize_events());
+		StateSidecar* sidecar = StateSidecar::in_this_thread ();
+
+		if (full && sidecar && sidecar->min_values() > 0 && _events.size() * 2 >= sidecar->min_values()) {
+			root->add_child_nocopy (serialize_events (*sidecar));
+		} else {
+			root->add_child_nocopy (serialize_events());
+		}
 	}
 
 	return *root;
@@ -392,28 +409,66 @@ XMLNode&
 AutomationList::serialize_events ()
 {
 	XMLNode* node = new XMLNode (X_("events"));
-	stringstream str;
 
-	for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
-		str << PBD::to_string ((*xx)->when);
-		str << ' ';
-		str << PBD::to_string ((*xx)->value);
-		str << '\n';
+	/* formatting the events is by far the most expensive part of saving
+	 * automation, so reuse the text from the last time unless the events
+	 * have changed since.
+	 */
+
+	const int version = events_version ();
+
+	if (!_serialized_events_valid || version != _serialized_events_version) {
+		stringstream str;
+
+		for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
+			str << PBD::to_string ((*xx)->when);
+			str << ' ';
+			str << PBD::to_string ((*xx)->value);
+			str << '\n';
+		}
+
+		_serialized_events = str.str();
+		_serialized_events_version = version;
+		_serialized_events_valid = true;
 	}
 
 	/* XML is a bit wierd */
 
 	XMLNode* content_node = new XMLNode (X_("foo")); /* it gets renamed by libxml when we set content */
-	content_node->set_content (str.str());
+	content_node->set_content (_serialized_events);
 
 	node->add_child_nocopy (*content_node);
 
 	return *node;
 }
 
+XMLNode&
+AutomationList::serialize_events (StateSidecar& sidecar)
+{
+	XMLNode* node = new XMLNode (X_("events"));
+	std::vector<double> values;
+
+	values.reserve (_events.size() * 2);
+
+	for (iterator xx = _events.begin(); xx != _events.end(); ++xx) {
+		values.push_back ((*xx)->when);
+		values.push_back ((*xx)->value);
+	}
+
+	node->set_property (X_("sidecar-offset"), sidecar.add (values));
+
+	return *node;
+}
+
 int
 AutomationList::deserialize_events (const XMLNode& node)
 {
+	uint64_t offset;
+
+	if (node.get_property (X_("sidecar-offset"), offset)) {
+		return deserialize_events (offset);
+	}
+
 	if (node.children().empty()) {
 		return -1;
 	}
@@ -462,6 +517,33 @@ AutomationList::deserialize_events (const XMLNode& node)
 	return 0;
 }
 
+int
+AutomationList::deserialize_events (uint64_t offset)
+{
+	StateSidecar* sidecar = StateSidecar::in_this_thread ();
+	std::vector<double> values;
+
+	if (!sidecar || !sidecar->get (offset, values) || (values.size() % 2)) {
+		error << _("automation list: events are missing from the state sidecar, all points ignored") << endmsg;
+		return -1;
+	}
+
+	ControlList::freeze ();
+	clear ();
+
+	for (std::vector<double>::const_iterator i = values.begin(); i != values.end(); i += 2) {
+		const double y = std::min ((double)_desc.upper, std::max ((double)_desc.lower, *(i + 1)));
+		fast_simple_add (*i, y);
+	}
+
+	mark_dirty ();
+	maybe_signal_changed ();
+
+	thaw ();
+
+	return 0;
+}
+
 int
 AutomationList::set_state (const XMLNode& node, int version)
 {
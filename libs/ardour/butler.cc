@@ -25,13 +25,22 @@
 #include <poll.h>
 #endif
 
+#include <algorithm>
+
 #include "pbd/error.h"
+#include "pbd/gstdio_compat.h"
 #include "pbd/pthread_utils.h"
+#include "ardour/audio_diskstream.h"
+#include "ardour/audiosource.h"
 #include "ardour/debug.h"
 #include "ardour/butler.h"
+#include "ardour/file_source.h"
 #include "ardour/io.h"
 #include "ardour/midi_diskstream.h"
+#include "ardour/playlist.h"
+#include "ardour/region.h"
 #include "ardour/session.h"
+#include "ardour/session_directory.h"
 #include "ardour/track.h"
 #include "ardour/auditioner.h"
 
@@ -41,6 +50,137 @@ using namespace PBD;
 
 namespace ARDOUR {
 
+/** A thread which performs refills or flushes for a subset of the tracks
+ *  on behalf of the butler.
+ */
+class Butler::IOWorker
+{
+  public:
+	IOWorker (Butler& b, uint32_t id)
+		: butler (b)
+		, refill (true)
+		, disk_work_outstanding (false)
+		, errors (0)
+		, _id (id)
+		, _quit (false)
+		, _have_thread (false)
+		, _run_sem ("butler_io_run", 0)
+	{
+		if (pthread_create_and_store (string_compose ("disk i/o %1", id), &_thread, _thread_work, this)) {
+			error << _("Session: could not create butler i/o thread") << endmsg;
+			return;
+		}
+		_have_thread = true;
+	}
+
+	~IOWorker ()
+	{
+		if (_have_thread) {
+			void* status;
+			_quit = true;
+			_run_sem.signal ();
+			pthread_join (_thread, &status);
+		}
+	}
+
+	bool ok () const { return _have_thread; }
+
+	/** start processing jobs; butler._io_done is signalled when done */
+	void run () { _run_sem.signal (); }
+
+	typedef std::pair<float, boost::shared_ptr<Track> > Job;
+	std::vector<Job> jobs;
+
+	Butler&  butler;
+	bool     refill;
+	bool     disk_work_outstanding;
+	uint32_t errors;
+	std::vector<boost::shared_ptr<Track> > failed;
+
+  private:
+	uint32_t       _id;
+	volatile bool  _quit;
+	bool           _have_thread;
+	pthread_t      _thread;
+	PBD::Semaphore _run_sem;
+
+	static void* _thread_work (void* arg)
+	{
+		IOWorker* w = static_cast<IOWorker*> (arg);
+		SessionEvent::create_per_thread_pool (string_compose ("butler i/o %1 events", w->_id), 64);
+		pthread_set_name (string_compose ("disk i/o %1", w->_id).c_str ());
+		AudioDiskstream::allocate_thread_working_buffers ();
+		AudioSource::allocate_thread_working_buffers ();
+		return w->thread_work ();
+	}
+
+	void* thread_work ()
+	{
+		while (true) {
+			_run_sem.wait ();
+			if (_quit) {
+				break;
+			}
+			if (refill) {
+				do_refills ();
+			} else {
+				do_flushes ();
+			}
+			butler._io_done.signal ();
+		}
+		return 0;
+	}
+
+	void do_refills ()
+	{
+		std::vector<Job>::iterator i;
+
+		for (i = jobs.begin(); !butler.transport_work_requested() && butler.should_run && i != jobs.end(); ++i) {
+			boost::shared_ptr<Track> tr = i->second;
+
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler i/o %1 refills %2, playback load = %3\n", _id, tr->name(), i->first));
+			switch (tr->do_refill ()) {
+			case 0:
+				break;
+			case 1:
+				disk_work_outstanding = true;
+				break;
+			default:
+				failed.push_back (tr);
+				break;
+			}
+		}
+
+		if (i != jobs.end()) {
+			/* we didn't get to all the streams */
+			disk_work_outstanding = true;
+		}
+	}
+
+	void do_flushes ()
+	{
+		for (std::vector<Job>::iterator i = jobs.begin(); !butler.transport_work_requested() && butler.should_run && i != jobs.end(); ++i) {
+			boost::shared_ptr<Track> tr = i->second;
+
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler i/o %1 flushes %2, capture load = %3\n", _id, tr->name(), i->first));
+			switch (tr->do_flush (ButlerContext, false)) {
+			case 0:
+				break;
+			case 1:
+				disk_work_outstanding = true;
+				break;
+			default:
+				/* don't break - try to flush all streams in case they
+				   are split across disks.
+				*/
+				errors++;
+				failed.push_back (tr);
+				break;
+			}
+		}
+	}
+};
+
 Butler::Butler(Session& s)
 	: SessionHandleRef (s)
 	, thread()
@@ -50,6 +190,7 @@ Butler::Butler(Session& s)
 	, midi_dstream_buffer_size(0)
 	, pool_trash(16)
 	, _xthread (true)
+	, _io_done ("butler_io_done", 0)
 {
 	g_atomic_int_set(&should_do_transport_work, 0);
 	SessionEvent::pool->set_trash (&pool_trash);
@@ -145,7 +286,11 @@ Butler::terminate_thread ()
                 DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: ask butler to quit @ %2\n", DEBUG_THREAD_SELF, g_get_monotonic_time()));
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
+		have_thread = false;
 	}
+
+	/* the butler thread is gone, nobody else uses the i/o workers */
+	reset_io_workers (0);
 }
 
 void *
@@ -162,7 +307,6 @@ Butler::thread_work ()
 	uint32_t err = 0;
 
 	bool disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time()));
@@ -203,6 +347,10 @@ Butler::thread_work ()
 		DEBUG_TRACE (DEBUG::Butler, "at restart for disk work\n");
 		disk_work_outstanding = false;
 
+		if (_io_workers.size() != Config->get_butler_io_threads()) {
+			reset_io_workers (Config->get_butler_io_threads());
+		}
+
 		if (transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, string_compose ("do transport work @ %1\n", g_get_monotonic_time()));
 			_session.butler_transport_work ();
@@ -224,43 +372,10 @@ Butler::thread_work ()
 		RouteList rl_with_auditioner = *rl;
 		rl_with_auditioner.push_back (_session.the_auditioner());
 
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
-
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
-
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active()) {
-				/* don't read inactive tracks */
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-			case 0:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-				break;
-
-			case 1:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
-				disk_work_outstanding = true;
-				break;
-
-			default:
-				error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
-                                std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
-				break;
-			}
-
-		}
-
-		if (i != rl_with_auditioner.begin() && i != rl_with_auditioner.end()) {
-			/* we didn't get to all the streams */
-			disk_work_outstanding = true;
+		if (_io_workers.empty()) {
+			disk_work_outstanding = refill_tracks_normal (rl_with_auditioner);
+		} else {
+			disk_work_outstanding = refill_tracks_parallel (rl_with_auditioner);
 		}
 
 		if (!err && transport_work_requested()) {
@@ -268,7 +383,11 @@ Butler::thread_work ()
 			goto restart;
 		}
 
-		disk_work_outstanding = flush_tracks_to_disk_normal (rl, err);
+		if (_io_workers.empty()) {
+			disk_work_outstanding = flush_tracks_to_disk_normal (rl, err);
+		} else {
+			disk_work_outstanding = flush_tracks_to_disk_parallel (rl, err);
+		}
 
 		if (err && _session.actively_recording()) {
 			/* stop the transport and try to catch as much possible
@@ -307,6 +426,54 @@ Butler::thread_work ()
 	return (0);
 }
 
+bool
+Butler::refill_tracks_normal (RouteList const & rl)
+{
+	bool disk_work_outstanding = false;
+	RouteList::const_iterator i;
+
+	for (i = rl.begin(); !transport_work_requested() && should_run && i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			/* don't read inactive tracks */
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
+			continue;
+		}
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
+		switch (tr->do_refill ()) {
+		case 0:
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
+			break;
+
+		case 1:
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
+			disk_work_outstanding = true;
+			break;
+
+		default:
+			error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
+			std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
+			break;
+		}
+
+	}
+
+	if (i != rl.begin() && i != rl.end()) {
+		/* we didn't get to all the streams */
+		disk_work_outstanding = true;
+	}
+
+	return disk_work_outstanding;
+}
+
 bool
 Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
 {
@@ -401,6 +568,244 @@ Butler::flush_tracks_to_disk_after_locate (boost::shared_ptr<RouteList> rl, uint
 	return disk_work_outstanding;
 }
 
+/** (Re)create the pool of disk I/O threads.
+ *  Must only be called from the butler thread, or when it is not running.
+ *  @param n number of threads; 0 means that the butler does all I/O itself.
+ */
+void
+Butler::reset_io_workers (uint32_t n)
+{
+	for (std::vector<IOWorker*>::iterator i = _io_workers.begin(); i != _io_workers.end(); ++i) {
+		delete *i;
+	}
+	_io_workers.clear ();
+	_io_groups.clear ();
+	_io_done.reset ();
+
+	for (uint32_t i = 0; i < n; ++i) {
+		IOWorker* w = new IOWorker (*this, i);
+		if (!w->ok ()) {
+			delete w;
+			break;
+		}
+		_io_workers.push_back (w);
+	}
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("butler uses %1 disk i/o threads\n", _io_workers.size()));
+}
+
+/** @return an identifier for the filesystem holding the data of a track;
+ *  tracks with the same identifier share the same disk(s).
+ */
+uint64_t
+Butler::io_group (boost::shared_ptr<Track> tr)
+{
+	boost::shared_ptr<Playlist> pl = tr->playlist ();
+	IOGroups::iterator i = _io_groups.find (tr->id());
+
+	if (i != _io_groups.end() && i->second.playlist.lock() == pl) {
+		return i->second.filesystem;
+	}
+
+	/* Look at the first file-backed source used by the playlist. This is
+	 * only a heuristic: a playlist could use sources from more than one
+	 * disk, but tracks normally record to and play from one place.
+	 */
+
+	std::string path;
+
+	if (pl) {
+		boost::shared_ptr<RegionList> regions = pl->region_list ();
+		for (RegionList::const_iterator r = regions->begin(); r != regions->end() && path.empty(); ++r) {
+			for (uint32_t n = 0; n < (*r)->n_channels() && path.empty(); ++n) {
+				boost::shared_ptr<FileSource> fs = boost::dynamic_pointer_cast<FileSource> ((*r)->source (n));
+				if (fs) {
+					path = fs->path ();
+				}
+			}
+		}
+	}
+
+	if (path.empty()) {
+		/* new recordings go here */
+		path = _session.session_directory().sound_path();
+	}
+
+	uint64_t filesystem = 0;
+	GStatBuf statbuf;
+
+	if (g_stat (path.c_str(), &statbuf) == 0) {
+		filesystem = statbuf.st_dev;
+	}
+
+	IOGroup g;
+	g.playlist = pl;
+	g.filesystem = filesystem;
+	_io_groups[tr->id()] = g;
+
+	return filesystem;
+}
+
+namespace {
+	/* order refills by playback buffer fill, emptiest first */
+	struct JobPlaybackUrgency {
+		bool operator() (std::pair<float, boost::shared_ptr<Track> > const & a, std::pair<float, boost::shared_ptr<Track> > const & b) const {
+			return a.first < b.first;
+		}
+	};
+
+	/* order flushes by capture buffer fill, fullest first */
+	struct JobCaptureUrgency {
+		bool operator() (std::pair<float, boost::shared_ptr<Track> > const & a, std::pair<float, boost::shared_ptr<Track> > const & b) const {
+			return a.first > b.first;
+		}
+	};
+}
+
+/** Distribute the tracks in @a rl across the i/o workers, so that each
+ *  filesystem is serviced by its own worker(s) and each worker handles its
+ *  most urgent tracks first.
+ */
+void
+Butler::partition_io_work (RouteList const & rl, bool refill)
+{
+	typedef std::map<uint64_t, std::vector<IOWorker::Job> > Partition;
+	Partition partition;
+
+	if (_io_groups.size() > 2 * rl.size()) {
+		/* forget about removed tracks */
+		_io_groups.clear ();
+	}
+
+	for (RouteList::const_iterator i = rl.begin(); i != rl.end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		if (refill) {
+			boost::shared_ptr<IO> io = tr->input ();
+			if (io && !io->active()) {
+				/* don't read inactive tracks */
+				continue;
+			}
+		}
+
+		/* note that we still try to flush diskstreams attached to inactive routes */
+
+		float const load = refill ? tr->playback_buffer_load () : tr->capture_buffer_load ();
+		partition[io_group (tr)].push_back (std::make_pair (load, tr));
+	}
+
+	uint32_t const n_workers = _io_workers.size ();
+	uint32_t const n_groups = partition.size ();
+
+	for (std::vector<IOWorker*>::iterator w = _io_workers.begin(); w != _io_workers.end(); ++w) {
+		(*w)->jobs.clear ();
+		(*w)->refill = refill;
+		(*w)->disk_work_outstanding = false;
+		(*w)->errors = 0;
+		(*w)->failed.clear ();
+	}
+
+	uint32_t g = 0;
+
+	for (Partition::iterator p = partition.begin(); p != partition.end(); ++p, ++g) {
+
+		/* the workers dedicated to this filesystem */
+		std::vector<IOWorker*> workers;
+
+		if (n_groups >= n_workers) {
+			workers.push_back (_io_workers[g % n_workers]);
+		} else {
+			for (uint32_t n = g; n < n_workers; n += n_groups) {
+				workers.push_back (_io_workers[n]);
+			}
+		}
+
+		for (size_t j = 0; j < p->second.size(); ++j) {
+			workers[j % workers.size()]->jobs.push_back (p->second[j]);
+		}
+	}
+
+	for (std::vector<IOWorker*>::iterator w = _io_workers.begin(); w != _io_workers.end(); ++w) {
+		if (refill) {
+			std::stable_sort ((*w)->jobs.begin(), (*w)->jobs.end(), JobPlaybackUrgency());
+		} else {
+			std::stable_sort ((*w)->jobs.begin(), (*w)->jobs.end(), JobCaptureUrgency());
+		}
+	}
+}
+
+/** Run all i/o workers which have been given work and wait for them to finish.
+ *  @return true if there is more disk work to do.
+ */
+bool
+Butler::run_io_workers (uint32_t& errors)
+{
+	bool disk_work_outstanding = false;
+	uint32_t n_running = 0;
+
+	for (std::vector<IOWorker*>::iterator w = _io_workers.begin(); w != _io_workers.end(); ++w) {
+		if (!(*w)->jobs.empty()) {
+			(*w)->run ();
+			++n_running;
+		}
+	}
+
+	while (n_running--) {
+		_io_done.wait ();
+	}
+
+	for (std::vector<IOWorker*>::iterator w = _io_workers.begin(); w != _io_workers.end(); ++w) {
+		IOWorker* iow (*w);
+
+		disk_work_outstanding = disk_work_outstanding || iow->disk_work_outstanding;
+		errors += iow->errors;
+
+		for (std::vector<boost::shared_ptr<Track> >::iterator t = iow->failed.begin(); t != iow->failed.end(); ++t) {
+			if (iow->refill) {
+				error << string_compose(_("Butler read ahead failure on dstream %1"), (*t)->name()) << endmsg;
+			} else {
+				error << string_compose(_("Butler write-behind failure on dstream %1"), (*t)->name()) << endmsg;
+			}
+		}
+
+		/* do not keep tracks alive */
+		iow->jobs.clear ();
+		iow->failed.clear ();
+	}
+
+	return disk_work_outstanding;
+}
+
+bool
+Butler::refill_tracks_parallel (RouteList const & rl)
+{
+	if (transport_work_requested() || !should_run) {
+		return false;
+	}
+
+	partition_io_work (rl, true);
+
+	/* like refill_tracks_normal(), report read errors but do not count them */
+	uint32_t read_errors = 0;
+	return run_io_workers (read_errors);
+}
+
+bool
+Butler::flush_tracks_to_disk_parallel (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+{
+	if (transport_work_requested() || !should_run) {
+		return false;
+	}
+
+	partition_io_work (*rl, false);
+	return run_io_workers (errors);
+}
+
 void
 Butler::schedule_transport_work ()
 {
@@ -58,6 +58,7 @@ namespace ARDOUR {
 
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
+	, job_pool (hardware_concurrency())
 	, thread_pool (hardware_concurrency())
 {
 	process_buffer_frames = session.engine().samples_per_cycle();
@@ -72,22 +73,56 @@ ExportGraphBuilder::process (framecnt_t frames, bool last_cycle)
 {
 	assert(frames <= process_buffer_frames);
 
+	/* each channel is read only once, however many configs use it */
+
 	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
-		Sample const * process_buffer = 0;
-		it->first->read (process_buffer, frames);
-		ConstProcessContext<Sample> context(process_buffer, frames, 1);
-		if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
-		it->second->process (context);
+		it->second = 0;
+		it->first->read (it->second, frames);
 	}
 
+	ProcessContext<Sample> context ((Sample*) 0, frames, 1);
+	if (last_cycle) { context.set_flag (ProcessContext<Sample>::EndOfInput); }
+
+	/* The trees of different channel configs share nothing but the data
+	 * read above, so when freewheeling they run in parallel.  Waiting for
+	 * other threads is no good in a realtime export, though.
+	 */
+
+	if (_realtime || channel_configs.size() < 2) {
+		for (ChannelConfigList::iterator it = channel_configs.begin(); it != channel_configs.end(); ++it) {
+			it->run (context);
+		}
+		return 0;
+	}
+
+	if (!channel_config_threader) {
+		channel_config_threader.reset (new Threader<Sample> (job_pool));
+		for (ChannelConfigList::iterator it = channel_configs.begin(); it != channel_configs.end(); ++it) {
+			channel_config_threader->add_output (boost::shared_ptr<Job<ChannelConfig> > (new Job<ChannelConfig> (*it)));
+		}
+	}
+
+	channel_config_threader->process (context);
+
 	return 0;
 }
 
 bool
 ExportGraphBuilder::post_process ()
 {
+	if (intermediates.size() > 1) {
+		/* each reads back its own file, and normalizes and encodes it */
+		Threader<Sample> threader (job_pool);
+		for (std::list<Intermediate *>::iterator it = intermediates.begin(); it != intermediates.end(); ++it) {
+			threader.add_output (boost::shared_ptr<Job<Intermediate> > (new Job<Intermediate> (**it)));
+		}
+		threader.process (ProcessContext<Sample> ((Sample*) 0, 0, 1));
+	} else if (!intermediates.empty()) {
+		intermediates.front()->finished = intermediates.front()->process ();
+	}
+
 	for (std::list<Intermediate *>::iterator it = intermediates.begin(); it != intermediates.end(); /* ++ in loop */) {
-		if ((*it)->process()) {
+		if ((*it)->finished) {
 			it = intermediates.erase (it);
 		} else {
 			++it;
@@ -111,6 +146,7 @@ void
 ExportGraphBuilder::reset ()
 {
 	timespan.reset();
+	channel_config_threader.reset ();
 	channel_configs.clear ();
 	channels.clear ();
 	intermediates.clear ();
@@ -121,6 +157,8 @@ ExportGraphBuilder::reset ()
 void
 ExportGraphBuilder::cleanup (bool remove_out_files/*=false*/)
 {
+	channel_config_threader.reset ();
+
 	ChannelConfigList::iterator iter = channel_configs.begin();
 
 	while (iter != channel_configs.end() ) {
@@ -202,6 +240,7 @@ ExportGraphBuilder::add_split_config (FileSpec const & config)
 	}
 
 	// No duplicate channel config found, create new one
+	channel_config_threader.reset ();
 	channel_configs.push_back (new ChannelConfig (*this, config, channels));
 }
 
@@ -414,7 +453,8 @@ ExportGraphBuilder::SFC::operator== (FileSpec const & other_config) const
 /* Intermediate (Normalizer, TmpFile) */
 
 ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, FileSpec const & new_config, framecnt_t max_frames)
-	: parent (parent)
+	: finished (false)
+	, parent (parent)
 	, use_loudness (false)
 	, use_peak (false)
 {
@@ -548,6 +588,8 @@ ExportGraphBuilder::Intermediate::prepare_post_processing()
 		}
 	}
 	tmp_file->add_output (normalizer);
+
+	Glib::Threads::Mutex::Lock lm (parent.intermediates_lock);
 	parent.intermediates.push_back (this);
 }
 
@@ -736,11 +778,11 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 		ChannelMap::iterator map_it = channel_map.find (*it);
 		if (map_it == channel_map.end()) {
 			std::pair<ChannelMap::iterator, bool> result_pair =
-				channel_map.insert (std::make_pair (*it, IdentityVertexPtr (new IdentityVertex<Sample> ())));
+				channel_map.insert (std::make_pair (*it, (Sample const *) 0));
 			assert (result_pair.second);
 			map_it = result_pair.first;
 		}
-		map_it->second->add_output (interleaver->input (chan));
+		inputs.push_back (map_it);
 	}
 
 	add_child (new_config);
@@ -775,6 +817,16 @@ ExportGraphBuilder::ChannelConfig::remove_children (bool remove_out_files)
 	}
 }
 
+void
+ExportGraphBuilder::ChannelConfig::run (ProcessContext<Sample> const & c)
+{
+	for (unsigned chan = 0; chan < inputs.size(); ++chan) {
+		ConstProcessContext<Sample> context (inputs[chan]->second, c.frames(), 1);
+		if (c.has_flag (ProcessContext<Sample>::EndOfInput)) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+		interleaver->input (chan)->process (context);
+	}
+}
+
 bool
 ExportGraphBuilder::ChannelConfig::operator== (FileSpec const & other_config) const
 {
@@ -140,6 +140,11 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain = 0;
 copy_vector_t			ARDOUR::copy_vector = 0;
+apply_gain_ramp_t       ARDOUR::apply_gain_ramp = 0;
+interleave_channel_t    ARDOUR::interleave_channel = 0;
+deinterleave_channel_t  ARDOUR::deinterleave_channel = 0;
+apply_gain_curve_t      ARDOUR::apply_gain_curve = 0;
+apply_gain_lpf_t        ARDOUR::apply_gain_lpf = 0;
 
 PBD::Signal1<void,std::string> ARDOUR::BootMessage;
 PBD::Signal3<void,std::string,std::string,bool> ARDOUR::PluginScanMessage;
@@ -171,14 +176,50 @@ setup_hardware_optimization (bool try_optimization)
 
 #if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
 
+		if (fpu->has_avx512f()) {
+
+			info << "Using AVX-512 optimized routines" << endmsg;
+
+			compute_peak          = x86_avx512f_compute_peak;
+			find_peaks            = x86_avx512f_find_peaks;
+			apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+			copy_vector           = x86_avx512f_copy_vector;
+			apply_gain_ramp       = x86_avx512f_apply_gain_ramp;
+			interleave_channel    = x86_avx512f_interleave_channel;
+			deinterleave_channel  = x86_avx512f_deinterleave_channel;
+			apply_gain_curve      = x86_avx512f_apply_gain_curve;
+			apply_gain_lpf        = x86_avx512f_apply_gain_lpf;
+
+			generic_mix_functions = false;
+
+		} else if (fpu->has_avx2() && fpu->has_fma()) {
+
+			info << "Using AVX2/FMA optimized routines" << endmsg;
+
+			compute_peak          = x86_avx2_compute_peak;
+			find_peaks            = x86_avx2_find_peaks;
+			apply_gain_to_buffer  = x86_avx2_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx2_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx2_mix_buffers_no_gain;
+			copy_vector           = x86_avx2_copy_vector;
+			apply_gain_ramp       = x86_avx2_apply_gain_ramp;
+			interleave_channel    = x86_avx2_interleave_channel;
+			deinterleave_channel  = x86_avx2_deinterleave_channel;
+			apply_gain_curve      = x86_avx2_apply_gain_curve;
+			apply_gain_lpf        = x86_avx2_apply_gain_lpf;
+
+			generic_mix_functions = false;
+
 #ifdef PLATFORM_WINDOWS
 		/* We have AVX-optimized code for Windows */
 
-		if (fpu->has_avx()) {
+		} else if (fpu->has_avx()) {
 #else
 		/* AVX code doesn't compile on Linux yet */
 
-		if (false) {
+		} else if (false) {
 #endif
 			info << "Using AVX optimized routines" << endmsg;
 
@@ -189,6 +230,11 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			interleave_channel    = default_interleave_channel;
+			deinterleave_channel  = default_deinterleave_channel;
+			apply_gain_curve      = default_apply_gain_curve;
+			apply_gain_lpf        = default_apply_gain_lpf;
 
 			generic_mix_functions = false;
 
@@ -203,6 +249,11 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			interleave_channel    = default_interleave_channel;
+			deinterleave_channel  = default_deinterleave_channel;
+			apply_gain_curve      = default_apply_gain_curve;
+			apply_gain_lpf        = default_apply_gain_lpf;
 
 			generic_mix_functions = false;
 
@@ -217,11 +268,37 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain  = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain    = veclib_mix_buffers_no_gain;
 			copy_vector            = default_copy_vector;
+			apply_gain_ramp        = default_apply_gain_ramp;
+			interleave_channel     = default_interleave_channel;
+			deinterleave_channel   = default_deinterleave_channel;
+			apply_gain_curve       = default_apply_gain_curve;
+			apply_gain_lpf         = default_apply_gain_lpf;
 
 			generic_mix_functions = false;
 
 			info << "Apple VecLib H/W specific optimizations in use" << endmsg;
 		}
+
+#elif defined (__aarch64__) && defined (BUILD_NEON_OPTIMIZATIONS)
+
+		if (fpu->has_neon()) {
+
+			info << "Using NEON optimized routines" << endmsg;
+
+			compute_peak          = arm_neon_compute_peak;
+			find_peaks            = arm_neon_find_peaks;
+			apply_gain_to_buffer  = arm_neon_apply_gain_to_buffer;
+			mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
+			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
+			copy_vector           = arm_neon_copy_vector;
+			apply_gain_ramp       = arm_neon_apply_gain_ramp;
+			interleave_channel    = arm_neon_interleave_channel;
+			deinterleave_channel  = arm_neon_deinterleave_channel;
+			apply_gain_curve      = arm_neon_apply_gain_curve;
+			apply_gain_lpf        = arm_neon_apply_gain_lpf;
+
+			generic_mix_functions = false;
+		}
 #endif
 
 		/* consider FPU denormal handling to be "h/w optimization" */
@@ -237,6 +314,11 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		apply_gain_ramp       = default_apply_gain_ramp;
+		interleave_channel    = default_interleave_channel;
+		deinterleave_channel  = default_deinterleave_channel;
+		apply_gain_curve      = default_apply_gain_curve;
+		apply_gain_lpf        = default_apply_gain_lpf;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
@@ -19,6 +19,7 @@
 */
 #include <stdio.h>
 #include <cmath>
+#include <algorithm>
 
 #include "pbd/compose.h"
 #include "pbd/debug_rt_alloc.h"
@@ -26,6 +27,7 @@
 
 #include "ardour/debug.h"
 #include "ardour/graph.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/types.h"
 #include "ardour/session.h"
 #include "ardour/route.h"
@@ -54,6 +56,8 @@ int alloc_allowed ()
 Graph::Graph (Session & session)
 	: SessionHandleRef (session)
 	, _threads_active (false)
+	, _work_stealing (false)
+	, _collect_thread_stats (false)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
@@ -66,6 +70,7 @@ Graph::Graph (Session & session)
 	_trigger_queue.reserve (8192);
 
 	_execution_tokens = 0;
+	_trigger_overflow = 0;
 
 	_current_chain = 0;
 	_pending_chain = 0;
@@ -105,11 +110,13 @@ Graph::reset_thread_list ()
 	/* For now, we shouldn't be using the graph code if we only have 1 DSP thread */
 	assert (num_threads > 1);
 
+	bool const work_stealing = Config->get_graph_work_stealing ();
+
 	/* don't bother doing anything here if we already have the right
-	 * number of threads.
+	 * number of threads and the scheduler has not changed.
 	 */
 
-	if (AudioEngine::instance()->process_thread_count() == num_threads) {
+	if (AudioEngine::instance()->process_thread_count() == num_threads && _work_stealing == work_stealing) {
 		return;
 	}
 
@@ -119,6 +126,21 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	_work_stealing = work_stealing;
+	_busy_usecs.assign (num_threads, 0);
+
+	if (_work_stealing) {
+		/* same (arbitrary) limit as _trigger_queue's reservation;
+		 * anything beyond spills over into _trigger_queue.
+		 */
+		for (uint32_t i = 0; i < num_threads; ++i) {
+			_work_queues.push_back (new WorkQueue (8192));
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::Graph, string_compose ("using %1 process threads, %2 scheduler\n",
+	                                           num_threads, _work_stealing ? "work-stealing" : "shared-queue"));
+
 	_threads_active = true;
 
 	if (AudioEngine::instance()->create_process_thread (boost::bind (&Graph::main_thread, this)) != 0) {
@@ -126,7 +148,7 @@ Graph::reset_thread_list ()
 	}
 
 	for (uint32_t i = 1; i < num_threads; ++i) {
-		if (AudioEngine::instance()->create_process_thread (boost::bind (&Graph::helper_thread, this))) {
+		if (AudioEngine::instance()->create_process_thread (boost::bind (&Graph::helper_thread, this, i))) {
 			throw failed_constructor ();
 		}
 	}
@@ -169,6 +191,13 @@ Graph::drop_threads ()
 	_callback_done_sem.signal ();
 	_execution_tokens = 0;
 
+	/* all process threads are gone, nobody can be using the work queues */
+	for (std::vector<WorkQueue*>::iterator i = _work_queues.begin(); i != _work_queues.end(); ++i) {
+		delete *i;
+	}
+	_work_queues.clear ();
+	_trigger_overflow = 0;
+
 	/* reset semaphores.
 	 * This is somewhat ugly, yet if a thread is killed (e.g jackd terminates
 	 * abnormally), some semaphores are still unlocked.
@@ -209,7 +238,7 @@ Graph::clear_other_chain ()
 }
 
 void
-Graph::prep()
+Graph::prep (uint32_t worker)
 {
 	node_list_t::iterator i;
 	int chain;
@@ -236,6 +265,13 @@ Graph::prep()
 	_finished_refcount = _init_finished_refcount[chain];
 
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
+	if (_work_stealing) {
+		for (i=_init_trigger_list[chain].begin(); i!=_init_trigger_list[chain].end(); i++) {
+			trigger (i->get (), worker);
+		}
+		return;
+	}
+
 	pthread_mutex_lock (&_trigger_mutex);
 	for (i=_init_trigger_list[chain].begin(); i!=_init_trigger_list[chain].end(); i++) {
 		/* don't use ::trigger here, as we have already locked the mutex */
@@ -244,19 +280,85 @@ Graph::prep()
 	pthread_mutex_unlock (&_trigger_mutex);
 }
 
+/** Queue a node for processing.
+ *  @param worker Index of the calling process thread.
+ */
 void
-Graph::trigger (GraphNode* n)
+Graph::trigger (GraphNode* n, uint32_t worker)
 {
+	if (_work_stealing) {
+		/* push to the calling thread's own deque: it will most likely
+		 * pick this node up itself, while its inputs are still hot in
+		 * its cache, unless an idle thread steals it first.
+		 */
+		if (!_work_queues[worker]->push (n)) {
+			pthread_mutex_lock (&_trigger_mutex);
+			_trigger_queue.push_back (n);
+			g_atomic_int_inc (&_trigger_overflow);
+			pthread_mutex_unlock (&_trigger_mutex);
+		}
+		wake_idle_worker ();
+		return;
+	}
+
 	pthread_mutex_lock (&_trigger_mutex);
 	_trigger_queue.push_back (n);
 	pthread_mutex_unlock (&_trigger_mutex);
 }
 
+/** Queue a job for any process thread to run. Unlike a graph node
+ *  it is not counted towards the end of the cycle: whoever triggers
+ *  a job must either retract it, or wait for it to finish, before the
+ *  node it belongs to is finished.
+ */
+void
+Graph::trigger_job (GraphNode* n)
+{
+	pthread_mutex_lock (&_trigger_mutex);
+	_trigger_queue.push_back (n);
+
+	if (_work_stealing) {
+		g_atomic_int_inc (&_trigger_overflow);
+		pthread_mutex_unlock (&_trigger_mutex);
+		wake_idle_worker ();
+		return;
+	}
+
+	if (_execution_tokens > 0) {
+		_execution_tokens -= 1;
+		_execution_sem.signal ();
+	}
+	pthread_mutex_unlock (&_trigger_mutex);
+}
+
+/** Remove a job queued by trigger_job() if no process thread has picked
+ *  it up yet.
+ *  @return true if the job was removed, and hence is not going to run.
+ */
+bool
+Graph::retract_job (GraphNode* n)
+{
+	bool found = false;
+
+	pthread_mutex_lock (&_trigger_mutex);
+	std::vector<GraphNode*>::iterator i = std::find (_trigger_queue.begin(), _trigger_queue.end(), n);
+	if (i != _trigger_queue.end()) {
+		_trigger_queue.erase (i);
+		if (_work_stealing) {
+			g_atomic_int_add (&_trigger_overflow, -1);
+		}
+		found = true;
+	}
+	pthread_mutex_unlock (&_trigger_mutex);
+
+	return found;
+}
+
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
  *  is finished.
  */
 void
-Graph::dec_ref()
+Graph::dec_ref (uint32_t worker)
 {
 	if (g_atomic_int_dec_and_test (const_cast<gint*> (&_finished_refcount))) {
 
@@ -264,12 +366,12 @@ Graph::dec_ref()
 		 * the graph, so there is nothing more to do this time around.
 		 */
 
-		restart_cycle ();
+		restart_cycle (worker);
 	}
 }
 
 void
-Graph::restart_cycle()
+Graph::restart_cycle (uint32_t worker)
 {
 	// we are through. wakeup our caller.
 
@@ -283,7 +385,7 @@ again:
 		return;
 	}
 
-	prep ();
+	prep (worker);
 
 	if (_graph_empty && _threads_active) {
 		goto again;
@@ -367,13 +469,18 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
 }
 
 /** Called by both the main thread and all helpers.
+ *  @param worker Index of the calling process thread.
  *  @return true to quit, false to carry on.
  */
 bool
-Graph::run_one()
+Graph::run_one (uint32_t worker)
 {
 	GraphNode* to_run;
 
+	if (_work_stealing) {
+		return run_one_work_stealing (worker);
+	}
+
 	pthread_mutex_lock (&_trigger_mutex);
 	if (_trigger_queue.size()) {
 		to_run = _trigger_queue.back();
@@ -415,8 +522,57 @@ Graph::run_one()
 	}
 	pthread_mutex_unlock (&_trigger_mutex);
 
-	to_run->process();
-	to_run->finish (_current_chain);
+	run_node (to_run, worker);
+
+	DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name()));
+
+	return !_threads_active;
+}
+
+/** Work-stealing variant of run_one(): take a node from our own deque,
+ *  or failing that from another thread's, and go to sleep only if there
+ *  is nothing left anywhere.
+ *  @return true to quit, false to carry on.
+ */
+bool
+Graph::run_one_work_stealing (uint32_t worker)
+{
+	GraphNode* to_run = _work_queues[worker]->pop ();
+
+	if (!to_run) {
+		to_run = steal_work (worker);
+	}
+
+	while (to_run == 0) {
+		/* announce that we are about to sleep */
+		g_atomic_int_inc (&_execution_tokens);
+
+		/* A concurrent trigger() may have missed us, look again before
+		 * actually going to sleep.
+		 */
+		to_run = steal_work (worker);
+
+		if (to_run) {
+			if (!retract_idle_token ()) {
+				/* somebody already took our token and signalled
+				 * us; consume that signal.
+				 */
+				_execution_sem.wait ();
+			}
+			break;
+		}
+
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name()));
+		_execution_sem.wait ();
+		if (!_threads_active) {
+			return true;
+		}
+		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 is awake\n", pthread_name()));
+
+		to_run = steal_work (worker);
+	}
+
+	run_node (to_run, worker);
 
 	DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name()));
 
@@ -424,7 +580,89 @@ Graph::run_one()
 }
 
 void
-Graph::helper_thread()
+Graph::run_node (GraphNode* n, uint32_t worker)
+{
+	if (_collect_thread_stats) {
+		const gint64 start = g_get_monotonic_time ();
+		n->process ();
+		_busy_usecs[worker] += g_get_monotonic_time () - start;
+	} else {
+		n->process ();
+	}
+
+	n->finish (_current_chain, worker);
+}
+
+/** Try to take a node queued by some other process thread.
+ *  @return the node, or 0 if there is no work anywhere.
+ */
+GraphNode*
+Graph::steal_work (uint32_t worker)
+{
+	GraphNode* n;
+	uint32_t const n_queues = _work_queues.size ();
+	bool retry;
+
+	do {
+		retry = false;
+		for (uint32_t i = 1; i < n_queues; ++i) {
+			WorkQueue* q = _work_queues[(worker + i) % n_queues];
+			if (q->steal (n)) {
+				return n;
+			}
+			if (!q->empty ()) {
+				/* lost a race with another thief, try again */
+				retry = true;
+			}
+		}
+	} while (retry);
+
+	if (g_atomic_int_get (&_trigger_overflow) > 0) {
+		n = 0;
+		pthread_mutex_lock (&_trigger_mutex);
+		if (!_trigger_queue.empty ()) {
+			n = _trigger_queue.back ();
+			_trigger_queue.pop_back ();
+			g_atomic_int_add (&_trigger_overflow, -1);
+		}
+		pthread_mutex_unlock (&_trigger_mutex);
+		return n;
+	}
+
+	return 0;
+}
+
+/** Wake up one sleeping process thread, if there is any (work-stealing mode) */
+void
+Graph::wake_idle_worker ()
+{
+	gint et;
+	while ((et = g_atomic_int_get (&_execution_tokens)) > 0) {
+		if (g_atomic_int_compare_and_exchange (&_execution_tokens, et, et - 1)) {
+			DEBUG_TRACE(DEBUG::ProcessThreads, string_compose ("%1 signals 1\n", pthread_name()));
+			_execution_sem.signal ();
+			return;
+		}
+	}
+}
+
+/** Undo a preceding increment of _execution_tokens.
+ *  @return false if the token was already taken by wake_idle_worker().
+ */
+bool
+Graph::retract_idle_token ()
+{
+	gint et;
+	while ((et = g_atomic_int_get (&_execution_tokens)) > 0) {
+		if (g_atomic_int_compare_and_exchange (&_execution_tokens, et, et - 1)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+Graph::helper_thread (uint32_t worker)
 {
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
@@ -433,7 +671,7 @@ Graph::helper_thread()
 	pt->get_buffers();
 
 	while(1) {
-		if (run_one()) {
+		if (run_one (worker)) {
 			break;
 		}
 	}
@@ -442,6 +680,18 @@ Graph::helper_thread()
 	delete pt;
 }
 
+void
+Graph::reset_thread_stats ()
+{
+	std::fill (_busy_usecs.begin(), _busy_usecs.end(), 0);
+}
+
+void
+Graph::thread_stats (std::vector<gint64>& busy_usecs) const
+{
+	busy_usecs = _busy_usecs;
+}
+
 /** Here's the main graph thread */
 void
 Graph::main_thread()
@@ -463,7 +713,7 @@ again:
 		return;
 	}
 
-	prep ();
+	prep (0);
 
 	if (_graph_empty && _threads_active) {
 		_callback_done_sem.signal ();
@@ -474,7 +724,7 @@ again:
 	/* This loop will run forever */
 	while (1) {
 		DEBUG_TRACE(DEBUG::ProcessThreads, "main thread runs one graph node\n");
-		if (run_one()) {
+		if (run_one (0)) {
 			break;
 		}
 	}
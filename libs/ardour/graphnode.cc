@@ -42,33 +42,34 @@ GraphNode::prep (int chain)
 
 /** Called by another node to tell us that one of the nodes that feed us
  *  has been processed.
+ *  @param worker Index of the process thread which ran the feeding node.
  */
 void
-GraphNode::dec_ref()
+GraphNode::dec_ref (uint32_t worker)
 {
 	if (g_atomic_int_dec_and_test (&_refcount)) {
 		/* All the nodes that feed us are done, so we can queue this node
 		 * for processing.
 		 */
-		_graph->trigger (this);
+		_graph->trigger (this, worker);
 	}
 }
 
 void
-GraphNode::finish (int chain)
+GraphNode::finish (int chain, uint32_t worker)
 {
 	node_set_t::iterator i;
 	bool feeds_somebody = false;
 
 	/* Tell the nodes that we feed that we've finished */
 	for (i=_activation_set[chain].begin(); i!=_activation_set[chain].end(); i++) {
-		(*i)->dec_ref();
+		(*i)->dec_ref (worker);
 		feeds_somebody = true;
 	}
 
 	if (!feeds_somebody) {
 		/* This node does not feed anybody, so decrement the graph's finished count */
-		_graph->dec_ref();
+		_graph->dec_ref (worker);
 	}
 }
 
@@ -40,8 +40,11 @@
 #include <boost/scoped_array.hpp>
 #include <boost/shared_array.hpp>
 
+#include <boost/bind.hpp>
+
 #include "pbd/basename.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 
 #include "evoral/SMF.hpp"
 
@@ -237,7 +240,8 @@ compose_status_message (const string& path,
 
 static void
 write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
-                               vector<boost::shared_ptr<Source> >& newfiles)
+                               vector<boost::shared_ptr<Source> >& newfiles,
+                               volatile float& progress)
 {
 	const framecnt_t nframes = ResampledImportableSource::blocksize;
 	boost::shared_ptr<AudioFileSource> afs;
@@ -258,7 +262,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 	boost::shared_ptr<AudioSource> s = boost::dynamic_pointer_cast<AudioSource> (newfiles[0]);
 	assert (s);
 
-	status.progress = 0.0f;
+	progress = 0.0f;
 	float progress_multiplier = 1;
 	float progress_base = 0;
 
@@ -281,7 +285,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 			peak = compute_peak (data.get(), nread * channels, peak);
 
 			read_count += nread / channels;
-			status.progress = 0.5 * read_count / (source->ratio() * source->length() * channels);
+			progress = 0.5 * read_count / (source->ratio() * source->length() * channels);
 		}
 
 		if (peak >= 1) {
@@ -340,8 +344,110 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 		}
 
 		read_count += nread;
-		status.progress = progress_base + progress_multiplier * read_count / (source->ratio () * source->length() * channels);
+		progress = progress_base + progress_multiplier * read_count / (source->ratio () * source->length() * channels);
+	}
+}
+
+/** An audio file waiting to be imported by one of the import workers */
+struct AudioImportJob {
+	AudioImportJob (string const & p, vector<boost::shared_ptr<Source> > const & n, string const & m)
+		: path (p), newfiles (n), message (m), progress (0), started (0), done (0) {}
+
+	string                             path;
+	vector<boost::shared_ptr<Source> > newfiles;
+	string                             message;
+	volatile float                     progress;
+	volatile gint                      started;
+	volatile gint                      done;
+};
+
+/** Import jobs, taken in order by however many workers are running */
+struct AudioImportQueue {
+	AudioImportQueue (ImportStatus& s, framecnt_t sr) : status (s), samplerate (sr), next (0) {}
+
+	ImportStatus&                              status;
+	framecnt_t                                 samplerate;
+	vector<boost::shared_ptr<AudioImportJob> > jobs;
+	volatile gint                              next;
+};
+
+static void
+audio_import_worker (AudioImportQueue* q)
+{
+	int n;
+
+	while (!q->status.cancel && (n = g_atomic_int_add (&q->next, 1)) < (int) q->jobs.size ()) {
+
+		boost::shared_ptr<AudioImportJob> job = q->jobs[n];
+		g_atomic_int_set (&job->started, 1);
+
+		/* the file was opened once already, to find out how many
+		   channels it has; it is opened again here so that only as
+		   many files are open (and resampling) as there are workers.
+		*/
+
+		try {
+			boost::shared_ptr<ImportableSource> source = open_importable_source (job->path, q->samplerate, q->status.quality);
+			write_audio_data_to_new_files (source.get(), q->status, job->newfiles, job->progress);
+		} catch (...) {
+			error << string_compose(_("Import: cannot open input sound file \"%1\""), job->path) << endmsg;
+			q->status.cancel = true;
+		}
+
+		job->progress = 1.0;
+		g_atomic_int_set (&job->done, 1);
+	}
+}
+
+/** Decode, resample and write the files in @param q, several at a time,
+ *  reporting overall progress through the queue's ImportStatus.
+ */
+static void
+run_audio_import_jobs (AudioImportQueue& q)
+{
+	ImportStatus& status (q.status);
+	const uint32_t first = status.current;
+	const uint32_t n_workers = min ((uint32_t) q.jobs.size (), max (1U, min (8U, hardware_concurrency ())));
+
+	vector<Glib::Threads::Thread*> workers;
+
+	for (uint32_t n = 0; n < n_workers; ++n) {
+		workers.push_back (Glib::Threads::Thread::create (boost::bind (audio_import_worker, &q)));
+	}
+
+	bool finished = false;
+
+	while (!finished) {
+
+		Glib::usleep (100000);
+
+		/* report the files in progress as fractions of a file, for
+		   consistency with a single file at a time.
+		*/
+
+		float sum = 0;
+		finished = true;
+
+		for (vector<boost::shared_ptr<AudioImportJob> >::const_iterator j = q.jobs.begin(); j != q.jobs.end(); ++j) {
+			if (!g_atomic_int_get (&(*j)->done)) {
+				finished = finished && status.cancel && !g_atomic_int_get (&(*j)->started);
+				if (g_atomic_int_get (&(*j)->started)) {
+					status.doing_what = (*j)->message;
+				}
+			}
+			sum += (*j)->progress;
+		}
+
+		const uint32_t whole = (uint32_t) sum;
+		status.current = first + whole;
+		status.progress = sum - whole;
 	}
+
+	for (vector<Glib::Threads::Thread*>::iterator w = workers.begin(); w != workers.end(); ++w) {
+		(*w)->join ();
+	}
+
+	status.progress = 0;
 }
 
 static void
@@ -494,6 +600,11 @@ Session::import_files (ImportStatus& status)
 	uint32_t channels = 0;
 	vector<string> smf_names;
 
+	/* audio files are set up here, one by one, but imported in parallel
+	   once all of them have been set up.
+	*/
+	AudioImportQueue audio_queue (status, frame_rate());
+
 	status.sources.clear ();
 
 	for (vector<string>::const_iterator p = status.paths.begin();
@@ -575,9 +686,10 @@ Session::import_files (ImportStatus& status)
 		}
 
 		if (source) { // audio
-			status.doing_what = compose_status_message (*p, source->samplerate(),
-			                                            frame_rate(), status.current, status.total);
-			write_audio_data_to_new_files (source.get(), status, newfiles);
+			audio_queue.jobs.push_back (boost::shared_ptr<AudioImportJob> (
+				                            new AudioImportJob (*p, newfiles, compose_status_message (*p, source->samplerate(),
+				                                                                                      frame_rate(), status.current, status.total))));
+			continue;
 		} else if (smf_reader.get()) { // midi
 			status.doing_what = string_compose(_("Loading MIDI file %1"), *p);
 			write_midi_data_to_new_files (smf_reader.get(), status, newfiles, status.split_midi_channels);
@@ -587,6 +699,10 @@ Session::import_files (ImportStatus& status)
 		status.progress = 0;
 	}
 
+	if (!status.cancel && !audio_queue.jobs.empty ()) {
+		run_audio_import_jobs (audio_queue);
+	}
+
 	if (!status.cancel) {
 		struct tm* now;
 		time_t xnow;
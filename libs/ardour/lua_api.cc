@@ -386,6 +386,29 @@ ARDOUR::LuaAPI::timecode_to_sample_lua (lua_State *L)
 	return 1;
 }
 
+int
+ARDOUR::LuaAPI::batch_graph_changes_lua (lua_State *L)
+{
+	int top = lua_gettop (L);
+	if (top < 2 || lua_type (L, 2) != LUA_TFUNCTION) {
+		return luaL_argerror (L, 1, "invalid arguments batch_graph_changes (function)");
+	}
+	Session* const s = luabridge::Userdata::get <Session> (L, 1, false);
+
+	int rv;
+	{
+		/* the blocker must go before a script error is raised again */
+		Session::GraphChangeBlocker gcb (s);
+		lua_pushvalue (L, 2);
+		rv = lua_pcall (L, 0, 0, 0);
+	}
+
+	if (rv != 0) {
+		return lua_error (L);
+	}
+	return 0;
+}
+
 int
 ARDOUR::LuaOSC::Address::send (lua_State *L)
 {
@@ -1033,6 +1033,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("set_comment", &Route::set_comment)
 		.addFunction ("strict_io", &Route::strict_io)
 		.addFunction ("set_strict_io", &Route::set_strict_io)
+		.addFunction ("processor_pipelining", &Route::processor_pipelining)
+		.addFunction ("set_processor_pipelining", &Route::set_processor_pipelining)
 		.addFunction ("reset_plugin_insert", &Route::reset_plugin_insert)
 		.addFunction ("customize_plugin_insert", &Route::customize_plugin_insert)
 		.addFunction ("add_sidechain", &Route::add_sidechain)
@@ -2016,6 +2018,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("vca_manager", &Session::vca_manager)
 		.addExtCFunction ("timecode_to_sample_lua", ARDOUR::LuaAPI::timecode_to_sample_lua)
 		.addExtCFunction ("sample_to_timecode_lua", ARDOUR::LuaAPI::sample_to_timecode_lua)
+		.addExtCFunction ("batch_graph_changes", ARDOUR::LuaAPI::batch_graph_changes_lua)
 		.endClass ()
 
 		.beginClass <RegionFactory> ("RegionFactory")
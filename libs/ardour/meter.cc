@@ -38,10 +38,10 @@ using namespace ARDOUR;
 PeakMeter::PeakMeter (Session& s, const std::string& name)
     : Processor (s, string_compose ("meter-%1", name))
 {
-	Kmeterdsp::init(s.nominal_frame_rate());
-	Iec1ppmdsp::init(s.nominal_frame_rate());
-	Iec2ppmdsp::init(s.nominal_frame_rate());
-	Vumeterdsp::init(s.nominal_frame_rate());
+	MultiKmeterdsp::init(s.nominal_frame_rate());
+	MultiIec1ppmdsp::init(s.nominal_frame_rate());
+	MultiIec2ppmdsp::init(s.nominal_frame_rate());
+	MultiVumeterdsp::init(s.nominal_frame_rate());
 	_pending_active = true;
 	_meter_type = MeterPeak;
 	_reset_dpm = true;
@@ -52,16 +52,6 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 
 PeakMeter::~PeakMeter ()
 {
-	while (_kmeter.size() > 0) {
-		delete (_kmeter.back());
-		delete (_iec1meter.back());
-		delete (_iec2meter.back());
-		delete (_vumeter.back());
-		_kmeter.pop_back();
-		_iec1meter.pop_back();
-		_iec2meter.pop_back();
-		_vumeter.pop_back();
-	}
 	while (_peak_power.size() > 0) {
 		_peak_buffer.pop_back();
 		_peak_power.pop_back();
@@ -166,17 +156,21 @@ PeakMeter::run (BufferSet& bufs, framepos_t /*start_frame*/, framepos_t /*end_fr
 			}
 		}
 
+		_audio_data[i] = bufs.get_audio(i).data();
+	}
+
+	if (n_audio > 0) {
 		if (_meter_type & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-			_kmeter[i]->process(bufs.get_audio(i).data(), nframes);
+			_kmeter.process (&_audio_data[0], n_audio, nframes);
 		}
 		if (_meter_type & (MeterIEC1DIN | MeterIEC1NOR)) {
-			_iec1meter[i]->process(bufs.get_audio(i).data(), nframes);
+			_iec1meter.process (&_audio_data[0], n_audio, nframes);
 		}
 		if (_meter_type & (MeterIEC2BBC | MeterIEC2EBU)) {
-			_iec2meter[i]->process(bufs.get_audio(i).data(), nframes);
+			_iec2meter.process (&_audio_data[0], n_audio, nframes);
 		}
 		if (_meter_type & MeterVU) {
-			_vumeter[i]->process(bufs.get_audio(i).data(), nframes);
+			_vumeter.process (&_audio_data[0], n_audio, nframes);
 		}
 	}
 
@@ -206,12 +200,10 @@ PeakMeter::reset ()
 	}
 
 	// these are handled async just fine.
-	for (size_t n = 0; n < _kmeter.size(); ++n) {
-		_kmeter[n]->reset();
-		_iec1meter[n]->reset();
-		_iec2meter[n]->reset();
-		_vumeter[n]->reset();
-	}
+	_kmeter.reset();
+	_iec1meter.reset();
+	_iec2meter.reset();
+	_vumeter.reset();
 }
 
 void
@@ -294,26 +286,11 @@ PeakMeter::set_max_channels (const ChanCount& chn)
 	assert(_max_peak_signal.size() == limit);
 
 	/* alloc/free other audio-only meter types. */
-	while (_kmeter.size() > n_audio) {
-		delete (_kmeter.back());
-		delete (_iec1meter.back());
-		delete (_iec2meter.back());
-		delete (_vumeter.back());
-		_kmeter.pop_back();
-		_iec1meter.pop_back();
-		_iec2meter.pop_back();
-		_vumeter.pop_back();
-	}
-	while (_kmeter.size() < n_audio) {
-		_kmeter.push_back(new Kmeterdsp());
-		_iec1meter.push_back(new Iec1ppmdsp());
-		_iec2meter.push_back(new Iec2ppmdsp());
-		_vumeter.push_back(new Vumeterdsp());
-	}
-	assert(_kmeter.size() == n_audio);
-	assert(_iec1meter.size() == n_audio);
-	assert(_iec2meter.size() == n_audio);
-	assert(_vumeter.size() == n_audio);
+	_kmeter.set_channels (n_audio);
+	_iec1meter.set_channels (n_audio);
+	_iec2meter.set_channels (n_audio);
+	_vumeter.set_channels (n_audio);
+	_audio_data.resize (n_audio);
 
 	reset();
 	reset_max();
@@ -324,7 +301,7 @@ PeakMeter::set_max_channels (const ChanCount& chn)
  * of meter size during this call.
  */
 
-#define CHECKSIZE(MTR) (n < MTR.size() + n_midi && n >= n_midi)
+#define CHECKSIZE(MTR) (n < MTR.n_channels() + n_midi && n >= n_midi)
 
 float
 PeakMeter::meter_level(uint32_t n, MeterType type) {
@@ -337,7 +314,7 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 			{
 				const uint32_t n_midi = current_meters.n_midi();
 				if (CHECKSIZE(_kmeter)) {
-					return accurate_coefficient_to_dB (_kmeter[n - n_midi]->read());
+					return accurate_coefficient_to_dB (_kmeter.read (n - n_midi));
 				}
 			}
 			break;
@@ -346,7 +323,7 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 			{
 				const uint32_t n_midi = current_meters.n_midi();
 				if (CHECKSIZE(_iec1meter)) {
-					return accurate_coefficient_to_dB (_iec1meter[n - n_midi]->read());
+					return accurate_coefficient_to_dB (_iec1meter.read (n - n_midi));
 				}
 			}
 			break;
@@ -355,7 +332,7 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 			{
 				const uint32_t n_midi = current_meters.n_midi();
 				if (CHECKSIZE(_iec2meter)) {
-					return accurate_coefficient_to_dB (_iec2meter[n - n_midi]->read());
+					return accurate_coefficient_to_dB (_iec2meter.read (n - n_midi));
 				}
 			}
 			break;
@@ -363,7 +340,7 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 			{
 				const uint32_t n_midi = current_meters.n_midi();
 				if (CHECKSIZE(_vumeter)) {
-					return accurate_coefficient_to_dB (_vumeter[n - n_midi]->read());
+					return accurate_coefficient_to_dB (_vumeter.read (n - n_midi));
 				}
 			}
 			break;
@@ -399,28 +376,16 @@ PeakMeter::set_type(MeterType t)
 	_meter_type = t;
 
 	if (t & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_kmeter[n]->reset();
-		}
+		_kmeter.reset();
 	}
 	if (t & (MeterIEC1DIN | MeterIEC1NOR)) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec1meter[n]->reset();
-		}
+		_iec1meter.reset();
 	}
 	if (t & (MeterIEC2BBC | MeterIEC2EBU)) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec2meter[n]->reset();
-		}
+		_iec2meter.reset();
 	}
 	if (t & MeterVU) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_vumeter[n]->reset();
-		}
+		_vumeter.reset();
 	}
 
 	TypeChanged(t);
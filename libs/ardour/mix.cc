@@ -142,6 +142,55 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+void
+default_apply_gain_ramp (ARDOUR::Sample * buf, pframes_t nframes, float g0, float g1)
+{
+	const float step = (g1 - g0) / nframes;
+
+	/* compute each gain from its index rather than accumulating the step,
+	 * so that rounding errors do not build up over long buffers.
+	 */
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= g0 + step * i;
+	}
+}
+
+void
+default_interleave_channel (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, uint32_t nchannels)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		dst[(size_t) i * nchannels] = src[i];
+	}
+}
+
+void
+default_deinterleave_channel (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, uint32_t nchannels)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		dst[i] = src[(size_t) i * nchannels];
+	}
+}
+
+void
+default_apply_gain_curve (ARDOUR::Sample * buf, const ARDOUR::gain_t * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= gain[i];
+	}
+}
+
+float
+default_apply_gain_lpf (ARDOUR::Sample * buf, pframes_t nframes, float g0, float g1, float a)
+{
+	double lpf = g0;
+
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= lpf;
+		lpf += a * (g1 - lpf);
+	}
+	return lpf;
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
@@ -0,0 +1,300 @@
+/*
+    Copyright (C) 2008-2012 Fons Adriaensen <fons@linuxaudio.org>
+    Adopted for Ardour 2013 by Robin Gareus <robin@gareus.org>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <math.h>
+#include <algorithm>
+
+#include "ardour/multi_meterdsp.h"
+
+static const uint32_t L = MultiMeterdsp::lanes;
+
+/* samples per channel that are transposed into lane-interleaved
+ * order at a time. Must be a multiple of 4. */
+static const int block = 64;
+
+/* Copy samples [s0, s0 + ns) of up to L channels into lane-interleaved
+ * order, so that buf[s][0..L-1] are adjacent. Unused lanes are silent.
+ */
+static inline void
+interleave (float buf[][L], float const * const *p, uint32_t nl, int s0, int ns)
+{
+    for (uint32_t l = 0; l < nl; ++l) {
+	float const *src = p[l] + s0;
+	for (int s = 0; s < ns; ++s) {
+	    buf[s][l] = src[s];
+	}
+    }
+    for (uint32_t l = nl; l < L; ++l) {
+	for (int s = 0; s < ns; ++s) {
+	    buf[s][l] = 0;
+	}
+    }
+}
+
+static inline float
+clamp (float v, float lo, float hi)
+{
+    return v > hi ? hi : (v < lo ? lo : v);
+}
+
+MultiMeterdsp::MultiMeterdsp (void)
+{
+}
+
+MultiMeterdsp::~MultiMeterdsp (void)
+{
+}
+
+void MultiMeterdsp::set_channels (uint32_t n)
+{
+    _z1.resize (n, 0);
+    _z2.resize (n, 0);
+    _m.resize (n, 0);
+    _res.resize (n, 1);
+}
+
+void MultiMeterdsp::reset ()
+{
+    std::fill (_z1.begin (), _z1.end (), 0.f);
+    std::fill (_z2.begin (), _z2.end (), 0.f);
+    std::fill (_m.begin (), _m.end (), 0.f);
+    std::fill (_res.begin (), _res.end (), 1);
+}
+
+
+float MultiKmeterdsp::_omega;
+
+void MultiKmeterdsp::init (int fsamp)
+{
+    _omega = 9.72f / fsamp; // ballistic filter coefficient
+}
+
+void MultiKmeterdsp::process (float const * const *p, uint32_t n_chan, int n)
+{
+    // see Kmeterdsp::process (), this runs the same filters
+    // on L channels at a time.
+    float buf[block][L];
+    float z1[L], z2[L];
+    const float w = _omega;
+
+    n &= ~3;
+
+    for (uint32_t c0 = 0; c0 < n_chan; c0 += L) {
+	const uint32_t nl = std::min (L, n_chan - c0);
+
+	// Get filter state.
+	for (uint32_t l = 0; l < L; ++l) {
+	    z1[l] = l < nl ? clamp (_z1[c0 + l], 0, 50) : 0;
+	    z2[l] = l < nl ? clamp (_z2[c0 + l], 0, 50) : 0;
+	}
+
+	for (int s0 = 0; s0 < n; s0 += block) {
+	    const int ns = std::min (block, n - s0);
+	    interleave (buf, p + c0, nl, s0, ns);
+
+	    // The second filter is evaluated only every 4th sample.
+	    for (int s = 0; s < ns; s += 4) {
+		for (int i = 0; i < 4; ++i) {
+		    for (uint32_t l = 0; l < L; ++l) {
+			const float x = buf[s + i][l];
+			z1[l] += w * (x * x - z1[l]); // Update first filter.
+		    }
+		}
+		for (uint32_t l = 0; l < L; ++l) {
+		    z2[l] += 4 * w * (z1[l] - z2[l]); // Update second filter.
+		}
+	    }
+	}
+
+	for (uint32_t l = 0; l < nl; ++l) {
+	    const uint32_t c = c0 + l;
+	    if (isnan (z1[l])) z1[l] = 0;
+	    if (isnan (z2[l])) z2[l] = 0;
+	    // Save filter state. The added constants avoid denormals.
+	    _z1[c] = z1[l] + 1e-20f;
+	    _z2[c] = z2[l] + 1e-20f;
+
+	    const float rms = sqrtf (2.0f * z2[l]);
+	    if (_res[c]) { // Display thread has read the rms value.
+		_m[c] = rms;
+		_res[c] = 0;
+	    } else if (rms > _m[c]) {
+		_m[c] = rms;
+	    }
+	}
+    }
+}
+
+float MultiKmeterdsp::read (uint32_t c)
+{
+    float rv = _m[c];
+    _res[c] = 1; // Resets _m in next process().
+    return rv;
+}
+
+
+void MultiIecppmdsp::process (float const * const *p, uint32_t n_chan, int n, float w1, float w2, float w3)
+{
+    // see Iec1ppmdsp::process ()
+    float buf[block][L];
+    float z1[L], z2[L], m[L];
+
+    n &= ~3;
+
+    for (uint32_t c0 = 0; c0 < n_chan; c0 += L) {
+	const uint32_t nl = std::min (L, n_chan - c0);
+
+	for (uint32_t l = 0; l < L; ++l) {
+	    const uint32_t c = c0 + l;
+	    z1[l] = l < nl ? clamp (_z1[c], 0, 20) : 0;
+	    z2[l] = l < nl ? clamp (_z2[c], 0, 20) : 0;
+	    m[l] = (l < nl && !_res[c]) ? _m[c] : 0;
+	}
+
+	for (int s0 = 0; s0 < n; s0 += block) {
+	    const int ns = std::min (block, n - s0);
+	    interleave (buf, p + c0, nl, s0, ns);
+
+	    for (int s = 0; s < ns; s += 4) {
+		for (uint32_t l = 0; l < L; ++l) {
+		    z1[l] *= w3;
+		    z2[l] *= w3;
+		}
+		for (int i = 0; i < 4; ++i) {
+		    for (uint32_t l = 0; l < L; ++l) {
+			const float t = fabsf (buf[s + i][l]);
+			z1[l] = t > z1[l] ? z1[l] + w1 * (t - z1[l]) : z1[l];
+			z2[l] = t > z2[l] ? z2[l] + w2 * (t - z2[l]) : z2[l];
+		    }
+		}
+		for (uint32_t l = 0; l < L; ++l) {
+		    const float t = z1[l] + z2[l];
+		    m[l] = t > m[l] ? t : m[l];
+		}
+	    }
+	}
+
+	for (uint32_t l = 0; l < nl; ++l) {
+	    const uint32_t c = c0 + l;
+	    _z1[c] = z1[l] + 1e-10f;
+	    _z2[c] = z2[l] + 1e-10f;
+	    _m[c] = m[l];
+	    _res[c] = 0;
+	}
+    }
+}
+
+float MultiIecppmdsp::read (uint32_t c, float g)
+{
+    _res[c] = 1;
+    return g * _m[c];
+}
+
+
+float MultiIec1ppmdsp::_w1;
+float MultiIec1ppmdsp::_w2;
+float MultiIec1ppmdsp::_w3;
+float MultiIec1ppmdsp::_g;
+
+void MultiIec1ppmdsp::init (float fsamp)
+{
+    _w1 =  450.0f / fsamp;
+    _w2 = 1300.0f / fsamp;
+    _w3 = 1.0f - 5.4f / fsamp;
+    _g  = 0.5108f;
+}
+
+
+float MultiIec2ppmdsp::_w1;
+float MultiIec2ppmdsp::_w2;
+float MultiIec2ppmdsp::_w3;
+float MultiIec2ppmdsp::_g;
+
+void MultiIec2ppmdsp::init (float fsamp)
+{
+    _w1 = 200.0f / fsamp;
+    _w2 = 860.0f / fsamp;
+    _w3 = 1.0f - 4.0f / fsamp;
+    _g = 0.5141f;
+}
+
+
+float MultiVumeterdsp::_w;
+float MultiVumeterdsp::_g;
+
+void MultiVumeterdsp::init (float fsamp)
+{
+    _w = 11.1f / fsamp;
+    _g = 1.5f * 1.571f;
+}
+
+void MultiVumeterdsp::process (float const * const *p, uint32_t n_chan, int n)
+{
+    // see Vumeterdsp::process ()
+    float buf[block][L];
+    float z1[L], z2[L], m[L];
+    const float w = _w;
+
+    n &= ~3;
+
+    for (uint32_t c0 = 0; c0 < n_chan; c0 += L) {
+	const uint32_t nl = std::min (L, n_chan - c0);
+
+	for (uint32_t l = 0; l < L; ++l) {
+	    const uint32_t c = c0 + l;
+	    z1[l] = l < nl ? clamp (_z1[c], -20, 20) : 0;
+	    z2[l] = l < nl ? clamp (_z2[c], -20, 20) : 0;
+	    m[l] = (l < nl && !_res[c]) ? _m[c] : 0;
+	}
+
+	for (int s0 = 0; s0 < n; s0 += block) {
+	    const int ns = std::min (block, n - s0);
+	    interleave (buf, p + c0, nl, s0, ns);
+
+	    for (int s = 0; s < ns; s += 4) {
+		for (int i = 0; i < 4; ++i) {
+		    for (uint32_t l = 0; l < L; ++l) {
+			const float t1 = fabsf (buf[s + i][l]) - z2[l] / 2;
+			z1[l] += w * (t1 - z1[l]);
+		    }
+		}
+		for (uint32_t l = 0; l < L; ++l) {
+		    z2[l] += 4 * w * (z1[l] - z2[l]);
+		    m[l] = z2[l] > m[l] ? z2[l] : m[l];
+		}
+	    }
+	}
+
+	for (uint32_t l = 0; l < nl; ++l) {
+	    const uint32_t c = c0 + l;
+	    if (isnan (z1[l])) z1[l] = 0;
+	    if (isnan (z2[l])) z2[l] = 0;
+	    _z1[c] = z1[l];
+	    _z2[c] = z2[l] + 1e-10f;
+	    _m[c] = m[l];
+	    _res[c] = 0;
+	}
+    }
+}
+
+float MultiVumeterdsp::read (uint32_t c)
+{
+    _res[c] = 1;
+    return _g * _m[c];
+}
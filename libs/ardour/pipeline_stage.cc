@@ -0,0 +1,287 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <cstring>
+
+#include "pbd/compose.h"
+
+#include "ardour/audio_buffer.h"
+#include "ardour/audioengine.h"
+#include "ardour/debug.h"
+#include "ardour/graph.h"
+#include "ardour/pipeline_stage.h"
+#include "ardour/session.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+PipelineStage::Job::Job (boost::shared_ptr<Graph> graph, PipelineStage& stage)
+	: GraphNode (graph)
+	, done ("pipeline_stage_done", 0)
+	, _stage (stage)
+{
+}
+
+void
+PipelineStage::Job::process ()
+{
+	_stage.process_stage ();
+}
+
+void
+PipelineStage::Job::finish (int, uint32_t)
+{
+	/* this job is not part of the graph's chain; instead of
+	 * activating other nodes, wake up the route waiting for it.
+	 */
+	done.signal ();
+}
+
+PipelineStage::PipelineStage (Session& s, const std::string& name)
+	: Processor (s, string_compose ("pipeline-%1", name))
+	, _job (0)
+	, _armed (false)
+	, _pipelined (false)
+	, _pending_flush (false)
+	, _block_size (AudioEngine::instance()->samples_per_cycle())
+	, _bsiz (0)
+	, _woff (0)
+	, _start_frame (0)
+	, _end_frame (0)
+	, _speed (0)
+	, _nframes (0)
+{
+	_graph = s.process_graph ();
+	if (_graph) {
+		_job = new Job (_graph, *this);
+	}
+}
+
+PipelineStage::~PipelineStage ()
+{
+	delete _job;
+}
+
+bool
+PipelineStage::can_support_io_configuration (const ChanCount& in, ChanCount& out)
+{
+	out = in;
+	return true;
+}
+
+bool
+PipelineStage::configure_io (ChanCount in, ChanCount out)
+{
+	if (out != in) { // always 1:1
+		return false;
+	}
+
+	bool const rv = Processor::configure_io (in, out);
+	realloc_buffers ();
+	return rv;
+}
+
+void
+PipelineStage::configure_stage (ChanCount const& max_streams)
+{
+	/* the ring-buffers only delay audio, and the stage's output
+	 * is copied back to the route's buffers as audio, too.
+	 */
+	bool ok = _job != 0 && !_stage.empty ()
+		&& _configured_input.n_audio () > 0 && _configured_input.n_midi () == 0;
+
+	for (ProcessorList::const_iterator i = _stage.begin (); ok && i != _stage.end (); ++i) {
+		ok = (*i)->input_streams ().n_midi () == 0 && (*i)->output_streams ().n_midi () == 0;
+	}
+
+	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: %2 processors, pipelined: %3\n", name (), _stage.size (), ok));
+
+	_pipelined = ok;
+	_max_streams = max_streams;
+	realloc_buffers ();
+}
+
+int
+PipelineStage::set_block_size (pframes_t nframes)
+{
+	_block_size = nframes;
+	realloc_buffers ();
+	return 0;
+}
+
+framecnt_t
+PipelineStage::signal_latency () const
+{
+	return _pipelined ? _block_size : 0;
+}
+
+void
+PipelineStage::realloc_buffers ()
+{
+	_buffers.ensure_buffers (ChanCount::max (_max_streams, _configured_input), _block_size);
+
+	const uint32_t chn = _configured_input.n_audio ();
+	_bsiz = 2 * _block_size;
+	_woff = 0;
+	if (chn > 0 && _bsiz > 0) {
+		_buf.reset (new Sample[chn * _bsiz]);
+		memset (_buf.get (), 0, sizeof (Sample) * chn * _bsiz);
+	} else {
+		_buf.reset ();
+	}
+	_pending_flush = false;
+}
+
+void
+PipelineStage::flush ()
+{
+	_pending_flush = true;
+}
+
+/** Copy the audio of @a bufs into the ring-buffers at the write position */
+void
+PipelineStage::write (BufferSet const& bufs, pframes_t nframes)
+{
+	const uint32_t chn = min (_configured_input.n_audio (), bufs.count ().n_audio ());
+	const framecnt_t n0 = min ((framecnt_t) nframes, _bsiz - _woff);
+
+	for (uint32_t c = 0; c < chn; ++c) {
+		Sample* rb = _buf.get () + c * _bsiz;
+		Sample const* src = bufs.get_audio (c).data ();
+		memcpy (rb + _woff, src, sizeof (Sample) * n0);
+		memcpy (rb, src + n0, sizeof (Sample) * (nframes - n0));
+	}
+}
+
+/** Read the audio written _block_size samples before the write position */
+void
+PipelineStage::read_delayed (BufferSet& bufs, pframes_t nframes)
+{
+	const uint32_t chn = _configured_input.n_audio ();
+	const framecnt_t roff = (_woff + _bsiz - _block_size) % _bsiz;
+	const framecnt_t n0 = min ((framecnt_t) nframes, _bsiz - roff);
+
+	for (uint32_t c = 0; c < chn; ++c) {
+		Sample const* rb = _buf.get () + c * _bsiz;
+		AudioBuffer& dst (bufs.get_audio (c));
+		dst.read_from (rb + roff, n0);
+		if (n0 < nframes) {
+			dst.read_from (rb, nframes - n0, n0);
+		}
+	}
+}
+
+bool
+PipelineStage::start (framepos_t start_frame, framepos_t end_frame, double speed, pframes_t nframes)
+{
+	assert (!_armed);
+
+	if (!_pipelined || !_buf || nframes > _block_size) {
+		return false;
+	}
+
+	if (_pending_flush) {
+		_pending_flush = false;
+		memset (_buf.get (), 0, sizeof (Sample) * _configured_input.n_audio () * _bsiz);
+	}
+
+	_start_frame = start_frame;
+	_end_frame = end_frame;
+	_speed = speed;
+	_nframes = nframes;
+	_armed = true;
+
+	_graph->trigger_job (_job);
+	return true;
+}
+
+/** Run the stage's processors on the delayed data (in a process thread
+ *  other than the route's, unless it was too late to get there).
+ */
+void
+PipelineStage::process_stage ()
+{
+	framecnt_t latency = 0;
+
+	_buffers.set_count (_configured_input);
+	read_delayed (_buffers, _nframes);
+
+	for (ProcessorList::const_iterator i = _stage.begin (); i != _stage.end (); ++i) {
+		(*i)->run (_buffers, _start_frame - latency, _end_frame - latency, _speed, _nframes, true);
+		_buffers.set_count ((*i)->output_streams ());
+		if ((*i)->active ()) {
+			latency += (*i)->signal_latency ();
+		}
+	}
+}
+
+void
+PipelineStage::run (BufferSet& bufs, framepos_t, framepos_t, double, pframes_t nframes, bool)
+{
+	if (!_pipelined || !_buf) {
+		_armed = false;
+		return;
+	}
+
+	if (_armed) {
+		_armed = false;
+
+		if (_graph->retract_job (_job)) {
+			/* no process thread has picked it up yet, do it ourselves */
+			process_stage ();
+		} else {
+			_job->done.wait ();
+		}
+
+		write (bufs, nframes);
+		_woff = (_woff + nframes) % _bsiz;
+
+		const ChanCount out (_buffers.count ());
+		for (uint32_t c = 0; c < out.n_audio (); ++c) {
+			bufs.get_audio (c).read_from (_buffers.get_audio (c), nframes);
+		}
+		bufs.set_count (out);
+		return;
+	}
+
+	/* plain delay-line, the route runs the stage's processors */
+
+	if (nframes > _block_size) {
+		/* cannot delay by more than a cycle, should never happen */
+		bufs.silence (nframes, 0);
+		return;
+	}
+
+	if (_pending_flush) {
+		_pending_flush = false;
+		memset (_buf.get (), 0, sizeof (Sample) * _configured_input.n_audio () * _bsiz);
+	}
+
+	write (bufs, nframes);
+	read_delayed (bufs, nframes);
+	_woff = (_woff + nframes) % _bsiz;
+}
+
+XMLNode&
+PipelineStage::state (bool full_state)
+{
+	XMLNode& node (Processor::state (full_state));
+	node.set_property ("type", "pipeline");
+	return node;
+}
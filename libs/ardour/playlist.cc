@@ -759,6 +759,7 @@ Playlist::add_region_internal (boost::shared_ptr<Region> region, framepos_t posi
 
 	regions.insert (upper_bound (regions.begin(), regions.end(), region, cmp), region);
 	all_regions.insert (region);
+	index_region (region);
 
 	possibly_splice_unlocked (position, region->length(), region);
 
@@ -820,6 +821,7 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region)
 			framecnt_t distance = (*i)->length();
 
 			regions.erase (i);
+			unindex_region (region);
 
 			possibly_splice_unlocked (pos, -distance);
 
@@ -836,6 +838,27 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region)
 	return -1;
 }
 
+void
+Playlist::index_region (boost::shared_ptr<Region> region)
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	_region_index.insert (region, region->first_frame(), region->last_frame());
+}
+
+void
+Playlist::unindex_region (boost::shared_ptr<Region> region)
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	_region_index.erase (region);
+}
+
+void
+Playlist::clear_region_index ()
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	_region_index.clear ();
+}
+
 void
 Playlist::get_equivalent_regions (boost::shared_ptr<Region> other, vector<boost::shared_ptr<Region> >& results)
 {
@@ -1704,6 +1727,16 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 return;
 	 }
 
+	 if (what_changed.contains (Properties::position) || what_changed.contains (Properties::length)) {
+		 /* keep the index up to date before anything else looks at
+		    it, whether or not region_changed() decides to react.
+		 */
+		 Glib::Threads::Mutex::Lock lm (_region_index_lock);
+		 if (_region_index.contains (region)) {
+			 _region_index.insert (region, region->first_frame(), region->last_frame());
+		 }
+	 }
+
 	 /* this makes a virtual call to the right kind of playlist ... */
 
 	 region_changed (what_changed, region);
@@ -1764,6 +1797,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 	 RegionWriteLock rl (this);
 	 regions.clear ();
 	 all_regions.clear ();
+	 clear_region_index ();
  }
 
  void
@@ -1792,6 +1826,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 }
 
 		 regions.clear ();
+		 clear_region_index ();
 
 		 for (set<boost::shared_ptr<Region> >::iterator s = pending_removes.begin(); s != pending_removes.end(); ++s) {
 			 remove_dependents (*s);
@@ -1844,15 +1879,9 @@ Playlist::regions_at (framepos_t frame)
  Playlist::count_regions_at (framepos_t frame) const
  {
 	 RegionReadLock rlock (const_cast<Playlist*>(this));
-	 uint32_t cnt = 0;
+	 Glib::Threads::Mutex::Lock lm (_region_index_lock);
 
-	 for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
-		 if ((*i)->covers (frame)) {
-			 cnt++;
-		 }
-	 }
-
-	 return cnt;
+	 return _region_index.count_overlapping (frame, frame);
  }
 
  boost::shared_ptr<Region>
@@ -1909,12 +1938,9 @@ Playlist::find_regions_at (framepos_t frame)
 	/* Caller must hold lock */
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->covers (frame)) {
-			rlist->push_back (*i);
-		}
-	}
+	_region_index.find_overlapping (frame, frame, *rlist);
 
 	return rlist;
 }
@@ -1965,9 +1991,21 @@ Playlist::regions_touched_locked (framepos_t start, framepos_t end)
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
-	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
-		if ((*i)->coverage (start, end) != Evoral::OverlapNone) {
-			rlist->push_back (*i);
+	if (start > end) {
+		/* Evoral::coverage() considers this to overlap nothing */
+		return rlist;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+	_region_index.find_overlapping (start, end, *rlist);
+
+	for (RegionList::iterator i = rlist->begin(); i != rlist->end(); ) {
+		/* zero-length regions are indexed, but never overlap */
+		if ((*i)->coverage (start, end) == Evoral::OverlapNone) {
+			i = rlist->erase (i);
+		} else {
+			++i;
 		}
 	}
 
@@ -2041,6 +2079,25 @@ Playlist::find_next_region (framepos_t frame, RegionPoint point, int dir)
 	boost::shared_ptr<Region> ret;
 	framepos_t closest = max_framepos;
 
+	/* start positions, and end positions looking forwards, are ordered
+	   the same way in the index as in the region list, so these can be
+	   answered without a scan.
+	*/
+
+	if (point == Start || (point == End && dir == 1)) {
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+		if (point == End) {
+			_region_index.first_ending_after (frame, ret);
+		} else if (dir == 1) {
+			_region_index.first_starting_after (frame, ret);
+		} else {
+			_region_index.last_starting_before (frame, ret);
+		}
+
+		return ret;
+	}
+
 	bool end_iter = false;
 
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
@@ -2995,13 +3052,9 @@ bool
 Playlist::has_region_at (framepos_t const p) const
 {
 	RegionReadLock (const_cast<Playlist *> (this));
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
 
-	RegionList::const_iterator i = regions.begin ();
-	while (i != regions.end() && !(*i)->covers (p)) {
-		++i;
-	}
-
-	return (i != regions.end());
+	return _region_index.count_overlapping (p, p) > 0;
 }
 
 /** Look from a session frame time and find the start time of the next region
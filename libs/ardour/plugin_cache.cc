@@ -0,0 +1,341 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifdef WAF_BUILD
+#include "libardour-config.h"
+#endif
+
+#include <cstdio>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/error.h"
+#include "pbd/compose.h"
+#include "pbd/xml++.h"
+
+#include "ardour/filesystem_paths.h"
+#include "ardour/ladspa_plugin.h"
+#include "ardour/plugin_cache.h"
+#include "ardour/types_convert.h"
+
+#ifdef WINDOWS_VST_SUPPORT
+#include "ardour/windows_vst_plugin.h"
+#endif
+
+#ifdef LXVST_SUPPORT
+#include "ardour/lxvst_plugin.h"
+#endif
+
+#ifdef MACVST_SUPPORT
+#include "ardour/mac_vst_plugin.h"
+#endif
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+using namespace std;
+
+PluginCache::PluginCache ()
+	: _dirty (false)
+{
+}
+
+string
+PluginCache::cache_path ()
+{
+	return Glib::build_filename (user_cache_directory (), X_("plugin_cache.xml"));
+}
+
+bool
+PluginCache::file_stat (string const & path, int64_t& mtime, int64_t& size)
+{
+	GStatBuf sb;
+
+	if (g_stat (path.c_str (), &sb)) {
+		return false;
+	}
+
+	mtime = sb.st_mtime;
+	size = sb.st_size;
+	return true;
+}
+
+/** @return a SHA1 hash of the contents of @param path, or an empty string
+ *  if it is not a regular file (a bundle, for example) or can not be read.
+ */
+string
+PluginCache::file_hash (string const & path)
+{
+	if (!Glib::file_test (path, Glib::FILE_TEST_IS_REGULAR)) {
+		return string ();
+	}
+
+	FILE* f = g_fopen (path.c_str (), "rb");
+
+	if (!f) {
+		return string ();
+	}
+
+	GChecksum* sum = g_checksum_new (G_CHECKSUM_SHA1);
+	guchar buf[65536];
+	size_t n;
+
+	while ((n = fread (buf, 1, sizeof (buf), f)) > 0) {
+		g_checksum_update (sum, buf, n);
+	}
+
+	string rv;
+	if (!ferror (f)) {
+		rv = g_checksum_get_string (sum);
+	}
+
+	g_checksum_free (sum);
+	fclose (f);
+	return rv;
+}
+
+PluginInfoPtr
+PluginCache::new_plugin_info (PluginType type)
+{
+	switch (type) {
+	case LADSPA:
+		return PluginInfoPtr (new LadspaPluginInfo);
+#ifdef WINDOWS_VST_SUPPORT
+	case Windows_VST:
+		return PluginInfoPtr (new WindowsVSTPluginInfo);
+#endif
+#ifdef LXVST_SUPPORT
+	case LXVST:
+		return PluginInfoPtr (new LXVSTPluginInfo);
+#endif
+#ifdef MACVST_SUPPORT
+	case MacVST:
+		return PluginInfoPtr (new MacVSTPluginInfo);
+#endif
+	default:
+		break;
+	}
+	return PluginInfoPtr ();
+}
+
+bool
+PluginCache::lookup (string const & path, PluginType type, PluginInfoList& plugins)
+{
+	Files::iterator i = _files.find (path);
+
+	if (i == _files.end () || i->second.type != type) {
+		return false;
+	}
+
+	File& f (i->second);
+	int64_t mtime;
+	int64_t size;
+
+	if (!file_stat (path, mtime, size) || size != f.size) {
+		return false;
+	}
+
+	if (mtime != f.mtime) {
+		if (f.hash.empty () || file_hash (path) != f.hash) {
+			return false;
+		}
+		f.mtime = mtime;
+		_dirty = true;
+	}
+
+	f.used = true;
+	plugins.insert (plugins.end (), f.plugins.begin (), f.plugins.end ());
+	return true;
+}
+
+void
+PluginCache::store (string const & path, PluginType type, PluginInfoList const & plugins)
+{
+	File f;
+
+	if (!file_stat (path, f.mtime, f.size)) {
+		return;
+	}
+
+	f.type = type;
+	f.hash = file_hash (path);
+	f.plugins = plugins;
+	f.used = true;
+
+	_files[path] = f;
+	_dirty = true;
+}
+
+void
+PluginCache::clear (PluginType type)
+{
+	for (Files::iterator i = _files.begin (); i != _files.end (); ) {
+		if (i->second.type == type) {
+			_files.erase (i++);
+			_dirty = true;
+		} else {
+			++i;
+		}
+	}
+}
+
+void
+PluginCache::forget_unused (PluginType type)
+{
+	for (Files::iterator i = _files.begin (); i != _files.end (); ) {
+		if (i->second.type == type && !i->second.used) {
+			_files.erase (i++);
+			_dirty = true;
+		} else {
+			++i;
+		}
+	}
+}
+
+int
+PluginCache::load ()
+{
+	string const path = cache_path ();
+
+	_files.clear ();
+	_dirty = false;
+
+	if (!Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		return 0;
+	}
+
+	XMLTree tree;
+
+	if (!tree.read (path)) {
+		error << string_compose (_("Plugin cache %1 is not a valid XML file, plugins will be re-scanned"), path) << endmsg;
+		return -1;
+	}
+
+	XMLNode const * root (tree.root ());
+
+	if (root->name () != X_("PluginCache")) {
+		return -1;
+	}
+
+	XMLNodeList const & files (root->children ());
+
+	for (XMLNodeConstIterator i = files.begin (); i != files.end (); ++i) {
+		string file_path;
+		File f;
+
+		if ((*i)->name () != X_("File")
+		    || !(*i)->get_property (X_("path"), file_path)
+		    || !(*i)->get_property (X_("type"), f.type)
+		    || !(*i)->get_property (X_("mtime"), f.mtime)
+		    || !(*i)->get_property (X_("size"), f.size)) {
+			continue;
+		}
+
+		(*i)->get_property (X_("hash"), f.hash);
+		f.used = false;
+
+		XMLNodeList const & plugins ((*i)->children ());
+
+		for (XMLNodeConstIterator p = plugins.begin (); p != plugins.end (); ++p) {
+			PluginInfoPtr info = new_plugin_info (f.type);
+
+			if (!info) {
+				break;
+			}
+
+			uint32_t audio_in = 0, midi_in = 0, audio_out = 0, midi_out = 0;
+
+			(*p)->get_property (X_("name"), info->name);
+			(*p)->get_property (X_("unique-id"), info->unique_id);
+			(*p)->get_property (X_("category"), info->category);
+			(*p)->get_property (X_("creator"), info->creator);
+			(*p)->get_property (X_("index"), info->index);
+			(*p)->get_property (X_("audio-in"), audio_in);
+			(*p)->get_property (X_("midi-in"), midi_in);
+			(*p)->get_property (X_("audio-out"), audio_out);
+			(*p)->get_property (X_("midi-out"), midi_out);
+
+			info->path = file_path;
+			info->n_inputs.set_audio (audio_in);
+			info->n_inputs.set_midi (midi_in);
+			info->n_outputs.set_audio (audio_out);
+			info->n_outputs.set_midi (midi_out);
+
+			f.plugins.push_back (info);
+		}
+
+		_files[file_path] = f;
+	}
+
+	return 0;
+}
+
+int
+PluginCache::save ()
+{
+	if (!_dirty) {
+		return 0;
+	}
+
+	XMLNode* root = new XMLNode (X_("PluginCache"));
+	root->set_property (X_("version"), 1);
+
+	for (Files::const_iterator i = _files.begin (); i != _files.end (); ++i) {
+		File const & f (i->second);
+		XMLNode* file = root->add_child (X_("File"));
+
+		file->set_property (X_("path"), i->first);
+		file->set_property (X_("type"), f.type);
+		file->set_property (X_("mtime"), f.mtime);
+		file->set_property (X_("size"), f.size);
+		file->set_property (X_("hash"), f.hash);
+
+		for (PluginInfoList::const_iterator p = f.plugins.begin (); p != f.plugins.end (); ++p) {
+			XMLNode* plugin = file->add_child (X_("Plugin"));
+
+			plugin->set_property (X_("name"), (*p)->name);
+			plugin->set_property (X_("unique-id"), (*p)->unique_id);
+			plugin->set_property (X_("category"), (*p)->category);
+			plugin->set_property (X_("creator"), (*p)->creator);
+			plugin->set_property (X_("index"), (*p)->index);
+			plugin->set_property (X_("audio-in"), (*p)->n_inputs.n_audio ());
+			plugin->set_property (X_("midi-in"), (*p)->n_inputs.n_midi ());
+			plugin->set_property (X_("audio-out"), (*p)->n_outputs.n_audio ());
+			plugin->set_property (X_("midi-out"), (*p)->n_outputs.n_midi ());
+		}
+	}
+
+	string const path = cache_path ();
+	XMLTree tree;
+
+	tree.set_root (root);
+
+	if (!tree.write (path)) {
+		error << string_compose (_("Could not save plugin cache to %1"), path) << endmsg;
+		g_unlink (path.c_str ());
+		return -1;
+	}
+
+	_dirty = false;
+	return 0;
+}
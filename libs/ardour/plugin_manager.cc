@@ -68,6 +68,7 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "pbd/cpus.h"
 #include "pbd/whitespace.h"
 #include "pbd/file_utils.h"
 
@@ -137,6 +138,8 @@ PluginManager::PluginManager ()
 	char* s;
 	string lrdf_path;
 
+	_cache.load ();
+
 #if defined WINDOWS_VST_SUPPORT || defined LXVST_SUPPORT || defined MACVST_SUPPORT
 	// source-tree (ardev, etc)
 	PBD::Searchpath vstsp(Glib::build_filename(ARDOUR::ardour_dll_directory(), "fst"));
@@ -335,6 +338,8 @@ PluginManager::refresh (bool cache_only)
 	au_refresh (cache_only);
 #endif
 
+	_cache.save ();
+
 	BootMessage (_("Plugin Scan Complete..."));
 	PluginListChanged (); /* EMIT SIGNAL */
 	PluginScanMessage(X_("closeme"), "", false);
@@ -423,6 +428,11 @@ PluginManager::clear_vst_cache ()
 			::g_unlink(i->c_str());
 		}
 	}
+
+	_cache.clear (ARDOUR::Windows_VST);
+	_cache.clear (ARDOUR::LXVST);
+	_cache.clear (ARDOUR::MacVST);
+	_cache.save ();
 #endif
 }
 
@@ -544,6 +554,8 @@ PluginManager::ladspa_refresh ()
 		ARDOUR::PluginScanMessage(_("LADSPA"), *i, false);
 		ladspa_discover (*i);
 	}
+
+	_cache.forget_unused (ARDOUR::LADSPA);
 }
 
 #ifdef HAVE_LRDF
@@ -628,95 +640,113 @@ PluginManager::add_lrdf_data (const string &path)
 int
 PluginManager::ladspa_discover (string path)
 {
-	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Checking for LADSPA plugin at %1\n", path));
+	PluginInfoList found;
 
-	Glib::Module module(path);
-	const LADSPA_Descriptor *descriptor;
-	LADSPA_Descriptor_Function dfunc;
-	void* func = 0;
+	if (!_cache.lookup (path, ARDOUR::LADSPA, found)) {
 
-	if (!module) {
-		error << string_compose(_("LADSPA: cannot load module \"%1\" (%2)"),
-			path, Glib::Module::get_last_error()) << endmsg;
-		return -1;
-	}
+		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Checking for LADSPA plugin at %1\n", path));
 
+		Glib::Module module(path);
+		const LADSPA_Descriptor *descriptor;
+		LADSPA_Descriptor_Function dfunc;
+		void* func = 0;
 
-	if (!module.get_symbol("ladspa_descriptor", func)) {
-		error << string_compose(_("LADSPA: module \"%1\" has no descriptor function."), path) << endmsg;
-		error << Glib::Module::get_last_error() << endmsg;
-		return -1;
-	}
-
-	dfunc = (LADSPA_Descriptor_Function)func;
+		if (!module) {
+			error << string_compose(_("LADSPA: cannot load module \"%1\" (%2)"),
+				path, Glib::Module::get_last_error()) << endmsg;
+			return -1;
+		}
 
-	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("LADSPA plugin found at %1\n", path));
 
-	for (uint32_t i = 0; ; ++i) {
-		/* if a ladspa plugin allocates memory here
-		 * it is never free()ed (or plugin-dependent only when unloading).
-		 * For some plugins memory allocated is incremental, we should
-		 * avoid re-scanning plugins and file bug reports.
-		 */
-		if ((descriptor = dfunc (i)) == 0) {
-			break;
+		if (!module.get_symbol("ladspa_descriptor", func)) {
+			error << string_compose(_("LADSPA: module \"%1\" has no descriptor function."), path) << endmsg;
+			error << Glib::Module::get_last_error() << endmsg;
+			return -1;
 		}
 
-		if (!ladspa_plugin_whitelist.empty()) {
-			if (find (ladspa_plugin_whitelist.begin(), ladspa_plugin_whitelist.end(), descriptor->UniqueID) == ladspa_plugin_whitelist.end()) {
-				continue;
+		dfunc = (LADSPA_Descriptor_Function)func;
+
+		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("LADSPA plugin found at %1\n", path));
+
+		for (uint32_t i = 0; ; ++i) {
+			/* if a ladspa plugin allocates memory here
+			 * it is never free()ed (or plugin-dependent only when unloading).
+			 * For some plugins memory allocated is incremental, we should
+			 * avoid re-scanning plugins and file bug reports.
+			 */
+			if ((descriptor = dfunc (i)) == 0) {
+				break;
 			}
-		}
 
-		PluginInfoPtr info(new LadspaPluginInfo);
-		info->name = descriptor->Name;
-		info->category = get_ladspa_category(descriptor->UniqueID);
-		info->creator = descriptor->Maker;
-		info->path = path;
-		info->index = i;
-		info->n_inputs = ChanCount();
-		info->n_outputs = ChanCount();
-		info->type = ARDOUR::LADSPA;
-
-		char buf[32];
-		snprintf (buf, sizeof (buf), "%lu", descriptor->UniqueID);
-		info->unique_id = buf;
-
-		for (uint32_t n=0; n < descriptor->PortCount; ++n) {
-			if ( LADSPA_IS_PORT_AUDIO (descriptor->PortDescriptors[n]) ) {
-				if ( LADSPA_IS_PORT_INPUT (descriptor->PortDescriptors[n]) ) {
-					info->n_inputs.set_audio(info->n_inputs.n_audio() + 1);
-				}
-				else if ( LADSPA_IS_PORT_OUTPUT (descriptor->PortDescriptors[n]) ) {
-					info->n_outputs.set_audio(info->n_outputs.n_audio() + 1);
+			PluginInfoPtr info(new LadspaPluginInfo);
+			info->name = descriptor->Name;
+			info->creator = descriptor->Maker;
+			info->path = path;
+			info->index = i;
+			info->n_inputs = ChanCount();
+			info->n_outputs = ChanCount();
+			info->type = ARDOUR::LADSPA;
+
+			char buf[32];
+			snprintf (buf, sizeof (buf), "%lu", descriptor->UniqueID);
+			info->unique_id = buf;
+
+			for (uint32_t n=0; n < descriptor->PortCount; ++n) {
+				if ( LADSPA_IS_PORT_AUDIO (descriptor->PortDescriptors[n]) ) {
+					if ( LADSPA_IS_PORT_INPUT (descriptor->PortDescriptors[n]) ) {
+						info->n_inputs.set_audio(info->n_inputs.n_audio() + 1);
+					}
+					else if ( LADSPA_IS_PORT_OUTPUT (descriptor->PortDescriptors[n]) ) {
+						info->n_outputs.set_audio(info->n_outputs.n_audio() + 1);
+					}
 				}
 			}
+
+			found.push_back (info);
 		}
 
-		if(_ladspa_plugin_info->empty()){
-			_ladspa_plugin_info->push_back (info);
+		/* remember the module, even if it has no plugins, so that it
+		 * is not loaded again until it changes.
+		 */
+		_cache.store (path, ARDOUR::LADSPA, found);
+
+// GDB WILL NOT LIKE YOU IF YOU DO THIS
+//		dlclose (module);
+	}
+
+	for (PluginInfoList::iterator p = found.begin(); p != found.end(); ++p) {
+
+		PluginInfoPtr info (*p);
+		const uint32_t unique_id = strtoul (info->unique_id.c_str(), 0, 10);
+
+		if (!ladspa_plugin_whitelist.empty()) {
+			if (find (ladspa_plugin_whitelist.begin(), ladspa_plugin_whitelist.end(), unique_id) == ladspa_plugin_whitelist.end()) {
+				continue;
+			}
 		}
 
+		/* the category comes from RDF data rather than the module,
+		 * so it is not cached.
+		 */
+		info->category = get_ladspa_category (unique_id);
+
 		//Ensure that the plugin is not already in the plugin list.
 
-		bool found = false;
+		bool duplicate = false;
 
 		for (PluginInfoList::const_iterator i = _ladspa_plugin_info->begin(); i != _ladspa_plugin_info->end(); ++i) {
 			if(0 == info->unique_id.compare((*i)->unique_id)){
-			      found = true;
+			      duplicate = true;
 			}
 		}
 
-		if(!found){
+		if(!duplicate){
 		    _ladspa_plugin_info->push_back (info);
 		}
 
 		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Found LADSPA plugin, name: %1, Inputs: %2, Outputs: %3\n", info->name, info->n_inputs, info->n_outputs));
 	}
 
-// GDB WILL NOT LIKE YOU IF YOU DO THIS
-//	dlclose (module);
-
 	return 0;
 }
 
@@ -817,6 +847,37 @@ PluginManager::au_refresh (bool cache_only)
 
 #endif
 
+#if (defined WINDOWS_VST_SUPPORT || defined LXVST_SUPPORT || defined MACVST_SUPPORT)
+/** Check those of @param plugin_objects that are not in the cache with
+ *  the external scanner, running several scanners at once.  The results
+ *  are then read by the *_discover() methods.
+ */
+void
+PluginManager::vst_scan_with_app (vector<string> const & plugin_objects, PluginType type)
+{
+	vector<string> to_scan;
+
+	for (vector<string>::const_iterator x = plugin_objects.begin(); x != plugin_objects.end (); ++x) {
+		PluginInfoList cached;
+		if (!_cache.lookup (*x, type, cached)) {
+			to_scan.push_back (*x);
+		}
+	}
+
+	if (to_scan.empty () || cancelled ()) {
+		return;
+	}
+
+	uint32_t jobs = Config->get_plugin_scan_jobs ();
+	if (jobs == 0) {
+		jobs = hardware_concurrency ();
+	}
+
+	_cancel_timeout = false;
+	vstfx_scan_with_app (to_scan, type, jobs);
+}
+#endif
+
 #ifdef WINDOWS_VST_SUPPORT
 
 void
@@ -828,7 +889,9 @@ PluginManager::windows_vst_refresh (bool cache_only)
 		_windows_vst_plugin_info = new ARDOUR::PluginInfoList();
 	}
 
-	windows_vst_discover_from_path (Config->get_plugin_path_vst(), cache_only);
+	if (windows_vst_discover_from_path (Config->get_plugin_path_vst(), cache_only) == 0) {
+		_cache.forget_unused (ARDOUR::Windows_VST);
+	}
 }
 
 static bool windows_vst_filter (const string& str, void * /*arg*/)
@@ -857,6 +920,13 @@ PluginManager::windows_vst_discover_from_path (string path, bool cache_only)
 
 	find_files_matching_filter (plugin_objects, path, windows_vst_filter, 0, false, true, true);
 
+	if (!cache_only) {
+		vst_scan_with_app (plugin_objects, ARDOUR::Windows_VST);
+	}
+
+	/* read once for the whole scan, to check the cached plugins against */
+	vstfx_get_blacklist (_vst_blacklist);
+
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x) {
 		ARDOUR::PluginScanMessage(_("VST"), *x, !cache_only && !cancelled());
 		windows_vst_discover (*x, cache_only || cancelled());
@@ -942,55 +1012,76 @@ PluginManager::windows_vst_discover (string path, bool cache_only)
 		}
 	}
 
-	_cancel_timeout = false;
-	vector<VSTInfo*> * finfos = vstfx_get_info_fst (const_cast<char *> (path.c_str()),
-			cache_only ? VST_SCAN_CACHE_ONLY : VST_SCAN_USE_APP);
-
-	// TODO  get extended error messae from vstfx_get_info_fst() e.g  blacklisted, 32/64bit compat,
-	// .err file scanner output etc.
+	PluginInfoList found;
 
-	if (finfos->empty()) {
-		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot get Windows VST information from '%1'\n", path));
-		if (Config->get_verbose_plugin_scan()) {
-			info << _(" -> Cannot get Windows VST information, plugin ignored.") << endmsg;
+	if (_cache.lookup (path, ARDOUR::Windows_VST, found)) {
+		/* the plugin may have been blacklisted since it was cached */
+		if (_vst_blacklist.find (path) != _vst_blacklist.end ()) {
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Windows VST '%1' is blacklisted\n", path));
+			return -1;
 		}
-		return -1;
-	}
+	} else {
 
-	uint32_t discovered = 0;
-	for (vector<VSTInfo *>::iterator x = finfos->begin(); x != finfos->end(); ++x) {
-		VSTInfo* finfo = *x;
-		char buf[32];
-
-		if (!finfo->canProcessReplacing) {
-			warning << string_compose (_("VST plugin %1 does not support processReplacing, and cannot be used in %2 at this time"),
-							 finfo->name, PROGRAM_NAME)
-				<< endl;
-			continue;
+		_cancel_timeout = false;
+		vector<VSTInfo*> * finfos = vstfx_get_info_fst (const_cast<char *> (path.c_str()),
+				cache_only ? VST_SCAN_CACHE_ONLY : VST_SCAN_USE_APP);
+
+		// TODO  get extended error messae from vstfx_get_info_fst() e.g  blacklisted, 32/64bit compat,
+		// .err file scanner output etc.
+
+		if (finfos->empty()) {
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot get Windows VST information from '%1'\n", path));
+			if (Config->get_verbose_plugin_scan()) {
+				info << _(" -> Cannot get Windows VST information, plugin ignored.") << endmsg;
+			}
+			vstfx_free_info_list (finfos);
+			return -1;
 		}
 
-		PluginInfoPtr info (new WindowsVSTPluginInfo);
+		for (vector<VSTInfo *>::iterator x = finfos->begin(); x != finfos->end(); ++x) {
+			VSTInfo* finfo = *x;
+			char buf[32];
 
-		/* what a joke freeware VST is */
+			if (!finfo->canProcessReplacing) {
+				warning << string_compose (_("VST plugin %1 does not support processReplacing, and cannot be used in %2 at this time"),
+								 finfo->name, PROGRAM_NAME)
+					<< endl;
+				continue;
+			}
 
-		if (!strcasecmp ("The Unnamed plugin", finfo->name)) {
-			info->name = PBD::basename_nosuffix (path);
-		} else {
-			info->name = finfo->name;
+			PluginInfoPtr info (new WindowsVSTPluginInfo);
+
+			/* what a joke freeware VST is */
+
+			if (!strcasecmp ("The Unnamed plugin", finfo->name)) {
+				info->name = PBD::basename_nosuffix (path);
+			} else {
+				info->name = finfo->name;
+			}
+
+
+			snprintf (buf, sizeof (buf), "%d", finfo->UniqueID);
+			info->unique_id = buf;
+			info->category = "VST";
+			info->path = path;
+			info->creator = finfo->creator;
+			info->index = 0;
+			info->n_inputs.set_audio (finfo->numInputs);
+			info->n_outputs.set_audio (finfo->numOutputs);
+			info->n_inputs.set_midi ((finfo->wantMidi&1) ? 1 : 0);
+			info->n_outputs.set_midi ((finfo->wantMidi&2) ? 1 : 0);
+			info->type = ARDOUR::Windows_VST;
+
+			found.push_back (info);
 		}
 
+		vstfx_free_info_list (finfos);
+		_cache.store (path, ARDOUR::Windows_VST, found);
+	}
 
-		snprintf (buf, sizeof (buf), "%d", finfo->UniqueID);
-		info->unique_id = buf;
-		info->category = "VST";
-		info->path = path;
-		info->creator = finfo->creator;
-		info->index = 0;
-		info->n_inputs.set_audio (finfo->numInputs);
-		info->n_outputs.set_audio (finfo->numOutputs);
-		info->n_inputs.set_midi ((finfo->wantMidi&1) ? 1 : 0);
-		info->n_outputs.set_midi ((finfo->wantMidi&2) ? 1 : 0);
-		info->type = ARDOUR::Windows_VST;
+	uint32_t discovered = 0;
+	for (PluginInfoList::iterator x = found.begin(); x != found.end(); ++x) {
+		PluginInfoPtr info (*x);
 
 		// TODO: check dup-IDs (lxvst AND windows vst)
 		bool duplicate = false;
@@ -1015,7 +1106,6 @@ PluginManager::windows_vst_discover (string path, bool cache_only)
 		}
 	}
 
-	vstfx_free_info_list (finfos);
 	return discovered > 0 ? 0 : -1;
 }
 
@@ -1031,7 +1121,9 @@ PluginManager::mac_vst_refresh (bool cache_only)
 		_mac_vst_plugin_info = new ARDOUR::PluginInfoList();
 	}
 
-	mac_vst_discover_from_path ("~/Library/Audio/Plug-Ins/VST:/Library/Audio/Plug-Ins/VST", cache_only);
+	if (mac_vst_discover_from_path ("~/Library/Audio/Plug-Ins/VST:/Library/Audio/Plug-Ins/VST", cache_only) == 0) {
+		_cache.forget_unused (ARDOUR::MacVST);
+	}
 }
 
 static bool mac_vst_filter (const string& str, void *)
@@ -1059,6 +1151,13 @@ PluginManager::mac_vst_discover_from_path (string path, bool cache_only)
 
 	find_paths_matching_filter (plugin_objects, path, mac_vst_filter, 0, true, true, true);
 
+	if (!cache_only) {
+		vst_scan_with_app (plugin_objects, ARDOUR::MacVST);
+	}
+
+	/* read once for the whole scan, to check the cached plugins against */
+	vstfx_get_blacklist (_vst_blacklist);
+
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x) {
 		ARDOUR::PluginScanMessage(_("MacVST"), *x, !cache_only && !cancelled());
 		mac_vst_discover (*x, cache_only || cancelled());
@@ -1071,43 +1170,64 @@ PluginManager::mac_vst_discover (string path, bool cache_only)
 {
 	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("checking apparent MacVST plugin at %1\n", path));
 
-	_cancel_timeout = false;
+	PluginInfoList found;
 
-	vector<VSTInfo*>* finfos = vstfx_get_info_mac (const_cast<char *> (path.c_str()),
-			cache_only ? VST_SCAN_CACHE_ONLY : VST_SCAN_USE_APP);
+	if (_cache.lookup (path, ARDOUR::MacVST, found)) {
+		/* the plugin may have been blacklisted since it was cached */
+		if (_vst_blacklist.find (path) != _vst_blacklist.end ()) {
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Mac VST '%1' is blacklisted\n", path));
+			return -1;
+		}
+	} else {
 
-	if (finfos->empty()) {
-		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot get Mac VST information from '%1'\n", path));
-		return -1;
-	}
+		_cancel_timeout = false;
 
-	uint32_t discovered = 0;
-	for (vector<VSTInfo *>::iterator x = finfos->begin(); x != finfos->end(); ++x) {
-		VSTInfo* finfo = *x;
-		char buf[32];
-
-		if (!finfo->canProcessReplacing) {
-			warning << string_compose (_("Mac VST plugin %1 does not support processReplacing, and so cannot be used in %2 at this time"),
-							 finfo->name, PROGRAM_NAME)
-				<< endl;
-			continue;
+		vector<VSTInfo*>* finfos = vstfx_get_info_mac (const_cast<char *> (path.c_str()),
+				cache_only ? VST_SCAN_CACHE_ONLY : VST_SCAN_USE_APP);
+
+		if (finfos->empty()) {
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot get Mac VST information from '%1'\n", path));
+			vstfx_free_info_list (finfos);
+			return -1;
 		}
 
-		PluginInfoPtr info (new MacVSTPluginInfo);
+		for (vector<VSTInfo *>::iterator x = finfos->begin(); x != finfos->end(); ++x) {
+			VSTInfo* finfo = *x;
+			char buf[32];
+
+			if (!finfo->canProcessReplacing) {
+				warning << string_compose (_("Mac VST plugin %1 does not support processReplacing, and so cannot be used in %2 at this time"),
+								 finfo->name, PROGRAM_NAME)
+					<< endl;
+				continue;
+			}
+
+			PluginInfoPtr info (new MacVSTPluginInfo);
+
+			info->name = finfo->name;
+
+			snprintf (buf, sizeof (buf), "%d", finfo->UniqueID);
+			info->unique_id = buf;
+			info->category = "MacVST";
+			info->path = path;
+			info->creator = finfo->creator;
+			info->index = 0;
+			info->n_inputs.set_audio (finfo->numInputs);
+			info->n_outputs.set_audio (finfo->numOutputs);
+			info->n_inputs.set_midi ((finfo->wantMidi&1) ? 1 : 0);
+			info->n_outputs.set_midi ((finfo->wantMidi&2) ? 1 : 0);
+			info->type = ARDOUR::MacVST;
+
+			found.push_back (info);
+		}
 
-		info->name = finfo->name;
+		vstfx_free_info_list (finfos);
+		_cache.store (path, ARDOUR::MacVST, found);
+	}
 
-		snprintf (buf, sizeof (buf), "%d", finfo->UniqueID);
-		info->unique_id = buf;
-		info->category = "MacVST";
-		info->path = path;
-		info->creator = finfo->creator;
-		info->index = 0;
-		info->n_inputs.set_audio (finfo->numInputs);
-		info->n_outputs.set_audio (finfo->numOutputs);
-		info->n_inputs.set_midi ((finfo->wantMidi&1) ? 1 : 0);
-		info->n_outputs.set_midi ((finfo->wantMidi&2) ? 1 : 0);
-		info->type = ARDOUR::MacVST;
+	uint32_t discovered = 0;
+	for (PluginInfoList::iterator x = found.begin(); x != found.end(); ++x) {
+		PluginInfoPtr info (*x);
 
 		bool duplicate = false;
 		if (!_mac_vst_plugin_info->empty()) {
@@ -1126,7 +1246,6 @@ PluginManager::mac_vst_discover (string path, bool cache_only)
 		}
 	}
 
-	vstfx_free_info_list (finfos);
 	return discovered > 0 ? 0 : -1;
 }
 
@@ -1143,7 +1262,9 @@ PluginManager::lxvst_refresh (bool cache_only)
 		_lxvst_plugin_info = new ARDOUR::PluginInfoList();
 	}
 
-	lxvst_discover_from_path (Config->get_plugin_path_lxvst(), cache_only);
+	if (lxvst_discover_from_path (Config->get_plugin_path_lxvst(), cache_only) == 0) {
+		_cache.forget_unused (ARDOUR::LXVST);
+	}
 }
 
 static bool lxvst_filter (const string& str, void *)
@@ -1173,6 +1294,13 @@ PluginManager::lxvst_discover_from_path (string path, bool cache_only)
 
 	find_files_matching_filter (plugin_objects, Config->get_plugin_path_lxvst(), lxvst_filter, 0, false, true, true);
 
+	if (!cache_only) {
+		vst_scan_with_app (plugin_objects, ARDOUR::LXVST);
+	}
+
+	/* read once for the whole scan, to check the cached plugins against */
+	vstfx_get_blacklist (_vst_blacklist);
+
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x) {
 		ARDOUR::PluginScanMessage(_("LXVST"), *x, !cache_only && !cancelled());
 		lxvst_discover (*x, cache_only || cancelled());
@@ -1186,53 +1314,74 @@ PluginManager::lxvst_discover (string path, bool cache_only)
 {
 	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("checking apparent LXVST plugin at %1\n", path));
 
-	_cancel_timeout = false;
-	vector<VSTInfo*> * finfos = vstfx_get_info_lx (const_cast<char *> (path.c_str()),
-			cache_only ? VST_SCAN_CACHE_ONLY : VST_SCAN_USE_APP);
+	PluginInfoList found;
 
-	if (finfos->empty()) {
-		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot get Linux VST information from '%1'\n", path));
-		return -1;
-	}
+	if (_cache.lookup (path, ARDOUR::LXVST, found)) {
+		/* the plugin may have been blacklisted since it was cached */
+		if (_vst_blacklist.find (path) != _vst_blacklist.end ()) {
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Linux VST '%1' is blacklisted\n", path));
+			return -1;
+		}
+	} else {
 
-	uint32_t discovered = 0;
-	for (vector<VSTInfo *>::iterator x = finfos->begin(); x != finfos->end(); ++x) {
-		VSTInfo* finfo = *x;
-		char buf[32];
-
-		if (!finfo->canProcessReplacing) {
-			warning << string_compose (_("linuxVST plugin %1 does not support processReplacing, and so cannot be used in %2 at this time"),
-							 finfo->name, PROGRAM_NAME)
-				<< endl;
-			continue;
+		_cancel_timeout = false;
+		vector<VSTInfo*> * finfos = vstfx_get_info_lx (const_cast<char *> (path.c_str()),
+				cache_only ? VST_SCAN_CACHE_ONLY : VST_SCAN_USE_APP);
+
+		if (finfos->empty()) {
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot get Linux VST information from '%1'\n", path));
+			vstfx_free_info_list (finfos);
+			return -1;
 		}
 
-		PluginInfoPtr info(new LXVSTPluginInfo);
+		for (vector<VSTInfo *>::iterator x = finfos->begin(); x != finfos->end(); ++x) {
+			VSTInfo* finfo = *x;
+			char buf[32];
 
-		if (!strcasecmp ("The Unnamed plugin", finfo->name)) {
-			info->name = PBD::basename_nosuffix (path);
-		} else {
-			info->name = finfo->name;
+			if (!finfo->canProcessReplacing) {
+				warning << string_compose (_("linuxVST plugin %1 does not support processReplacing, and so cannot be used in %2 at this time"),
+								 finfo->name, PROGRAM_NAME)
+					<< endl;
+				continue;
+			}
+
+			PluginInfoPtr info(new LXVSTPluginInfo);
+
+			if (!strcasecmp ("The Unnamed plugin", finfo->name)) {
+				info->name = PBD::basename_nosuffix (path);
+			} else {
+				info->name = finfo->name;
+			}
+
+
+			snprintf (buf, sizeof (buf), "%d", finfo->UniqueID);
+			info->unique_id = buf;
+			info->category = "linuxVSTs";
+			info->path = path;
+			info->creator = finfo->creator;
+			info->index = 0;
+			info->n_inputs.set_audio (finfo->numInputs);
+			info->n_outputs.set_audio (finfo->numOutputs);
+			info->n_inputs.set_midi ((finfo->wantMidi&1) ? 1 : 0);
+			info->n_outputs.set_midi ((finfo->wantMidi&2) ? 1 : 0);
+			info->type = ARDOUR::LXVST;
+
+			found.push_back (info);
 		}
 
+		vstfx_free_info_list (finfos);
+		_cache.store (path, ARDOUR::LXVST, found);
+	}
 
-		snprintf (buf, sizeof (buf), "%d", finfo->UniqueID);
-		info->unique_id = buf;
-		info->category = "linuxVSTs";
-		info->path = path;
-		info->creator = finfo->creator;
-		info->index = 0;
-		info->n_inputs.set_audio (finfo->numInputs);
-		info->n_outputs.set_audio (finfo->numOutputs);
-		info->n_inputs.set_midi ((finfo->wantMidi&1) ? 1 : 0);
-		info->n_outputs.set_midi ((finfo->wantMidi&2) ? 1 : 0);
-		info->type = ARDOUR::LXVST;
-
-					/* Make sure we don't find the same plugin in more than one place along
-			 the LXVST_PATH We can't use a simple 'find' because the path is included
-			 in the PluginInfo, and that is the one thing we can be sure MUST be
-			 different if a duplicate instance is found.  So we just compare the type
-			 and unique ID (which for some VSTs isn't actually unique...)
+	uint32_t discovered = 0;
+	for (PluginInfoList::iterator x = found.begin(); x != found.end(); ++x) {
+		PluginInfoPtr info (*x);
+
+		/* Make sure we don't find the same plugin in more than one place along
+		   the LXVST_PATH We can't use a simple 'find' because the path is included
+		   in the PluginInfo, and that is the one thing we can be sure MUST be
+		   different if a duplicate instance is found.  So we just compare the type
+		   and unique ID (which for some VSTs isn't actually unique...)
 		*/
 
 		// TODO: check dup-IDs with windowsVST, too
@@ -1253,7 +1402,6 @@ PluginManager::lxvst_discover (string path, bool cache_only)
 		}
 	}
 
-	vstfx_free_info_list (finfos);
 	return discovered > 0 ? 0 : -1;
 }
 
@@ -115,7 +115,7 @@ PortManager::make_port_name_relative (const string& portname) const
 		return portname;
 	}
 
-	if (portname.substr (0, colon) == _backend->my_name()) {
+	if (portname.compare (0, colon, _backend->my_name()) == 0) {
 		return portname.substr (colon+1);
 	}
 
@@ -162,10 +162,10 @@ PortManager::port_is_mine (const string& portname) const
 		return true;
 	}
 
-	string self = _backend->my_name();
+	const string& self = _backend->my_name();
 
 	if (portname.find_first_of (':') != string::npos) {
-		if (portname.substr (0, self.length ()) != self) {
+		if (portname.compare (0, self.length (), self) != 0) {
                         return false;
                 }
         }
@@ -61,6 +61,7 @@
 #include "ardour/panner_shell.h"
 #include "ardour/parameter_descriptor.h"
 #include "ardour/phase_control.h"
+#include "ardour/pipeline_stage.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/port.h"
 #include "ardour/port_insert.h"
@@ -422,8 +423,25 @@ Route::process_output_buffers (BufferSet& bufs,
 	framecnt_t latency = 0;
 	const double speed = _session.transport_speed ();
 
+	/* if the chain is split by a pipeline stage, queue the processors
+	 * after it to run on the previous cycle's data in another process
+	 * thread, while we run the processors before it.
+	 */
+	uint32_t n_pipelined = 0;
+	bool const pipeline_started = _pipeline && _pipeline->pipelined () && start_pipeline (start_frame, end_frame, speed, nframes);
+
 	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
 
+		if (n_pipelined > 0) {
+			/* already run by the pipeline stage */
+			--n_pipelined;
+			bufs.set_count ((*i)->output_streams());
+			if ((*i)->active ()) {
+				latency += (*i)->signal_latency ();
+			}
+			continue;
+		}
+
 		if (meter_already_run && boost::dynamic_pointer_cast<PeakMeter> (*i)) {
 			/* don't ::run() the meter, otherwise it will have its previous peak corrupted */
 			continue;
@@ -462,9 +480,52 @@ Route::process_output_buffers (BufferSet& bufs,
 		if ((*i)->active ()) {
 			latency += (*i)->signal_latency ();
 		}
+
+		if (*i == _pipeline && pipeline_started) {
+			n_pipelined = _pipeline->stage ().size ();
+		}
 	}
 }
 
+/** Start the processors after the pipeline stage for this cycle.
+ *  Must be called with the _processor_lock held.
+ *  @return true if started, see PipelineStage::start()
+ */
+bool
+Route::start_pipeline (framepos_t start_frame, framepos_t end_frame, double speed, pframes_t nframes)
+{
+	framecnt_t latency = 0;
+	ProcessorList::const_iterator i;
+
+	for (i = _processors.begin(); i != _processors.end() && *i != _pipeline; ++i) {
+		if ((*i)->active ()) {
+			latency += (*i)->signal_latency ();
+		}
+	}
+
+	if (i == _processors.end ()) {
+		return false;
+	}
+
+	latency += _pipeline->signal_latency ();
+
+	const framecnt_t stage_latency = latency;
+	const framecnt_t longest_session_latency = _initial_delay + _signal_latency;
+	PipelineStage::ProcessorList const& stage (_pipeline->stage ());
+
+	for (PipelineStage::ProcessorList::const_iterator p = stage.begin(); p != stage.end(); ++p) {
+		if (boost::dynamic_pointer_cast<PluginInsert>(*p) != 0) {
+			boost::dynamic_pointer_cast<PluginInsert>(*p)->set_sidechain_latency (
+					_initial_delay + latency, longest_session_latency - latency);
+		}
+		if ((*p)->active ()) {
+			latency += (*p)->signal_latency ();
+		}
+	}
+
+	return _pipeline->start (start_frame - stage_latency, end_frame - stage_latency, speed, nframes);
+}
+
 void
 Route::bounce_process (BufferSet& buffers, framepos_t start, framecnt_t nframes,
 		boost::shared_ptr<Processor> endpoint,
@@ -1250,7 +1311,7 @@ Route::clear_processors (Placement p)
 				seen_amp = true;
 			}
 
-			if ((*i) == _amp || (*i) == _meter || (*i) == _main_outs || (*i) == _delayline || (*i) == _trim) {
+			if ((*i) == _amp || (*i) == _meter || (*i) == _main_outs || (*i) == _delayline || (*i) == _pipeline || (*i) == _trim) {
 
 				/* you can't remove these */
 
@@ -1319,7 +1380,7 @@ Route::remove_processor (boost::shared_ptr<Processor> processor, ProcessorStream
 
 	/* these can never be removed */
 
-	if (processor == _amp || processor == _meter || processor == _main_outs || processor == _delayline || processor == _trim) {
+	if (processor == _amp || processor == _meter || processor == _main_outs || processor == _delayline || processor == _pipeline || processor == _trim) {
 		return 0;
 	}
 
@@ -1421,11 +1482,11 @@ int
 Route::replace_processor (boost::shared_ptr<Processor> old, boost::shared_ptr<Processor> sub, ProcessorStreams* err)
 {
 	/* these can never be removed */
-	if (old == _amp || old == _meter || old == _main_outs || old == _delayline || old == _trim) {
+	if (old == _amp || old == _meter || old == _main_outs || old == _delayline || old == _pipeline || old == _trim) {
 		return 1;
 	}
 	/* and can't be used as substitute, either */
-	if (sub == _amp || sub == _meter || sub == _main_outs || sub == _delayline || sub == _trim) {
+	if (sub == _amp || sub == _meter || sub == _main_outs || sub == _delayline || sub == _pipeline || sub == _trim) {
 		return 1;
 	}
 
@@ -1540,7 +1601,7 @@ Route::remove_processors (const ProcessorList& to_be_deleted, ProcessorStreams*
 
 			/* these can never be removed */
 
-			if (processor == _amp || processor == _meter || processor == _main_outs || processor == _delayline || processor == _trim) {
+			if (processor == _amp || processor == _meter || processor == _main_outs || processor == _delayline || processor == _pipeline || processor == _trim) {
 				++i;
 				continue;
 			}
@@ -1857,6 +1918,10 @@ Route::configure_processors_unlocked (ProcessorStreams* err, Glib::Threads::RWLo
 		_meter->set_max_channels (processor_max_streams);
 	}
 
+	if (_pipeline) {
+		_pipeline->configure_stage (processor_max_streams);
+	}
+
 	/* make sure we have sufficient scratch buffers to cope with the new processor
 	   configuration
 	*/
@@ -2261,6 +2326,33 @@ Route::customize_plugin_insert (boost::shared_ptr<Processor> proc, uint32_t coun
 	return true;
 }
 
+/** Enable or disable splitting a long chain of plugins in two stages
+ *  that run concurrently, at the expense of one cycle of latency.
+ */
+void
+Route::set_processor_pipelining (bool yn)
+{
+	if (yn == processor_pipelining ()) {
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
+
+		if (yn) {
+			_pipeline.reset (new PipelineStage (_session, _name));
+			_pipeline->activate ();
+		} else {
+			_pipeline.reset ();
+		}
+
+		configure_processors (0);
+	}
+
+	processors_changed (RouteProcessorChange ()); /* EMIT SIGNAL */
+	_session.set_dirty ();
+}
+
 bool
 Route::set_strict_io (const bool enable)
 {
@@ -2326,6 +2418,7 @@ Route::state(bool full_state)
 	node->set_property ("name", name());
 	node->set_property ("default-type", _default_type);
 	node->set_property ("strict-io", _strict_io);
+	node->set_property ("processor-pipelining", processor_pipelining ());
 
 	node->add_child_nocopy (_presentation_info.get_state());
 
@@ -2436,6 +2529,12 @@ Route::set_state (const XMLNode& node, int version)
 
 	node.get_property (X_("strict-io"), _strict_io);
 
+	bool pipelining;
+	if (node.get_property (X_("processor-pipelining"), pipelining) && pipelining && !_pipeline) {
+		_pipeline.reset (new PipelineStage (_session, _name));
+		_pipeline->activate ();
+	}
+
 	if (is_monitor()) {
 		/* monitor bus does not get a panner, but if (re)created
 		   via XML, it will already have one by the time we
@@ -2827,6 +2926,9 @@ Route::set_processor_state (const XMLNode& node)
 		} else if (prop->value() == "capture") {
 			/* CapturingProcessor should never be restored, it's always
 			   added explicitly when needed */
+		} else if (prop->value() == "pipeline") {
+			/* the pipeline stage is placed by setup_invisible_processors ()
+			   when processor pipelining is enabled */
 		} else {
 			ProcessorList::iterator o;
 
@@ -3324,6 +3426,11 @@ Route::nonrealtime_handle_transport_stopped (bool /*abort_ignored*/, bool /*did_
 void
 Route::input_change_handler (IOChange change, void * /*src*/)
 {
+	if (change.type & (IOChange::ConfigurationChanged | IOChange::ConnectionsChanged)) {
+		/* the next re-sort of the route graph must look at us again */
+		_session.mark_route_graph_dirty (boost::dynamic_pointer_cast<Route> (shared_from_this ()));
+	}
+
 	if ((change.type & IOChange::ConfigurationChanged)) {
 		/* This is called with the process lock held if change
 		   contains ConfigurationChanged
@@ -3407,6 +3514,10 @@ Route::output_change_handler (IOChange change, void * /*src*/)
 		return;
 	}
 
+	if (change.type & (IOChange::ConfigurationChanged | IOChange::ConnectionsChanged)) {
+		_session.mark_route_graph_dirty (boost::dynamic_pointer_cast<Route> (shared_from_this ()));
+	}
+
 	if ((change.type & IOChange::ConfigurationChanged)) {
 		/* This is called with the process lock held if change
 		   contains ConfigurationChanged
@@ -4493,6 +4604,50 @@ Route::setup_invisible_processors ()
 		}
 	}
 
+	/* PIPELINE STAGE */
+
+	if (_pipeline) {
+		/* split the longest run of consecutive plugins in half; plugins
+		 * with a sidechain input are left out, their sidechain could not
+		 * be delayed along with the main input.
+		 */
+		ProcessorList::iterator run = new_processors.end ();
+		ProcessorList::iterator longest = new_processors.end ();
+		uint32_t run_len = 0;
+		uint32_t longest_len = 0;
+
+		for (ProcessorList::iterator i = new_processors.begin(); ; ++i) {
+			boost::shared_ptr<PluginInsert> pi;
+			if (i != new_processors.end () && (pi = boost::dynamic_pointer_cast<PluginInsert> (*i)) != 0 && !pi->has_sidechain ()) {
+				if (run_len++ == 0) {
+					run = i;
+				}
+				continue;
+			}
+			if (run_len > longest_len) {
+				longest = run;
+				longest_len = run_len;
+			}
+			run_len = 0;
+			if (i == new_processors.end ()) {
+				break;
+			}
+		}
+
+		PipelineStage::ProcessorList stage;
+
+		if (longest_len > 1) {
+			ProcessorList::iterator split = longest;
+			std::advance (split, longest_len / 2);
+			ProcessorList::iterator end = split;
+			std::advance (end, longest_len - longest_len / 2);
+			stage.assign (split, end);
+			new_processors.insert (split, _pipeline);
+		}
+
+		_pipeline->set_stage (stage);
+	}
+
 	/* find the amp */
 
 	ProcessorList::iterator amp = find (new_processors.begin(), new_processors.end(), _amp);
@@ -234,6 +234,10 @@ Session::Session (AudioEngine &eng,
 	, _state_of_the_state (StateOfTheState(CannotSave|InitialConnecting|Loading))
 	, _suspend_save (0)
 	, _save_queued (false)
+	, _state_write (0)
+	, _state_writer_running (false)
+	, _dirty_generation (0)
+	, _state_write_alive (new bool (true))
 	, _last_roll_location (0)
 	, _last_roll_or_reversal_location (0)
 	, _last_record_location (0)
@@ -319,6 +323,12 @@ Session::Session (AudioEngine &eng,
 	, _step_editors (0)
 	, _suspend_timecode_transmission (0)
 	,  _speakers (new Speakers)
+	, _current_route_graph_size (0)
+	, _route_graph_all_dirty (true)
+	, _ignore_graph_changes (0)
+	, _graph_change_pending (0)
+	, _resort_pending (0)
+	, _latency_change_pending (0)
 	, _ignore_route_processor_changes (0)
 	, midi_clock (0)
 	, _scene_changer (0)
@@ -635,6 +645,13 @@ Session::destroy ()
 
 	_state_of_the_state = StateOfTheState (CannotSave|Deletion);
 
+	/* finish writing the last state file, if that is still going on */
+	{
+		Glib::Threads::Mutex::Lock lm (save_state_lock);
+		wait_for_state_writer ();
+		*_state_write_alive = false;
+	}
+
 	/* disconnect from any and all signals that we are connected to */
 
 	Port::PortSignalDrop (); /* EMIT SIGNAL */
@@ -2295,24 +2312,71 @@ trace_terminal (boost::shared_ptr<Route> r1, boost::shared_ptr<Route> rbase)
 
 void
 Session::resort_routes ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_route_graph_dirty_lock);
+		_route_graph_all_dirty = true;
+	}
+
+	resort_dirty_routes ();
+}
+
+void
+Session::mark_route_graph_dirty (boost::shared_ptr<Route> r)
+{
+	Glib::Threads::Mutex::Lock lm (_route_graph_dirty_lock);
+
+	if (r) {
+		_route_graph_dirty.insert (r);
+	} else {
+		_route_graph_all_dirty = true;
+	}
+}
+
+/** Re-sort the routes, only re-examining the connections of those which
+ *  have been marked dirty since the last successful sort.
+ */
+void
+Session::resort_dirty_routes ()
 {
 	/* don't do anything here with signals emitted
 	   by Routes during initial setup or while we
-	   are being destroyed.
+	   are being destroyed.  The routes may have
+	   changed in the meantime, so the next sort
+	   starts from scratch.
 	*/
 
-	if (_state_of_the_state & (InitialConnecting | Deletion)) {
+	if ((_state_of_the_state & (InitialConnecting | Deletion)) || _route_deletion_in_progress) {
+		Glib::Threads::Mutex::Lock lm (_route_graph_dirty_lock);
+		_route_graph_all_dirty = true;
 		return;
 	}
 
-	if (_route_deletion_in_progress) {
+	if (graph_change_deferred (&_resort_pending)) {
 		return;
 	}
 
 	{
 		RCUWriter<RouteList> writer (routes);
 		boost::shared_ptr<RouteList> r = writer.get_copy ();
-		resort_routes_using (r);
+
+		std::set<GraphVertex> dirty;
+		bool all_dirty;
+
+		{
+			Glib::Threads::Mutex::Lock lm (_route_graph_dirty_lock);
+			all_dirty = _route_graph_all_dirty || r->size () != _current_route_graph_size;
+			for (std::set<boost::weak_ptr<Route> >::const_iterator i = _route_graph_dirty.begin(); i != _route_graph_dirty.end(); ++i) {
+				boost::shared_ptr<Route> dr = i->lock ();
+				if (dr) {
+					dirty.insert (dr);
+				}
+			}
+			_route_graph_dirty.clear ();
+			_route_graph_all_dirty = false;
+		}
+
+		resort_routes_using (r, all_dirty ? 0 : &dirty);
 		/* writer goes out of scope and forces update */
 	}
 
@@ -2343,6 +2407,17 @@ Session::resort_routes ()
 
 void
 Session::resort_routes_using (boost::shared_ptr<RouteList> r)
+{
+	resort_routes_using (r, 0);
+}
+
+/** @param r List of routes, in any order.
+ *  @param dirty Routes whose connections must be re-examined; edges between
+ *  any other two routes are taken from the current graph.  If 0, all
+ *  connections are re-examined.
+ */
+void
+Session::resort_routes_using (boost::shared_ptr<RouteList> r, std::set<GraphVertex> const * dirty)
 {
 	/* We are going to build a directed graph of our routes;
 	   this is where the edges of that graph are put.
@@ -2370,6 +2445,17 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 
 			bool via_sends_only;
 
+			if (dirty && dirty->find (*i) == dirty->end () && dirty->find (*j) == dirty->end ()) {
+				/* neither route has changed, so this edge is
+				   the same as it was in the current graph.
+				*/
+				if (_current_route_graph.has (*j, *i, &via_sends_only)) {
+					edges.add (*j, *i, via_sends_only);
+					(*i)->add_fed_by (*j, via_sends_only);
+				}
+				continue;
+			}
+
 			/* See if this *j feeds *i according to the current state of the JACK
 			   connections and internal sends.
 			*/
@@ -2397,6 +2483,7 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 		}
 
 		_current_route_graph = edges;
+		_current_route_graph_size = r->size ();
 
 		/* Complete the building of the routes' lists of what directly
 		   or indirectly feeds them.
@@ -2424,8 +2511,16 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 		   do trace_terminal here, as it would fail due to an endless recursion,
 		   so the solo code will think that everything is still connected
 		   as it was before.
+
+		   The old graph no longer matches the connections, so the
+		   next sort has to look at all of them.
 		*/
 
+		{
+			Glib::Threads::Mutex::Lock lm (_route_graph_dirty_lock);
+			_route_graph_all_dirty = true;
+		}
+
 		FeedbackDetected (); /* EMIT SIGNAL */
 	}
 
@@ -3582,7 +3677,7 @@ Session::add_routes_inner (RouteList& new_routes, bool input_auto_connect, bool
 			r->mute_control()->Changed.connect_same_thread (*this, boost::bind (&Session::route_mute_changed, this));
 
 			r->output()->changed.connect_same_thread (*this, boost::bind (&Session::set_worst_io_latencies_x, this, _1, _2));
-			r->processors_changed.connect_same_thread (*this, boost::bind (&Session::route_processors_changed, this, _1));
+			r->processors_changed.connect_same_thread (*this, boost::bind (&Session::route_processors_changed, this, _1, boost::weak_ptr<Route> (r)));
 			r->processor_latency_changed.connect_same_thread (*this, boost::bind (&Session::queue_latency_recompute, this));
 
 			if (r->is_master()) {
@@ -3726,6 +3821,9 @@ Session::globally_add_internal_sends (boost::shared_ptr<Route> dest, Placement p
 void
 Session::add_internal_sends (boost::shared_ptr<Route> dest, Placement p, boost::shared_ptr<RouteList> senders)
 {
+	/* sort the graph once, rather than after each send */
+	GraphChangeBlocker gcb (this);
+
 	for (RouteList::iterator i = senders->begin(); i != senders->end(); ++i) {
 		add_internal_send (dest, (*i)->before_processor_for_placement (p), *i);
 	}
@@ -5685,6 +5783,10 @@ Session::graph_reordered ()
 		return;
 	}
 
+	if (graph_change_deferred (&_graph_change_pending)) {
+		return;
+	}
+
 	/* every track/bus asked for this to be handled but it was deferred because
 	   we were connecting. do it now.
 	*/
@@ -6827,6 +6929,10 @@ Session::update_latency (bool playback)
 		return;
 	}
 
+	if (graph_change_deferred (&_latency_change_pending)) {
+		return;
+	}
+
 	boost::shared_ptr<RouteList> r = routes.reader ();
 	framecnt_t max_latency = 0;
 
@@ -6978,6 +7084,10 @@ Session::update_latency_compensation (bool force_whole_graph)
 		return;
 	}
 
+	if (graph_change_deferred (&_latency_change_pending)) {
+		return;
+	}
+
 	DEBUG_TRACE(DEBUG::Latency, "---------------------------- update latency compensation\n\n");
 
 	_worst_track_latency = 0;
@@ -7158,6 +7268,50 @@ Session::auto_connect_thread_wakeup ()
 	}
 }
 
+/** If a GraphChangeBlocker exists, note that some work is needed when the
+ *  last one goes away.
+ *  @param pending Flag to set.
+ *  @return true if the caller should not do the work now.
+ */
+bool
+Session::graph_change_deferred (gint* pending)
+{
+	if (g_atomic_int_get (&_ignore_graph_changes) == 0) {
+		return false;
+	}
+
+	g_atomic_int_set (pending, 1);
+
+	/* the last blocker may have gone away since we checked, without
+	   seeing the flag; if so, whoever clears it does the work.
+	*/
+	if (g_atomic_int_get (&_ignore_graph_changes) == 0 && g_atomic_int_compare_and_exchange (pending, 1, 0)) {
+		return false;
+	}
+
+	return true;
+}
+
+void
+Session::graph_changes_unblocked ()
+{
+	/* graph_reordered() re-sorts everything, so a deferred partial
+	   re-sort is not needed as well.
+	*/
+	const bool reordered = g_atomic_int_compare_and_exchange (&_graph_change_pending, 1, 0);
+	const bool resort = g_atomic_int_compare_and_exchange (&_resort_pending, 1, 0);
+
+	if (reordered) {
+		graph_reordered ();
+	} else if (resort) {
+		resort_dirty_routes ();
+	}
+
+	if (g_atomic_int_compare_and_exchange (&_latency_change_pending, 1, 0)) {
+		update_latency_compensation (true);
+	}
+}
+
 void
 Session::queue_latency_recompute ()
 {
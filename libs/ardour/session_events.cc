@@ -24,6 +24,7 @@
 #include "pbd/enumwriter.h"
 #include "pbd/stacktrace.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/rt_arena.h"
 
 #include "ardour/debug.h"
 #include "ardour/session_event.h"
@@ -76,6 +77,16 @@ void *
 SessionEvent::operator new (size_t)
 {
 	CrossThreadPool* p = pool->per_thread_pool ();
+
+	if (p->available () == 0 && p->pending_size () == 0) {
+		/* pool exhausted: use this thread's realtime arena rather than
+		 * giving up.  RTArena's stats will show that this happened.
+		 */
+		SessionEvent* ev = static_cast<SessionEvent*> (rt_alloc (sizeof (SessionEvent)));
+		ev->own_pool = 0;
+		return ev;
+	}
+
 	SessionEvent* ev = static_cast<SessionEvent*> (p->alloc ());
 	DEBUG_TRACE (DEBUG::SessionEvents, string_compose ("%1 Allocating SessionEvent from %2 ev @ %3 pool size %4 free %5 used %6\n", pthread_name(), p->name(), ev,
 	                                                   p->total(), p->available(), p->used()));
@@ -90,6 +101,11 @@ SessionEvent::operator delete (void *ptr, size_t /*size*/)
 	Pool* p = pool->per_thread_pool (false);
 	SessionEvent* ev = static_cast<SessionEvent*> (ptr);
 
+	if (!ev->own_pool) {
+		rt_free (ptr);
+		return;
+	}
+
 	DEBUG_TRACE (DEBUG::SessionEvents, string_compose (
 		             "%1 Deleting SessionEvent @ %2 type %3 action %4 ev thread pool = %5 ev pool = %6 size %7 free %8 used %9\n",
 		             pthread_name(), ev, enum_2_string (ev->type), enum_2_string (ev->action), p->name(), ev->own_pool->name(), ev->own_pool->total(), ev->own_pool->available(), ev->own_pool->used()
@@ -147,8 +163,14 @@ SessionEventManager::clear_events (SessionEvent::Type type, boost::function<void
 	*/
 
 	ev->event_loop = PBD::EventLoop::get_event_loop_for_thread ();
-	if (ev->event_loop) {
+	if (ev->event_loop && ev->event_pool()) {
 		ev->rt_return = boost::bind (&CrossThreadPool::flush_pending_with_ev, ev->event_pool(), _1);
+	} else {
+		/* no pool (the event came from the realtime arena, which needs
+		   no flushing) or nowhere to flush it from: merge_event() will
+		   just delete it.
+		*/
+		ev->event_loop = 0;
 	}
 
 	queue_event (ev);
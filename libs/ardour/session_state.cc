@@ -126,6 +126,7 @@
 #include "ardour/sndfilesource.h"
 #include "ardour/source_factory.h"
 #include "ardour/speakers.h"
+#include "ardour/state_sidecar.h"
 #include "ardour/template_utils.h"
 #include "ardour/tempo.h"
 #include "ardour/ticker.h"
@@ -195,6 +196,7 @@ Session::pre_engine_init (string fullpath)
 	last_rr_session_dir = session_dirs.begin();
 
 	set_history_depth (Config->get_history_depth());
+	_history.set_memory_budget ((size_t) Config->get_history_memory_budget() * 1024 * 1024);
 
 	/* default: assume simple stereo speaker configuration */
 
@@ -791,7 +793,6 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 {
 	DEBUG_TRACE (DEBUG::Locale, string_compose ("Session::save_state locale '%1'\n", setlocale (LC_NUMERIC, NULL)));
 
-	XMLTree tree;
 	std::string xml_path(_session_dir->root_path());
 
 	/* prevent concurrent saves from different threads */
@@ -808,6 +809,11 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 	}
 	_save_queued = false;
 
+	/* the files written by the previous save may be the ones
+	 * that we are about to back up or replace.
+	 */
+	wait_for_state_writer ();
+
 	snapshot_t fork_state = NormalSave;
 	if (!snapshot_name.empty() && snapshot_name != _current_snapshot_name && !template_only && !pending) {
 		/* snapshot, close midi */
@@ -836,11 +842,22 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		mark_as_clean = false;
 	}
 
+	StateWrite* sw = new StateWrite;
+	sw->tree = new XMLTree;
+
+	/* bulk data goes into a sidecar only for proper saves: templates
+	 * must stay self-contained, and pending state is short lived.
+	 */
+	if (!template_only && !pending && Config->get_state_sidecar_threshold() > 0) {
+		sw->sidecar = new StateSidecar (Config->get_state_sidecar_threshold());
+	}
+
 	if (template_only) {
 		mark_as_clean = false;
-		tree.set_root (&get_template());
+		sw->tree->set_root (&get_template());
 	} else {
-		tree.set_root (&state (true, fork_state));
+		StateSidecar::Use su (sw->sidecar);
+		sw->tree->set_root (&state (true, fork_state));
 	}
 
 	if (snapshot_name.empty()) {
@@ -861,6 +878,7 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 		if (Glib::file_test (xml_path, Glib::FILE_TEST_EXISTS) && !create_backup_file (xml_path)) {
 			// create_backup_file will log the error
+			delete sw;
 			return -1;
 		}
 
@@ -873,55 +891,255 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 	std::string tmp_path(_session_dir->root_path());
 	tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
 
-	cerr << "actually writing state to " << tmp_path << endl;
+	sw->xml_path = xml_path;
+	sw->tmp_path = tmp_path;
+
+	if (sw->sidecar && !sw->sidecar->empty()) {
+		/* every sidecar gets a new name, so that the state file being
+		 * replaced (and its backup) still find the one they refer to.
+		 */
+		const std::string sidecar_name = string_compose ("%1.%2%3", legalize_for_path (snapshot_name), g_get_real_time (), sidecar_suffix);
+		sw->sidecar_path = Glib::build_filename (_session_dir->root_path(), sidecar_name);
+		sw->snapshot_name = legalize_for_path (snapshot_name);
+		sw->tree->root()->set_property (X_("sidecar"), sidecar_name);
+	} else if (!pending && !template_only) {
+		sw->snapshot_name = legalize_for_path (snapshot_name);
+	}
+
+	/* Proper saves of the current snapshot can be written in the background:
+	 * the tree is a complete copy of the state, so nothing else needs to wait
+	 * for it.  Everything else (snapshots, templates, pending state) is
+	 * written before returning, because callers go on to use the file.
+	 */
+	bool background = Config->get_background_session_save() && !pending && !template_only && fork_state == NormalSave;
+
+	if (background) {
+		/* the save is completed (session marked clean, StateSaved emitted)
+		 * in this thread once the file has been written, which requires
+		 * an event loop to get back here.
+		 */
+		sw->event_loop = PBD::EventLoop::get_event_loop_for_thread ();
+		sw->saved_name = snapshot_name;
+		sw->mark_as_clean = mark_as_clean;
+		sw->dirty_generation = g_atomic_int_get (&_dirty_generation);
+		background = sw->event_loop != 0;
+	}
+
+	if (background) {
+		_state_write = sw;
+		_state_writer_running = true;
+		if (pthread_create (&_state_writer_thread, NULL, state_writer_thread, this)) {
+			_state_writer_running = false;
+			_state_write = 0;
+			background = false;
+			if (write_state (*sw)) {
+				delete sw;
+				return -1;
+			}
+			delete sw;
+		}
+	} else {
+		const int ret = write_state (*sw);
+		delete sw;
+		if (ret) {
+			return -1;
+		}
+	}
+
+	if (!pending) {
+
+		save_history (snapshot_name);
 
-	if (!tree.write (tmp_path)) {
-		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
-		if (g_remove (tmp_path.c_str()) != 0) {
+		if (!background) {
+			state_saved (snapshot_name, mark_as_clean);
+		}
+	}
+
+#ifndef NDEBUG
+	const int64_t elapsed_time_us = g_get_monotonic_time() - save_start_time;
+	cerr << "saved state in " << fixed << setprecision (1) << elapsed_time_us / 1000. << " ms" << (background ? " (writing in background)" : "") << "\n";
+#endif
+	return 0;
+}
+
+Session::StateWrite::~StateWrite ()
+{
+	delete tree;
+	delete sidecar;
+}
+
+/** Write a state file, and its sidecar if there is one.  Called with
+ *  save_state_lock held, or from the state writer thread.
+ *  @return 0 on success.
+ */
+int
+Session::write_state (StateWrite& sw)
+{
+	if (sw.sidecar && !sw.sidecar_path.empty()) {
+		/* the sidecar has a new name, so it can be written in place */
+		if (sw.sidecar->write (sw.sidecar_path)) {
+			::g_unlink (sw.sidecar_path.c_str());
+			return -1;
+		}
+	}
+
+	cerr << "actually writing state to " << sw.tmp_path << endl;
+
+	if (!sw.tree->write (sw.tmp_path)) {
+		error << string_compose (_("state could not be saved to %1"), sw.tmp_path) << endmsg;
+		if (g_remove (sw.tmp_path.c_str()) != 0) {
 			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-					tmp_path, g_strerror (errno)) << endmsg;
+					sw.tmp_path, g_strerror (errno)) << endmsg;
+		}
+		if (!sw.sidecar_path.empty()) {
+			::g_unlink (sw.sidecar_path.c_str());
 		}
 		return -1;
 
 	} else {
 
-		cerr << "renaming state to " << xml_path << endl;
+		cerr << "renaming state to " << sw.xml_path << endl;
 
-		if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
+		if (::g_rename (sw.tmp_path.c_str(), sw.xml_path.c_str()) != 0) {
 			error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
-					tmp_path, xml_path, g_strerror(errno)) << endmsg;
-			if (g_remove (tmp_path.c_str()) != 0) {
+					sw.tmp_path, sw.xml_path, g_strerror(errno)) << endmsg;
+			if (g_remove (sw.tmp_path.c_str()) != 0) {
 				error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-						tmp_path, g_strerror (errno)) << endmsg;
+						sw.tmp_path, g_strerror (errno)) << endmsg;
+			}
+			if (!sw.sidecar_path.empty()) {
+				::g_unlink (sw.sidecar_path.c_str());
 			}
 			return -1;
 		}
 	}
 
-	if (!pending) {
+	if (sw.snapshot_name.empty()) {
+		return 0;
+	}
 
-		save_history (snapshot_name);
+	/* Remove sidecars which no state file refers to any more.  Apart from
+	 * the new one, keep the most recent older one: the backup of the
+	 * previous state file refers to it.
+	 */
 
-		if (mark_as_clean) {
-			bool was_dirty = dirty();
+	const std::string dir = Glib::path_get_dirname (sw.xml_path);
+	const std::string prefix = sw.snapshot_name + '.';
+	const std::string current = Glib::path_get_basename (sw.sidecar_path);
+	std::map<uint64_t, std::string> older;
 
-			_state_of_the_state = StateOfTheState (_state_of_the_state & ~Dirty);
+	try {
+		Glib::Dir d (dir);
 
-			if (was_dirty) {
-				DirtyChanged (); /* EMIT SIGNAL */
+		for (Glib::DirIterator di = d.begin(); di != d.end(); di++) {
+			const std::string name = *di;
+
+			if (name == current ||
+			    name.size() <= prefix.size() + strlen (sidecar_suffix) ||
+			    name.compare (0, prefix.size(), prefix) ||
+			    name.compare (name.size() - strlen (sidecar_suffix), string::npos, sidecar_suffix)) {
+				continue;
 			}
+
+			const std::string stamp = name.substr (prefix.size(), name.size() - prefix.size() - strlen (sidecar_suffix));
+
+			if (stamp.find_first_not_of ("0123456789") != string::npos) {
+				/* some other snapshot whose name starts with ours */
+				continue;
+			}
+
+			older[PBD::string_to<uint64_t> (stamp)] = name;
 		}
+	} catch (Glib::FileError const& e) {
+		return 0;
+	}
 
-		StateSaved (snapshot_name); /* EMIT SIGNAL */
+	if (!older.empty()) {
+		older.erase (--older.end());
+	}
+
+	for (std::map<uint64_t, std::string>::const_iterator i = older.begin(); i != older.end(); ++i) {
+		::g_unlink (Glib::build_filename (dir, i->second).c_str());
 	}
 
-#ifndef NDEBUG
-	const int64_t elapsed_time_us = g_get_monotonic_time() - save_start_time;
-	cerr << "saved state in " << fixed << setprecision (1) << elapsed_time_us / 1000. << " ms\n";
-#endif
 	return 0;
 }
 
+void*
+Session::state_writer_thread (void* arg)
+{
+	Session* s = static_cast<Session*> (arg);
+	StateWrite* sw = s->_state_write;
+
+	pthread_set_name (X_("StateWriter"));
+
+	const int result = write_state (*sw);
+
+	/* complete the save in the thread that started it */
+	sw->event_loop->call_slot (MISSING_INVALIDATOR,
+			boost::bind (&Session::state_write_done, s->_state_write_alive, s,
+				sw->saved_name, sw->mark_as_clean, sw->dirty_generation, result));
+
+	delete sw;
+
+	pthread_exit (0);
+	return 0;
+}
+
+/** Called in the thread that started a background save, once the
+ *  state file has been written (or failed to be).
+ */
+void
+Session::state_write_done (boost::shared_ptr<bool> alive, Session* s, std::string snapshot_name, bool mark_as_clean, gint dirty_generation, int result)
+{
+	if (!*alive) {
+		return;
+	}
+
+	if (result) {
+		/* write_state() logged the details; the session stays dirty */
+		error << string_compose (_("Session state \"%1\" could not be saved"), snapshot_name) << endmsg;
+		return;
+	}
+
+	/* don't mark changes made while the file was written as saved */
+	s->state_saved (snapshot_name, mark_as_clean && g_atomic_int_get (&s->_dirty_generation) == dirty_generation);
+}
+
+/** Mark the session clean after it was saved, and tell the world */
+void
+Session::state_saved (std::string const& snapshot_name, bool mark_as_clean)
+{
+	if (mark_as_clean) {
+		bool was_dirty = dirty();
+
+		_state_of_the_state = StateOfTheState (_state_of_the_state & ~Dirty);
+
+		if (was_dirty) {
+			DirtyChanged (); /* EMIT SIGNAL */
+		}
+	}
+
+	StateSaved (snapshot_name); /* EMIT SIGNAL */
+}
+
+/** Wait for a state file that is being written in the background.
+ *  Must be called with save_state_lock held.
+ */
+void
+Session::wait_for_state_writer ()
+{
+	if (!_state_writer_running) {
+		return;
+	}
+
+	void* status;
+	pthread_join (_state_writer_thread, &status);
+
+	_state_writer_running = false;
+	_state_write = 0;
+}
+
 int
 Session::restore_state (string snapshot_name)
 {
@@ -1491,6 +1709,9 @@ Session::set_state (const XMLNode& node, int version)
 	XMLNodeList nlist;
 	XMLNode* child;
 	int ret = -1;
+	std::string sidecar_name;
+	StateSidecar sidecar;
+	StateSidecar::Use su (&sidecar);
 
 	_state_of_the_state = StateOfTheState (_state_of_the_state|CannotSave);
 
@@ -1499,6 +1720,11 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	if (node.get_property (X_("sidecar"), sidecar_name)) {
+		/* objects which refer to data in it will report what is missing */
+		sidecar.read (Glib::build_filename (_session_dir->root_path(), sidecar_name));
+	}
+
 	node.get_property ("name", _name);
 
 	if (node.get_property (X_("sample-rate"), _base_frame_rate)) {
@@ -3576,6 +3802,8 @@ Session::cleanup_trash_sources (CleanupReport& rep)
 void
 Session::set_dirty ()
 {
+	g_atomic_int_inc (&_dirty_generation);
+
 	/* return early if there's nothing to do */
 	if (dirty ()) {
 		return;
@@ -4156,6 +4384,8 @@ Session::config_changed (std::string p, bool ours)
 		setup_fpu ();
 	} else if (p == "history-depth") {
 		set_history_depth (Config->get_history_depth());
+	} else if (p == "history-memory-budget") {
+		_history.set_memory_budget ((size_t) Config->get_history_memory_budget() * 1024 * 1024);
 	} else if (p == "remote-model") {
 		/* XXX DO SOMETHING HERE TO TELL THE GUI THAT WE NEED
 		   TO SET REMOTE ID'S
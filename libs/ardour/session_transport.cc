@@ -2098,7 +2098,7 @@ Session::xrun_recovery ()
 }
 
 void
-Session::route_processors_changed (RouteProcessorChange c)
+Session::route_processors_changed (RouteProcessorChange c, boost::weak_ptr<Route> wr)
 {
 	if (g_atomic_int_get (&_ignore_route_processor_changes) > 0) {
 		return;
@@ -2115,7 +2115,12 @@ Session::route_processors_changed (RouteProcessorChange c)
 	}
 
 	update_latency_compensation ();
-	resort_routes ();
+
+	/* only the connections of the route whose processors changed need
+	   to be looked at again; if we don't know which it was, look at all.
+	*/
+	mark_route_graph_dirty (wr.lock ());
+	resort_dirty_routes ();
 
 	set_dirty ();
 }
@@ -136,9 +136,7 @@ SlavableAutomationControl::masters_curve_multiply (framepos_t start, framepos_t
 	bool from_list = _list && boost::dynamic_pointer_cast<AutomationList>(_list)->automation_playback();
 	bool rv = from_list && list()->curve().rt_safe_get_vector (start, end, scratch, veclen);
 	if (rv) {
-		for (framecnt_t i = 0; i < veclen; ++i) {
-			vec[i] *= scratch[i];
-		}
+		apply_gain_curve (vec, scratch, veclen);
 	} else {
 		apply_gain_to_buffer (vec, veclen, Control::get_double ());
 	}
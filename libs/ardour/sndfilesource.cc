@@ -568,16 +568,10 @@ SndFileSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) con
 
 	/* stride through the interleaved data */
 
+	deinterleave_channel (dst, ptr, nread, _info.channels);
+
 	if (_gain != 1.f) {
-		for (framecnt_t n = 0; n < nread; ++n) {
-			dst[n] = *ptr * _gain;
-			ptr += _info.channels;
-		}
-	} else {
-		for (framecnt_t n = 0; n < nread; ++n) {
-			dst[n] = *ptr;
-			ptr += _info.channels;
-		}
+		apply_gain_to_buffer (dst, nread, _gain);
 	}
 
 	return nread;
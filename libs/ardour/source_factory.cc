@@ -24,6 +24,7 @@
 
 #include "pbd/error.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/stacktrace.h"
 
@@ -32,6 +33,7 @@
 #include "ardour/boost_debug.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_playlist_source.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/source.h"
 #include "ardour/source_factory.h"
 #include "ardour/sndfilesource.h"
@@ -102,7 +104,17 @@ SourceFactory::peak_work_queue_length ()
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	uint32_t n_threads = Config->get_peak_building_threads ();
+
+	if (n_threads == 0) {
+		/* peaks for different sources are built in parallel, but it is
+		 * mostly disk-bound work: beyond a few threads they just compete
+		 * for the same disk.
+		 */
+		n_threads = max (2U, min (8U, hardware_concurrency ()));
+	}
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
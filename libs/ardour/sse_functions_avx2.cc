@@ -0,0 +1,286 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* AVX2 + FMA versions of the runtime mix functions.
+ *
+ * This file is compiled with -mavx2 -mfma and must only be called after
+ * PBD::FPU has confirmed that the CPU (and OS) support both.
+ *
+ * Buffers do not need to be aligned: unaligned loads and stores cost the
+ * same as aligned ones on every CPU that has AVX2, as long as the data does
+ * not actually straddle a cache line, so the loops do not bother to peel
+ * off an unaligned head.
+ */
+
+#include <immintrin.h>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+static inline float
+hmax256 (__m256 v)
+{
+	__m128 m = _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_max_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_max_ss (m, _mm_shuffle_ps (m, m, 1));
+	return _mm_cvtss_f32 (m);
+}
+
+static inline float
+hmin256 (__m256 v)
+{
+	__m128 m = _mm_min_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	m = _mm_min_ps (m, _mm_movehl_ps (m, m));
+	m = _mm_min_ss (m, _mm_shuffle_ps (m, m, 1));
+	return _mm_cvtss_f32 (m);
+}
+
+float
+x86_avx2_compute_peak (const float * buf, uint32_t nsamples, float current)
+{
+	const __m256 abs_mask = _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff));
+	__m256 vmax0 = _mm256_set1_ps (current);
+	__m256 vmax1 = vmax0;
+
+	/* two accumulators hide the latency of maxps */
+	while (nsamples >= 16) {
+		vmax0 = _mm256_max_ps (vmax0, _mm256_and_ps (_mm256_loadu_ps (buf), abs_mask));
+		vmax1 = _mm256_max_ps (vmax1, _mm256_and_ps (_mm256_loadu_ps (buf + 8), abs_mask));
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	if (nsamples >= 8) {
+		vmax0 = _mm256_max_ps (vmax0, _mm256_and_ps (_mm256_loadu_ps (buf), abs_mask));
+		buf += 8;
+		nsamples -= 8;
+	}
+
+	current = hmax256 (_mm256_max_ps (vmax0, vmax1));
+
+	while (nsamples--) {
+		current = std::max (current, fabsf (*buf));
+		++buf;
+	}
+
+	return current;
+}
+
+void
+x86_avx2_find_peaks (const float * buf, uint32_t nframes, float *min, float *max)
+{
+	__m256 vmin = _mm256_set1_ps (*min);
+	__m256 vmax = _mm256_set1_ps (*max);
+
+	while (nframes >= 8) {
+		const __m256 work = _mm256_loadu_ps (buf);
+		vmin = _mm256_min_ps (vmin, work);
+		vmax = _mm256_max_ps (vmax, work);
+		buf += 8;
+		nframes -= 8;
+	}
+
+	float a = hmax256 (vmax);
+	float b = hmin256 (vmin);
+
+	while (nframes--) {
+		a = std::max (a, *buf);
+		b = std::min (b, *buf);
+		++buf;
+	}
+
+	*max = a;
+	*min = b;
+}
+
+void
+x86_avx2_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
+{
+	const __m256 vgain = _mm256_set1_ps (gain);
+
+	while (nframes >= 8) {
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), vgain));
+		buf += 8;
+		nframes -= 8;
+	}
+
+	while (nframes--) {
+		*buf++ *= gain;
+	}
+}
+
+void
+x86_avx2_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m256 vgain = _mm256_set1_ps (gain);
+
+	while (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_fmadd_ps (_mm256_loadu_ps (src), vgain, _mm256_loadu_ps (dst)));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes--) {
+		*dst++ += *src++ * gain;
+	}
+}
+
+void
+x86_avx2_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_add_ps (_mm256_loadu_ps (src), _mm256_loadu_ps (dst)));
+		dst += 8;
+		src += 8;
+		nframes -= 8;
+	}
+
+	while (nframes--) {
+		*dst++ += *src++;
+	}
+}
+
+void
+x86_avx2_copy_vector (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm256_storeu_ps (dst, _mm256_loadu_ps (src));
+		_mm256_storeu_ps (dst + 8, _mm256_loadu_ps (src + 8));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		memcpy (dst, src, nframes * sizeof (float));
+	}
+}
+
+void
+x86_avx2_apply_gain_ramp (float * buf, uint32_t nframes, float g0, float g1)
+{
+	const float step = (g1 - g0) / nframes;
+	const __m256 vstep = _mm256_set1_ps (step);
+	const __m256 vg0 = _mm256_set1_ps (g0);
+	const __m256 eight = _mm256_set1_ps (8.f);
+	/* index of each lane; exact in float for any realistic buffer size */
+	__m256 vidx = _mm256_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+	uint32_t i = 0;
+
+	for (; i + 8 <= nframes; i += 8) {
+		const __m256 g = _mm256_fmadd_ps (vidx, vstep, vg0);
+		_mm256_storeu_ps (buf + i, _mm256_mul_ps (_mm256_loadu_ps (buf + i), g));
+		vidx = _mm256_add_ps (vidx, eight);
+	}
+
+	for (; i < nframes; ++i) {
+		buf[i] *= g0 + step * i;
+	}
+}
+
+void
+x86_avx2_interleave_channel (float * dst, const float * src, uint32_t nframes, uint32_t nchannels)
+{
+	if (nchannels == 1) {
+		x86_avx2_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	/* AVX2 has no scatter; let the compiler do its best */
+	default_interleave_channel (dst, src, nframes, nchannels);
+}
+
+void
+x86_avx2_deinterleave_channel (float * dst, const float * src, uint32_t nframes, uint32_t nchannels)
+{
+	if (nchannels == 1) {
+		x86_avx2_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m256i vindex = _mm256_mullo_epi32 (_mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32 (nchannels));
+	const size_t block_stride = 8 * (size_t) nchannels;
+
+	while (nframes >= 8) {
+		_mm256_storeu_ps (dst, _mm256_i32gather_ps (src, vindex, 4));
+		dst += 8;
+		src += block_stride;
+		nframes -= 8;
+	}
+
+	while (nframes--) {
+		*dst++ = *src;
+		src += nchannels;
+	}
+}
+
+void
+x86_avx2_apply_gain_curve (float * buf, const float * gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), _mm256_loadu_ps (gain)));
+		_mm256_storeu_ps (buf + 8, _mm256_mul_ps (_mm256_loadu_ps (buf + 8), _mm256_loadu_ps (gain + 8)));
+		buf += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	while (nframes--) {
+		*buf++ *= *gain++;
+	}
+}
+
+float
+x86_avx2_apply_gain_lpf (float * buf, uint32_t nframes, float g0, float g1, float a)
+{
+	/* g[i] = g1 + (g0 - g1) * r^i, with r = 1 - a, is the closed form of
+	 * the recursion in default_apply_gain_lpf(). The distance to the target
+	 * is carried in double precision from one block of 8 to the next, so
+	 * that rounding does not build up over long buffers.
+	 */
+	const double r = 1.0 - a;
+	float rk[8];
+	double r8 = 1.0;
+	for (int k = 0; k < 8; ++k) {
+		rk[k] = r8;
+		r8 *= r;
+	}
+
+	const __m256 vrk = _mm256_loadu_ps (rk);
+	const __m256 vg1 = _mm256_set1_ps (g1);
+	double d = (double) g0 - g1;
+
+	while (nframes >= 8) {
+		const __m256 g = _mm256_fmadd_ps (_mm256_set1_ps ((float) d), vrk, vg1);
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), g));
+		d *= r8;
+		buf += 8;
+		nframes -= 8;
+	}
+
+	while (nframes--) {
+		*buf++ *= g1 + d;
+		d *= r;
+	}
+
+	return g1 + d;
+}
@@ -0,0 +1,282 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+/* AVX-512F versions of the runtime mix functions.
+ *
+ * This file is compiled with -mavx512f and must only be called after
+ * PBD::FPU has confirmed that the CPU (and OS) support it.
+ *
+ * The last, partial vector of each buffer is handled with masked loads and
+ * stores, so there are no scalar tail loops.
+ */
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "ardour/mix.h"
+
+static inline __mmask16
+tail_mask (uint32_t n)
+{
+	return (__mmask16) ((1U << n) - 1);
+}
+
+float
+x86_avx512f_compute_peak (const float * buf, uint32_t nsamples, float current)
+{
+	__m512 vmax0 = _mm512_set1_ps (current);
+	__m512 vmax1 = vmax0;
+
+	while (nsamples >= 32) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		vmax1 = _mm512_max_ps (vmax1, _mm512_abs_ps (_mm512_loadu_ps (buf + 16)));
+		buf += 32;
+		nsamples -= 32;
+	}
+
+	if (nsamples >= 16) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (buf)));
+		buf += 16;
+		nsamples -= 16;
+	}
+
+	if (nsamples) {
+		/* masked-off lanes load as 0, which cannot raise the peak */
+		vmax1 = _mm512_max_ps (vmax1, _mm512_abs_ps (_mm512_maskz_loadu_ps (tail_mask (nsamples), buf)));
+	}
+
+	return _mm512_reduce_max_ps (_mm512_max_ps (vmax0, vmax1));
+}
+
+void
+x86_avx512f_find_peaks (const float * buf, uint32_t nframes, float *min, float *max)
+{
+	__m512 vmin = _mm512_set1_ps (*min);
+	__m512 vmax = _mm512_set1_ps (*max);
+
+	while (nframes >= 16) {
+		const __m512 work = _mm512_loadu_ps (buf);
+		vmin = _mm512_min_ps (vmin, work);
+		vmax = _mm512_max_ps (vmax, work);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 work = _mm512_maskz_loadu_ps (m, buf);
+		/* only the loaded lanes take part */
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, work);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, work);
+	}
+
+	*max = _mm512_reduce_max_ps (vmax);
+	*min = _mm512_reduce_min_ps (vmin);
+}
+
+void
+x86_avx512f_apply_gain_to_buffer (float * buf, uint32_t nframes, float gain)
+{
+	const __m512 vgain = _mm512_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), vgain));
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), vgain));
+	}
+}
+
+void
+x86_avx512f_mix_buffers_with_gain (float * dst, const float * src, uint32_t nframes, float gain)
+{
+	const __m512 vgain = _mm512_set1_ps (gain);
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_fmadd_ps (_mm512_loadu_ps (src), vgain, _mm512_loadu_ps (dst)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, src), vgain, _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+void
+x86_avx512f_mix_buffers_no_gain (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (src), _mm512_loadu_ps (dst)));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, src), _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+void
+x86_avx512f_copy_vector (float * dst, const float * src, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+		dst += 16;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+}
+
+void
+x86_avx512f_apply_gain_ramp (float * buf, uint32_t nframes, float g0, float g1)
+{
+	const __m512 vstep = _mm512_set1_ps ((g1 - g0) / nframes);
+	const __m512 vg0 = _mm512_set1_ps (g0);
+	const __m512 sixteen = _mm512_set1_ps (16.f);
+	/* index of each lane; exact in float for any realistic buffer size */
+	__m512 vidx = _mm512_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f);
+
+	while (nframes >= 16) {
+		const __m512 g = _mm512_fmadd_ps (vidx, vstep, vg0);
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		vidx = _mm512_add_ps (vidx, sixteen);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 g = _mm512_fmadd_ps (vidx, vstep, vg0);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+	}
+}
+
+void
+x86_avx512f_interleave_channel (float * dst, const float * src, uint32_t nframes, uint32_t nchannels)
+{
+	if (nchannels == 1) {
+		x86_avx512f_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m512i vindex = _mm512_mullo_epi32 (_mm512_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32 (nchannels));
+	const size_t block_stride = 16 * (size_t) nchannels;
+
+	while (nframes >= 16) {
+		_mm512_i32scatter_ps (dst, vindex, _mm512_loadu_ps (src), 4);
+		dst += block_stride;
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_i32scatter_ps (dst, m, vindex, _mm512_maskz_loadu_ps (m, src), 4);
+	}
+}
+
+void
+x86_avx512f_deinterleave_channel (float * dst, const float * src, uint32_t nframes, uint32_t nchannels)
+{
+	if (nchannels == 1) {
+		x86_avx512f_copy_vector (dst, src, nframes);
+		return;
+	}
+
+	const __m512i vindex = _mm512_mullo_epi32 (_mm512_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32 (nchannels));
+	const size_t block_stride = 16 * (size_t) nchannels;
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_i32gather_ps (vindex, src, 4));
+		dst += 16;
+		src += block_stride;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mask_i32gather_ps (_mm512_setzero_ps (), m, vindex, src, 4));
+	}
+}
+
+void
+x86_avx512f_apply_gain_curve (float * buf, const float * gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), _mm512_loadu_ps (gain)));
+		buf += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), _mm512_maskz_loadu_ps (m, gain)));
+	}
+}
+
+float
+x86_avx512f_apply_gain_lpf (float * buf, uint32_t nframes, float g0, float g1, float a)
+{
+	/* see x86_avx2_apply_gain_lpf() */
+	const double r = 1.0 - a;
+	float rk[16];
+	double r16 = 1.0;
+	for (int k = 0; k < 16; ++k) {
+		rk[k] = r16;
+		r16 *= r;
+	}
+
+	const __m512 vrk = _mm512_loadu_ps (rk);
+	const __m512 vg1 = _mm512_set1_ps (g1);
+	double d = (double) g0 - g1;
+
+	while (nframes >= 16) {
+		const __m512 g = _mm512_fmadd_ps (_mm512_set1_ps ((float) d), vrk, vg1);
+		_mm512_storeu_ps (buf, _mm512_mul_ps (_mm512_loadu_ps (buf), g));
+		d *= r16;
+		buf += 16;
+		nframes -= 16;
+	}
+
+	if (nframes) {
+		const __mmask16 m = tail_mask (nframes);
+		const __m512 g = _mm512_fmadd_ps (_mm512_set1_ps ((float) d), vrk, vg1);
+		_mm512_mask_storeu_ps (buf, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, buf), g));
+		while (nframes--) {
+			d *= r;
+		}
+	}
+
+	return g1 + d;
+}
@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+
+#include "ardour/state_sidecar.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+/* The file is a header followed by the blocks, stored as native doubles.
+ * There is no byte swapping: a sidecar written on a machine of the other
+ * endianness is rejected, just like any other damaged sidecar.
+ */
+
+namespace {
+
+struct SidecarHeader {
+	char     magic[4];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t reserved;
+};
+
+const char     sidecar_magic[4] = { 'A', 'R', 'S', 'C' };
+const uint32_t sidecar_version = 1;
+const uint32_t sidecar_byte_order = 0x01020304;
+
+void do_not_delete_the_sidecar (void*) { }
+
+}
+
+Glib::Threads::Private<StateSidecar> StateSidecar::_in_this_thread (do_not_delete_the_sidecar);
+
+StateSidecar::StateSidecar (size_t min_values)
+	: _min_values (min_values)
+{
+}
+
+uint64_t
+StateSidecar::add (std::vector<double> const & values)
+{
+	const uint64_t offset = _blocks.size ();
+
+	_blocks.push_back (values.size ());
+	_blocks.insert (_blocks.end(), values.begin(), values.end());
+
+	return offset;
+}
+
+bool
+StateSidecar::get (uint64_t offset, std::vector<double>& values) const
+{
+	if (offset >= _blocks.size ()) {
+		return false;
+	}
+
+	const double len = _blocks[offset];
+
+	if (len < 0 || len > (double) (_blocks.size () - offset - 1)) {
+		return false;
+	}
+
+	std::vector<double>::const_iterator b = _blocks.begin() + offset + 1;
+	values.assign (b, b + (size_t) len);
+
+	return true;
+}
+
+int
+StateSidecar::read (std::string const & path)
+{
+	FILE* f = g_fopen (path.c_str(), "rb");
+
+	if (!f) {
+		error << string_compose (_("Could not open state sidecar %1 (%2)"), path, g_strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	SidecarHeader h;
+
+	if (fread (&h, sizeof (h), 1, f) != 1 ||
+	    memcmp (h.magic, sidecar_magic, sizeof (h.magic)) ||
+	    h.version != sidecar_version ||
+	    h.byte_order != sidecar_byte_order) {
+		error << string_compose (_("%1 is not a state sidecar that this version can read"), path) << endmsg;
+		fclose (f);
+		return -1;
+	}
+
+	_blocks.clear ();
+
+	double buf[1024];
+	size_t n;
+
+	while ((n = fread (buf, sizeof (double), sizeof (buf) / sizeof (double), f)) > 0) {
+		_blocks.insert (_blocks.end(), buf, buf + n);
+	}
+
+	const bool failed = ferror (f);
+	fclose (f);
+
+	if (failed) {
+		error << string_compose (_("Could not read state sidecar %1"), path) << endmsg;
+		_blocks.clear ();
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+StateSidecar::write (std::string const & path) const
+{
+	FILE* f = g_fopen (path.c_str(), "wb");
+
+	if (!f) {
+		error << string_compose (_("Could not create state sidecar %1 (%2)"), path, g_strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	SidecarHeader h;
+	memcpy (h.magic, sidecar_magic, sizeof (h.magic));
+	h.version = sidecar_version;
+	h.byte_order = sidecar_byte_order;
+	h.reserved = 0;
+
+	bool ok = fwrite (&h, sizeof (h), 1, f) == 1;
+
+	if (ok && !_blocks.empty ()) {
+		ok = fwrite (&_blocks[0], sizeof (double), _blocks.size (), f) == _blocks.size ();
+	}
+
+	if (fclose (f) != 0) {
+		ok = false;
+	}
+
+	if (!ok) {
+		error << string_compose (_("Could not write state sidecar %1 (%2)"), path, g_strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	return 0;
+}
+
+StateSidecar*
+StateSidecar::in_this_thread ()
+{
+	return _in_this_thread.get ();
+}
+
+StateSidecar::Use::Use (StateSidecar* s)
+	: _previous (_in_this_thread.get ())
+{
+	_in_this_thread.set (s);
+}
+
+StateSidecar::Use::~Use ()
+{
+	_in_this_thread.set (_previous);
+}
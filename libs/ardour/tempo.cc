@@ -715,7 +715,383 @@ struct MetricSectionFrameSorter {
     }
 };
 
+/* shared by TempoMap and TempoMapPoints once the meter in effect has been found */
+
+static double
+beat_at_bbt_in_meter (const MeterSection& prev_m, const BBT_Time& bbt)
+{
+	const double remaining_bars = bbt.bars - prev_m.bbt().bars;
+	const double remaining_bars_in_beats = remaining_bars * prev_m.divisions_per_bar();
+
+	return remaining_bars_in_beats + prev_m.beat() + (bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat);
+}
+
+static double
+pulse_at_bbt_in_meter (const MeterSection& prev_m, const BBT_Time& bbt)
+{
+	const double remaining_bars = bbt.bars - prev_m.bbt().bars;
+	const double remaining_pulses = remaining_bars * prev_m.divisions_per_bar() / prev_m.note_divisor();
+
+	return remaining_pulses + prev_m.pulse() + (((bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat)) / prev_m.note_divisor());
+}
+
+static BBT_Time
+bbt_in_meter (const MeterSection& prev_m, const double beats_in_ms)
+{
+	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / prev_m.divisions_per_bar());
+	const uint32_t total_bars = bars_in_ms + (prev_m.bbt().bars - 1);
+	const double remaining_beats = beats_in_ms - (bars_in_ms * prev_m.divisions_per_bar());
+	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
+
+	BBT_Time ret;
+
+	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
+	ret.beats = (uint32_t) floor (remaining_beats);
+	ret.bars = total_bars;
+
+	/* 0 0 0 to 1 1 0 - based mapping*/
+	++ret.bars;
+	++ret.beats;
+
+	if (ret.ticks >= BBT_Time::ticks_per_beat) {
+		++ret.beats;
+		ret.ticks -= BBT_Time::ticks_per_beat;
+	}
+
+	if (ret.beats >= prev_m.divisions_per_bar() + 1) {
+		++ret.bars;
+		ret.beats = 1;
+	}
+
+	return ret;
+}
+
+/** Returns the index of the first entry after the first one in @p col
+ *  which is greater than @p x, or the size of @p col if there is none.
+ *
+ *  The first entry is skipped because the metric list walks in TempoMap
+ *  always accept the first section they see.
+ */
+template<typename T> static size_t
+first_after (const std::vector<T>& col, const T x, bool sorted)
+{
+	if (col.size() < 2) {
+		return col.size();
+	}
+
+	if (sorted) {
+		return upper_bound (col.begin() + 1, col.end(), x) - col.begin();
+	}
+
+	for (size_t i = 1; i < col.size(); ++i) {
+		if (col[i] > x) {
+			return i;
+		}
+	}
+
+	return col.size();
+}
+
+TempoMapPoints::TempoMapPoints ()
+	: _sorted (true)
+{
+}
+
+TempoMapPoints::TempoMapPoints (const Metrics& metrics)
+	: _sorted (true)
+{
+	const MeterSection* prev_m = 0;
+
+	for (Metrics::const_iterator i = metrics.begin(); i != metrics.end(); ++i) {
+
+		if ((*i)->is_tempo()) {
+			const TempoSection* t = static_cast<const TempoSection*> (*i);
+
+			if (!t->active()) {
+				continue;
+			}
+
+			if (!_tempos.empty() && (t->minute() < _tempo_minute.back() || t->pulse() < _tempo_pulse.back() || t->frame() < _tempo_frame.back())) {
+				_sorted = false;
+			}
+
+			_tempos.push_back (boost::shared_ptr<const TempoSection> (new TempoSection (*t)));
+			_tempo_minute.push_back (t->minute());
+			_tempo_pulse.push_back (t->pulse());
+			_tempo_frame.push_back (t->frame());
+
+		} else {
+			const MeterSection* m = static_cast<const MeterSection*> (*i);
+			double bars = 0.0;
+
+			if (prev_m) {
+				/* as in TempoMap::beat_at_bbt_locked() */
+				const double bars_to_m = (m->beat() - prev_m->beat()) / prev_m->divisions_per_bar();
+				bars = bars_to_m + (prev_m->bbt().bars - 1);
+
+				if (m->minute() < _meter_minute.back() || m->pulse() < _meter_pulse.back() || m->beat() < _meter_beat.back()
+				    || (_meters.size() > 1 && bars < _meter_bars.back()) || (double) m->bbt().bars < _meter_bbt_bars.back()) {
+					_sorted = false;
+				}
+			}
+
+			_meters.push_back (boost::shared_ptr<const MeterSection> (new MeterSection (*m)));
+			_meter_minute.push_back (m->minute());
+			_meter_pulse.push_back (m->pulse());
+			_meter_beat.push_back (m->beat());
+			_meter_bars.push_back (bars);
+			_meter_bbt_bars.push_back (m->bbt().bars);
+
+			prev_m = m;
+		}
+	}
+
+	assert (!_tempos.empty());
+	assert (!_meters.empty());
+}
+
+const TempoSection&
+TempoMapPoints::tempo_section_at_minute (double minute) const
+{
+	return *_tempos[first_after (_tempo_minute, minute, _sorted) - 1];
+}
+
+/** Returns the index of the tempo section in effect at @p beat, where
+ *  @p prev_m is the meter in effect there.
+ */
+size_t
+TempoMapPoints::tempo_index_at_beat (const MeterSection& prev_m, double beat) const
+{
+	size_t lo = 1;
+	size_t hi = _tempos.size();
+
+	if (_sorted) {
+		while (lo < hi) {
+			const size_t mid = lo + (hi - lo) / 2;
+			if (((_tempo_pulse[mid] - prev_m.pulse()) * prev_m.note_divisor()) + prev_m.beat() > beat) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+		}
+	} else {
+		while (lo < hi && ((_tempo_pulse[lo] - prev_m.pulse()) * prev_m.note_divisor()) + prev_m.beat() <= beat) {
+			++lo;
+		}
+	}
+
+	return lo - 1;
+}
+
+const TempoSection&
+TempoMapPoints::tempo_section_at_beat (double beat) const
+{
+	return *_tempos[tempo_index_at_beat (meter_section_at_beat (beat), beat)];
+}
+
+const MeterSection&
+TempoMapPoints::meter_section_at_minute (double minute) const
+{
+	return *_meters[first_after (_meter_minute, minute, _sorted) - 1];
+}
+
+const MeterSection&
+TempoMapPoints::meter_section_at_beat (double beat) const
+{
+	return *_meters[first_after (_meter_beat, beat, _sorted) - 1];
+}
+
+double
+TempoMapPoints::pulse_at_minute (double minute) const
+{
+	const size_t i = first_after (_tempo_minute, minute, _sorted);
+
+	if (i < _tempos.size()) {
+		const double ret = _tempos[i - 1]->pulse_at_minute (minute);
+		/* audio locked section in new meter*/
+		if (_tempo_pulse[i] < ret) {
+			return _tempo_pulse[i];
+		}
+		return ret;
+	}
+
+	/* treated as constant for this ts */
+	const TempoSection& prev_t (*_tempos.back());
+	const double pulses_in_section = ((minute - prev_t.minute()) * prev_t.note_types_per_minute()) / prev_t.note_type();
+
+	return pulses_in_section + prev_t.pulse();
+}
+
+double
+TempoMapPoints::minute_at_pulse (double pulse) const
+{
+	const size_t i = first_after (_tempo_pulse, pulse, _sorted);
+
+	if (i < _tempos.size()) {
+		return _tempos[i - 1]->minute_at_pulse (pulse);
+	}
+
+	/* must be treated as constant, irrespective of _type */
+	const TempoSection& prev_t (*_tempos.back());
+	const double dtime = ((pulse - prev_t.pulse()) * prev_t.note_type()) / prev_t.note_types_per_minute();
+
+	return dtime + prev_t.minute();
+}
+
+double
+TempoMapPoints::beat_at_minute (double minute) const
+{
+	const TempoSection& ts = tempo_section_at_minute (minute);
+	const size_t i = first_after (_meter_minute, minute, _sorted);
+	const MeterSection& prev_m (*_meters[i - 1]);
+
+	const double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* audio locked meters fake their beat */
+	if (i < _meters.size() && _meter_beat[i] < beat) {
+		return _meter_beat[i];
+	}
+
+	return beat;
+}
+
+double
+TempoMapPoints::minute_at_beat (double beat) const
+{
+	const MeterSection& prev_m = meter_section_at_beat (beat);
+	const TempoSection& prev_t (*_tempos[tempo_index_at_beat (prev_m, beat)]);
+
+	return prev_t.minute_at_pulse (((beat - prev_m.beat()) / prev_m.note_divisor()) + prev_m.pulse());
+}
+
+double
+TempoMapPoints::pulse_at_beat (double beat) const
+{
+	const MeterSection& prev_m = meter_section_at_beat (beat);
+
+	return prev_m.pulse() + ((beat - prev_m.beat()) / prev_m.note_divisor());
+}
+
+double
+TempoMapPoints::beat_at_pulse (double pulse) const
+{
+	const MeterSection& prev_m (*_meters[first_after (_meter_pulse, pulse, _sorted) - 1]);
+
+	return ((pulse - prev_m.pulse()) * prev_m.note_divisor()) + prev_m.beat();
+}
+
+Tempo
+TempoMapPoints::tempo_at_minute (double minute) const
+{
+	const size_t i = first_after (_tempo_minute, minute, _sorted);
+
+	if (i < _tempos.size()) {
+		return _tempos[i - 1]->tempo_at_minute (minute);
+	}
+
+	const TempoSection& prev_t (*_tempos.back());
+
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+Tempo
+TempoMapPoints::tempo_at_pulse (double pulse) const
+{
+	const size_t i = first_after (_tempo_pulse, pulse, _sorted);
+
+	if (i < _tempos.size()) {
+		return _tempos[i - 1]->tempo_at_pulse (pulse);
+	}
+
+	const TempoSection& prev_t (*_tempos.back());
+
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+double
+TempoMapPoints::beat_at_bbt (const BBT_Time& bbt) const
+{
+	const double bars = bbt.bars - 1;
+
+	return beat_at_bbt_in_meter (*_meters[first_after (_meter_bars, bars, _sorted) - 1], bbt);
+}
+
+double
+TempoMapPoints::pulse_at_bbt (const BBT_Time& bbt) const
+{
+	const double bars = bbt.bars;
+
+	return pulse_at_bbt_in_meter (*_meters[first_after (_meter_bbt_bars, bars, _sorted) - 1], bbt);
+}
+
+BBT_Time
+TempoMapPoints::bbt_at_beat (double b) const
+{
+	const double beats = max (0.0, b);
+	const MeterSection& prev_m = meter_section_at_beat (beats);
+
+	return bbt_in_meter (prev_m, beats - prev_m.beat());
+}
+
+BBT_Time
+TempoMapPoints::bbt_at_pulse (double pulse) const
+{
+	const MeterSection& prev_m (*_meters[first_after (_meter_pulse, pulse, _sorted) - 1]);
+
+	return bbt_in_meter (prev_m, (pulse - prev_m.pulse()) * prev_m.note_divisor());
+}
+
+BBT_Time
+TempoMapPoints::bbt_at_minute (double minute) const
+{
+	if (minute < 0) {
+		BBT_Time bbt;
+		bbt.bars = 1;
+		bbt.beats = 1;
+		bbt.ticks = 0;
+		return bbt;
+	}
+
+	const TempoSection& ts = tempo_section_at_minute (minute);
+	const size_t i = first_after (_meter_minute, minute, _sorted);
+	const MeterSection& prev_m (*_meters[i - 1]);
+
+	double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* handle frame before first meter */
+	if (minute < prev_m.minute()) {
+		beat = 0.0;
+	}
+	/* audio locked meters fake their beat */
+	if (i < _meters.size() && _meter_beat[i] < beat) {
+		beat = _meter_beat[i];
+	}
+
+	beat = max (0.0, beat);
+
+	return bbt_in_meter (prev_m, beat - prev_m.beat());
+}
+
+double
+TempoMapPoints::quarter_notes_between_frames (framecnt_t start, framecnt_t end) const
+{
+	const TempoSection* prev_t = _tempos[first_after (_tempo_frame, start, _sorted) - 1].get();
+	const double start_qn = prev_t->pulse_at_frame (start);
+
+	/* as in TempoMap::quarter_notes_between_frames_locked(), the
+	   section found for start is kept if end is before the first one.
+	*/
+	if (_tempo_frame.front() <= end) {
+		prev_t = _tempos[first_after (_tempo_frame, end, _sorted) - 1].get();
+	}
+
+	const double end_qn = prev_t->pulse_at_frame (end);
+
+	return (end_qn - start_qn) * 4.0;
+}
+
 TempoMap::TempoMap (framecnt_t fr)
+	: _points (new TempoMapPoints)
 {
 	_frame_rate = fr;
 	BBT_Time start (1, 1, 0);
@@ -733,6 +1109,7 @@ TempoMap::TempoMap (framecnt_t fr)
 	_metrics.push_back (t);
 	_metrics.push_back (m);
 
+	publish_points ();
 }
 
 TempoMap&
@@ -740,7 +1117,7 @@ TempoMap::operator= (TempoMap const & other)
 {
 	if (&other != this) {
 		Glib::Threads::RWLock::ReaderLock lr (other.lock);
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		_frame_rate = other._frame_rate;
 
 		Metrics::const_iterator d = _metrics.begin();
@@ -791,13 +1168,24 @@ TempoMap::minute_at_frame (const framepos_t frame) const
 	return (frame / (double) _frame_rate) / 60.0;
 }
 
+void
+TempoMap::publish_points ()
+{
+	/* CALLER MUST HOLD WRITE LOCK */
+
+	/* the points are rebuilt from scratch, there is no need to
+	   copy the current ones first.
+	*/
+	_points.replace (boost::shared_ptr<TempoMapPoints> (new TempoMapPoints (_metrics)));
+}
+
 void
 TempoMap::remove_tempo (const TempoSection& tempo, bool complete_operation)
 {
 	bool removed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		if ((removed = remove_tempo_locked (tempo))) {
 			if (complete_operation) {
 				recompute_map (_metrics);
@@ -836,7 +1224,7 @@ TempoMap::remove_meter (const MeterSection& tempo, bool complete_operation)
 	bool removed = false;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		if ((removed = remove_meter_locked (tempo))) {
 			if (complete_operation) {
 				recompute_map (_metrics);
@@ -1030,7 +1418,7 @@ TempoMap::add_tempo (const Tempo& tempo, const double& pulse, const framepos_t&
 	TempoSection* ts = 0;
 	TempoSection* prev_tempo = 0;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		ts = add_tempo_locked (tempo, pulse, minute_at_frame (frame), pls, true);
 		for (Metrics::iterator i = _metrics.begin(); i != _metrics.end(); ++i) {
 
@@ -1070,7 +1458,7 @@ TempoMap::replace_tempo (TempoSection& ts, const Tempo& tempo, const double& pul
 	TempoSection* new_ts = 0;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		TempoSection& first (first_tempo());
 		if (!ts.initial()) {
 			if (locked_to_meter) {
@@ -1148,7 +1536,7 @@ TempoMap::add_meter (const Meter& meter, const double& beat, const Timecode::BBT
 {
 	MeterSection* m = 0;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		m = add_meter_locked (meter, beat, where, frame, pls, true);
 	}
 
@@ -1167,7 +1555,7 @@ void
 TempoMap::replace_meter (const MeterSection& ms, const Meter& meter, const BBT_Time& where, framepos_t frame, PositionLockStyle pls)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		const double beat = beat_at_bbt_locked (_metrics, where);
 
 		if (!ms.initial()) {
@@ -1261,7 +1649,7 @@ TempoMap::change_initial_tempo (double note_types_per_minute, double note_type,
 				continue;
 			}
 			{
-				Glib::Threads::RWLock::WriterLock lm (lock);
+				WriteLock lm (*this);
 				*((Tempo*) t) = newtempo;
 				recompute_map (_metrics);
 			}
@@ -1314,7 +1702,7 @@ TempoMap::change_existing_tempo_at (framepos_t where, double note_types_per_minu
 	/* reset */
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		/* cannot move the first tempo section */
 		*((Tempo*)prev) = newtempo;
 		recompute_map (_metrics);
@@ -1615,9 +2003,7 @@ TempoMap::metric_at (BBT_Time bbt) const
 double
 TempoMap::beat_at_frame (const framecnt_t& frame) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return beat_at_minute_locked (_metrics, minute_at_frame (frame));
+	return _points.reader ()->beat_at_minute (minute_at_frame (frame));
 }
 
 /* This function uses both tempo and meter.*/
@@ -1657,9 +2043,7 @@ TempoMap::beat_at_minute_locked (const Metrics& metrics, const double& minute) c
 framepos_t
 TempoMap::frame_at_beat (const double& beat) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return frame_at_minute (minute_at_beat_locked (_metrics, beat));
+	return frame_at_minute (_points.reader ()->minute_at_beat (beat));
 }
 
 /* meter & tempo section based */
@@ -1712,9 +2096,7 @@ TempoMap::minute_at_beat_locked (const Metrics& metrics, const double& beat) con
 Tempo
 TempoMap::tempo_at_frame (const framepos_t& frame) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return tempo_at_minute_locked (_metrics, minute_at_frame (frame));
+	return _points.reader ()->tempo_at_minute (minute_at_frame (frame));
 }
 
 Tempo
@@ -1862,9 +2244,7 @@ TempoMap::pulse_at_tempo_locked (const Metrics& metrics, const Tempo& tempo) con
 Tempo
 TempoMap::tempo_at_quarter_note (const double& qn) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return tempo_at_pulse_locked (_metrics, qn / 4.0);
+	return _points.reader ()->tempo_at_pulse (qn / 4.0);
 }
 
 /** Returns the position in quarter-note beats corresponding to the supplied Tempo.
@@ -1996,8 +2376,7 @@ TempoMap::minute_at_pulse_locked (const Metrics& metrics, const double& pulse) c
 double
 TempoMap::beat_at_bbt (const Timecode::BBT_Time& bbt)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	return beat_at_bbt_locked (_metrics, bbt);
+	return _points.reader ()->beat_at_bbt (bbt);
 }
 
 
@@ -2026,11 +2405,7 @@ TempoMap::beat_at_bbt_locked (const Metrics& metrics, const Timecode::BBT_Time&
 		}
 	}
 
-	const double remaining_bars = bbt.bars - prev_m->bbt().bars;
-	const double remaining_bars_in_beats = remaining_bars * prev_m->divisions_per_bar();
-	const double ret = remaining_bars_in_beats + prev_m->beat() + (bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat);
-
-	return ret;
+	return beat_at_bbt_in_meter (*prev_m, bbt);
 }
 
 /** Returns the BBT time corresponding to the supplied BBT (meter-based) beat.
@@ -2041,8 +2416,7 @@ TempoMap::beat_at_bbt_locked (const Metrics& metrics, const Timecode::BBT_Time&
 Timecode::BBT_Time
 TempoMap::bbt_at_beat (const double& beat)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	return bbt_at_beat_locked (_metrics, beat);
+	return _points.reader ()->bbt_at_beat (beat);
 }
 
 Timecode::BBT_Time
@@ -2069,33 +2443,7 @@ TempoMap::bbt_at_beat_locked (const Metrics& metrics, const double& b) const
 	}
 	assert (prev_m);
 
-	const double beats_in_ms = beats - prev_m->beat();
-	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / prev_m->divisions_per_bar());
-	const uint32_t total_bars = bars_in_ms + (prev_m->bbt().bars - 1);
-	const double remaining_beats = beats_in_ms - (bars_in_ms * prev_m->divisions_per_bar());
-	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
-
-	BBT_Time ret;
-
-	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
-	ret.beats = (uint32_t) floor (remaining_beats);
-	ret.bars = total_bars;
-
-	/* 0 0 0 to 1 1 0 - based mapping*/
-	++ret.bars;
-	++ret.beats;
-
-	if (ret.ticks >= BBT_Time::ticks_per_beat) {
-		++ret.beats;
-		ret.ticks -= BBT_Time::ticks_per_beat;
-	}
-
-	if (ret.beats >= prev_m->divisions_per_bar() + 1) {
-		++ret.bars;
-		ret.beats = 1;
-	}
-
-	return ret;
+	return bbt_in_meter (*prev_m, beats - prev_m->beat());
 }
 
 /** Returns the quarter-note beat corresponding to the supplied BBT time (meter-based).
@@ -2109,21 +2457,14 @@ TempoMap::bbt_at_beat_locked (const Metrics& metrics, const double& b) const
 double
 TempoMap::quarter_note_at_bbt (const Timecode::BBT_Time& bbt)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return pulse_at_bbt_locked (_metrics, bbt) * 4.0;
+	return _points.reader ()->pulse_at_bbt (bbt) * 4.0;
 }
 
 double
 TempoMap::quarter_note_at_bbt_rt (const Timecode::BBT_Time& bbt)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		throw std::logic_error ("TempoMap::quarter_note_at_bbt_rt() could not lock tempo map");
-	}
-
-	return pulse_at_bbt_locked (_metrics, bbt) * 4.0;
+	/* lock-free, like quarter_note_at_bbt() */
+	return _points.reader ()->pulse_at_bbt (bbt) * 4.0;
 }
 
 double
@@ -2150,11 +2491,7 @@ TempoMap::pulse_at_bbt_locked (const Metrics& metrics, const Timecode::BBT_Time&
 		}
 	}
 
-	const double remaining_bars = bbt.bars - prev_m->bbt().bars;
-	const double remaining_pulses = remaining_bars * prev_m->divisions_per_bar() / prev_m->note_divisor();
-	const double ret = remaining_pulses + prev_m->pulse() + (((bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat)) / prev_m->note_divisor());
-
-	return ret;
+	return pulse_at_bbt_in_meter (*prev_m, bbt);
 }
 
 /** Returns the BBT time corresponding to the supplied quarter-note beat.
@@ -2167,9 +2504,7 @@ TempoMap::pulse_at_bbt_locked (const Metrics& metrics, const Timecode::BBT_Time&
 Timecode::BBT_Time
 TempoMap::bbt_at_quarter_note (const double& qn)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return bbt_at_pulse_locked (_metrics, qn / 4.0);
+	return _points.reader ()->bbt_at_pulse (qn / 4.0);
 }
 
 /** Returns the BBT time (meter-based) corresponding to the supplied whole-note pulse position.
@@ -2207,33 +2542,7 @@ TempoMap::bbt_at_pulse_locked (const Metrics& metrics, const double& pulse) cons
 
 	assert (prev_m);
 
-	const double beats_in_ms = (pulse - prev_m->pulse()) * prev_m->note_divisor();
-	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / prev_m->divisions_per_bar());
-	const uint32_t total_bars = bars_in_ms + (prev_m->bbt().bars - 1);
-	const double remaining_beats = beats_in_ms - (bars_in_ms * prev_m->divisions_per_bar());
-	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
-
-	BBT_Time ret;
-
-	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
-	ret.beats = (uint32_t) floor (remaining_beats);
-	ret.bars = total_bars;
-
-	/* 0 0 0 to 1 1 0 mapping*/
-	++ret.bars;
-	++ret.beats;
-
-	if (ret.ticks >= BBT_Time::ticks_per_beat) {
-		++ret.beats;
-		ret.ticks -= BBT_Time::ticks_per_beat;
-	}
-
-	if (ret.beats >= prev_m->divisions_per_bar() + 1) {
-		++ret.bars;
-		ret.beats = 1;
-	}
-
-	return ret;
+	return bbt_in_meter (*prev_m, (pulse - prev_m->pulse()) * prev_m->note_divisor());
 }
 
 /** Returns the BBT time corresponding to the supplied frame position.
@@ -2255,25 +2564,14 @@ TempoMap::bbt_at_frame (framepos_t frame)
 		return bbt;
 	}
 
-	const double minute =  minute_at_frame (frame);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return bbt_at_minute_locked (_metrics, minute);
+	return _points.reader ()->bbt_at_minute (minute_at_frame (frame));
 }
 
 BBT_Time
 TempoMap::bbt_at_frame_rt (framepos_t frame)
 {
-	const double minute =  minute_at_frame (frame);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		throw std::logic_error ("TempoMap::bbt_at_frame_rt() could not lock tempo map");
-	}
-
-	return bbt_at_minute_locked (_metrics, minute);
+	/* lock-free, like bbt_at_frame() */
+	return _points.reader ()->bbt_at_minute (minute_at_frame (frame));
 }
 
 Timecode::BBT_Time
@@ -2317,33 +2615,7 @@ TempoMap::bbt_at_minute_locked (const Metrics& metrics, const double& minute) co
 
 	beat = max (0.0, beat);
 
-	const double beats_in_ms = beat - prev_m->beat();
-	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / prev_m->divisions_per_bar());
-	const uint32_t total_bars = bars_in_ms + (prev_m->bbt().bars - 1);
-	const double remaining_beats = beats_in_ms - (bars_in_ms * prev_m->divisions_per_bar());
-	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
-
-	BBT_Time ret;
-
-	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
-	ret.beats = (uint32_t) floor (remaining_beats);
-	ret.bars = total_bars;
-
-	/* 0 0 0 to 1 1 0 - based mapping*/
-	++ret.bars;
-	++ret.beats;
-
-	if (ret.ticks >= BBT_Time::ticks_per_beat) {
-		++ret.beats;
-		ret.ticks -= BBT_Time::ticks_per_beat;
-	}
-
-	if (ret.beats >= prev_m->divisions_per_bar() + 1) {
-		++ret.bars;
-		ret.beats = 1;
-	}
-
-	return ret;
+	return bbt_in_meter (*prev_m, beat - prev_m->beat());
 }
 
 /** Returns the frame position corresponding to the supplied BBT time.
@@ -2365,13 +2637,9 @@ TempoMap::frame_at_bbt (const BBT_Time& bbt)
 		throw std::logic_error ("beats are counted from one");
 	}
 
-	double minute;
-	{
-		Glib::Threads::RWLock::ReaderLock lm (lock);
-		minute = minute_at_bbt_locked (_metrics, bbt);
-	}
+	boost::shared_ptr<TempoMapPoints> points (_points.reader ());
 
-	return frame_at_minute (minute);
+	return frame_at_minute (points->minute_at_beat (points->beat_at_bbt (bbt)));
 }
 
 /* meter & tempo section based */
@@ -2394,25 +2662,14 @@ TempoMap::minute_at_bbt_locked (const Metrics& metrics, const BBT_Time& bbt) con
 double
 TempoMap::quarter_note_at_frame (const framepos_t frame) const
 {
-	const double minute =  minute_at_frame (frame);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return pulse_at_minute_locked (_metrics, minute) * 4.0;
+	return _points.reader ()->pulse_at_minute (minute_at_frame (frame)) * 4.0;
 }
 
 double
 TempoMap::quarter_note_at_frame_rt (const framepos_t frame) const
 {
-	const double minute =  minute_at_frame (frame);
-
-	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
-
-	if (!lm.locked()) {
-		throw std::logic_error ("TempoMap::quarter_note_at_frame_rt() could not lock tempo map");
-	}
-
-	return pulse_at_minute_locked (_metrics, minute) * 4.0;
+	/* lock-free, like quarter_note_at_frame() */
+	return _points.reader ()->pulse_at_minute (minute_at_frame (frame)) * 4.0;
 }
 
 /**
@@ -2426,14 +2683,7 @@ TempoMap::quarter_note_at_frame_rt (const framepos_t frame) const
 framepos_t
 TempoMap::frame_at_quarter_note (const double quarter_note) const
 {
-	double minute;
-	{
-		Glib::Threads::RWLock::ReaderLock lm (lock);
-
-		minute = minute_at_pulse_locked (_metrics, quarter_note / 4.0);
-	}
-
-	return frame_at_minute (minute);
+	return frame_at_minute (_points.reader ()->minute_at_pulse (quarter_note / 4.0));
 }
 
 /** Returns the quarter-note beats corresponding to the supplied BBT (meter-based) beat.
@@ -2446,9 +2696,7 @@ TempoMap::frame_at_quarter_note (const double quarter_note) const
 double
 TempoMap::quarter_note_at_beat (const double beat) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return pulse_at_beat_locked (_metrics, beat) * 4.0;
+	return _points.reader ()->pulse_at_beat (beat) * 4.0;
 }
 
 /** Returns the BBT (meter-based) beat position corresponding to the supplied quarter-note beats.
@@ -2461,9 +2709,7 @@ TempoMap::quarter_note_at_beat (const double beat) const
 double
 TempoMap::beat_at_quarter_note (const double quarter_note) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return beat_at_pulse_locked (_metrics, quarter_note / 4.0);
+	return _points.reader ()->beat_at_pulse (quarter_note / 4.0);
 }
 
 /** Returns the duration in frames between two supplied quarter-note beat positions.
@@ -2479,14 +2725,9 @@ TempoMap::beat_at_quarter_note (const double quarter_note) const
 framecnt_t
 TempoMap::frames_between_quarter_notes (const double start, const double end) const
 {
-	double minutes;
+	boost::shared_ptr<TempoMapPoints> points (_points.reader ());
 
-	{
-		Glib::Threads::RWLock::ReaderLock lm (lock);
-		minutes = minutes_between_quarter_notes_locked (_metrics, start, end);
-	}
-
-	return frame_at_minute (minutes);
+	return frame_at_minute (points->minute_at_pulse (end / 4.0) - points->minute_at_pulse (start / 4.0));
 }
 
 double
@@ -2499,9 +2740,7 @@ TempoMap::minutes_between_quarter_notes_locked (const Metrics& metrics, const do
 double
 TempoMap::quarter_notes_between_frames (const framecnt_t start, const framecnt_t end) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return quarter_notes_between_frames_locked (_metrics, start, end);
+	return _points.reader ()->quarter_notes_between_frames (start, end);
 }
 
 double
@@ -3221,7 +3460,7 @@ TempoMap::gui_set_tempo_position (TempoSection* ts, const framepos_t& frame, con
 	if (ts->position_lock_style() == MusicTime) {
 		{
 			/* if we're snapping to a musical grid, set the pulse exactly instead of via the supplied frame. */
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			WriteLock lm (*this);
 			TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 			tempo_copy->set_position_lock_style (AudioTime);
@@ -3240,7 +3479,7 @@ TempoMap::gui_set_tempo_position (TempoSection* ts, const framepos_t& frame, con
 	} else {
 
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			WriteLock lm (*this);
 			TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 			if (solve_map_minute (future_map, tempo_copy, minute_at_frame (frame))) {
@@ -3294,7 +3533,7 @@ TempoMap::gui_set_meter_position (MeterSection* ms, const framepos_t& frame)
 	if (ms->position_lock_style() == AudioTime) {
 
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			WriteLock lm (*this);
 			MeterSection* copy = copy_metrics_and_point (_metrics, future_map, ms);
 
 			if (solve_map_minute (future_map, copy, minute_at_frame (frame))) {
@@ -3304,7 +3543,7 @@ TempoMap::gui_set_meter_position (MeterSection* ms, const framepos_t& frame)
 		}
 	} else {
 		{
-			Glib::Threads::RWLock::WriterLock lm (lock);
+			WriteLock lm (*this);
 			MeterSection* copy = copy_metrics_and_point (_metrics, future_map, ms);
 
 			const double beat = beat_at_minute_locked (_metrics, minute_at_frame (frame));
@@ -3332,7 +3571,7 @@ TempoMap::gui_change_tempo (TempoSection* ts, const Tempo& bpm)
 	Metrics future_map;
 	bool can_solve = false;
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		TempoSection* tempo_copy = copy_metrics_and_point (_metrics, future_map, ts);
 
 		if (tempo_copy->type() == TempoSection::Constant) {
@@ -3399,7 +3638,7 @@ TempoMap::gui_stretch_tempo (TempoSection* ts, const framepos_t frame, const fra
 	Metrics future_map;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 
 		if (!ts) {
 			return;
@@ -3514,7 +3753,7 @@ TempoMap::gui_stretch_tempo_end (TempoSection* ts, const framepos_t frame, const
 	Metrics future_map;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 
 		if (!ts) {
 			return;
@@ -3593,7 +3832,7 @@ TempoMap::gui_twist_tempi (TempoSection* ts, const Tempo& bpm, const framepos_t
 	framepos_t const min_dframe = 2;
 
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		if (!ts) {
 			return false;
 		}
@@ -4153,29 +4392,30 @@ void
 TempoMap::get_grid (vector<TempoMap::BBTPoint>& points,
 		    framepos_t lower, framepos_t upper, uint32_t bar_mod)
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	int32_t cnt = ceil (beat_at_minute_locked (_metrics, minute_at_frame (lower)));
+	boost::shared_ptr<TempoMapPoints> tmap (_points.reader ());
+
+	int32_t cnt = ceil (tmap->beat_at_minute (minute_at_frame (lower)));
 	framecnt_t pos = 0;
 	/* although the map handles negative beats, bbt doesn't. */
 	if (cnt < 0.0) {
 		cnt = 0.0;
 	}
 
-	if (minute_at_beat_locked (_metrics, cnt) >= minute_at_frame (upper)) {
+	if (tmap->minute_at_beat (cnt) >= minute_at_frame (upper)) {
 		return;
 	}
 	if (bar_mod == 0) {
 		while (pos >= 0 && pos < upper) {
-			pos = frame_at_minute (minute_at_beat_locked (_metrics, cnt));
-			const MeterSection meter = meter_section_at_minute_locked (_metrics, minute_at_frame (pos));
-			const BBT_Time bbt = bbt_at_beat_locked (_metrics, cnt);
-			const double qn = pulse_at_beat_locked (_metrics, cnt) * 4.0;
+			pos = frame_at_minute (tmap->minute_at_beat (cnt));
+			const MeterSection meter = tmap->meter_section_at_minute (minute_at_frame (pos));
+			const BBT_Time bbt = tmap->bbt_at_beat (cnt);
+			const double qn = tmap->pulse_at_beat (cnt) * 4.0;
 
-			points.push_back (BBTPoint (meter, tempo_at_minute_locked (_metrics, minute_at_frame (pos)), pos, bbt.bars, bbt.beats, qn));
+			points.push_back (BBTPoint (meter, tmap->tempo_at_minute (minute_at_frame (pos)), pos, bbt.bars, bbt.beats, qn));
 			++cnt;
 		}
 	} else {
-		BBT_Time bbt = bbt_at_minute_locked (_metrics, minute_at_frame (lower));
+		BBT_Time bbt = tmap->bbt_at_minute (minute_at_frame (lower));
 		bbt.beats = 1;
 		bbt.ticks = 0;
 
@@ -4185,11 +4425,11 @@ TempoMap::get_grid (vector<TempoMap::BBTPoint>& points,
 		}
 
 		while (pos >= 0 && pos < upper) {
-			pos = frame_at_minute (minute_at_bbt_locked (_metrics, bbt));
-			const MeterSection meter = meter_section_at_minute_locked (_metrics, minute_at_frame (pos));
-			const double qn = pulse_at_bbt_locked (_metrics, bbt) * 4.0;
+			pos = frame_at_minute (tmap->minute_at_beat (tmap->beat_at_bbt (bbt)));
+			const MeterSection meter = tmap->meter_section_at_minute (minute_at_frame (pos));
+			const double qn = tmap->pulse_at_bbt (bbt) * 4.0;
 
-			points.push_back (BBTPoint (meter, tempo_at_minute_locked (_metrics, minute_at_frame (pos)), pos, bbt.bars, bbt.beats, qn));
+			points.push_back (BBTPoint (meter, tmap->tempo_at_minute (minute_at_frame (pos)), pos, bbt.bars, bbt.beats, qn));
 			bbt.bars += bar_mod;
 		}
 	}
@@ -4606,7 +4846,7 @@ int
 TempoMap::set_state (const XMLNode& node, int /*version*/)
 {
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 
 		XMLNodeList nlist;
 		XMLNodeConstIterator niter;
@@ -4813,7 +5053,7 @@ TempoMap::remove_time (framepos_t where, framecnt_t amount)
 	bool tempo_after = false; // is there a tempo marker at the first sample after the removed range?
 	bool meter_after = false; // is there a meter marker likewise?
 	{
-		Glib::Threads::RWLock::WriterLock lm (lock);
+		WriteLock lm (*this);
 		for (Metrics::iterator i = _metrics.begin(); i != _metrics.end(); ++i) {
 			if ((*i)->frame() >= where && (*i)->frame() < where+amount) {
 				metric_kill_list.push_back(*i);
@@ -4868,10 +5108,10 @@ TempoMap::remove_time (framepos_t where, framecnt_t amount)
 framepos_t
 TempoMap::framepos_plus_qn (framepos_t frame, Evoral::Beats beats) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-	const double frame_qn = pulse_at_minute_locked (_metrics, minute_at_frame (frame)) * 4.0;
+	boost::shared_ptr<TempoMapPoints> points (_points.reader ());
+	const double frame_qn = points->pulse_at_minute (minute_at_frame (frame)) * 4.0;
 
-	return frame_at_minute (minute_at_pulse_locked (_metrics, (frame_qn + beats.to_double()) / 4.0));
+	return frame_at_minute (points->minute_at_pulse ((frame_qn + beats.to_double()) / 4.0));
 }
 
 framepos_t
@@ -4904,9 +5144,7 @@ TempoMap::framepos_plus_bbt (framepos_t pos, BBT_Time op) const
 Evoral::Beats
 TempoMap::framewalk_to_qn (framepos_t pos, framecnt_t distance) const
 {
-	Glib::Threads::RWLock::ReaderLock lm (lock);
-
-	return Evoral::Beats (quarter_notes_between_frames_locked (_metrics, pos, pos + distance));
+	return Evoral::Beats (_points.reader ()->quarter_notes_between_frames (pos, pos + distance));
 }
 
 struct bbtcmp {
@@ -22,6 +22,7 @@
 #include "pbd/properties.h"
 #include "pbd/stateful_diff_command.h"
 #include "ardour/automation_list.h"
+#include "ardour/state_sidecar.h"
 #include "automation_list_property_test.h"
 #include "test_util.h"
 
@@ -162,3 +163,58 @@ AutomationListPropertyTest::undoTest ()
 	write_automation_list_xml (&sheila->get_state(), test_data_filename);
 	check_xml (&sheila->get_state(), test_data_file4, ignore_properties);
 }
+
+void
+AutomationListPropertyTest::sidecarTest ()
+{
+	Evoral::Parameter const gain (GainAutomation);
+	AutomationList al (gain);
+
+	for (int i = 0; i < 100; ++i) {
+		al.add (i * 10, (i % 7) / 7.0, false, false);
+	}
+
+	StateSidecar sidecar (2);
+	XMLNode* state;
+
+	{
+		StateSidecar::Use su (&sidecar);
+		state = &al.get_state ();
+	}
+
+	/* the events went into the sidecar, not the XML */
+	XMLNode* events = state->child ("events");
+	CPPUNIT_ASSERT (events);
+	CPPUNIT_ASSERT (events->children().empty());
+	CPPUNIT_ASSERT (!sidecar.empty());
+
+	std::string path = Glib::build_filename (new_test_output_dir ("automation_list_sidecar"), "test.sidecar");
+	CPPUNIT_ASSERT_EQUAL (0, sidecar.write (path));
+
+	StateSidecar reread;
+	CPPUNIT_ASSERT_EQUAL (0, reread.read (path));
+
+	AutomationList copy (gain);
+
+	{
+		StateSidecar::Use su (&reread);
+		CPPUNIT_ASSERT_EQUAL (0, copy.set_state (*state, Stateful::loading_state_version));
+	}
+
+	CPPUNIT_ASSERT (!(copy != al));
+	delete state;
+
+	/* with no sidecar in use the events are written as text again,
+	 * and the cached text follows changes to the al.
+	 */
+	state = &al.get_state ();
+	CPPUNIT_ASSERT (!state->child ("events")->children().empty());
+	std::string const before = state->child ("events")->children().front()->content();
+	delete state;
+
+	al.add (2000, 0.5, false, false);
+
+	state = &al.get_state ();
+	CPPUNIT_ASSERT (state->child ("events")->children().front()->content() != before);
+	delete state;
+}
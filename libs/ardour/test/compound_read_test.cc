@@ -0,0 +1,120 @@
+/*
+    Copyright (C) 2026 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <pthread.h>
+
+#include "ardour/audioplaylist.h"
+#include "ardour/audiosource.h"
+#include "ardour/playlist_factory.h"
+#include "ardour/region.h"
+
+#include "compound_read_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (CompoundReadTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+namespace {
+
+int const read_length = 256;
+int const reads_per_thread = 500;
+
+struct Reader {
+	boost::shared_ptr<AudioPlaylist> playlist;
+	Sample const* expected;
+	int errors;
+};
+
+void*
+read_thread (void* arg)
+{
+	Reader* r = static_cast<Reader*> (arg);
+
+	/* as a butler I/O worker does */
+	AudioSource::allocate_thread_working_buffers ();
+
+	Sample buf[read_length];
+	Sample mbuf[read_length];
+	float gbuf[read_length];
+
+	for (int n = 0; n < reads_per_thread; ++n) {
+		r->playlist->read (buf, mbuf, gbuf, 0, read_length, 0);
+		for (int i = 0; i < read_length; ++i) {
+			if (buf[i] != r->expected[i]) {
+				++r->errors;
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+}
+
+void
+CompoundReadTest::concurrentReadTest ()
+{
+	/* Two playlists, each holding a compound region (of the same nesting
+	   level, so that they share working buffers unless each reading thread
+	   has its own) whose contents differ.
+	*/
+
+	boost::shared_ptr<AudioPlaylist> playlists[2];
+	playlists[0] = _audio_playlist;
+	playlists[1] = boost::dynamic_pointer_cast<AudioPlaylist> (PlaylistFactory::create (DataType::AUDIO, *_session, "test2"));
+
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 64);
+	playlists[1]->add_region (_r[2], 37);
+	playlists[1]->add_region (_r[3], 101);
+
+	for (int p = 0; p < 2; ++p) {
+		RegionList rl = playlists[p]->region_list_property().rlist ();
+		playlists[p]->combine (rl);
+		CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, playlists[p]->n_regions ());
+	}
+
+	Sample expected[2][read_length];
+	Sample mbuf[read_length];
+	float gbuf[read_length];
+
+	for (int p = 0; p < 2; ++p) {
+		playlists[p]->read (expected[p], mbuf, gbuf, 0, read_length, 0);
+	}
+
+	CPPUNIT_ASSERT (memcmp (expected[0], expected[1], sizeof (expected[0])) != 0);
+
+	Reader readers[4];
+	pthread_t threads[4];
+
+	for (int n = 0; n < 4; ++n) {
+		readers[n].playlist = playlists[n % 2];
+		readers[n].expected = expected[n % 2];
+		readers[n].errors = 0;
+		CPPUNIT_ASSERT_EQUAL (0, pthread_create (&threads[n], 0, read_thread, &readers[n]));
+	}
+
+	for (int n = 0; n < 4; ++n) {
+		pthread_join (threads[n], 0);
+		CPPUNIT_ASSERT_EQUAL (0, readers[n].errors);
+	}
+
+	playlists[1]->drop_regions ();
+}
@@ -0,0 +1,33 @@
+/*
+    Copyright (C) 2026 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "audio_region_test.h"
+
+/** Check that refills of playlists containing compound regions
+ *  give the right data when they are done concurrently, as by the
+ *  butler's I/O worker threads.
+ */
+class CompoundReadTest : public AudioRegionTest
+{
+	CPPUNIT_TEST_SUITE (CompoundReadTest);
+	CPPUNIT_TEST (concurrentReadTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void concurrentReadTest ();
+};
@@ -0,0 +1,158 @@
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+#include "ardour/interval_tree.h"
+#include "ardour/types.h"
+
+#include "interval_tree_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (IntervalTreeTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+typedef IntervalTree<int, framepos_t> Tree;
+
+void
+IntervalTreeTest::basicTest ()
+{
+	Tree t;
+	list<int> r;
+
+	CPPUNIT_ASSERT (t.empty ());
+
+	t.insert (1, 0, 99);
+	t.insert (2, 50, 149);
+	t.insert (3, 200, 299);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (3), t.size ());
+
+	t.find_overlapping (100, 100, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), r.size ());
+	CPPUNIT_ASSERT_EQUAL (2, r.front ());
+
+	r.clear ();
+	t.find_overlapping (99, 200, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (3), r.size ());
+
+	CPPUNIT_ASSERT_EQUAL (size_t (0), t.count_overlapping (150, 199));
+	CPPUNIT_ASSERT_EQUAL (size_t (2), t.count_overlapping (50, 50));
+
+	/* moving an item */
+	t.insert (3, 120, 130);
+	CPPUNIT_ASSERT_EQUAL (size_t (3), t.size ());
+	CPPUNIT_ASSERT_EQUAL (size_t (0), t.count_overlapping (200, 299));
+	CPPUNIT_ASSERT_EQUAL (size_t (2), t.count_overlapping (125, 125));
+
+	CPPUNIT_ASSERT (t.erase (2));
+	CPPUNIT_ASSERT (!t.erase (2));
+	CPPUNIT_ASSERT (!t.contains (2));
+	CPPUNIT_ASSERT_EQUAL (size_t (1), t.count_overlapping (125, 125));
+
+	t.clear ();
+	CPPUNIT_ASSERT (t.empty ());
+	CPPUNIT_ASSERT_EQUAL (size_t (0), t.count_overlapping (0, 1000));
+}
+
+void
+IntervalTreeTest::orderTest ()
+{
+	Tree t;
+	int item;
+
+	t.insert (1, 100, 199);
+	t.insert (2, 100, 149);
+	t.insert (3, 0, 299);
+	t.insert (4, 300, 399);
+
+	/* ordered by start, then by insertion */
+	list<int> r;
+	t.find_overlapping (0, 1000, r);
+	CPPUNIT_ASSERT_EQUAL (size_t (4), r.size ());
+	list<int>::iterator i = r.begin ();
+	CPPUNIT_ASSERT_EQUAL (3, *i++);
+	CPPUNIT_ASSERT_EQUAL (1, *i++);
+	CPPUNIT_ASSERT_EQUAL (2, *i++);
+	CPPUNIT_ASSERT_EQUAL (4, *i++);
+
+	CPPUNIT_ASSERT (t.first_starting_after (0, item));
+	CPPUNIT_ASSERT_EQUAL (1, item);
+	CPPUNIT_ASSERT (t.first_starting_after (100, item));
+	CPPUNIT_ASSERT_EQUAL (4, item);
+	CPPUNIT_ASSERT (!t.first_starting_after (300, item));
+
+	CPPUNIT_ASSERT (t.last_starting_before (300, item));
+	CPPUNIT_ASSERT_EQUAL (1, item);
+	CPPUNIT_ASSERT (t.last_starting_before (100, item));
+	CPPUNIT_ASSERT_EQUAL (3, item);
+	CPPUNIT_ASSERT (!t.last_starting_before (0, item));
+
+	CPPUNIT_ASSERT (t.first_ending_after (150, item));
+	CPPUNIT_ASSERT_EQUAL (3, item);
+	CPPUNIT_ASSERT (t.first_ending_after (299, item));
+	CPPUNIT_ASSERT_EQUAL (4, item);
+	CPPUNIT_ASSERT (!t.first_ending_after (399, item));
+}
+
+namespace {
+	struct Interval {
+		framepos_t start;
+		framepos_t end;
+		bool present;
+	};
+}
+
+void
+IntervalTreeTest::randomTest ()
+{
+	::srand (0);
+
+	Tree t;
+	vector<Interval> ref (500);
+
+	for (size_t n = 0; n < ref.size (); ++n) {
+		ref[n].present = false;
+	}
+
+	for (int iter = 0; iter < 20000; ++iter) {
+		int const n = ::rand () % ref.size ();
+
+		if (::rand () % 3 == 0) {
+			CPPUNIT_ASSERT_EQUAL (ref[n].present, t.erase (n));
+			ref[n].present = false;
+		} else {
+			ref[n].start = ::rand () % 100000;
+			ref[n].end = ref[n].start + ::rand () % 5000;
+			ref[n].present = true;
+			t.insert (n, ref[n].start, ref[n].end);
+		}
+
+		if (iter % 100) {
+			continue;
+		}
+
+		framepos_t const s = ::rand () % 100000;
+		framepos_t const e = s + ::rand () % 10000;
+
+		size_t expected = 0;
+		for (size_t k = 0; k < ref.size (); ++k) {
+			if (ref[k].present && ref[k].start <= e && ref[k].end >= s) {
+				++expected;
+			}
+		}
+
+		vector<int> found;
+		t.find_overlapping (s, e, found);
+		CPPUNIT_ASSERT_EQUAL (expected, found.size ());
+		CPPUNIT_ASSERT_EQUAL (expected, t.count_overlapping (s, e));
+
+		for (size_t k = 0; k < found.size (); ++k) {
+			Interval const & i (ref[found[k]]);
+			CPPUNIT_ASSERT (i.present && i.start <= e && i.end >= s);
+			if (k > 0) {
+				CPPUNIT_ASSERT (ref[found[k-1]].start <= i.start);
+			}
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class IntervalTreeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (IntervalTreeTest);
+	CPPUNIT_TEST (basicTest);
+	CPPUNIT_TEST (orderTest);
+	CPPUNIT_TEST (randomTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void basicTest ();
+	void orderTest ();
+	void randomTest ();
+};
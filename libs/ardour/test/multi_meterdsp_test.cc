@@ -0,0 +1,130 @@
+#include <vector>
+#include <stdint.h>
+
+#include "ardour/iec1ppmdsp.h"
+#include "ardour/iec2ppmdsp.h"
+#include "ardour/kmeterdsp.h"
+#include "ardour/multi_meterdsp.h"
+#include "ardour/vumeterdsp.h"
+
+#include "multi_meterdsp_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MultiMeterdspTest);
+
+using namespace std;
+
+/* none of these are multiples of 4 (the K-meter's unrolling) or 64 (the
+ * multi-channel meters' transpose block), except as a control.
+ */
+static const int block_sizes[] = { 1, 3, 5, 7, 63, 65, 64, 127, 130, 255, 257, 1021 };
+
+/** a deterministic sequence of samples in [-amp, amp) */
+static float
+random_sample (uint32_t& seed, float amp)
+{
+	seed = seed * 1664525 + 1013904223;
+	return amp * ((seed >> 8) / 8388608.f - 1.f);
+}
+
+/** Run @param n_chan single-channel meters and one multi-channel meter
+ *  over the same random input, in blocks of varying size, and check that
+ *  every reading is identical.  The input ends in silence, during which
+ *  the readings depend only on the filter state, so that has to match as
+ *  well.
+ */
+template<typename Single, typename Multi>
+static void
+check_equivalence (uint32_t n_chan)
+{
+	vector<Single> single (n_chan);
+	Multi multi;
+	multi.set_channels (n_chan);
+
+	uint32_t seed = 1 + n_chan;
+	const int n_sizes = sizeof (block_sizes) / sizeof (block_sizes[0]);
+	const int n_blocks = 4 * n_sizes;
+	const int n_silent = 64;
+
+	for (int b = 0; b < n_blocks + n_silent; ++b) {
+		const int n = block_sizes[b % n_sizes];
+
+		/* the loudness varies from block to block, and between channels */
+		vector<vector<float> > data (n_chan, vector<float> (n));
+		vector<float const *> p (n_chan);
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			const float amp = b < n_blocks ? (random_sample (seed, 1.f) + 1.f) : 0.f;
+			for (int i = 0; i < n; ++i) {
+				data[c][i] = random_sample (seed, amp);
+			}
+			p[c] = &data[c][0];
+		}
+
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			single[c].process (p[c], n);
+		}
+		multi.process (&p[0], n_chan, n);
+
+		/* reading resets the maximum, so read after some blocks but
+		   not others, to check that this is followed as well.
+		*/
+		if (b % 3 == 1 || b >= n_blocks) {
+			for (uint32_t c = 0; c < n_chan; ++c) {
+				CPPUNIT_ASSERT_EQUAL (single[c].read (), multi.read (c));
+			}
+		}
+
+		if (b == n_blocks / 2) {
+			for (uint32_t c = 0; c < n_chan; ++c) {
+				single[c].reset ();
+			}
+			multi.reset ();
+		}
+	}
+}
+
+template<typename Single, typename Multi>
+static void
+check_equivalence ()
+{
+	for (uint32_t n_chan = 1; n_chan <= MultiMeterdsp::lanes + 1; ++n_chan) {
+		check_equivalence<Single, Multi> (n_chan);
+	}
+}
+
+void
+MultiMeterdspTest::setUp ()
+{
+	Kmeterdsp::init (48000);
+	Iec1ppmdsp::init (48000);
+	Iec2ppmdsp::init (48000);
+	Vumeterdsp::init (48000);
+
+	MultiKmeterdsp::init (48000);
+	MultiIec1ppmdsp::init (48000);
+	MultiIec2ppmdsp::init (48000);
+	MultiVumeterdsp::init (48000);
+}
+
+void
+MultiMeterdspTest::kmeterTest ()
+{
+	check_equivalence<Kmeterdsp, MultiKmeterdsp> ();
+}
+
+void
+MultiMeterdspTest::iec1ppmTest ()
+{
+	check_equivalence<Iec1ppmdsp, MultiIec1ppmdsp> ();
+}
+
+void
+MultiMeterdspTest::iec2ppmTest ()
+{
+	check_equivalence<Iec2ppmdsp, MultiIec2ppmdsp> ();
+}
+
+void
+MultiMeterdspTest::vumeterTest ()
+{
+	check_equivalence<Vumeterdsp, MultiVumeterdsp> ();
+}
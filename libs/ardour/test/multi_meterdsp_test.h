@@ -0,0 +1,23 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+/** Check that the multi-channel meters give the same results as one
+ *  single-channel meter per channel.
+ */
+class MultiMeterdspTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (MultiMeterdspTest);
+	CPPUNIT_TEST (kmeterTest);
+	CPPUNIT_TEST (iec1ppmTest);
+	CPPUNIT_TEST (iec2ppmTest);
+	CPPUNIT_TEST (vumeterTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+
+	void kmeterTest ();
+	void iec1ppmTest ();
+	void iec2ppmTest ();
+	void vumeterTest ();
+};
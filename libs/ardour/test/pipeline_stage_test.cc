@@ -0,0 +1,140 @@
+#include <vector>
+
+#include <glibmm/timer.h>
+
+#include "ardour/audio_buffer.h"
+#include "ardour/buffer_set.h"
+#include "ardour/pipeline_stage.h"
+#include "ardour/session.h"
+
+#include "pipeline_stage_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PipelineStageTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/** A processor whose output depends on all of its past input, so that
+ *  its output is only the same as a delayed copy of another's if it saw
+ *  exactly the same, delayed, signal.
+ */
+class Smoother : public Processor
+{
+public:
+	Smoother (Session& s) : Processor (s, "smoother") {}
+
+	bool can_support_io_configuration (const ChanCount& in, ChanCount& out) {
+		out = in;
+		return true;
+	}
+
+	void run (BufferSet& bufs, framepos_t, framepos_t, double, pframes_t nframes, bool) {
+		_z.resize (bufs.count ().n_audio (), 0.f);
+		for (uint32_t c = 0; c < bufs.count ().n_audio (); ++c) {
+			Sample* d = bufs.get_audio (c).data ();
+			for (pframes_t i = 0; i < nframes; ++i) {
+				_z[c] += 0.125f * (d[i] - _z[c]);
+				d[i] = _z[c];
+			}
+		}
+	}
+
+private:
+	vector<Sample> _z;
+};
+
+void
+PipelineStageTest::delayedOutputTest ()
+{
+	const uint32_t n_chan = 2;
+	const pframes_t block_size = 256;
+	const ChanCount streams (DataType::AUDIO, n_chan);
+
+	CPPUNIT_ASSERT (_session->process_graph ());
+
+	PipelineStage stage (*_session, "test");
+	boost::shared_ptr<Processor> smoother (new Smoother (*_session));
+	PipelineStage::ProcessorList procs;
+	procs.push_back (smoother);
+
+	smoother->configure_io (streams, streams);
+	CPPUNIT_ASSERT (stage.configure_io (streams, streams));
+	stage.set_block_size (block_size);
+	stage.set_stage (procs);
+	stage.configure_stage (streams);
+
+	CPPUNIT_ASSERT (stage.pipelined ());
+	CPPUNIT_ASSERT_EQUAL ((framecnt_t) block_size, stage.signal_latency ());
+
+	/* full cycles, and some shorter ones as after a locate */
+	const pframes_t cycles[] = { 256, 256, 100, 256, 1, 255, 256, 256, 64, 256 };
+	const int n_cycles = sizeof (cycles) / sizeof (cycles[0]);
+
+	framecnt_t length = 0;
+	for (int i = 0; i < n_cycles; ++i) {
+		length += cycles[i];
+	}
+
+	vector<vector<Sample> > input (n_chan, vector<Sample> (length));
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		for (framecnt_t s = 0; s < length; ++s) {
+			input[c][s] = ((s * (c + 3)) % 97) / 48.f - 1.f;
+		}
+	}
+
+	/* the unpipelined processor's output, delayed by the stage's latency */
+	vector<vector<Sample> > expected (n_chan, vector<Sample> (length, 0.f));
+	{
+		Smoother ref (*_session);
+		ref.configure_io (streams, streams);
+		BufferSet bufs;
+		bufs.ensure_buffers (DataType::AUDIO, n_chan, length);
+		bufs.set_count (streams);
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			bufs.get_audio (c).read_from (&input[c][0], length);
+		}
+		ref.run (bufs, 0, length, 1.0, length, true);
+		const framecnt_t latency = stage.signal_latency ();
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			Sample const* d = bufs.get_audio (c).data ();
+			for (framecnt_t s = latency; s < length; ++s) {
+				expected[c][s] = d[s - latency];
+			}
+		}
+	}
+
+	BufferSet bufs;
+	bufs.ensure_buffers (DataType::AUDIO, n_chan, block_size);
+
+	framepos_t pos = 0;
+	for (int i = 0; i < n_cycles; ++i) {
+		const pframes_t n = cycles[i];
+
+		bufs.set_count (streams);
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			bufs.get_audio (c).read_from (&input[c][pos], n);
+		}
+
+		/* queues the stage's processors with Graph::trigger_job() */
+		CPPUNIT_ASSERT (stage.start (pos, pos + n, 1.0, n));
+
+		/* give a process thread the chance to pick the job up on some
+		   cycles, so that run() both waits for it, and takes it back
+		   with Graph::retract_job() and runs it itself.
+		*/
+		if (i % 2) {
+			Glib::usleep (2000);
+		}
+
+		stage.run (bufs, pos, pos + n, 1.0, n, true);
+
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			Sample const* d = bufs.get_audio (c).data ();
+			for (pframes_t s = 0; s < n; ++s) {
+				CPPUNIT_ASSERT_EQUAL (expected[c][pos + s], d[s]);
+			}
+		}
+
+		pos += n;
+	}
+}
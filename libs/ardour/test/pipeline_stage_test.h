@@ -0,0 +1,12 @@
+#include "test_needing_session.h"
+
+/** Tests for splitting a route's processors into two pipeline stages */
+class PipelineStageTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (PipelineStageTest);
+	CPPUNIT_TEST (delayedOutputTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void delayedOutputTest ();
+};
@@ -52,3 +52,28 @@ PluginsTest::test ()
 
 
 }
+
+/* a second refresh finds the same LADSPA plugins, which now come from
+ * the plugin cache rather than loading the modules again.
+ */
+void
+PluginsTest::testCachedRefresh ()
+{
+	PluginManager& pm = PluginManager::instance ();
+
+	pm.refresh ();
+	const PluginInfoList scanned = pm.ladspa_plugin_info ();
+
+	pm.refresh ();
+	const PluginInfoList& cached = pm.ladspa_plugin_info ();
+
+	CPPUNIT_ASSERT_EQUAL (scanned.size (), cached.size ());
+
+	PluginInfoList::const_iterator c = cached.begin ();
+	for (PluginInfoList::const_iterator s = scanned.begin (); s != scanned.end (); ++s, ++c) {
+		CPPUNIT_ASSERT_EQUAL ((*s)->unique_id, (*c)->unique_id);
+		CPPUNIT_ASSERT_EQUAL ((*s)->name, (*c)->name);
+		CPPUNIT_ASSERT_EQUAL ((*s)->n_inputs.n_audio (), (*c)->n_inputs.n_audio ());
+		CPPUNIT_ASSERT_EQUAL ((*s)->n_outputs.n_audio (), (*c)->n_outputs.n_audio ());
+	}
+}
@@ -5,8 +5,10 @@ class PluginsTest : public CppUnit::TestFixture
 {
 	CPPUNIT_TEST_SUITE (PluginsTest);
 	CPPUNIT_TEST (test);
+	CPPUNIT_TEST (testCachedRefresh);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
 	void test ();
+	void testCachedRefresh ();
 };
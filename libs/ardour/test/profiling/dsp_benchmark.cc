@@ -0,0 +1,437 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <glib.h>
+#include <glibmm.h>
+
+#include "pbd/compose.h"
+#include "pbd/failed_constructor.h"
+#include "pbd/rt_arena.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/audio_track.h"
+#include "ardour/automation_list.h"
+#include "ardour/gain_control.h"
+#include "ardour/graph.h"
+#include "ardour/monitor_control.h"
+#include "ardour/plugin_insert.h"
+#include "ardour/plugin_manager.h"
+#include "ardour/session.h"
+#include "ardour/utils.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+/** Build a synthetic session on the Dummy backend, run it freewheeling
+ *  and report how long each process cycle took, as JSON.
+ *
+ *  Every track gets its input from the backend's signal generator, runs
+ *  it through the given number of plugins and sends it to every bus, so
+ *  that the same options always produce the same work.
+ */
+
+static void
+usage (int status)
+{
+	printf ("Usage: dsp_benchmark [ OPTIONS ]\n\n");
+	printf ("Options:\n\
+  -h, --help                 display this help and exit\n\
+  -t, --tracks <n>           number of mono tracks (default: 32)\n\
+  -p, --plugins <n>          plugins per track (default: 2)\n\
+  -P, --plugin <name>        plugin to use (default: \"a-High/Low Pass Filter\")\n\
+  -b, --busses <n>           number of stereo busses (default: 4)\n\
+  -S, --no-sends             do not send every track to every bus\n\
+  -A, --no-automation        do not automate track gain\n\
+  -c, --cycles <n>           process cycles to measure (default: 10000)\n\
+  -w, --warmup <n>           cycles to run before measuring (default: 500)\n\
+  -B, --buffer-size <n>      samples per cycle (default: 256)\n\
+  -r, --samplerate <rate>    sample rate (default: 48000)\n\
+  -o, --output <file>        write the JSON report to a file, not stdout\n\
+\n");
+	::exit (status);
+}
+
+/** Runs in the engine's process thread while freewheeling */
+class Bench
+{
+  public:
+	Bench (Session& s, uint32_t warmup, uint32_t cycles)
+		: session (s)
+		, warmup (warmup)
+		, cycles (cycles)
+		, n (0)
+		, done (0)
+	{
+		usecs.reserve (cycles);
+		playback_load.reserve (cycles);
+	}
+
+	void process (pframes_t nframes)
+	{
+		if (g_atomic_int_get (&done)) {
+			session.process (nframes);
+			return;
+		}
+
+		if (n == warmup) {
+			boost::shared_ptr<Graph> graph (session.process_graph ());
+			if (graph) {
+				graph->reset_thread_stats ();
+				graph->set_collect_thread_stats (true);
+			}
+		}
+
+		const gint64 start = g_get_monotonic_time ();
+		session.process (nframes);
+		const gint64 elapsed = g_get_monotonic_time () - start;
+
+		if (n++ < warmup) {
+			return;
+		}
+
+		usecs.push_back (elapsed);
+		playback_load.push_back (session.playback_load ());
+
+		if (usecs.size () == cycles) {
+			boost::shared_ptr<Graph> graph (session.process_graph ());
+			if (graph) {
+				graph->set_collect_thread_stats (false);
+			}
+			g_atomic_int_set (&done, 1);
+		}
+	}
+
+	bool finished () const { return g_atomic_int_get (&done); }
+
+	Session&         session;
+	uint32_t         warmup;
+	uint32_t         cycles;
+	uint32_t         n;
+	gint             done;
+	vector<gint64>   usecs;
+	vector<uint32_t> playback_load;
+};
+
+template<typename T>
+static T
+percentile (vector<T> const & sorted, double p)
+{
+	if (sorted.empty ()) {
+		return 0;
+	}
+	size_t i = (size_t) (p * (sorted.size () - 1) + 0.5);
+	return sorted[min (i, sorted.size () - 1)];
+}
+
+static PluginInfoPtr
+find_plugin (string const & name)
+{
+	PluginManager& pm (PluginManager::instance ());
+	PluginInfoList const * lists[] = { &pm.lua_plugin_info (), &pm.lv2_plugin_info (), &pm.ladspa_plugin_info () };
+
+	for (size_t l = 0; l < sizeof (lists) / sizeof (lists[0]); ++l) {
+		for (PluginInfoList::const_iterator i = lists[l]->begin (); i != lists[l]->end (); ++i) {
+			if ((*i)->name == name) {
+				return *i;
+			}
+		}
+	}
+
+	return PluginInfoPtr ();
+}
+
+static Session*
+create_session (uint32_t sample_rate, uint32_t buffer_size)
+{
+	AudioEngine* engine = AudioEngine::create ();
+
+	if (!engine->set_backend ("None (Dummy)", "DSP-Benchmark", "")) {
+		cerr << "Cannot create the Dummy backend\n";
+		return 0;
+	}
+
+	engine->set_device_name ("Sine Sweep");
+	engine->set_input_channels (8);
+	engine->set_output_channels (8);
+
+	if (engine->set_sample_rate (sample_rate) || engine->set_buffer_size (buffer_size)) {
+		cerr << "Cannot configure the Dummy backend\n";
+		return 0;
+	}
+
+	init_post_engine ();
+
+	if (engine->start () != 0) {
+		cerr << "Cannot start the Dummy backend\n";
+		return 0;
+	}
+
+	BusProfile bus_profile;
+	bus_profile.master_out_channels = 2;
+	bus_profile.input_ac = AutoConnectPhysical;
+	bus_profile.output_ac = AutoConnectMaster;
+	bus_profile.requested_physical_in = 0;
+	bus_profile.requested_physical_out = 0;
+
+	const string dir = Glib::build_filename (new_test_output_dir ("dsp_benchmark"), "session");
+
+	Session* session = new Session (*engine, dir, "dsp_benchmark", &bus_profile);
+	engine->set_session (session);
+
+	return session;
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_tracks = 32;
+	uint32_t n_plugins = 2;
+	string plugin_name = "a-High/Low Pass Filter";
+	uint32_t n_busses = 4;
+	bool sends = true;
+	bool automation = true;
+	uint32_t cycles = 10000;
+	uint32_t warmup = 500;
+	uint32_t buffer_size = 256;
+	uint32_t sample_rate = 48000;
+	string output;
+
+	const char *optstring = "hp:P:t:b:SAc:w:B:r:o:";
+
+	const struct option longopts[] = {
+		{ "help",          0, 0, 'h' },
+		{ "tracks",        1, 0, 't' },
+		{ "plugins",       1, 0, 'p' },
+		{ "plugin",        1, 0, 'P' },
+		{ "busses",        1, 0, 'b' },
+		{ "no-sends",      0, 0, 'S' },
+		{ "no-automation", 0, 0, 'A' },
+		{ "cycles",        1, 0, 'c' },
+		{ "warmup",        1, 0, 'w' },
+		{ "buffer-size",   1, 0, 'B' },
+		{ "samplerate",    1, 0, 'r' },
+		{ "output",        1, 0, 'o' },
+		{ 0, 0, 0, 0 },
+	};
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv, optstring, longopts, (int *) 0))) {
+		switch (c) {
+			case 't': n_tracks = atoi (optarg); break;
+			case 'p': n_plugins = atoi (optarg); break;
+			case 'P': plugin_name = optarg; break;
+			case 'b': n_busses = atoi (optarg); break;
+			case 'S': sends = false; break;
+			case 'A': automation = false; break;
+			case 'c': cycles = atoi (optarg); break;
+			case 'w': warmup = atoi (optarg); break;
+			case 'B': buffer_size = atoi (optarg); break;
+			case 'r': sample_rate = atoi (optarg); break;
+			case 'o': output = optarg; break;
+			case 'h': usage (0); break;
+			default: usage (EXIT_FAILURE); break;
+		}
+	}
+
+	if (cycles == 0 || buffer_size == 0 || sample_rate == 0) {
+		usage (EXIT_FAILURE);
+	}
+
+	ARDOUR::init (false, true, localedir);
+
+	Session* session = 0;
+
+	try {
+		session = create_session (sample_rate, buffer_size);
+	} catch (failed_constructor& e) {
+		cerr << "failed_constructor: " << e.what () << "\n";
+	} catch (exception& e) {
+		cerr << "exception: " << e.what () << "\n";
+	}
+
+	if (!session) {
+		exit (EXIT_FAILURE);
+	}
+
+	PluginInfoPtr plugin;
+
+	if (n_plugins > 0 && !(plugin = find_plugin (plugin_name))) {
+		cerr << string_compose ("Plugin \"%1\" not found\n", plugin_name);
+		exit (EXIT_FAILURE);
+	}
+
+	/* build the session */
+
+	const framecnt_t length = (framecnt_t) (warmup + cycles) * buffer_size;
+
+	list<boost::shared_ptr<AudioTrack> > tracks = session->new_audio_track (1, 2, 0, n_tracks, "Track", PresentationInfo::max_order);
+	RouteList busses = session->new_audio_route (2, 2, 0, n_busses, "Bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+
+	if (tracks.size () != n_tracks || busses.size () != n_busses) {
+		cerr << "Could not create all tracks and busses\n";
+		exit (EXIT_FAILURE);
+	}
+
+	boost::shared_ptr<RouteList> senders (new RouteList);
+
+	for (list<boost::shared_ptr<AudioTrack> >::iterator t = tracks.begin (); t != tracks.end (); ++t) {
+
+		/* play what the generator feeds in, whether rolling or not */
+		(*t)->monitoring_control ()->set_value (MonitorInput, Controllable::NoGroup);
+
+		for (uint32_t p = 0; p < n_plugins; ++p) {
+			boost::shared_ptr<Processor> processor (new PluginInsert (*session, plugin->load (*session)));
+			if ((*t)->add_processor (processor, PreFader)) {
+				cerr << string_compose ("Could not add \"%1\" to %2\n", plugin_name, (*t)->name ());
+				exit (EXIT_FAILURE);
+			}
+			processor->activate ();
+		}
+
+		if (automation) {
+			/* a fade down and back up again over the whole run */
+			boost::shared_ptr<AutomationList> al ((*t)->gain_control ()->alist ());
+			al->clear ();
+			al->add (0, 1.0, false);
+			al->add (length / 2, 0.25, false);
+			al->add (length, 1.0, false);
+			(*t)->gain_control ()->set_automation_state (Play);
+		}
+
+		senders->push_back (*t);
+	}
+
+	if (sends) {
+		for (RouteList::iterator b = busses.begin (); b != busses.end (); ++b) {
+			session->add_internal_sends (*b, PostFader, senders);
+		}
+	}
+
+	/* run it */
+
+	Bench bench (*session, warmup, cycles);
+	ScopedConnection connection;
+	AudioEngine* engine = AudioEngine::instance ();
+
+	session->request_locate (0, true);
+	while (!session->transport_rolling ()) {
+		Glib::usleep (1000);
+	}
+
+	engine->Freewheel.connect_same_thread (connection, boost::bind (&Bench::process, &bench, _1));
+
+	RTArena::reset_stats ();
+
+	if (engine->freewheel (true)) {
+		cerr << "Cannot start freewheeling\n";
+		exit (EXIT_FAILURE);
+	}
+
+	while (!bench.finished ()) {
+		Glib::usleep (10000);
+	}
+
+	engine->freewheel (false);
+	connection.disconnect ();
+
+	/* report */
+
+	vector<gint64> usecs (bench.usecs);
+	sort (usecs.begin (), usecs.end ());
+
+	vector<uint32_t> loads (bench.playback_load);
+	sort (loads.begin (), loads.end ());
+
+	gint64 total = 0;
+	for (vector<gint64>::const_iterator i = usecs.begin (); i != usecs.end (); ++i) {
+		total += *i;
+	}
+
+	const double period = 1e6 * buffer_size / (double) sample_rate;
+
+	stringstream json;
+	json << "{\n"
+	     << "  \"config\": {\n"
+	     << "    \"tracks\": " << n_tracks << ",\n"
+	     << "    \"plugins_per_track\": " << n_plugins << ",\n"
+	     << "    \"plugin\": \"" << plugin_name << "\",\n"
+	     << "    \"busses\": " << n_busses << ",\n"
+	     << "    \"sends\": " << (sends ? "true" : "false") << ",\n"
+	     << "    \"automation\": " << (automation ? "true" : "false") << ",\n"
+	     << "    \"buffer_size\": " << buffer_size << ",\n"
+	     << "    \"sample_rate\": " << sample_rate << ",\n"
+	     << "    \"warmup_cycles\": " << warmup << ",\n"
+	     << "    \"cycles\": " << cycles << ",\n"
+	     << "    \"dsp_threads\": " << how_many_dsp_threads () << "\n"
+	     << "  },\n"
+	     << "  \"cycle_usecs\": {\n"
+	     << "    \"period\": " << period << ",\n"
+	     << "    \"mean\": " << total / (double) usecs.size () << ",\n"
+	     << "    \"p50\": " << percentile (usecs, .5) << ",\n"
+	     << "    \"p99\": " << percentile (usecs, .99) << ",\n"
+	     << "    \"max\": " << usecs.back () << "\n"
+	     << "  },\n"
+	     << "  \"butler_playback_load\": {\n"
+	     << "    \"min\": " << loads.front () << ",\n"
+	     << "    \"p1\": " << percentile (loads, .01) << ",\n"
+	     << "    \"p50\": " << percentile (loads, .5) << "\n"
+	     << "  },\n"
+	     << "  \"graph_thread_utilization\": [";
+
+	boost::shared_ptr<Graph> graph (session->process_graph ());
+	if (graph) {
+		vector<gint64> busy;
+		graph->thread_stats (busy);
+		for (size_t i = 0; i < busy.size (); ++i) {
+			json << (i ? ", " : " ") << (total ? busy[i] / (double) total : 0);
+		}
+		json << " ";
+	}
+
+	json << "],\n"
+	     << "  \"rt_arenas\": [";
+
+	vector<RTArena::Stats> arenas;
+	RTArena::get_stats (arenas);
+	for (vector<RTArena::Stats>::const_iterator i = arenas.begin (); i != arenas.end (); ++i) {
+		json << (i == arenas.begin () ? "\n" : ",\n")
+		     << "    { \"name\": \"" << i->name << "\""
+		     << ", \"size\": " << i->size
+		     << ", \"high_water\": " << i->high_water
+		     << ", \"allocs\": " << i->n_alloc
+		     << ", \"malloc_fallbacks\": " << i->n_fallback << " }";
+	}
+
+	json << "\n  ]\n"
+	     << "}\n";
+
+	if (output.empty ()) {
+		cout << json.str ();
+	} else {
+		ofstream f (output.c_str ());
+		f << json.str ();
+		if (!f) {
+			cerr << string_compose ("Could not write %1\n", output);
+			exit (EXIT_FAILURE);
+		}
+	}
+
+	engine->remove_session ();
+	delete session;
+	engine->stop ();
+	AudioEngine::destroy ();
+
+	return 0;
+}
@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <glib.h>
+
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+/** Time each of the runtime mix functions, for every implementation which
+ *  this CPU can run, and check that they agree with the default ones.
+ *  Syntax: mix_kernels [<frames-per-call> [<calls>]]
+ *
+ *  The interleave functions are measured on an 8 channel buffer.
+ *
+ *  Finally the gain stages of Amp::run() are timed for 8 channels, as the
+ *  previous per-channel scalar code ("legacy") and as the current code
+ *  using these kernels.
+ */
+
+struct KernelSet {
+	KernelSet (const char* n)
+		: name (n)
+		, compute_peak (default_compute_peak)
+		, find_peaks (default_find_peaks)
+		, apply_gain_to_buffer (default_apply_gain_to_buffer)
+		, mix_buffers_with_gain (default_mix_buffers_with_gain)
+		, mix_buffers_no_gain (default_mix_buffers_no_gain)
+		, copy_vector (default_copy_vector)
+		, apply_gain_ramp (default_apply_gain_ramp)
+		, interleave_channel (default_interleave_channel)
+		, deinterleave_channel (default_deinterleave_channel)
+		, apply_gain_curve (default_apply_gain_curve)
+		, apply_gain_lpf (default_apply_gain_lpf)
+	{}
+
+	const char*             name;
+	compute_peak_t          compute_peak;
+	find_peaks_t            find_peaks;
+	apply_gain_to_buffer_t  apply_gain_to_buffer;
+	mix_buffers_with_gain_t mix_buffers_with_gain;
+	mix_buffers_no_gain_t   mix_buffers_no_gain;
+	copy_vector_t           copy_vector;
+	apply_gain_ramp_t       apply_gain_ramp;
+	interleave_channel_t    interleave_channel;
+	deinterleave_channel_t  deinterleave_channel;
+	apply_gain_curve_t      apply_gain_curve;
+	apply_gain_lpf_t        apply_gain_lpf;
+};
+
+static const uint32_t n_channels = 8;
+
+static pframes_t nframes = 1024;
+static int       n_calls = 20000;
+
+static Sample* src_buf;
+static Sample* dst_buf;
+static Sample* ref_buf;
+static Sample* interleaved;
+static gain_t* gain_buf;
+
+static Sample*
+alloc_buffer (size_t n)
+{
+	void* p;
+	cache_aligned_malloc (&p, n * sizeof (Sample));
+	return (Sample*) p;
+}
+
+static void
+fill (Sample* buf, size_t n, unsigned int seed)
+{
+	srand (seed);
+	for (size_t i = 0; i < n; ++i) {
+		buf[i] = (rand () / (float) RAND_MAX) * 2.f - 1.f;
+	}
+}
+
+static bool
+same (Sample const * a, Sample const * b, size_t n, float tolerance)
+{
+	for (size_t i = 0; i < n; ++i) {
+		if (fabsf (a[i] - b[i]) > tolerance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void
+report (KernelSet const & k, const char* kernel, gint64 before, gint64 after, bool ok)
+{
+	const double ns_per_sample = (after - before) * 1000.0 / ((double) n_calls * nframes);
+	printf ("%-8s %-22s %8.4f ns/sample%s\n", k.name, kernel, ns_per_sample, ok ? "" : "  MISMATCH");
+}
+
+static bool
+run (KernelSet const & k)
+{
+	bool all_ok = true;
+	bool ok;
+	gint64 before;
+	gint64 after;
+
+	/* compute_peak */
+	fill (src_buf, nframes, 1);
+	ok = k.compute_peak (src_buf, nframes, 0.f) == default_compute_peak (src_buf, nframes, 0.f);
+	before = g_get_monotonic_time ();
+	float peak = 0.f;
+	for (int n = 0; n < n_calls; ++n) {
+		peak = k.compute_peak (src_buf, nframes, peak);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "compute_peak", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* find_peaks */
+	{
+		float kmin = 0.f, kmax = 0.f, dmin = 0.f, dmax = 0.f;
+		k.find_peaks (src_buf, nframes, &kmin, &kmax);
+		default_find_peaks (src_buf, nframes, &dmin, &dmax);
+		ok = kmin == dmin && kmax == dmax;
+		before = g_get_monotonic_time ();
+		for (int n = 0; n < n_calls; ++n) {
+			k.find_peaks (src_buf, nframes, &kmin, &kmax);
+		}
+		after = g_get_monotonic_time ();
+		report (k, "find_peaks", before, after, ok);
+		all_ok = all_ok && ok;
+	}
+
+	/* apply_gain_to_buffer; unity gain so that repeated calls do not
+	 * drift into denormals.
+	 */
+	fill (dst_buf, nframes, 2);
+	fill (ref_buf, nframes, 2);
+	k.apply_gain_to_buffer (dst_buf, nframes, .5f);
+	default_apply_gain_to_buffer (ref_buf, nframes, .5f);
+	ok = same (dst_buf, ref_buf, nframes, 0.f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.apply_gain_to_buffer (dst_buf, nframes, 1.f);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "apply_gain_to_buffer", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* mix_buffers_with_gain; FMA rounds once instead of twice */
+	fill (dst_buf, nframes, 3);
+	fill (ref_buf, nframes, 3);
+	k.mix_buffers_with_gain (dst_buf, src_buf, nframes, .7f);
+	default_mix_buffers_with_gain (ref_buf, src_buf, nframes, .7f);
+	ok = same (dst_buf, ref_buf, nframes, 1e-6f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.mix_buffers_with_gain (dst_buf, src_buf, nframes, 1e-3f);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "mix_buffers_with_gain", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* mix_buffers_no_gain */
+	fill (dst_buf, nframes, 4);
+	fill (ref_buf, nframes, 4);
+	k.mix_buffers_no_gain (dst_buf, src_buf, nframes);
+	default_mix_buffers_no_gain (ref_buf, src_buf, nframes);
+	ok = same (dst_buf, ref_buf, nframes, 0.f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.mix_buffers_no_gain (dst_buf, src_buf, nframes);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "mix_buffers_no_gain", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* copy_vector */
+	k.copy_vector (dst_buf, src_buf, nframes);
+	ok = same (dst_buf, src_buf, nframes, 0.f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.copy_vector (dst_buf, src_buf, nframes);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "copy_vector", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* apply_gain_ramp */
+	fill (dst_buf, nframes, 5);
+	fill (ref_buf, nframes, 5);
+	k.apply_gain_ramp (dst_buf, nframes, 1.f, .25f);
+	default_apply_gain_ramp (ref_buf, nframes, 1.f, .25f);
+	ok = same (dst_buf, ref_buf, nframes, 1e-6f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.apply_gain_ramp (dst_buf, nframes, 1.f, 1.f);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "apply_gain_ramp", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* interleave_channel, into channel 3 */
+	{
+		std::vector<Sample> expected (nframes * n_channels);
+		fill (interleaved, nframes * n_channels, 6);
+		memcpy (&expected[0], interleaved, nframes * n_channels * sizeof (Sample));
+		k.interleave_channel (interleaved + 3, src_buf, nframes, n_channels);
+		default_interleave_channel (&expected[3], src_buf, nframes, n_channels);
+		ok = same (interleaved, &expected[0], nframes * n_channels, 0.f);
+		before = g_get_monotonic_time ();
+		for (int n = 0; n < n_calls; ++n) {
+			k.interleave_channel (interleaved + 3, src_buf, nframes, n_channels);
+		}
+		after = g_get_monotonic_time ();
+		report (k, "interleave_channel", before, after, ok);
+		all_ok = all_ok && ok;
+	}
+
+	/* deinterleave_channel, from the last channel */
+	k.deinterleave_channel (dst_buf, interleaved + n_channels - 1, nframes, n_channels);
+	default_deinterleave_channel (ref_buf, interleaved + n_channels - 1, nframes, n_channels);
+	ok = same (dst_buf, ref_buf, nframes, 0.f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.deinterleave_channel (dst_buf, interleaved + n_channels - 1, nframes, n_channels);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "deinterleave_channel", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* apply_gain_curve; a curve around unity so that repeated calls do
+	 * not drift into denormals.
+	 */
+	for (pframes_t i = 0; i < nframes; ++i) {
+		gain_buf[i] = 1.f + ((i & 1) ? 1e-7f : -1e-7f);
+	}
+	fill (dst_buf, nframes, 7);
+	fill (ref_buf, nframes, 7);
+	k.apply_gain_curve (dst_buf, gain_buf, nframes);
+	default_apply_gain_curve (ref_buf, gain_buf, nframes);
+	ok = same (dst_buf, ref_buf, nframes, 0.f);
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		k.apply_gain_curve (dst_buf, gain_buf, nframes);
+	}
+	after = g_get_monotonic_time ();
+	report (k, "apply_gain_curve", before, after, ok);
+	all_ok = all_ok && ok;
+
+	/* apply_gain_lpf; a 25Hz fade at 48kHz, as used by Amp */
+	{
+		const float a = 156.825 / 48000.;
+		fill (dst_buf, nframes, 8);
+		fill (ref_buf, nframes, 8);
+		const float kg = k.apply_gain_lpf (dst_buf, nframes, 1.f, .25f, a);
+		const float dg = default_apply_gain_lpf (ref_buf, nframes, 1.f, .25f, a);
+		ok = same (dst_buf, ref_buf, nframes, 1e-6f) && fabsf (kg - dg) < 1e-6f;
+		before = g_get_monotonic_time ();
+		for (int n = 0; n < n_calls; ++n) {
+			k.apply_gain_lpf (dst_buf, nframes, 1.f, 1.f, a);
+		}
+		after = g_get_monotonic_time ();
+		report (k, "apply_gain_lpf", before, after, ok);
+		all_ok = all_ok && ok;
+	}
+
+	return all_ok;
+}
+
+/* Amp::run() with gain automation, before and after it used the kernels.
+ * `chn' are n_channels buffers of nframes samples, `gab' the automation
+ * curve.
+ */
+
+static gain_t
+legacy_automation (Sample** chn, gain_t* gab, gain_t current, double a)
+{
+	double lpf = current;
+	for (uint32_t c = 0; c < n_channels; ++c) {
+		Sample* const sp = chn[c];
+		lpf = current;
+		for (pframes_t nx = 0; nx < nframes; ++nx) {
+			sp[nx] *= lpf;
+			lpf += a * (gab[nx] - lpf);
+		}
+	}
+	return lpf;
+}
+
+static gain_t
+kernel_automation (KernelSet const & k, Sample** chn, gain_t* gab, gain_t current, double a)
+{
+	double lpf = current;
+	for (pframes_t nx = 0; nx < nframes; ++nx) {
+		const gain_t g = gab[nx];
+		gab[nx] = lpf;
+		lpf += a * (g - lpf);
+	}
+	for (uint32_t c = 0; c < n_channels; ++c) {
+		k.apply_gain_curve (chn[c], gab, nframes);
+	}
+	return lpf;
+}
+
+/* Amp::apply_gain(), a declicked change of gain */
+
+static gain_t
+legacy_declick (Sample** chn, gain_t initial, gain_t target, double a)
+{
+	gain_t rv = target;
+	for (uint32_t c = 0; c < n_channels; ++c) {
+		Sample* const buffer = chn[c];
+		double lpf = initial;
+		for (pframes_t nx = 0; nx < nframes; ++nx) {
+			buffer[nx] *= lpf;
+			lpf += a * (target - lpf);
+		}
+		if (c == 0) {
+			rv = lpf;
+		}
+	}
+	return rv;
+}
+
+static gain_t
+kernel_declick (KernelSet const & k, Sample** chn, gain_t initial, gain_t target, double a)
+{
+	gain_t rv = target;
+	for (uint32_t c = 0; c < n_channels; ++c) {
+		const gain_t lpf = k.apply_gain_lpf (chn[c], nframes, initial, target, a);
+		if (c == 0) {
+			rv = lpf;
+		}
+	}
+	return rv;
+}
+
+static void
+report_amp (const char* name, const char* stage, gint64 legacy, gint64 kernel)
+{
+	const double scale = 1000.0 / ((double) n_calls * nframes * n_channels);
+	printf ("%-8s %-22s %8.4f ns/sample (legacy %8.4f ns/sample, %5.2fx)\n",
+	        name, stage, kernel * scale, legacy * scale, legacy / (double) std::max ((gint64) 1, kernel));
+}
+
+static void
+run_amp (KernelSet const & k)
+{
+	const double a = 156.825 / 48000.;
+	Sample* chn[n_channels];
+	for (uint32_t c = 0; c < n_channels; ++c) {
+		chn[c] = interleaved + c * nframes;
+	}
+	std::vector<gain_t> curve (nframes);
+	gint64 before;
+	gint64 legacy;
+	gint64 kernel;
+
+	/* gain automation: a slow sawtooth around unity, so that the gain
+	 * curve is never constant but the buffers do not decay.
+	 */
+	for (pframes_t i = 0; i < nframes; ++i) {
+		curve[i] = 1.f + 1e-3f * ((i % 256) / 256.f - .5f);
+	}
+
+	fill (interleaved, nframes * n_channels, 9);
+	gain_t g = 1.f;
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		g = legacy_automation (chn, &curve[0], g, a);
+	}
+	legacy = g_get_monotonic_time () - before;
+
+	fill (interleaved, nframes * n_channels, 9);
+	g = 1.f;
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		memcpy (gain_buf, &curve[0], nframes * sizeof (gain_t)); // refilled every cycle by setup_gain_automation()
+		g = kernel_automation (k, chn, gain_buf, g, a);
+	}
+	kernel = g_get_monotonic_time () - before;
+	report_amp (k.name, "amp gain automation", legacy, kernel);
+
+	/* declick, alternating between two gains close to unity */
+	fill (interleaved, nframes * n_channels, 10);
+	g = 1.f;
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		g = legacy_declick (chn, g, (n & 1) ? 1.0001f : .9999f, a);
+	}
+	legacy = g_get_monotonic_time () - before;
+
+	fill (interleaved, nframes * n_channels, 10);
+	g = 1.f;
+	before = g_get_monotonic_time ();
+	for (int n = 0; n < n_calls; ++n) {
+		g = kernel_declick (k, chn, g, (n & 1) ? 1.0001f : .9999f, a);
+	}
+	kernel = g_get_monotonic_time () - before;
+	report_amp (k.name, "amp declick", legacy, kernel);
+}
+
+int
+main (int argc, char* argv[])
+{
+	if (argc > 1) {
+		nframes = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		n_calls = atoi (argv[2]);
+	}
+
+	if (nframes < 1 || n_calls < 1) {
+		cerr << "Syntax: " << argv[0] << " [<frames-per-call> [<calls>]]\n";
+		return EXIT_FAILURE;
+	}
+
+	src_buf = alloc_buffer (nframes);
+	dst_buf = alloc_buffer (nframes);
+	ref_buf = alloc_buffer (nframes);
+	interleaved = alloc_buffer (nframes * n_channels);
+	gain_buf = alloc_buffer (nframes);
+
+	std::vector<KernelSet> sets;
+
+	sets.push_back (KernelSet ("default"));
+
+	FPU* fpu = FPU::instance ();
+	(void) fpu;
+
+#if defined (ARCH_X86) && defined (BUILD_SSE_OPTIMIZATIONS)
+	if (fpu->has_sse ()) {
+		KernelSet k ("sse");
+		k.compute_peak          = x86_sse_compute_peak;
+		k.find_peaks            = x86_sse_find_peaks;
+		k.apply_gain_to_buffer  = x86_sse_apply_gain_to_buffer;
+		k.mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
+		k.mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
+		sets.push_back (k);
+	}
+
+	if (fpu->has_avx2 () && fpu->has_fma ()) {
+		KernelSet k ("avx2");
+		k.compute_peak          = x86_avx2_compute_peak;
+		k.find_peaks            = x86_avx2_find_peaks;
+		k.apply_gain_to_buffer  = x86_avx2_apply_gain_to_buffer;
+		k.mix_buffers_with_gain = x86_avx2_mix_buffers_with_gain;
+		k.mix_buffers_no_gain   = x86_avx2_mix_buffers_no_gain;
+		k.copy_vector           = x86_avx2_copy_vector;
+		k.apply_gain_ramp       = x86_avx2_apply_gain_ramp;
+		k.interleave_channel    = x86_avx2_interleave_channel;
+		k.deinterleave_channel  = x86_avx2_deinterleave_channel;
+		k.apply_gain_curve      = x86_avx2_apply_gain_curve;
+		k.apply_gain_lpf        = x86_avx2_apply_gain_lpf;
+		sets.push_back (k);
+	}
+
+	if (fpu->has_avx512f ()) {
+		KernelSet k ("avx512f");
+		k.compute_peak          = x86_avx512f_compute_peak;
+		k.find_peaks            = x86_avx512f_find_peaks;
+		k.apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+		k.mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+		k.mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+		k.copy_vector           = x86_avx512f_copy_vector;
+		k.apply_gain_ramp       = x86_avx512f_apply_gain_ramp;
+		k.interleave_channel    = x86_avx512f_interleave_channel;
+		k.deinterleave_channel  = x86_avx512f_deinterleave_channel;
+		k.apply_gain_curve      = x86_avx512f_apply_gain_curve;
+		k.apply_gain_lpf        = x86_avx512f_apply_gain_lpf;
+		sets.push_back (k);
+	}
+#elif defined (__aarch64__) && defined (BUILD_NEON_OPTIMIZATIONS)
+	if (fpu->has_neon ()) {
+		KernelSet k ("neon");
+		k.compute_peak          = arm_neon_compute_peak;
+		k.find_peaks            = arm_neon_find_peaks;
+		k.apply_gain_to_buffer  = arm_neon_apply_gain_to_buffer;
+		k.mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
+		k.mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
+		k.copy_vector           = arm_neon_copy_vector;
+		k.apply_gain_ramp       = arm_neon_apply_gain_ramp;
+		k.interleave_channel    = arm_neon_interleave_channel;
+		k.deinterleave_channel  = arm_neon_deinterleave_channel;
+		k.apply_gain_curve      = arm_neon_apply_gain_curve;
+		k.apply_gain_lpf        = arm_neon_apply_gain_lpf;
+		sets.push_back (k);
+	}
+#endif
+
+	printf ("%u frames per call, %d calls\n", nframes, n_calls);
+
+	bool ok = true;
+
+	for (std::vector<KernelSet>::const_iterator k = sets.begin(); k != sets.end(); ++k) {
+		ok = run (*k) && ok;
+	}
+
+	for (std::vector<KernelSet>::const_iterator k = sets.begin(); k != sets.end(); ++k) {
+		run_amp (*k);
+	}
+
+	cache_aligned_free (src_buf);
+	cache_aligned_free (dst_buf);
+	cache_aligned_free (ref_buf);
+	cache_aligned_free (interleaved);
+	cache_aligned_free (gain_buf);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+#include "test_util.h"
+#include "ardour/ardour.h"
+#include "ardour/midi_track.h"
+#include "ardour/midi_region.h"
+#include "ardour/session.h"
+#include "ardour/playlist.h"
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+/** Time positional queries on a playlist with many regions.
+ *  Syntax: region_queries [<number-of-regions> [<queries>]]
+ */
+int
+main (int argc, char* argv[])
+{
+	int n_regions = 10000;
+	int n_queries = 10000;
+
+	if (argc > 1) {
+		n_regions = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		n_queries = atoi (argv[2]);
+	}
+
+	ARDOUR::init (false, true, localedir);
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	assert (session->get_routes()->size() == 2);
+
+	boost::shared_ptr<MidiTrack> track = boost::dynamic_pointer_cast<MidiTrack> (session->get_routes()->back());
+	assert (track);
+
+	boost::shared_ptr<Playlist> playlist = track->playlist ();
+	assert (playlist);
+
+	boost::shared_ptr<MidiRegion> region = boost::dynamic_pointer_cast<MidiRegion> (playlist->region_list_property().rlist().front());
+	assert (region);
+
+	gint64 before = g_get_monotonic_time ();
+	playlist->duplicate (region, region->last_frame() + 1, n_regions - 1);
+	gint64 after = g_get_monotonic_time ();
+
+	cout << "duplicate " << playlist->n_regions() << " regions: " << (after - before) << "us\n";
+
+	framepos_t const extent = playlist->get_extent().second;
+	framecnt_t const step = max ((framecnt_t) 1, (framecnt_t) (extent / n_queries));
+	framecnt_t const width = region->length() * 4;
+	size_t found = 0;
+
+	before = g_get_monotonic_time ();
+	for (framepos_t p = 0; p < extent; p += step) {
+		found += playlist->regions_touched (p, p + width)->size ();
+	}
+	after = g_get_monotonic_time ();
+	cout << "regions_touched: " << (after - before) << "us (" << found << " found)\n";
+
+	found = 0;
+	before = g_get_monotonic_time ();
+	for (framepos_t p = 0; p < extent; p += step) {
+		found += playlist->regions_at (p)->size ();
+	}
+	after = g_get_monotonic_time ();
+	cout << "regions_at: " << (after - before) << "us (" << found << " found)\n";
+
+	found = 0;
+	before = g_get_monotonic_time ();
+	for (framepos_t p = 0; p < extent; p += step) {
+		found += playlist->count_regions_at (p);
+	}
+	after = g_get_monotonic_time ();
+	cout << "count_regions_at: " << (after - before) << "us (" << found << " found)\n";
+
+	found = 0;
+	before = g_get_monotonic_time ();
+	for (framepos_t p = 0; p < extent; p += step) {
+		if (playlist->find_next_region (p, Start, 1)) {
+			++found;
+		}
+		if (playlist->find_next_region (p, Start, -1)) {
+			++found;
+		}
+		if (playlist->find_next_region (p, End, 1)) {
+			++found;
+		}
+	}
+	after = g_get_monotonic_time ();
+	cout << "find_next_region: " << (after - before) << "us (" << found << " found)\n";
+
+	return 0;
+}
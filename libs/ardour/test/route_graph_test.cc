@@ -0,0 +1,93 @@
+#include <vector>
+
+#include "ardour/audio_track.h"
+#include "ardour/io.h"
+#include "ardour/port.h"
+#include "ardour/port_set.h"
+#include "ardour/route_graph.h"
+#include "ardour/send.h"
+#include "ardour/session.h"
+
+#include "route_graph_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (RouteGraphTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/** Check that the graph left by the last (partial) re-sort is the same
+ *  as the one found by re-examining every pair of routes.
+ */
+void
+RouteGraphTest::check_against_full_resort ()
+{
+	GraphEdges partial = _session->current_route_graph ();
+	_session->resort_routes ();
+	GraphEdges full = _session->current_route_graph ();
+
+	boost::shared_ptr<RouteList> routes = _session->get_routes ();
+
+	for (RouteList::iterator i = routes->begin(); i != routes->end(); ++i) {
+		for (RouteList::iterator j = routes->begin(); j != routes->end(); ++j) {
+			bool partial_sends_only = false;
+			bool full_sends_only = false;
+			const bool in_partial = partial.has (*i, *j, &partial_sends_only);
+			const bool in_full = full.has (*i, *j, &full_sends_only);
+			CPPUNIT_ASSERT_EQUAL (in_full, in_partial);
+			CPPUNIT_ASSERT_EQUAL (full_sends_only, partial_sends_only);
+		}
+	}
+}
+
+static void
+connect_outputs (boost::shared_ptr<Route> from, boost::shared_ptr<Route> to)
+{
+	from->output()->disconnect (0);
+
+	PortSet& out (from->output()->ports ());
+	PortSet& in (to->input()->ports ());
+
+	for (uint32_t n = 0; n < out.num_ports (DataType::AUDIO) && n < in.num_ports (DataType::AUDIO); ++n) {
+		from->output()->connect (out.port (DataType::AUDIO, n), in.port (DataType::AUDIO, n)->name (), 0);
+	}
+}
+
+void
+RouteGraphTest::partialResortTest ()
+{
+	list<boost::shared_ptr<AudioTrack> > t = _session->new_audio_track (1, 2, NULL, 4, "Track", PresentationInfo::max_order, Normal);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, t.size ());
+	vector<boost::shared_ptr<Route> > tracks (t.begin (), t.end ());
+
+	RouteList b = _session->new_audio_route (2, 2, NULL, 2, "Bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, b.size ());
+	vector<boost::shared_ptr<Route> > busses (b.begin (), b.end ());
+
+	bool sends_only;
+
+	/* a processor change: adding a send re-sorts the sending route */
+	tracks[0]->add_aux_send (busses[0], boost::shared_ptr<Processor> ());
+	check_against_full_resort ();
+	CPPUNIT_ASSERT (GraphEdges (_session->current_route_graph ()).has (tracks[0], busses[0], &sends_only));
+	CPPUNIT_ASSERT (sends_only);
+
+	/* an IO change only marks the route; the next processor change
+	   re-sorts both it and the route whose processors changed.
+	*/
+	connect_outputs (tracks[1], busses[1]);
+	tracks[2]->add_aux_send (busses[1], boost::shared_ptr<Processor> ());
+	check_against_full_resort ();
+	CPPUNIT_ASSERT (GraphEdges (_session->current_route_graph ()).has (tracks[1], busses[1], &sends_only));
+	CPPUNIT_ASSERT (!sends_only);
+
+	/* a bus feeding another, and so the tracks sending to it */
+	connect_outputs (busses[0], busses[1]);
+	tracks[3]->add_aux_send (busses[0], boost::shared_ptr<Processor> ());
+	check_against_full_resort ();
+	CPPUNIT_ASSERT (GraphEdges (_session->current_route_graph ()).feeds (tracks[0], busses[1]));
+
+	/* removing a send */
+	CPPUNIT_ASSERT_EQUAL (0, tracks[0]->remove_processor (tracks[0]->internal_send_for (busses[0])));
+	check_against_full_resort ();
+	CPPUNIT_ASSERT (!GraphEdges (_session->current_route_graph ()).has (tracks[0], busses[0], &sends_only));
+}
@@ -0,0 +1,15 @@
+#include "test_needing_session.h"
+
+/** Tests for re-sorting only the routes whose connections have changed */
+class RouteGraphTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (RouteGraphTest);
+	CPPUNIT_TEST (partialResortTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void partialResortTest ();
+
+private:
+	void check_against_full_resort ();
+};
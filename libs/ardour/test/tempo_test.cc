@@ -635,3 +635,60 @@ TempoTest::tempoFundamentalsTest ()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (164.0, tE->quarter_notes_per_minute (), 1e-17);
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (41.0, tE->pulses_per_minute (), 1e-17);
 }
+
+void
+TempoTest::pointsTest ()
+{
+	int const sampling_rate = 48000;
+
+	TempoMap map (sampling_rate);
+	map.replace_meter (map.first_meter(), Meter (4, 4), BBT_Time (1, 1, 0), 0, AudioTime);
+	map.replace_tempo (map.first_tempo(), Tempo (120.0, 4.0), 0.0, 0, AudioTime);
+
+	/* lots of tempo changes, alternately ramped and constant */
+	for (int n = 1; n < 400; ++n) {
+		const double npm = 60.0 + (n % 17) * 10.0;
+		const double end_npm = (n % 2) ? npm + 15.0 : npm;
+		map.add_tempo (Tempo (npm, 4.0, end_npm), n * 0.75, 0, MusicTime);
+	}
+
+	/* and some meter changes: 4/4 until bar 9, 3/4 until bar 17 */
+	map.add_meter (Meter (3, 4), 32.0, BBT_Time (9, 1, 0), 0, MusicTime);
+	map.add_meter (Meter (4, 4), 56.0, BBT_Time (17, 1, 0), 0, MusicTime);
+
+	boost::shared_ptr<TempoMapPoints> points (map._points.reader ());
+	const double last_minute = map.minute_at_pulse_locked (map._metrics, 320.0);
+
+	for (double minute = -0.5; minute < last_minute; minute += last_minute / 997.0) {
+		CPPUNIT_ASSERT_EQUAL (map.pulse_at_minute_locked (map._metrics, minute), points->pulse_at_minute (minute));
+		CPPUNIT_ASSERT_EQUAL (map.beat_at_minute_locked (map._metrics, minute), points->beat_at_minute (minute));
+		CPPUNIT_ASSERT_EQUAL (map.tempo_at_minute_locked (map._metrics, minute).note_types_per_minute(),
+		                      points->tempo_at_minute (minute).note_types_per_minute());
+		CPPUNIT_ASSERT (map.bbt_at_minute_locked (map._metrics, minute) == points->bbt_at_minute (minute));
+	}
+
+	for (double pulse = -1.0; pulse < 320.0; pulse += 0.3) {
+		const double beat = pulse * 4.0;
+		CPPUNIT_ASSERT_EQUAL (map.minute_at_pulse_locked (map._metrics, pulse), points->minute_at_pulse (pulse));
+		CPPUNIT_ASSERT_EQUAL (map.minute_at_beat_locked (map._metrics, beat), points->minute_at_beat (beat));
+		CPPUNIT_ASSERT_EQUAL (map.pulse_at_beat_locked (map._metrics, beat), points->pulse_at_beat (beat));
+		CPPUNIT_ASSERT_EQUAL (map.beat_at_pulse_locked (map._metrics, pulse), points->beat_at_pulse (pulse));
+		CPPUNIT_ASSERT (map.bbt_at_beat_locked (map._metrics, beat) == points->bbt_at_beat (beat));
+	}
+
+	for (uint32_t bars = 1; bars < 300; ++bars) {
+		const BBT_Time bbt (bars, 2, 960);
+		CPPUNIT_ASSERT_EQUAL (map.beat_at_bbt_locked (map._metrics, bbt), points->beat_at_bbt (bbt));
+		CPPUNIT_ASSERT_EQUAL (map.pulse_at_bbt_locked (map._metrics, bbt), points->pulse_at_bbt (bbt));
+	}
+
+	for (framepos_t frame = 0; frame < 60 * sampling_rate; frame += 4801) {
+		CPPUNIT_ASSERT_EQUAL (map.quarter_notes_between_frames_locked (map._metrics, frame, frame + 123456),
+		                      points->quarter_notes_between_frames (frame, frame + 123456));
+	}
+
+	/* the published points must follow changes to the map */
+	map.add_tempo (Tempo (200.0, 4.0), 10.1, 0, MusicTime);
+	CPPUNIT_ASSERT (points != map._points.reader ());
+	CPPUNIT_ASSERT_EQUAL (map.frame_at_minute (map.minute_at_pulse_locked (map._metrics, 10.2)), map.frame_at_quarter_note (40.8));
+}
@@ -625,13 +625,31 @@ Track::capture_buffer_load () const
 int
 Track::do_refill ()
 {
-	return _diskstream->do_refill ();
+	const int64_t before = g_get_monotonic_time ();
+	int ret = _diskstream->do_refill ();
+	const uint64_t elapsed = g_get_monotonic_time () - before;
+
+	_disk_io_stats.n_reads++;
+	_disk_io_stats.total_read_usecs += elapsed;
+	_disk_io_stats.last_read_usecs = elapsed;
+	_disk_io_stats.max_read_usecs = std::max (_disk_io_stats.max_read_usecs, elapsed);
+
+	return ret;
 }
 
 int
 Track::do_flush (RunContext c, bool force)
 {
-	return _diskstream->do_flush (c, force);
+	const int64_t before = g_get_monotonic_time ();
+	int ret = _diskstream->do_flush (c, force);
+	const uint64_t elapsed = g_get_monotonic_time () - before;
+
+	_disk_io_stats.n_writes++;
+	_disk_io_stats.total_write_usecs += elapsed;
+	_disk_io_stats.last_write_usecs = elapsed;
+	_disk_io_stats.max_write_usecs = std::max (_disk_io_stats.max_write_usecs, elapsed);
+
+	return ret;
 }
 
 void
@@ -29,11 +29,24 @@
 #include <unistd.h>
 #include <errno.h>
 
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/file.h>
+#endif
+
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
@@ -110,6 +123,79 @@ vstfx_infofile_path (const char* dllpath)
 
 /* *** VST Blacklist *** */
 
+/* Several scanner processes may run at once, and each of them adds the
+ * plugin it checks to the blacklist and then removes it again.  Changes
+ * to the blacklist are made while holding a lock file, so that they are
+ * not lost.
+ */
+class BlacklistLock {
+  public:
+	BlacklistLock ()
+		: _fd (::g_open (Glib::build_filename (ARDOUR::user_cache_directory (), string (VST_BLACKLIST) + ".lock").c_str (), O_CREAT | O_RDWR, 0644))
+		, _locked (false)
+	{
+		if (_fd < 0) {
+			return;
+		}
+		/* the system drops the lock of a scanner that is killed, so one
+		 * which is still held after a few seconds belongs to a scanner that
+		 * hangs; carry on without it rather than hang as well.
+		 */
+		for (int tries = 0; tries < 300; ++tries) {
+			if (try_lock ()) {
+				_locked = true;
+				return;
+			}
+			g_usleep (10000);
+		}
+		PBD::warning << _("Timed out waiting for the VST blacklist lock") << endmsg;
+	}
+
+	~BlacklistLock ()
+	{
+		/* the lock file itself stays, removing it would race with
+		 * another scanner that has just opened it.
+		 */
+		if (_fd < 0) {
+			return;
+		}
+		if (_locked) {
+			unlock ();
+		}
+		::close (_fd);
+	}
+
+  private:
+	int  _fd;
+	bool _locked;
+
+#ifdef PLATFORM_WINDOWS
+	bool try_lock ()
+	{
+		OVERLAPPED ov;
+		memset (&ov, 0, sizeof (ov));
+		return LockFileEx ((HANDLE) _get_osfhandle (_fd), LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &ov);
+	}
+
+	void unlock ()
+	{
+		OVERLAPPED ov;
+		memset (&ov, 0, sizeof (ov));
+		UnlockFileEx ((HANDLE) _get_osfhandle (_fd), 0, 1, 0, &ov);
+	}
+#else
+	bool try_lock ()
+	{
+		return ::flock (_fd, LOCK_EX | LOCK_NB) == 0;
+	}
+
+	void unlock ()
+	{
+		::flock (_fd, LOCK_UN);
+	}
+#endif
+};
+
 static void vstfx_read_blacklist (std::string &bl) {
 	FILE * blacklist_fd = NULL;
 	bl = "";
@@ -144,6 +230,7 @@ static void vstfx_read_blacklist (std::string &bl) {
 static void vstfx_blacklist (const char *id)
 {
 	string fn = Glib::build_filename (ARDOUR::user_cache_directory (), VST_BLACKLIST);
+	BlacklistLock lock;
 	FILE * blacklist_fd = NULL;
 	if (! (blacklist_fd = g_fopen (fn.c_str (), "a"))) {
 		PBD::error << string_compose (_("Cannot append to VST blacklist for '%1'"), id) << endmsg;
@@ -159,6 +246,7 @@ static void vstfx_un_blacklist (const char *idcs)
 {
 	string id (idcs);
 	string fn = Glib::build_filename (ARDOUR::user_cache_directory (), VST_BLACKLIST);
+	BlacklistLock lock;
 	if (!Glib::file_test (fn, Glib::FILE_TEST_EXISTS)) {
 		PBD::warning << _("Expected VST Blacklist file does not exist.") << endmsg;
 		return;
@@ -190,6 +278,30 @@ static void vstfx_un_blacklist (const char *idcs)
 	::fclose (blacklist_fd);
 }
 
+/** read the blacklist into @param bl, one entry per plugin */
+static void vstfx_read_blacklist (std::set<std::string>& bl)
+{
+	bl.clear ();
+
+	string fn = Glib::build_filename (ARDOUR::user_cache_directory (), VST_BLACKLIST);
+	if (!Glib::file_test (fn, Glib::FILE_TEST_EXISTS)) {
+		return;
+	}
+
+	std::string s;
+	{
+		BlacklistLock lock;
+		vstfx_read_blacklist (s);
+	}
+
+	string::size_type pos = 0;
+	string::size_type nl;
+	while ((nl = s.find ('\n', pos)) != string::npos) {
+		bl.insert (s.substr (pos, nl - pos));
+		pos = nl + 1;
+	}
+}
+
 /* return true if plugin is blacklisted */
 static bool vst_is_blacklisted (const char *idcs)
 {
@@ -201,7 +313,10 @@ static bool vst_is_blacklisted (const char *idcs)
 	}
 
 	std::string bl;
-	vstfx_read_blacklist (bl);
+	{
+		BlacklistLock lock;
+		vstfx_read_blacklist (bl);
+	}
 
 	assert (id.find ("\n") == string::npos);
 
@@ -438,6 +553,26 @@ vstfx_remove_infofile (const char *dllpath)
 	::g_unlink (vstfx_infofile_path (dllpath).c_str ());
 }
 
+/** @return true if there is an info file for the given plugin which
+ * is newer than the plugin itself
+ */
+static bool
+vstfx_infofile_is_current (const char* dllpath)
+{
+	string const path = vstfx_infofile_path (dllpath);
+
+	if (!Glib::file_test (path, Glib::FileTest (Glib::FILE_TEST_EXISTS | Glib::FILE_TEST_IS_REGULAR))) {
+		return false;
+	}
+
+	GStatBuf dllstat;
+	GStatBuf fsistat;
+
+	return g_stat (dllpath, &dllstat) == 0
+		&& g_stat (path.c_str (), &fsistat) == 0
+		&& dllstat.st_mtime <= fsistat.st_mtime;
+}
+
 /** cache file for given plugin
  * @return FILE of the .fsi cache if found and up-to-date*/
 static FILE *
@@ -456,18 +591,12 @@ vstfx_infofile_for_read (const char* dllpath)
 
 	string const path = vstfx_infofile_path (dllpath);
 
+	if (vstfx_infofile_is_current (dllpath)) {
+		/* plugin is older than info file */
+		return g_fopen (path.c_str (), "rb");
+	}
+
 	if (Glib::file_test (path, Glib::FileTest (Glib::FILE_TEST_EXISTS | Glib::FILE_TEST_IS_REGULAR))) {
-		GStatBuf dllstat;
-		GStatBuf fsistat;
-
-		if (g_stat (dllpath, &dllstat) == 0) {
-			if (g_stat (path.c_str (), &fsistat) == 0) {
-				if (dllstat.st_mtime <= fsistat.st_mtime) {
-					/* plugin is older than info file */
-					return g_fopen (path.c_str (), "rb");
-				}
-			}
-		}
 		PBD::warning << string_compose (_("Ignored VST plugin which is newer than cache: '%1' (cache: '%2')"), dllpath, path) << endmsg;
 		PBD::info << _("Re-Scan Plugins (Preferences > Plugins) to update the cache, also make sure your system-time is set correctly.") << endmsg;
 	}
@@ -908,53 +1037,160 @@ vstfx_instantiate_and_get_info_mac (
 }
 #endif
 
-/* *** ERROR LOGGING *** */
+/* *** EXTERNAL SCANNER *** */
 #ifndef VST_SCANNER_APP
 
-static FILE * _errorlog_fd = 0;
-static char * _errorlog_dll = 0;
+/** one run of the scanner app, checking one plugin */
+struct ScanJob {
+	ScanJob (std::string const & p) : dllpath (p), scanner (0), timeout (PLUGIN_SCAN_TIMEOUT) {}
+	~ScanJob () { delete scanner; }
+
+	std::string dllpath;
+	ARDOUR::SystemExec* scanner;
+	int timeout; // deciseconds left
 
-static void parse_scanner_output (std::string msg, size_t /*len*/)
+	/* output is collected, and reported when the scanner is done, so
+	 * that messages from several scanners are not interleaved.
+	 */
+	PBD::ScopedConnection output_connection;
+	Glib::Threads::Mutex output_lock;
+	std::string output;
+};
+
+static void
+collect_scanner_output (ScanJob* job, std::string msg, size_t /*len*/)
 {
-	if (!_errorlog_fd && !_errorlog_dll) {
-		PBD::error << "VST scanner: " << msg;
-		return;
-	}
+	Glib::Threads::Mutex::Lock lm (job->output_lock);
+	job->output += msg;
+}
 
-#if 0 // TODO
-	if (!_errorlog_fd) {
-		if (!(_errorlog_fd = g_fopen (vstfx_errorfile_path (_errorlog_dll).c_str (), "w"))) {
-			PBD::error << "Cannot create plugin error-log for plugin " << _errorlog_dll;
-			free (_errorlog_dll);
-			_errorlog_dll = NULL;
-		}
+static ScanJob*
+start_scan_job (std::string const & scanner_bin_path, std::string const & dllpath)
+{
+	char **argp= (char**) calloc (3,sizeof (char*));
+	argp[0] = strdup (scanner_bin_path.c_str ());
+	argp[1] = strdup (dllpath.c_str ());
+	argp[2] = 0;
+
+	ScanJob* job = new ScanJob (dllpath);
+	job->scanner = new ARDOUR::SystemExec (scanner_bin_path, argp);
+	job->scanner->ReadStdout.connect_same_thread (job->output_connection, boost::bind (&collect_scanner_output, job, _1 ,_2));
+
+	if (job->scanner->start (2 /* send stderr&stdout via signal */)) {
+		PBD::error << string_compose (_("Cannot launch VST scanner app '%1': %2"), scanner_bin_path, strerror (errno)) << endmsg;
+		delete job;
+		return 0;
 	}
-#endif
 
-	if (_errorlog_fd) {
-		fprintf (_errorlog_fd, "%s\n", msg.c_str ());
-	} else if (_errorlog_dll) {
-		PBD::error << "VST '" << _errorlog_dll << "': " << msg;
-	} else {
-		PBD::error << "VST scanner: " << msg;
-	}
+	return job;
 }
 
 static void
-set_error_log (const char* dllpath) {
-	assert (!_errorlog_fd);
-	assert (!_errorlog_dll);
-	_errorlog_dll = strdup (dllpath);
+finish_scan_job (ScanJob* job)
+{
+	/* this waits for the scanner to exit, and for all of its output */
+	delete job->scanner;
+	job->scanner = 0;
+
+	if (!job->output.empty ()) {
+		PBD::error << "VST '" << job->dllpath << "': " << job->output << endmsg;
+	}
+
+	delete job;
 }
 
-static void
-close_error_log () {
-	if (_errorlog_fd) {
-		fclose (_errorlog_fd);
-		_errorlog_fd = 0;
+static std::string
+scan_message_type (enum ARDOUR::PluginType type)
+{
+	switch (type) {
+		case ARDOUR::LXVST:
+			return _("LXVST");
+		case ARDOUR::MacVST:
+			return _("MacVST");
+		default:
+			return _("VST");
+	}
+}
+
+void
+vstfx_scan_with_app (std::vector<std::string> const & dllpaths, enum ARDOUR::PluginType type, int jobs)
+{
+	std::string scanner_bin_path = ARDOUR::PluginManager::scanner_bin_path;
+
+	if (scanner_bin_path.empty ()) {
+		return;
+	}
+
+	std::set<std::string> blacklist;
+	vstfx_read_blacklist (blacklist);
+
+	std::list<ScanJob*> running;
+	std::vector<std::string>::const_iterator next = dllpaths.begin ();
+	bool cancelled = false;
+	int ticks = 0;
+
+	while (true) {
+
+		/* start as many scanners as we may */
+
+		while (!cancelled && next != dllpaths.end () && (int) running.size () < std::max (1, jobs)) {
+			std::string const & dllpath (*next++);
+
+			if (blacklist.find (dllpath) != blacklist.end () || vstfx_infofile_is_current (dllpath.c_str ())) {
+				continue;
+			}
+
+			ScanJob* job = start_scan_job (scanner_bin_path, dllpath);
+
+			if (job) {
+				ARDOUR::PluginScanMessage (scan_message_type (type), dllpath, true);
+				running.push_back (job);
+			}
+		}
+
+		if (running.empty ()) {
+			break;
+		}
+
+		ARDOUR::GUIIdle ();
+		Glib::usleep (100000);
+
+		if (ARDOUR::PluginManager::instance ().cancelled ()) {
+			cancelled = true;
+		}
+
+		const bool count_down = PLUGIN_SCAN_TIMEOUT > 0 && !ARDOUR::PluginManager::instance ().no_timeout ();
+		int shortest_timeout = PLUGIN_SCAN_TIMEOUT;
+
+		for (std::list<ScanJob*>::iterator j = running.begin (); j != running.end (); ) {
+			ScanJob* job = *j;
+
+			if (job->scanner->is_running ()) {
+				if (cancelled) {
+					// remove info file (might be incomplete)
+					vstfx_remove_infofile (job->dllpath.c_str ());
+					// remove temporary blacklist file (scan incomplete)
+					vstfx_un_blacklist (job->dllpath.c_str ());
+				} else if (count_down && --job->timeout > 0) {
+					shortest_timeout = std::min (shortest_timeout, job->timeout);
+					++j;
+					continue;
+				} else if (!count_down) {
+					++j;
+					continue;
+				}
+				/* timed out plugins stay blacklisted */
+				job->scanner->terminate ();
+			}
+
+			finish_scan_job (job);
+			j = running.erase (j);
+		}
+
+		if (count_down && ++ticks % 5 == 0) {
+			ARDOUR::PluginScanTimeout (shortest_timeout);
+		}
 	}
-	free (_errorlog_dll);
-	_errorlog_dll = 0;
 }
 
 #endif
@@ -985,47 +1221,8 @@ vstfx_get_info (const char* dllpath, enum ARDOUR::PluginType type, enum VSTScanM
 	}
 	else if (mode == VST_SCAN_USE_APP && scanner_bin_path != "") {
 		/* use external scanner app */
+		vstfx_scan_with_app (std::vector<std::string> (1, dllpath), type, 1);
 
-		char **argp= (char**) calloc (3,sizeof (char*));
-		argp[0] = strdup (scanner_bin_path.c_str ());
-		argp[1] = strdup (dllpath);
-		argp[2] = 0;
-
-		set_error_log (dllpath);
-		ARDOUR::SystemExec scanner (scanner_bin_path, argp);
-		PBD::ScopedConnectionList cons;
-		scanner.ReadStdout.connect_same_thread (cons, boost::bind (&parse_scanner_output, _1 ,_2));
-		if (scanner.start (2 /* send stderr&stdout via signal */)) {
-			PBD::error << string_compose (_("Cannot launch VST scanner app '%1': %2"), scanner_bin_path, strerror (errno)) << endmsg;
-			close_error_log ();
-			return infos;
-		} else {
-			int timeout = PLUGIN_SCAN_TIMEOUT;
-			bool no_timeout = (timeout <= 0);
-			ARDOUR::PluginScanTimeout (timeout);
-			while (scanner.is_running () && (no_timeout || timeout > 0)) {
-				if (!no_timeout && !ARDOUR::PluginManager::instance ().no_timeout ()) {
-					if (timeout%5 == 0) {
-						ARDOUR::PluginScanTimeout (timeout);
-					}
-					--timeout;
-				}
-				ARDOUR::GUIIdle ();
-				Glib::usleep (100000);
-
-				if (ARDOUR::PluginManager::instance ().cancelled ()) {
-					// remove info file (might be incomplete)
-					vstfx_remove_infofile (dllpath);
-					// remove temporary blacklist file (scan incomplete)
-					vstfx_un_blacklist (dllpath);
-					scanner.terminate ();
-					close_error_log ();
-					return infos;
-				}
-			}
-			scanner.terminate ();
-		}
-		close_error_log ();
 		/* re-read index (generated by external scanner) */
 		vstfx_clear_info_list (infos);
 		if (!vst_is_blacklisted (dllpath)) {
@@ -1119,5 +1316,11 @@ vstfx_get_info_fst (char* dllpath, enum VSTScanMode mode)
 #endif
 
 #ifndef VST_SCANNER_APP
+void
+vstfx_get_blacklist (std::set<std::string>& dllpaths)
+{
+	vstfx_read_blacklist (dllpaths);
+}
+
 } // namespace
 #endif
@@ -823,6 +823,7 @@ AlsaAudioBackend::_start (bool for_latency_measurement)
 		_system_midi_in.clear();
 		_system_midi_out.clear();
 		_ports.clear();
+		_porthandles.clear();
 		_portmap.clear();
 	}
 
@@ -1231,7 +1232,11 @@ AlsaAudioBackend::set_port_name (PortEngine::PortHandle port, const std::string&
 	AlsaPort* p = static_cast<AlsaPort*>(port);
 	_portmap.erase (p->name());
 	_portmap.insert (make_pair (newname, p));
-	return p->set_name (newname);
+	/* _ports is ordered by name */
+	_ports.erase (p);
+	const int rv = p->set_name (newname);
+	_ports.insert (p);
+	return rv;
 }
 
 std::string
@@ -1358,6 +1363,7 @@ AlsaAudioBackend::add_port (
 	}
 
 	_ports.insert (port);
+	_porthandles.insert (port);
 	_portmap.insert (make_pair (name, port));
 
 	return port;
@@ -1370,14 +1376,14 @@ AlsaAudioBackend::unregister_port (PortEngine::PortHandle port_handle)
 		return;
 	}
 	AlsaPort* port = static_cast<AlsaPort*>(port_handle);
-	PortIndex::iterator i = std::find (_ports.begin(), _ports.end(), static_cast<AlsaPort*>(port_handle));
-	if (i == _ports.end ()) {
+	if (!valid_port (port_handle)) {
 		PBD::error << _("AlsaBackend::unregister_port: Failed to find port") << endmsg;
 		return;
 	}
 	disconnect_all(port_handle);
 	_portmap.erase (port->name());
-	_ports.erase (i);
+	_ports.erase (port);
+	_porthandles.erase (port);
 	delete port;
 }
 
@@ -1553,6 +1559,7 @@ AlsaAudioBackend::unregister_ports (bool system_only)
 		if (! system_only || (port->is_physical () && port->is_terminal ())) {
 			port->disconnect_all ();
 			_portmap.erase (port->name());
+			_porthandles.erase (port);
 			delete port;
 			_ports.erase (cur);
 		}
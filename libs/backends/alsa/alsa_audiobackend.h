@@ -421,8 +421,10 @@ class AlsaAudioBackend : public AudioBackend {
 
 		typedef std::map<std::string, AlsaPort *> PortMap; // fast lookup in _ports
 		typedef std::set<AlsaPort *, SortByPortName> PortIndex; // fast lookup in _ports
+		typedef std::set<AlsaPort *> PortHandles; // fast valid_port ()
 		PortMap _portmap;
 		PortIndex _ports;
+		PortHandles _porthandles;
 
 		std::vector<AlsaMidiOut *> _rmidi_out;
 		std::vector<AlsaMidiIn  *> _rmidi_in;
@@ -456,7 +458,7 @@ class AlsaAudioBackend : public AudioBackend {
 		}
 
 		bool valid_port (PortHandle port) const {
-			return std::find (_ports.begin(), _ports.end(), static_cast<AlsaPort*>(port)) != _ports.end ();
+			return _porthandles.find (static_cast<AlsaPort*>(port)) != _porthandles.end ();
 		}
 
 		AlsaPort* find_port (const std::string& port_name) const {
@@ -504,6 +504,7 @@ CoreAudioBackend::_start (bool for_latency_measurement)
 		_system_midi_in.clear();
 		_system_midi_out.clear();
 		_ports.clear();
+		_porthandles.clear();
 		_portmap.clear();
 	}
 
@@ -930,7 +931,11 @@ CoreAudioBackend::set_port_name (PortEngine::PortHandle port, const std::string&
 	CoreBackendPort* p = static_cast<CoreBackendPort*>(port);
 	_portmap.erase (p->name());
 	_portmap.insert (make_pair (newname, p));
-	return p->set_name (newname);
+	/* _ports is ordered by name */
+	_ports.erase (p);
+	const int rv = p->set_name (newname);
+	_ports.insert (p);
+	return rv;
 }
 
 std::string
@@ -1057,6 +1062,7 @@ CoreAudioBackend::add_port (
 	}
 
 	_ports.insert (port);
+	_porthandles.insert (port);
 	_portmap.insert (make_pair (name, port));
 
 	return port;
@@ -1069,14 +1075,14 @@ CoreAudioBackend::unregister_port (PortEngine::PortHandle port_handle)
 		return;
 	}
 	CoreBackendPort* port = static_cast<CoreBackendPort*>(port_handle);
-	PortIndex::iterator i = std::find (_ports.begin(), _ports.end(), static_cast<CoreBackendPort*>(port_handle));
-	if (i == _ports.end ()) {
+	if (!valid_port (port_handle)) {
 		PBD::warning << _("CoreAudioBackend::unregister_port: Failed to find port") << endmsg;
 		return;
 	}
 	disconnect_all(port_handle);
 	_portmap.erase (port->name());
-	_ports.erase (i);
+	_ports.erase (port);
+	_porthandles.erase (port);
 	delete port;
 }
 
@@ -1239,6 +1245,7 @@ CoreAudioBackend::unregister_ports (bool system_only)
 		if (! system_only || (port->is_physical () && port->is_terminal ())) {
 			port->disconnect_all ();
 			_portmap.erase (port->name());
+			_porthandles.erase (port);
 			delete port;
 			_ports.erase (cur);
 		}
@@ -478,8 +478,10 @@ class CoreAudioBackend : public AudioBackend {
 
 	typedef std::map<std::string, CoreBackendPort *> PortMap; // fast lookup in _ports
 	typedef std::set<CoreBackendPort *, SortByPortName> PortIndex; // fast lookup in _ports
+	typedef std::set<CoreBackendPort *> PortHandles; // fast valid_port ()
 	PortMap _portmap;
 	PortIndex _ports;
+	PortHandles _porthandles;
 
 	struct PortConnectData {
 		std::string a;
@@ -507,7 +509,7 @@ class CoreAudioBackend : public AudioBackend {
 	}
 
 	bool valid_port (PortHandle port) const {
-		return std::find (_ports.begin(), _ports.end(), static_cast<CoreBackendPort*>(port)) != _ports.end ();
+		return _porthandles.find (static_cast<CoreBackendPort*>(port)) != _porthandles.end ();
 	}
 
 	CoreBackendPort* find_port (const std::string& port_name) const {
@@ -444,6 +444,7 @@ DummyAudioBackend::_start (bool /*for_latency_measurement*/)
 		_system_midi_in.clear();
 		_system_midi_out.clear();
 		_ports.clear();
+		_porthandles.clear();
 		_portmap.clear();
 	}
 
@@ -665,7 +666,11 @@ DummyAudioBackend::set_port_name (PortEngine::PortHandle port, const std::string
 	DummyPort* p = static_cast<DummyPort*>(port);
 	_portmap.erase (p->name());
 	_portmap.insert (make_pair (newname, p));
-	return p->set_name (newname);
+	/* _ports is ordered by name */
+	_ports.erase (p);
+	const int rv = p->set_name (newname);
+	_ports.insert (p);
+	return rv;
 }
 
 std::string
@@ -795,6 +800,7 @@ DummyAudioBackend::add_port (
 	}
 
 	_ports.insert (port);
+	_porthandles.insert (port);
 	_portmap.insert (make_pair (name, port));
 
 	return port;
@@ -809,14 +815,14 @@ DummyAudioBackend::unregister_port (PortEngine::PortHandle port_handle)
 		return;
 	}
 	DummyPort* port = static_cast<DummyPort*>(port_handle);
-	PortIndex::iterator i = std::find (_ports.begin(), _ports.end(), static_cast<DummyPort*>(port_handle));
-	if (i == _ports.end ()) {
+	if (!valid_port (port_handle)) {
 		PBD::error << _("DummyBackend::unregister_port: Failed to find port") << endmsg;
 		return;
 	}
 	disconnect_all(port_handle);
 	_portmap.erase (port->name());
-	_ports.erase (i);
+	_ports.erase (port);
+	_porthandles.erase (port);
 	delete port;
 }
 
@@ -948,6 +954,7 @@ DummyAudioBackend::unregister_ports (bool system_only)
 		if (! system_only || (port->is_physical () && port->is_terminal ())) {
 			port->disconnect_all ();
 			_portmap.erase (port->name());
+			_porthandles.erase (port);
 			delete port;
 			_ports.erase (cur);
 		}
@@ -462,8 +462,10 @@ class DummyAudioBackend : public AudioBackend {
 
 		typedef std::map<std::string, DummyPort *> PortMap; // fast lookup in _ports
 		typedef std::set<DummyPort *, SortByPortName> PortIndex; // fast lookup in _ports
+		typedef std::set<DummyPort *> PortHandles; // fast valid_port ()
 		PortMap _portmap;
 		PortIndex _ports;
+		PortHandles _porthandles;
 
 		struct PortConnectData {
 			std::string a;
@@ -491,7 +493,7 @@ class DummyAudioBackend : public AudioBackend {
 		}
 
 		bool valid_port (PortHandle port) const {
-			return std::find (_ports.begin(), _ports.end(), static_cast<DummyPort*>(port)) != _ports.end ();
+			return _porthandles.find (static_cast<DummyPort*>(port)) != _porthandles.end ();
 		}
 
 		DummyPort* find_port (const std::string& port_name) const {
@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -28,6 +29,7 @@
 
 #include <glibmm/threads.h>
 
+#include "pbd/rcu.h"
 #include "pbd/signals.h"
 
 #include "evoral/visibility.h"
@@ -208,6 +210,7 @@ public:
 	 */
 	double eval (double where) const {
 		Glib::Threads::RWLock::ReaderLock lm (_lock);
+		unlocked_update_eval_table ();
 		return unlocked_eval (where);
 	}
 
@@ -259,6 +262,25 @@ public:
 	 */
 	double unlocked_eval (double x) const;
 
+	/** Evaluate the list at @a veclen evenly spaced positions, starting at
+	 * @a x0 and @a dx apart, writing the values to @a vec.  The caller must
+	 * hold the lock (at least for reading).
+	 *
+	 * This walks the segments of the list once rather than looking up
+	 * every position on its own.
+	 *
+	 * @returns false if the list cannot be evaluated this way (Curved
+	 * interpolation, or the lookup table is being rebuilt by another
+	 * reader); @a vec is left untouched in that case.
+	 */
+	bool unlocked_eval_block (double x0, double dx, float* vec, int32_t veclen) const;
+
+	/** Rebuild the evaluation table if an edit has made it invalid.
+	 *  Call with (at least) the read lock held, and not from a realtime
+	 *  thread.
+	 */
+	void unlocked_update_eval_table () const;
+
 	bool rt_safe_earliest_event (double start, double& x, double& y, bool start_inclusive=false) const;
 	bool rt_safe_earliest_event_unlocked (double start, double& x, double& y, bool start_inclusive=false) const;
 	bool rt_safe_earliest_event_linear_unlocked (double start, double& x, double& y, bool inclusive) const;
@@ -272,6 +294,11 @@ public:
 
 	void mark_dirty () const;
 
+	/** @return a number which changes whenever the events in the list change,
+	 *  for users which keep their own copy of data derived from them.
+	 */
+	int events_version () const { return g_atomic_int_get (&_events_version); }
+
 	enum InterpolationStyle {
 		Discrete,
 		Linear,
@@ -359,6 +386,28 @@ private:
 	void unlocked_remove_duplicates ();
 	void unlocked_invalidate_insert_iterator ();
 	void add_guard_point (double when);
+
+	/* Contiguous copy of the positions and values in _events, used for
+	 * evaluation, and published with RCU.  Edits only invalidate it; it is
+	 * rebuilt at the end of a write pass, on thaw(), or by the next
+	 * non-realtime evaluation, so that a burst of edits costs one rebuild.
+	 * While it is invalid, readers fall back to searching _events; the
+	 * process thread never builds it.
+	 */
+	struct EvalTable {
+		EvalTable () : valid (false) {}
+		std::vector<double> when;
+		std::vector<double> value;
+		bool valid;
+	};
+
+	mutable SerializedRCUManager<EvalTable> _eval_table;
+
+	mutable gint _events_version;
+
+	void   rebuild_eval_table () const;
+	void   invalidate_eval_table () const;
+	static size_t eval_segment (EvalTable const&, double x, size_t& hint);
 };
 
 } // namespace Evoral
@@ -24,6 +24,8 @@
 #include <sstream>
 #include <stdint.h>
 
+#include "pbd/rt_arena.h"
+
 #include "evoral/midi_events.h"
 #include "evoral/types.hpp"
 #include "evoral/visibility.h"
@@ -31,6 +33,9 @@
 /** If this is not defined, all methods of MidiEvent are RT safe
  * but MidiEvent will never deep copy and (depending on the scenario)
  * may not be usable in STL containers, signals, etc.
+ *
+ * If it is defined, buffers are allocated with PBD::rt_alloc(), so that
+ * events created by a process thread use its realtime arena.
  */
 #define EVORAL_EVENT_ALLOC 1
 
@@ -84,7 +89,7 @@ public:
 	 */
 	inline void set_buffer(uint32_t size, uint8_t* buf, bool own) {
 		if (_owns_buf) {
-			free(_buf);
+			PBD::rt_free(_buf);
 			_buf = NULL;
 		}
 		_size     = size;
@@ -95,9 +100,9 @@ public:
 	inline void realloc(uint32_t size) {
 		if (_owns_buf) {
 			if (size > _size)
-				_buf = (uint8_t*) ::realloc(_buf, size);
+				_buf = (uint8_t*) PBD::rt_realloc(_buf, size);
 		} else {
-			_buf = (uint8_t*) ::malloc(size);
+			_buf = (uint8_t*) PBD::rt_alloc(size);
 			_owns_buf = true;
 		}
 
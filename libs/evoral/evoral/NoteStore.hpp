@@ -0,0 +1,324 @@
+/* This file is part of Evoral.
+ * Copyright (C) 2017 Paul Davis
+ *
+ * Evoral is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * Evoral is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef EVORAL_NOTE_STORE_HPP
+#define EVORAL_NOTE_STORE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "evoral/visibility.h"
+#include "evoral/Note.hpp"
+
+namespace Evoral {
+
+/** A time-ordered collection of notes, used in place of a
+ *  std::multiset<NotePtr> sorted by note time.
+ *
+ *  Notes are kept in a list of sorted arrays ("chunks") of at most
+ *  max_chunk_size entries, each entry holding a note's time next to the
+ *  pointer to it.  Iteration is then a walk along contiguous memory and
+ *  searching by time does not have to follow note pointers, while
+ *  insertion and removal only move the entries of one chunk.
+ *
+ *  The notes themselves are still shared, so a NotePtr is a stable handle
+ *  to a note however the collection changes.  Iterators, however, are
+ *  invalidated by any insertion or removal; use the iterator returned by
+ *  erase() to continue an iteration which removes notes.
+ *
+ *  A note's time must not be changed while it is in the collection;
+ *  remove it, change it and add it again.  Notes with equal times are
+ *  kept in the order in which they were added.
+ */
+template<typename Time>
+class /*LIBEVORAL_API*/ NoteStore {
+public:
+	typedef boost::shared_ptr< Note<Time> > NotePtr;
+	typedef NotePtr                         value_type;
+	typedef size_t                          size_type;
+
+	static const size_t max_chunk_size = 256;
+
+private:
+	struct Entry {
+		Entry (NotePtr const & n) : time (n->time()), note (n) {}
+		Time    time;
+		NotePtr note;
+	};
+
+	typedef std::vector<Entry>  Chunk;
+	typedef std::vector<Chunk*> Chunks;
+
+public:
+	/** Iterator over the notes in time order.  As with a std::multiset,
+	 *  notes can not be replaced through an iterator, so there is no
+	 *  separate mutable iterator.
+	 */
+	class const_iterator {
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef NotePtr                         value_type;
+		typedef std::ptrdiff_t                  difference_type;
+		typedef NotePtr const *                 pointer;
+		typedef NotePtr const &                 reference;
+
+		const_iterator () : _chunks (0), _chunk (0), _entry (0), _chunk_end (0) {}
+
+		reference operator* () const { return _entry->note; }
+		pointer operator-> () const { return &_entry->note; }
+
+		const_iterator& operator++ () {
+			if (++_entry == _chunk_end) {
+				set_chunk (_chunk + 1);
+			}
+			return *this;
+		}
+
+		const_iterator operator++ (int) {
+			const_iterator tmp (*this);
+			++(*this);
+			return tmp;
+		}
+
+		const_iterator& operator-- () {
+			if (!_entry || _entry == &(*(*_chunks)[_chunk])[0]) {
+				set_chunk (_chunk - 1);
+				_entry = _chunk_end - 1;
+			} else {
+				--_entry;
+			}
+			return *this;
+		}
+
+		const_iterator operator-- (int) {
+			const_iterator tmp (*this);
+			--(*this);
+			return tmp;
+		}
+
+		bool operator== (const_iterator const & other) const { return _entry == other._entry; }
+		bool operator!= (const_iterator const & other) const { return _entry != other._entry; }
+
+	private:
+		friend class NoteStore<Time>;
+
+		const_iterator (Chunks const * chunks, size_t chunk, size_t pos)
+			: _chunks (chunks)
+		{
+			set_chunk (chunk);
+			if (_entry) {
+				_entry += pos;
+			}
+		}
+
+		void set_chunk (size_t n) {
+			_chunk = n;
+			if (n < _chunks->size ()) {
+				Chunk const & c (*(*_chunks)[n]);
+				_entry = &c[0];
+				_chunk_end = _entry + c.size ();
+			} else {
+				/* end */
+				_entry = _chunk_end = 0;
+			}
+		}
+
+		size_t pos () const { return _entry - &(*(*_chunks)[_chunk])[0]; }
+
+		Chunks const * _chunks;
+		size_t         _chunk;
+		Entry const *  _entry;
+		Entry const *  _chunk_end;
+	};
+
+	typedef const_iterator                        iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	typedef const_reverse_iterator                reverse_iterator;
+
+	NoteStore () : _size (0) {}
+
+	NoteStore (NoteStore const & other) : _size (0) {
+		copy (other);
+	}
+
+	~NoteStore () {
+		clear ();
+	}
+
+	NoteStore& operator= (NoteStore const & other) {
+		if (&other != this) {
+			clear ();
+			copy (other);
+		}
+		return *this;
+	}
+
+	const_iterator begin () const { return const_iterator (&_chunks, 0, 0); }
+	const_iterator end ()   const { return const_iterator (&_chunks, _chunks.size (), 0); }
+
+	const_reverse_iterator rbegin () const { return const_reverse_iterator (end ()); }
+	const_reverse_iterator rend ()   const { return const_reverse_iterator (begin ()); }
+
+	size_t size ()  const { return _size; }
+	bool   empty () const { return _size == 0; }
+
+	void clear () {
+		for (typename Chunks::iterator c = _chunks.begin(); c != _chunks.end(); ++c) {
+			delete *c;
+		}
+		_chunks.clear ();
+		_size = 0;
+	}
+
+	/** Add a note after any others with the same time.
+	 *  @return iterator pointing at the new note.
+	 */
+	const_iterator insert (NotePtr const & note) {
+		const Time t (note->time ());
+
+		if (_chunks.empty () || !(t < _chunks.back()->back().time)) {
+			/* appending, as when reading a file or copying: fill chunks up
+			 * rather than splitting them, so that they end up full.
+			 */
+			if (_chunks.empty () || _chunks.back()->size () >= max_chunk_size) {
+				_chunks.push_back (new Chunk);
+				_chunks.back()->reserve (max_chunk_size);
+			}
+			_chunks.back()->push_back (Entry (note));
+			++_size;
+			return const_iterator (&_chunks, _chunks.size () - 1, _chunks.back()->size () - 1);
+		}
+
+		/* first chunk with a later note in it; there is one, since we are
+		 * not appending.
+		 */
+		size_t c = std::upper_bound (_chunks.begin(), _chunks.end(), t, TimeBeforeChunkEnd ()) - _chunks.begin();
+		Chunk& chunk (*_chunks[c]);
+		size_t pos = std::upper_bound (chunk.begin(), chunk.end(), t, TimeBeforeEntry ()) - chunk.begin();
+
+		chunk.insert (chunk.begin() + pos, Entry (note));
+		++_size;
+
+		if (chunk.size () > max_chunk_size) {
+			const size_t half = chunk.size () / 2;
+			Chunk* upper = new Chunk (chunk.begin() + half, chunk.end());
+			upper->reserve (max_chunk_size);
+			chunk.erase (chunk.begin() + half, chunk.end());
+			_chunks.insert (_chunks.begin() + c + 1, upper);
+			if (pos >= half) {
+				++c;
+				pos -= half;
+			}
+		}
+
+		return const_iterator (&_chunks, c, pos);
+	}
+
+	/** Remove the note at @param i.
+	 *  @return iterator pointing at the note after it.
+	 */
+	const_iterator erase (const_iterator i) {
+		size_t c = i._chunk;
+		size_t pos = i.pos ();
+		Chunk& chunk (*_chunks[c]);
+
+		chunk.erase (chunk.begin() + pos);
+		--_size;
+
+		if (chunk.empty ()) {
+			delete _chunks[c];
+			_chunks.erase (_chunks.begin() + c);
+			return const_iterator (&_chunks, c, 0);
+		}
+
+		/* merge small neighbours so that mass removal does not leave
+		 * lots of nearly empty chunks behind.
+		 */
+		if (c + 1 < _chunks.size () && chunk.size () + _chunks[c + 1]->size () <= max_chunk_size / 2) {
+			chunk.insert (chunk.end(), _chunks[c + 1]->begin(), _chunks[c + 1]->end());
+			delete _chunks[c + 1];
+			_chunks.erase (_chunks.begin() + c + 1);
+		}
+
+		if (pos == chunk.size ()) {
+			return const_iterator (&_chunks, c + 1, 0);
+		}
+
+		return const_iterator (&_chunks, c, pos);
+	}
+
+	/** @return iterator pointing at the first note with time >= @param t */
+	const_iterator lower_bound (Time const & t) const {
+		size_t c = std::lower_bound (_chunks.begin(), _chunks.end(), t, ChunkEndBeforeTime ()) - _chunks.begin();
+		if (c == _chunks.size ()) {
+			return end ();
+		}
+		Chunk const & chunk (*_chunks[c]);
+		return const_iterator (&_chunks, c, std::lower_bound (chunk.begin(), chunk.end(), t, EntryBeforeTime ()) - chunk.begin());
+	}
+
+	/** @return iterator pointing at the first note with time > @param t */
+	const_iterator upper_bound (Time const & t) const {
+		size_t c = std::upper_bound (_chunks.begin(), _chunks.end(), t, TimeBeforeChunkEnd ()) - _chunks.begin();
+		if (c == _chunks.size ()) {
+			return end ();
+		}
+		Chunk const & chunk (*_chunks[c]);
+		return const_iterator (&_chunks, c, std::upper_bound (chunk.begin(), chunk.end(), t, TimeBeforeEntry ()) - chunk.begin());
+	}
+
+	/** @return iterator pointing at the first note not earlier than @param note */
+	const_iterator lower_bound (NotePtr const & note) const {
+		return lower_bound (note->time ());
+	}
+
+private:
+	struct EntryBeforeTime {
+		bool operator() (Entry const & e, Time const & t) const { return e.time < t; }
+	};
+
+	struct TimeBeforeEntry {
+		bool operator() (Time const & t, Entry const & e) const { return t < e.time; }
+	};
+
+	struct ChunkEndBeforeTime {
+		bool operator() (Chunk const * c, Time const & t) const { return c->back().time < t; }
+	};
+
+	struct TimeBeforeChunkEnd {
+		bool operator() (Time const & t, Chunk const * c) const { return t < c->back().time; }
+	};
+
+	void copy (NoteStore const & other) {
+		_chunks.reserve (other._chunks.size ());
+		for (typename Chunks::const_iterator c = other._chunks.begin(); c != other._chunks.end(); ++c) {
+			_chunks.push_back (new Chunk (**c));
+		}
+		_size = other._size;
+	}
+
+	Chunks _chunks;
+	size_t _size;
+};
+
+} // namespace Evoral
+
+#endif // EVORAL_NOTE_STORE_HPP
@@ -72,6 +72,12 @@ public:
 	void seek_to_start() const;
 	int  seek_to_track(int track);
 
+	/** Move the read position to the first event at or after @a pulses.
+	 *  @return the time, in pulses, of the event before that one (or 0),
+	 *  which is where the delta time of the next event read counts from.
+	 */
+	uint64_t seek_to_pulses(uint64_t pulses) const;
+
 	int read_event(uint32_t* delta_t, uint32_t* size, uint8_t** buf, event_id_t* note_id) const;
 
 	uint16_t num_tracks() const;
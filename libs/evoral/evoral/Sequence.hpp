@@ -29,6 +29,7 @@
 
 #include "evoral/visibility.h"
 #include "evoral/Note.hpp"
+#include "evoral/NoteStore.hpp"
 #include "evoral/ControlSet.hpp"
 #include "evoral/ControlList.hpp"
 #include "evoral/PatchChange.hpp"
@@ -151,7 +152,7 @@ public:
 		}
 	};
 
-	typedef std::multiset<NotePtr, EarlierNoteComparator> Notes;
+	typedef NoteStore<Time> Notes;
 	inline       Notes& notes()       { return _notes; }
 	inline const Notes& notes() const { return _notes; }
 
@@ -57,6 +57,7 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 	, _desc(desc)
 	, _interpolation (default_interpolation ())
 	, _curve(0)
+	, _eval_table (new EvalTable)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
@@ -66,6 +67,7 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc)
 	_search_cache.left = -1;
 	_search_cache.first = _events.end();
 	_sort_pending = false;
+	_events_version = 0;
 	new_write_pass = true;
 	_in_write_pass = false;
 	did_write_during_pass = false;
@@ -78,6 +80,7 @@ ControlList::ControlList (const ControlList& other)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
+	, _eval_table (new EvalTable)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
@@ -85,6 +88,7 @@ ControlList::ControlList (const ControlList& other)
 	_lookup_cache.range.second = _events.end();
 	_search_cache.first = _events.end();
 	_sort_pending = false;
+	_events_version = 0;
 	new_write_pass = true;
 	_in_write_pass = false;
 	did_write_during_pass = false;
@@ -100,6 +104,7 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	, _desc(other._desc)
 	, _interpolation(other._interpolation)
 	, _curve(0)
+	, _eval_table (new EvalTable)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
@@ -107,6 +112,7 @@ ControlList::ControlList (const ControlList& other, double start, double end)
 	_lookup_cache.range.second = _events.end();
 	_search_cache.first = _events.end();
 	_sort_pending = false;
+	_events_version = 0;
 
 	/* now grab the relevant points, and shift them back if necessary */
 
@@ -478,6 +484,12 @@ ControlList::write_pass_finished (double /*when*/, double thinning_factor)
 	}
 	new_write_pass = true;
 	_in_write_pass = false;
+
+	{
+		/* the points written during the pass only invalidated it */
+		Glib::Threads::RWLock::WriterLock lm (_lock);
+		rebuild_eval_table ();
+	}
 }
 
 void
@@ -540,6 +552,9 @@ ControlList::add_guard_point (double when)
 		++most_recent_insert_iterator;
 	}
 
+	/* callers mark the list dirty only after adding the real point */
+	invalidate_eval_table ();
+
 	/* don't do this again till the next write pass */
 
 	new_write_pass = false;
@@ -1043,8 +1058,12 @@ ControlList::thaw ()
 			_events.sort (event_time_less_than);
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
+			g_atomic_int_inc (&_events_version);
 			_sort_pending = false;
 		}
+
+		/* edits made while frozen left the evaluation table invalid */
+		rebuild_eval_table ();
 	}
 }
 
@@ -1057,6 +1076,9 @@ ControlList::mark_dirty () const
 	_search_cache.left = -1;
 	_search_cache.first = _events.end();
 
+	invalidate_eval_table ();
+	g_atomic_int_inc (&_events_version);
+
 	if (_curve) {
 		_curve->mark_dirty();
 	}
@@ -1340,6 +1362,53 @@ ControlList::multipoint_eval (double x) const
 	double uval, lval;
 	double fraction;
 
+	boost::shared_ptr<EvalTable> table (_eval_table.reader ());
+
+	if (table->valid) {
+		std::vector<double> const& when (table->when);
+		std::vector<double> const& value (table->value);
+		const size_t n = when.size ();
+		size_t hint = 0;
+		const size_t j = eval_segment (*table, x, hint);
+
+		if (j == n) {
+			/* we're after the last point */
+			return value[n - 1];
+		}
+		if (j == 0 || when[j] == x) {
+			/* before the first point, or x is a control point in the data */
+			return value[j];
+		}
+
+		lpos = when[j - 1];
+		lval = value[j - 1];
+
+		if (_interpolation == Discrete) {
+			return lval;
+		}
+
+		upos = when[j];
+		uval = value[j];
+
+		fraction = (double) (x - lpos) / (double) (upos - lpos);
+
+		switch (_interpolation) {
+			case Logarithmic:
+				return interpolate_logarithmic (lval, uval, fraction, _desc.lower, _desc.upper);
+			case Exponential:
+				return interpolate_gain (lval, uval, fraction, _desc.upper);
+			case Discrete:
+				/* handled above */
+			case Curved:
+				/* only used x-fade curves, never direct eval */
+				assert (0);
+			default: // Linear
+				return interpolate_linear (lval, uval, fraction);
+		}
+	}
+
+	/* No table while frozen or before the next mark_dirty(); search the list. */
+
 	/* "Stepped" lookup (no interpolation) */
 	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
@@ -1418,6 +1487,194 @@ ControlList::multipoint_eval (double x) const
 	return (*range.first)->value;
 }
 
+/** Publish an evaluation table made from _events.
+ *  Called with the write lock held, or from unlocked_update_eval_table().
+ */
+void
+ControlList::rebuild_eval_table () const
+{
+	boost::shared_ptr<EvalTable> table (new EvalTable);
+
+	if (!_frozen) {
+		table->when.reserve (_events.size ());
+		table->value.reserve (_events.size ());
+
+		for (const_iterator i = _events.begin(); i != _events.end(); ++i) {
+			table->when.push_back ((*i)->when);
+			table->value.push_back ((*i)->value);
+		}
+
+		table->valid = true;
+	} else if (!_eval_table.reader ()->valid) {
+		/* already invalid, it will be rebuilt on thaw() */
+		return;
+	}
+
+	_eval_table.replace (table);
+}
+
+void
+ControlList::unlocked_update_eval_table () const
+{
+	/* _events cannot change while any lock is held, and replacing the
+	 * table is serialized, so concurrent readers may both do this.
+	 */
+	if (!_frozen && !_eval_table.reader ()->valid) {
+		rebuild_eval_table ();
+	}
+}
+
+/** Make readers stop using the evaluation table until it is rebuilt.
+ *  Called with the write lock held.
+ */
+void
+ControlList::invalidate_eval_table () const
+{
+	if (_eval_table.reader ()->valid) {
+		_eval_table.replace (boost::shared_ptr<EvalTable> (new EvalTable));
+	}
+}
+
+/** @return the index of the first point at or after @a x (or the number of
+ *  points if there is none), like std::lower_bound().  Successive lookups
+ *  by one caller tend to land in the same or the next segment, so those are
+ *  tried (starting from the caller's @a hint, which is updated) before doing
+ *  a binary search.
+ */
+size_t
+ControlList::eval_segment (EvalTable const& table, double x, size_t& hint)
+{
+	std::vector<double> const& when (table.when);
+	const size_t n = when.size ();
+	size_t j = hint;
+
+	if (j < n && when[j] >= x && (j == 0 || when[j - 1] < x)) {
+		return j;
+	}
+
+	++j;
+
+	if (j < n && when[j] >= x && when[j - 1] < x) {
+		hint = j;
+		return j;
+	}
+
+	j = lower_bound (when.begin(), when.end(), x) - when.begin();
+	hint = j;
+	return j;
+}
+
+bool
+ControlList::unlocked_eval_block (double x0, double dx, float* vec, int32_t veclen) const
+{
+	if (_interpolation == Curved) {
+		return false;
+	}
+
+	boost::shared_ptr<EvalTable> table (_eval_table.reader ());
+
+	if (!table->valid) {
+		return false;
+	}
+
+	const size_t n = table->when.size ();
+
+	if (n == 0) {
+		for (int32_t i = 0; i < veclen; ++i) {
+			vec[i] = _desc.normal;
+		}
+		return true;
+	}
+
+	const double* when = &table->when[0];
+	const double* value = &table->value[0];
+	int32_t i = 0;
+	size_t hint = 0;
+
+	while (i < veclen) {
+
+		const double x = x0 + i * dx;
+		const size_t j = eval_segment (*table, x, hint);
+
+		if (j == n) {
+			/* after the last point: the rest is constant */
+			const float v = value[n - 1];
+			for (; i < veclen; ++i) {
+				vec[i] = v;
+			}
+			break;
+		}
+
+		if (j == 0 || when[j] == x) {
+			/* before the first point, or exactly on a control point */
+			vec[i++] = value[j];
+			continue;
+		}
+
+		/* x lies in (when[j-1], when[j]); find how many of the remaining
+		 * positions do too, and fill them in one go.
+		 */
+
+		int32_t cnt = veclen - i;
+
+		if (dx > 0) {
+			const double span = ceil ((when[j] - x) / dx);
+			if (span < cnt) {
+				cnt = std::max ((int32_t) 1, (int32_t) span);
+			}
+			/* guard against rounding: never step onto or past the upper point */
+			while (cnt > 1 && x0 + (i + cnt - 1) * dx >= when[j]) {
+				--cnt;
+			}
+		}
+
+		const double lpos = when[j - 1];
+		const double lval = value[j - 1];
+		const double uval = value[j];
+		const double trange = when[j] - lpos;
+		float* v = vec + i;
+
+		if (_interpolation == Discrete || lval == uval) {
+			const float c = lval;
+			for (int32_t k = 0; k < cnt; ++k) {
+				v[k] = c;
+			}
+		} else {
+			/* fraction along the segment of the first position, and its
+			 * increment per position.
+			 */
+			const double f0 = (x - lpos) / trange;
+			const double df = dx / trange;
+
+			switch (_interpolation) {
+				case Logarithmic:
+					for (int32_t k = 0; k < cnt; ++k) {
+						v[k] = interpolate_logarithmic (lval, uval, f0 + k * df, _desc.lower, _desc.upper);
+					}
+					break;
+				case Exponential:
+					for (int32_t k = 0; k < cnt; ++k) {
+						v[k] = interpolate_gain (lval, uval, f0 + k * df, _desc.upper);
+					}
+					break;
+				default: // Linear
+				{
+					/* no loop-carried dependency: the compiler can vectorize this */
+					const double vdelta = uval - lval;
+					for (int32_t k = 0; k < cnt; ++k) {
+						v[k] = lval + vdelta * (f0 + k * df);
+					}
+				}
+					break;
+			}
+		}
+
+		i += cnt;
+	}
+
+	return true;
+}
+
 void
 ControlList::build_search_cache_if_necessary (double start) const
 {
@@ -187,6 +187,7 @@ void
 Curve::get_vector (double x0, double x1, float *vec, int32_t veclen) const
 {
 	Glib::Threads::RWLock::ReaderLock lm(_list.lock());
+	_list.unlocked_update_eval_table ();
 	_get_vector (x0, x1, vec, veclen);
 }
 
@@ -349,17 +350,21 @@ Curve::_get_vector (double x0, double x1, float *vec, int32_t veclen) const
 		return;
 	}
 
+	double dx = 0;
+	if (veclen > 1) {
+		dx = (hx - lx) / (veclen - 1);
+	}
+
+	if (_list.unlocked_eval_block (lx, dx, vec, veclen)) {
+		return;
+	}
+
 	if (_dirty) {
 		solve ();
 	}
 
 	rx = lx;
 
-	double dx = 0;
-	if (veclen > 1) {
-		dx = (hx - lx) / (veclen - 1);
-	}
-
 	for (i = 0; i < veclen; ++i, rx += dx) {
 		vec[i] = multipoint_eval (rx);
 	}
@@ -64,7 +64,7 @@ Event<Timestamp>::Event(EventType type, Timestamp time, uint32_t size, uint8_t*
 	, _owns_buf(alloc)
 {
 	if (alloc) {
-		_buf = (uint8_t*)malloc(_size);
+		_buf = (uint8_t*)PBD::rt_alloc(_size);
 		if (buf) {
 			memcpy(_buf, buf, _size);
 		} else {
@@ -81,7 +81,7 @@ Event<Timestamp>::Event(EventType      type,
 	: _type(type)
 	, _time(time)
 	, _size(size)
-	, _buf((uint8_t*)malloc(size))
+	, _buf((uint8_t*)PBD::rt_alloc(size))
 	, _id(-1)
 	, _owns_buf(true)
 {
@@ -98,7 +98,7 @@ Event<Timestamp>::Event(const Event& copy, bool owns_buf)
 	, _owns_buf(owns_buf)
 {
 	if (owns_buf) {
-		_buf = (uint8_t*)malloc(_size);
+		_buf = (uint8_t*)PBD::rt_alloc(_size);
 		if (copy._buf) {
 			memcpy(_buf, copy._buf, _size);
 		} else {
@@ -110,7 +110,7 @@ Event<Timestamp>::Event(const Event& copy, bool owns_buf)
 template<typename Timestamp>
 Event<Timestamp>::~Event() {
 	if (_owns_buf) {
-		free(_buf);
+		PBD::rt_free(_buf);
 	}
 }
 
@@ -125,11 +125,11 @@ Event<Timestamp>::assign(const Event& other)
 	if (_owns_buf) {
 		if (other._buf) {
 			if (other._size > _size) {
-				_buf = (uint8_t*)::realloc(_buf, other._size);
+				_buf = (uint8_t*)PBD::rt_realloc(_buf, other._size);
 			}
 			memcpy(_buf, other._buf, other._size);
 		} else {
-			free(_buf);
+			PBD::rt_free(_buf);
 			_buf = NULL;
 		}
 	} else {
@@ -145,7 +145,7 @@ Event<Timestamp>::set (const uint8_t* buf, uint32_t size, Timestamp t)
 {
 	if (_owns_buf) {
 		if (_size < size) {
-			_buf = (uint8_t*) ::realloc(_buf, size);
+			_buf = (uint8_t*) PBD::rt_realloc(_buf, size);
 		}
 		memcpy (_buf, buf, size);
 	} else {
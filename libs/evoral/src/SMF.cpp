@@ -261,6 +261,49 @@ SMF::seek_to_start() const
 	}
 }
 
+uint64_t
+SMF::seek_to_pulses(uint64_t pulses) const
+{
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+
+	if (!_smf_track) {
+		cerr << "WARNING: SMF seek_to_pulses() with no track" << endl;
+		return 0;
+	}
+
+	/* libsmf keeps every event of the track in memory, in time order
+	 * and with its absolute time, so find the first event at or after
+	 * `pulses' by binary search rather than by reading up to it.
+	 */
+
+	size_t lo = 0;
+	size_t hi = _smf_track->number_of_events;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		smf_event_t* ev = (smf_event_t*) g_ptr_array_index (_smf_track->events_array, mid);
+		if (ev->time_pulses < pulses) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	/* events are numbered from 1, and 0 means the end of the track */
+	if (lo < _smf_track->number_of_events) {
+		_smf_track->next_event_number = lo + 1;
+		_smf_track->time_of_next_event = ((smf_event_t*) g_ptr_array_index (_smf_track->events_array, lo))->time_pulses;
+	} else {
+		_smf_track->next_event_number = 0;
+	}
+
+	if (lo == 0) {
+		return 0;
+	}
+
+	return ((smf_event_t*) g_ptr_array_index (_smf_track->events_array, lo - 1))->time_pulses;
+}
+
 /** Read an event from the current position in file.
  *
  * File position MUST be at the beginning of a delta time, or this will die very messily.
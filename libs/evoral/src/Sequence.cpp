@@ -653,8 +653,6 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 : end_write (%2 notes) delete stuck option %3 @ %4\n", this, _notes.size(), option, when));
 
 	for (typename Notes::iterator n = _notes.begin(); n != _notes.end() ;) {
-		typename Notes::iterator next = n;
-		++next;
 
 		if (!(*n)->length()) {
 			switch (option) {
@@ -662,13 +660,14 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 				break;
 			case DeleteStuckNotes:
 				cerr << "WARNING: Stuck note lost: " << (*n)->note() << endl;
-				_notes.erase(n);
-				break;
+				n = _notes.erase(n);
+				continue;
 			case ResolveStuckNotes:
 				if (when <= (*n)->time()) {
 					cerr << "WARNING: Stuck note resolution - end time @ "
 					     << when << " is before note on: " << (**n) << endl;
-					_notes.erase (*n);
+					n = _notes.erase (n);
+					continue;
 				} else {
 					(*n)->set_length (when - (*n)->time());
 					cerr << "WARNING: resolved note-on with no note-off to generate " << (**n) << endl;
@@ -677,7 +676,7 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 			}
 		}
 
-		n = next;
+		++n;
 	}
 
 	for (int i = 0; i < 16; ++i) {
@@ -1196,8 +1195,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::const_iterator
 Sequence<Time>::note_lower_bound (Time t) const
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
-	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(search_note);
+	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(t);
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
 }
@@ -1231,8 +1229,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::iterator
 Sequence<Time>::note_lower_bound (Time t)
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
-	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(search_note);
+	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(t);
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
 }
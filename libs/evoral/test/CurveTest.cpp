@@ -293,6 +293,71 @@ CurveTest::ctrlListEval ()
 	CPPUNIT_ASSERT_EQUAL(9.0, cl->unlocked_eval(999.));
 }
 
+void
+CurveTest::blockEval ()
+{
+	float vec[1024];
+
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	cl->create_curve ();
+
+	/* ramps of varying slope, some flat, and a step at x=2048 */
+	for (int i = 0; i < 64; ++i) {
+		cl->fast_simple_add (i * 64.0, ((i * 5) % 8) / 8.0 + .125);
+		if (i == 32) {
+			cl->fast_simple_add (i * 64.0, .0625);
+		}
+	}
+
+	static const ControlList::InterpolationStyle styles[] = {
+		ControlList::Linear, ControlList::Exponential, ControlList::Discrete
+	};
+
+	static const double ranges[][2] = {
+		{    0.0, 4032.0 },
+		{  100.5,  200.25 },
+		{ 2000.0, 2100.0 },
+		{ 1023.0, 1024.0 },
+	};
+
+	for (size_t s = 0; s < sizeof (styles) / sizeof (styles[0]); ++s) {
+		CPPUNIT_ASSERT (cl->set_interpolation (styles[s]));
+
+		for (size_t r = 0; r < sizeof (ranges) / sizeof (ranges[0]); ++r) {
+			const double x0 = ranges[r][0];
+			const double x1 = ranges[r][1];
+			const double dx = (x1 - x0) / 1023.0;
+
+			/* the block evaluator must agree with evaluating each position */
+			cl->curve ().get_vector (x0, x1, vec, 1024);
+			for (int i = 0; i < 1024; ++i) {
+				char msg[64];
+				snprintf (msg, 64, "style %d at i=%d (x0=%.1f, x1=%.1f)", (int) styles[s], i, x0, x1);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE (msg, cl->unlocked_eval (x0 + i * dx), vec[i], 1e-6);
+			}
+		}
+	}
+
+	/* at the step, the first of the two points wins */
+	cl->set_interpolation (ControlList::Linear);
+	cl->curve ().get_vector (2048.0, 2048.0, vec, 1);
+	CPPUNIT_ASSERT_EQUAL (.125f, vec[0]);
+	CPPUNIT_ASSERT_EQUAL (.125, cl->unlocked_eval (2048.0));
+
+	/* edits must be seen by the next evaluation */
+	cl->curve ().get_vector (192.0, 192.0, vec, 1);
+	CPPUNIT_ASSERT_EQUAL (1.f, vec[0]);
+
+	ControlList::iterator i = cl->begin ();
+	std::advance (i, 3);
+	cl->modify (i, 192.0, .5);
+
+	cl->curve ().get_vector (192.0, 192.0, vec, 1);
+	CPPUNIT_ASSERT_EQUAL (.5f, vec[0]);
+	CPPUNIT_ASSERT_EQUAL (.5, cl->unlocked_eval (192.0));
+	CPPUNIT_ASSERT_EQUAL (.4375, cl->unlocked_eval (160.0));
+}
+
 void
 CurveTest::constrainedCubic ()
 {
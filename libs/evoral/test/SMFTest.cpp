@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "SMFTest.hpp"
 
 #include <glibmm/fileutils.h>
@@ -117,3 +119,45 @@ SMFTest::writeTest ()
 
 	// TODO: Check files are actually equivalent
 }
+
+void
+SMFTest::seekTest ()
+{
+	TestSMF smf;
+	string testdata_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TakeFive.mid", testdata_path));
+	smf.open(testdata_path);
+	CPPUNIT_ASSERT_EQUAL(0, smf.seek_to_track(1));
+
+	/* the time of every event, read from the start */
+	vector<uint64_t> times;
+	uint64_t time = 0;
+	uint32_t delta_t = 0;
+	uint32_t size    = 0;
+	uint8_t* buf     = NULL;
+
+	smf.seek_to_start();
+	while (smf.read_event(&delta_t, &size, &buf) >= 0) {
+		time += delta_t;
+		times.push_back (time);
+	}
+	CPPUNIT_ASSERT (!times.empty());
+
+	/* after seeking, the next event read is the first one at or after
+	   the seek time, and its delta counts from the time returned
+	*/
+	for (uint64_t t = 0; t <= times.back() + 1; t += 97) {
+		const size_t next = lower_bound (times.begin(), times.end(), t) - times.begin();
+		time = smf.seek_to_pulses (t);
+		const int ret = smf.read_event(&delta_t, &size, &buf);
+		if (next == times.size()) {
+			CPPUNIT_ASSERT_EQUAL (-1, ret);
+		} else {
+			CPPUNIT_ASSERT (ret >= 0);
+			CPPUNIT_ASSERT_EQUAL (times[next], time + delta_t);
+		}
+	}
+
+	free (buf);
+	smf.close();
+}
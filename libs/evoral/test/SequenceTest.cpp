@@ -194,3 +194,85 @@ SequenceTest::controlInterpolationTest ()
 		last_value = i->second;
 	}
 }
+
+void
+SequenceTest::noteStoreTest ()
+{
+	typedef MySequence<Time>::Notes Store;
+	typedef boost::shared_ptr< Note<Time> > NotePtr;
+
+	/* enough notes for many chunks, added out of order and with
+	   plenty of equal times
+	*/
+	const int n_notes = 5000;
+	vector<NotePtr> added;
+	Store store;
+
+	for (int i = 0; i < n_notes; ++i) {
+		NotePtr n (new Note<Time> (0, Beats ((i * 7919) % 1000), Beats (1), i % 128, 64));
+		added.push_back (n);
+		Store::iterator j = store.insert (n);
+		CPPUNIT_ASSERT (*j == n);
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) n_notes, store.size ());
+
+	/* notes are in time order, and those with equal times are in the
+	   order in which they were added
+	*/
+	int count = 0;
+	NotePtr prev;
+	for (Store::const_iterator i = store.begin(); i != store.end(); ++i, ++count) {
+		if (prev) {
+			CPPUNIT_ASSERT (prev->time() <= (*i)->time());
+			if (prev->time() == (*i)->time()) {
+				CPPUNIT_ASSERT (find (added.begin(), added.end(), prev) < find (added.begin(), added.end(), *i));
+			}
+		}
+		prev = *i;
+	}
+	CPPUNIT_ASSERT_EQUAL (n_notes, count);
+
+	count = 0;
+	for (Store::const_reverse_iterator i = store.rbegin(); i != store.rend(); ++i) {
+		++count;
+	}
+	CPPUNIT_ASSERT_EQUAL (n_notes, count);
+
+	Store::const_iterator lb = store.lower_bound (Beats (500));
+	CPPUNIT_ASSERT ((*lb)->time() == Beats (500));
+	CPPUNIT_ASSERT ((*--lb)->time() < Beats (500));
+	CPPUNIT_ASSERT (store.lower_bound (Beats (1000)) == store.end());
+	CPPUNIT_ASSERT (store.upper_bound (Beats (999)) == store.end());
+	CPPUNIT_ASSERT (store.lower_bound (Beats (0)) == store.begin());
+
+	/* a copy is independent of the original */
+	Store copy (store);
+	CPPUNIT_ASSERT_EQUAL (store.size (), copy.size ());
+
+	/* remove every other note while iterating */
+	bool odd = false;
+	for (Store::iterator i = store.begin(); i != store.end(); ) {
+		if (odd) {
+			i = store.erase (i);
+		} else {
+			++i;
+		}
+		odd = !odd;
+	}
+	CPPUNIT_ASSERT_EQUAL ((size_t) n_notes / 2, store.size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) n_notes, copy.size ());
+
+	count = 0;
+	prev.reset ();
+	for (Store::const_iterator i = store.begin(); i != store.end(); ++i, ++count) {
+		CPPUNIT_ASSERT (!prev || prev->time() <= (*i)->time());
+		prev = *i;
+	}
+	CPPUNIT_ASSERT_EQUAL (n_notes / 2, count);
+
+	while (!store.empty ()) {
+		store.erase (store.begin ());
+	}
+	CPPUNIT_ASSERT (store.begin() == store.end());
+}
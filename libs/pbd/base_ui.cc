@@ -52,6 +52,7 @@ BaseUI::BaseUI (const string& loop_name)
 	, m_context(MainContext::get_default())
 	, run_loop_thread (0)
 	, request_channel (true)
+	, _wakeup_pending (0)
 {
 	base_ui_instance = this;
 	request_channel.set_receive_handler (sigc::mem_fun (*this, &BaseUI::request_handler));
@@ -131,6 +132,9 @@ BaseUI::request_handler (Glib::IOCondition ioc)
 	if (ioc & IO_IN) {
 		request_channel.drain ();
 
+		/* from here on, new requests need to wake us again */
+		g_atomic_int_set (&_wakeup_pending, 0);
+
 		/* there may been an error. we'd rather handle requests first,
 		   and then get IO_HUP or IO_ERR on the next loop.
 		*/
@@ -147,8 +151,13 @@ BaseUI::request_handler (Glib::IOCondition ioc)
 void
 BaseUI::signal_new_request ()
 {
-	DEBUG_TRACE (DEBUG::EventLoop, string_compose ("%1: signal_new_request\n", event_loop_name()));
-	request_channel.wakeup ();
+	/* only the first request since we last looked needs to wake us up;
+	 * the rest will be handled along with it.
+	 */
+	if (g_atomic_int_compare_and_exchange (&_wakeup_pending, 0, 1)) {
+		DEBUG_TRACE (DEBUG::EventLoop, string_compose ("%1: signal_new_request\n", event_loop_name()));
+		request_channel.wakeup ();
+	}
 }
 
 /**
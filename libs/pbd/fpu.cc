@@ -69,6 +69,32 @@ __cpuid(int regs[4], int cpuid_leaf)
 	         "%ecx", "%edx", "memory");
 }
 
+/* ditto, __cpuidex(): for leaves which take a sub-leaf in %ecx */
+
+static void
+__cpuidex(int regs[4], int cpuid_leaf, int cpuid_subleaf)
+{
+        asm volatile (
+#if defined(__i386__)
+	        "pushl %%ebx;\n\t"
+#endif
+	        "cpuid;\n\t"
+	        "movl %%eax, (%2);\n\t"
+	        "movl %%ebx, 4(%2);\n\t"
+	        "movl %%ecx, 8(%2);\n\t"
+	        "movl %%edx, 12(%2);\n\t"
+#if defined(__i386__)
+	        "popl %%ebx;\n\t"
+#endif
+	        :"=a" (cpuid_leaf), "=c" (cpuid_subleaf) /* %eax, %ecx clobbered by CPUID */
+	        :"S" (regs), "a" (cpuid_leaf), "c" (cpuid_subleaf)
+	        :
+#if !defined(__i386__)
+	         "%ebx",
+#endif
+	         "%edx", "memory");
+}
+
 #endif /* !PLATFORM_WINDOWS */
 
 #ifndef HAVE_XGETBV // Allow definition by build system
@@ -154,7 +180,11 @@ FPU::FPU ()
 	}
 
 #if !( (defined __x86_64__) || (defined __i386__) || (defined _M_X64) || (defined _M_IX86) ) // !ARCH_X86
-	/* Non-Intel architecture, nothing to do here */
+	/* Non-Intel architecture, nothing to detect at runtime */
+#if defined (__aarch64__) || defined (_M_ARM64)
+	/* NEON (Advanced SIMD) is a mandatory part of ARMv8-A */
+	_flags = Flags (_flags | HasNEON);
+#endif
 	return;
 #else
 
@@ -187,11 +217,42 @@ FPU::FPU ()
 
 		__cpuid (cpu_info, 1);
 
+		uint64_t xcr0 = 0;
+
+		if (cpu_info[2] & (1<<27)) { /* OSXSAVE */
+			xcr0 = _xgetbv (_XCR_XFEATURE_ENABLED_MASK);
+		}
+
 		if ((cpu_info[2] & (1<<27)) /* OSXSAVE */ &&
 		    (cpu_info[2] & (1<<28) /* AVX */) &&
-		    ((_xgetbv (_XCR_XFEATURE_ENABLED_MASK) & 0x6) == 0x6)) { /* OS really supports XSAVE */
+		    ((xcr0 & 0x6) == 0x6)) { /* OS really supports XSAVE */
 			info << _("AVX-capable processor") << endmsg;
 			_flags = Flags (_flags | (HasAVX) );
+
+			if (cpu_info[2] & (1<<12)) {
+				_flags = Flags (_flags | HasFMA);
+			}
+		}
+
+		if (num_ids >= 7 && (_flags & HasAVX)) {
+
+			/* structured extended feature flags, sub-leaf 0 */
+
+			int ext_info[4];
+			__cpuidex (ext_info, 7, 0);
+
+			if (ext_info[1] & (1<<5)) {
+				info << _("AVX2-capable processor") << endmsg;
+				_flags = Flags (_flags | HasAVX2);
+			}
+
+			/* AVX-512 also needs the OS to save the opmask and
+			 * upper ZMM registers (XCR0 bits 5, 6 and 7).
+			 */
+			if ((ext_info[1] & (1<<16)) && ((xcr0 & 0xe6) == 0xe6)) {
+				info << _("AVX-512-capable processor") << endmsg;
+				_flags = Flags (_flags | HasAVX512F);
+			}
 		}
 
 		if (cpu_info[3] & (1<<25)) {
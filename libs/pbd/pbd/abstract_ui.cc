@@ -19,9 +19,13 @@
 #include <unistd.h>
 #include <iostream>
 #include <algorithm>
+#include <set>
+#include <vector>
 
 #include "pbd/stacktrace.h"
 #include "pbd/abstract_ui.h"
+#include "pbd/compose.h"
+#include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/failed_constructor.h"
 #include "pbd/debug.h"
@@ -71,29 +75,54 @@ AbstractUI<RequestObject>::AbstractUI (const string& name)
 	   register_thread() is thread safe anyway.
 	*/
 
+	for (int n = 0; n < max_request_buffers; ++n) {
+		request_buffers[n] = 0;
+	}
+
 	PBD::ThreadCreatedWithRequestSize.connect_same_thread (new_thread_connection, boost::bind (pmf, this, _1, _2, _3));
 
 	/* find pre-registerer threads */
 
 	vector<EventLoop::ThreadBufferMapping> tbm = EventLoop::get_request_buffers_for_target_thread (event_loop_name());
 
-	{
-		Glib::Threads::Mutex::Lock rbml (request_buffer_map_lock);
-		for (vector<EventLoop::ThreadBufferMapping>::iterator t = tbm.begin(); t != tbm.end(); ++t) {
-			request_buffers[t->emitting_thread] = static_cast<RequestBuffer*> (t->request_buffer);
-		}
+	for (vector<EventLoop::ThreadBufferMapping>::iterator t = tbm.begin(); t != tbm.end(); ++t) {
+		add_request_buffer (static_cast<RequestBuffer*> (t->request_buffer));
 	}
 }
 
 template <typename RequestObject>
 AbstractUI<RequestObject>::~AbstractUI ()
 {
-	for (RequestBufferMapIterator i = request_buffers.begin(); i != request_buffers.end(); ++i) {
-		if ((*i).second->dead) {
-			EventLoop::remove_request_buffer_from_map ((*i).second);
-			delete (*i).second;
+	for (int n = 0; n < max_request_buffers; ++n) {
+		RequestBuffer* rb = request_buffer (n);
+		if (rb && rb->dead) {
+			EventLoop::remove_request_buffer_from_map (rb);
+			delete rb;
+		}
+	}
+}
+
+/** Add @param rb to the buffers that we read requests from, unless it is
+ *  there already.  May be called from any thread.
+ *  @return false if there was no room for it.
+ */
+template <typename RequestObject> bool
+AbstractUI<RequestObject>::add_request_buffer (RequestBuffer* rb)
+{
+	for (int n = 0; n < max_request_buffers; ++n) {
+		if (request_buffer (n) == rb) {
+			return true;
+		}
+	}
+
+	for (int n = 0; n < max_request_buffers; ++n) {
+		if (g_atomic_pointer_compare_and_exchange (&request_buffers[n], 0, rb)) {
+			return true;
 		}
 	}
+
+	PBD::error << string_compose (_("%1: too many threads registered for requests"), event_loop_name()) << endmsg;
+	return false;
 }
 
 template <typename RequestObject> void
@@ -118,38 +147,39 @@ AbstractUI<RequestObject>::register_thread (pthread_t thread_id, string thread_n
 
 	RequestBuffer* b = per_thread_request_buffer.get();
 
-	if (!b) {
+	if (b) {
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 : %2 is already registered\n", event_loop_name(), thread_name));
+		add_request_buffer (b);
+		return;
+	}
 
-		/* create a new request queue/ringbuffer */
+	/* create a new request queue/ringbuffer */
 
-		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("create new request buffer for %1 in %2\n", thread_name, event_loop_name()));
+	DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("create new request buffer for %1 in %2\n", thread_name, event_loop_name()));
 
-		b = new RequestBuffer (num_requests); // XXX leaks
-		/* set this thread's per_thread_request_buffer to this new
-		   queue/ringbuffer. remember that only this thread will
-		   get this queue when it calls per_thread_request_buffer.get()
+	b = new RequestBuffer (num_requests); // XXX leaks
 
-		   the second argument is a function that will be called
-		   when the thread exits, and ensures that the buffer is marked
-		   dead. it will then be deleted during a call to handle_ui_requests()
-		*/
+	/* add the new request queue (ringbuffer) to the buffers we read
+	   from, so that we can iterate over it when the time is right. If
+	   there is no room, the thread will have to use heap-allocated
+	   requests instead.
+	*/
 
-		per_thread_request_buffer.set (b);
-	} else {
-		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 : %2 is already registered\n", event_loop_name(), thread_name));
+	if (!add_request_buffer (b)) {
+		delete b;
+		return;
 	}
 
-	{
-		/* add the new request queue (ringbuffer) to our map
-		   so that we can iterate over it when the time is right.
-		   This step is not RT-safe, but is assumed to be called
-		   only at thread initialization time, not repeatedly,
-		   and so this is of little consequence.
-		*/
-		Glib::Threads::Mutex::Lock rbml (request_buffer_map_lock);
-		request_buffers[thread_id] = b;
-	}
+	/* set this thread's per_thread_request_buffer to this new
+	   queue/ringbuffer. remember that only this thread will
+	   get this queue when it calls per_thread_request_buffer.get()
+
+	   the destructor given to per_thread_request_buffer will be called
+	   when the thread exits, and ensures that the buffer is marked
+	   dead. it will then be deleted during a call to handle_ui_requests()
+	*/
 
+	per_thread_request_buffer.set (b);
 }
 
 template <typename RequestObject> RequestObject*
@@ -179,6 +209,7 @@ AbstractUI<RequestObject>::get_request (RequestType rt)
 		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: allocated per-thread request of type %2, caller %3\n", event_loop_name(), rt, pthread_name()));
 
 		vec.buf[0]->type = rt;
+		vec.buf[0]->coalesce_key = 0;
 		return vec.buf[0];
 	}
 
@@ -195,12 +226,32 @@ AbstractUI<RequestObject>::get_request (RequestType rt)
 	return req;
 }
 
+/** Find which of a batch of requests are superseded by later ones: set
+ *  @param superseded[i] for each request in @param reqs that has a
+ *  coalescing key that is used again later in the batch.
+ */
+template <typename RequestObject> static void
+find_superseded (vector<RequestObject*> const & reqs, vector<bool>& superseded)
+{
+	typedef std::pair<void const *, PBD::EventLoop::InvalidationRecord*> Key;
+	std::set<Key> seen;
+
+	superseded.assign (reqs.size(), false);
+
+	for (size_t i = reqs.size(); i > 0; --i) {
+		RequestObject* req = reqs[i - 1];
+		if (!req->coalesce_key || !req->invalidation) {
+			continue;
+		}
+		if (!seen.insert (Key (req->coalesce_key, req->invalidation)).second) {
+			superseded[i - 1] = true;
+		}
+	}
+}
+
 template <typename RequestObject> void
 AbstractUI<RequestObject>::handle_ui_requests ()
 {
-	RequestBufferMapIterator i;
-	RequestBufferVector vec;
-
 	/* check all registered per-thread buffers first */
 	Glib::Threads::Mutex::Lock rbml (request_buffer_map_lock);
 
@@ -226,143 +277,190 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 	}
 #endif
 
-	DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 check %2 request buffers for requests\n", event_loop_name(), request_buffers.size()));
-
-	for (i = request_buffers.begin(); i != request_buffers.end(); ++i) {
-
-		while (!(*i).second->dead) {
-
-			/* we must process requests 1 by 1 because
-			 * the request may run a recursive main
-			 * event loop that will itself call
-			 * handle_ui_requests. when we return
-			 * from the request handler, we cannot
-			 * expect that the state of queued requests
-			 * is even remotely consistent with
-			 * the condition before we called it.
-			 */
-
-			i->second->get_read_vector (&vec);
-
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 reading requests from RB[%2] @ %5, requests = %3 + %4\n",
-						event_loop_name(), std::distance (request_buffers.begin(), i), vec.len[0], vec.len[1], i->second));
-
-			if (vec.len[0] == 0) {
-				break;
-			} else {
-				if (vec.buf[0]->invalidation && !vec.buf[0]->invalidation->valid ()) {
-					DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: skipping invalidated request\n", event_loop_name()));
-					rbml.release ();
-				} else {
-
-					DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: valid request, unlocking before calling\n", event_loop_name()));
-					rbml.release ();
-
-					DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: valid request, calling ::do_request()\n", event_loop_name()));
-					do_request (vec.buf[0]);
-				}
-
-				/* if the request was CallSlot, then we need to ensure that we reset the functor in the request, in case it
-				 * held a shared_ptr<>. Failure to do so can lead to dangling references to objects passed to PBD::Signals.
-				 *
-				 * Note that this method (::handle_ui_requests()) is by definition called from the event loop thread, so
-				 * caller_is_self() is true, which means that the execution of the functor has definitely happened after
-				 * do_request() returns and we no longer need the functor for any reason.
-				 */
-
-				if (vec.buf[0]->type == CallSlot) {
-					vec.buf[0]->the_slot = 0;
-				}
-
-				rbml.acquire ();
-				if (vec.buf[0]->invalidation) {
-					vec.buf[0]->invalidation->unref ();
-				}
-				vec.buf[0]->invalidation = NULL;
-				i->second->increment_read_ptr (1);
-			}
+	for (int n = 0; n < max_request_buffers; ++n) {
+		RequestBuffer* rb = request_buffer (n);
+		if (rb && !rb->dead) {
+			handle_buffered_requests (rb, rbml);
 		}
 	}
 
 	assert (rbml.locked ());
-	for (i = request_buffers.begin(); i != request_buffers.end(); ) {
-		if ((*i).second->dead) {
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 deleting dead per-thread request buffer for %3 @ %4 (%5 requests)\n", event_loop_name(), pthread_name(), i->second, (*i).second->read_space()));
-			RequestBufferMapIterator tmp = i;
-			++tmp;
+	for (int n = 0; n < max_request_buffers; ++n) {
+		RequestBuffer* rb = request_buffer (n);
+		if (rb && rb->dead && rb->readers == 0) {
+			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 deleting dead per-thread request buffer for %3 @ %4 (%5 requests)\n", event_loop_name(), pthread_name(), rb, rb->read_space()));
 			/* remove it from the EventLoop static map of all request buffers */
-			EventLoop::remove_request_buffer_from_map ((*i).second);
+			EventLoop::remove_request_buffer_from_map (rb);
+			/* remove it from this UI's request buffers */
+			g_atomic_pointer_set (&request_buffers[n], 0);
 			/* delete it
 			 *
 			 * Deleting the ringbuffer destroys all RequestObjects
 			 * and thereby drops any InvalidationRecord references of
 			 * requests that have not been processed.
 			 */
-			delete (*i).second;
-			/* remove it from this thread's list of request buffers */
-			request_buffers.erase (i);
-			i = tmp;
-		} else {
-			++i;
+			delete rb;
 		}
 	}
 
 	/* and now, the generic request buffer. same rules as above apply */
 
+	handle_heap_requests (rbml);
+
+	rbml.release ();
+}
+
+/** Deliver the requests queued in @param rb, in batches of however many
+ *  are waiting when we look, until it is empty.  Must be called with
+ *  @param rbml held; it is released while each request is carried out.
+ */
+template <typename RequestObject> void
+AbstractUI<RequestObject>::handle_buffered_requests (RequestBuffer* rb, Glib::Threads::Mutex::Lock& rbml)
+{
+	RequestBufferVector vec;
+	vector<RequestObject*> batch;
+	vector<bool> superseded;
+
+	/* a request may run a recursive main event loop that will itself
+	 * call handle_ui_requests, and deliver later requests from this
+	 * buffer before do_request() returns here. So each request is taken
+	 * out of the buffer before it is carried out, and if a nested call
+	 * has taken any more by then, we look at the buffer afresh.
+	 */
+
+	++rb->readers;
+
+	while (!rb->dead) {
+
+		rb->get_read_vector (&vec);
+
+		if (vec.len[0] + vec.len[1] == 0) {
+			break;
+		}
+
+		batch.clear ();
+		for (size_t i = 0; i < vec.len[0]; ++i) {
+			batch.push_back (&vec.buf[0][i]);
+		}
+		for (size_t i = 0; i < vec.len[1]; ++i) {
+			batch.push_back (&vec.buf[1][i]);
+		}
+
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 reading %2 requests from RB @ %3\n", event_loop_name(), batch.size(), rb));
+
+		find_superseded (batch, superseded);
+
+		const uint64_t first = rb->n_read;
+
+		for (size_t i = 0; i < batch.size() && !rb->dead && rb->n_read == first + i; ++i) {
+
+			/* the copy takes over the request, including its reference
+			 * to the invalidation record and anything its functor holds.
+			 */
+			RequestObject req (*batch[i]);
+			*batch[i] = RequestObject ();
+			rb->increment_read_ptr (1);
+			++rb->n_read;
+
+			if (superseded[i]) {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: skipping superseded request\n", event_loop_name()));
+			} else if (req.invalidation && !req.invalidation->valid ()) {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: skipping invalidated request\n", event_loop_name()));
+			} else {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: valid request, unlocking before calling ::do_request()\n", event_loop_name()));
+				rbml.release ();
+				do_request (&req);
+				rbml.acquire ();
+			}
+
+			/* drop our reference to the invalidation record while
+			 * holding the lock; the functor (which may hold shared_ptr<>s
+			 * to objects passed to PBD::Signals) goes with the copy.
+			 */
+
+			if (req.invalidation) {
+				req.invalidation->unref ();
+			}
+			req.invalidation = NULL;
+		}
+	}
+
+	--rb->readers;
+}
+
+/** Deliver requests from threads without their own request buffer.
+ *  Must be called with @param rbml held.
+ */
+template <typename RequestObject> void
+AbstractUI<RequestObject>::handle_heap_requests (Glib::Threads::Mutex::Lock& rbml)
+{
+	vector<bool> superseded;
+
 	while (!request_list.empty()) {
 		assert (rbml.locked ());
-		RequestObject* req = request_list.front ();
-		request_list.pop_front ();
 
-		/* we're about to execute this request, so its
-		 * too late for any invalidation. mark
-		 * the request as "done" before we start.
+		/* take everything that is waiting now; anything queued while we
+		 * deliver these, including by a nested call, waits for the next
+		 * time around.
 		 */
 
-		if (req->invalidation && !req->invalidation->valid()) {
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 handling invalid heap request, type %3, deleting\n", event_loop_name(), pthread_name(), req->type));
-			delete req;
-			continue;
-		}
+		vector<RequestObject*> batch (request_list.begin(), request_list.end());
+		request_list.clear ();
 
-		/* at this point, an object involved in a functor could be
-		 * deleted before we actually execute the functor. so there is
-		 * a race condition that makes the invalidation architecture
-		 * somewhat pointless.
-		 *
-		 * really, we should only allow functors containing shared_ptr
-		 * references to objects to enter into the request queue.
-		 */
+		find_superseded (batch, superseded);
 
-		/* unlock the request lock while we execute the request, so
-		 * that we don't needlessly block other threads (note: not RT
-		 * threads since they have their own queue) from making requests.
-		 */
+		for (size_t i = 0; i < batch.size(); ++i) {
 
-		/* also the request may destroy the object itself resulting in a direct
-		 * path to EventLoop::invalidate_request () from here
-		 * which takes the lock */
+			RequestObject* req = batch[i];
 
-		rbml.release ();
+			/* we're about to execute this request, so its
+			 * too late for any invalidation. mark
+			 * the request as "done" before we start.
+			 */
 
-		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 execute request type %3\n", event_loop_name(), pthread_name(), req->type));
+			if (superseded[i] || (req->invalidation && !req->invalidation->valid())) {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 dropping invalid or superseded heap request, type %3\n", event_loop_name(), pthread_name(), req->type));
+				delete req;
+				continue;
+			}
 
-		/* and lets do it ... this is a virtual call so that each
-		 * specific type of UI can have its own set of requests without
-		 * some kind of central request type registration logic
-		 */
+			/* at this point, an object involved in a functor could be
+			 * deleted before we actually execute the functor. so there is
+			 * a race condition that makes the invalidation architecture
+			 * somewhat pointless.
+			 *
+			 * really, we should only allow functors containing shared_ptr
+			 * references to objects to enter into the request queue.
+			 */
 
-		do_request (req);
+			/* unlock the request lock while we execute the request, so
+			 * that we don't needlessly block other threads (note: not RT
+			 * threads since they have their own queue) from making requests.
+			 */
 
-		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 delete heap request type %3\n", event_loop_name(), pthread_name(), req->type));
-		delete req;
+			/* also the request may destroy the object itself resulting in a direct
+			 * path to EventLoop::invalidate_request () from here
+			 * which takes the lock */
 
-		/* re-acquire the list lock so that we check again */
+			rbml.release ();
 
-		rbml.acquire();
-	}
+			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 execute request type %3\n", event_loop_name(), pthread_name(), req->type));
 
-	rbml.release ();
+			/* and lets do it ... this is a virtual call so that each
+			 * specific type of UI can have its own set of requests without
+			 * some kind of central request type registration logic
+			 */
+
+			do_request (req);
+
+			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 delete heap request type %3\n", event_loop_name(), pthread_name(), req->type));
+			delete req;
+
+			/* re-acquire the list lock so that we check again */
+
+			rbml.acquire();
+		}
+	}
 }
 
 template <typename RequestObject> void
@@ -422,7 +520,7 @@ AbstractUI<RequestObject>::send_request (RequestObject *req)
 }
 
 template<typename RequestObject> void
-AbstractUI<RequestObject>::call_slot (InvalidationRecord* invalidation, const boost::function<void()>& f)
+AbstractUI<RequestObject>::call_slot (InvalidationRecord* invalidation, const boost::function<void()>& f, void const * coalesce_key)
 {
 	if (caller_is_self()) {
 		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 direct dispatch of call slot via functor @ %3, invalidation %4\n", event_loop_name(), pthread_name(), &f, invalidation));
@@ -473,6 +571,7 @@ AbstractUI<RequestObject>::call_slot (InvalidationRecord* invalidation, const bo
 	 */
 
 	req->invalidation = invalidation;
+	req->coalesce_key = coalesce_key;
 
 	send_request (req);
 }
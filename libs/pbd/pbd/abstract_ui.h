@@ -20,6 +20,7 @@
 #ifndef __pbd_abstract_ui_h__
 #define __pbd_abstract_ui_h__
 
+#include <list>
 #include <map>
 #include <string>
 #include <pthread.h>
@@ -59,7 +60,7 @@ public:
 	virtual ~AbstractUI();
 
 	void register_thread (pthread_t, std::string, uint32_t num_requests);
-	void call_slot (EventLoop::InvalidationRecord*, const boost::function<void()>&);
+	void call_slot (EventLoop::InvalidationRecord*, const boost::function<void()>&, void const * coalesce_key = 0);
 	Glib::Threads::Mutex& slot_invalidation_mutex() { return request_buffer_map_lock; }
 
 	Glib::Threads::Mutex request_buffer_map_lock;
@@ -69,28 +70,29 @@ public:
 protected:
 	struct RequestBuffer : public PBD::RingBufferNPT<RequestObject> {
 		bool dead;
+		int readers;     ///< calls delivering requests from this buffer (they may nest)
+		uint64_t n_read; ///< number of requests taken out of this buffer
 		RequestBuffer (uint32_t size)
 			: PBD::RingBufferNPT<RequestObject> (size)
-			, dead (false) {}
+			, dead (false)
+			, readers (0)
+			, n_read (0) {}
 	};
 	typedef typename RequestBuffer::rw_vector RequestBufferVector;
 
-#if defined(COMPILER_MINGW) && defined(PTW32_VERSION)
-	struct pthread_cmp
-	{
-		bool operator() (const ptw32_handle_t& thread1, const ptw32_handle_t& thread2)
-		{
-			return thread1.p < thread2.p;
-		}
-	};
-	typedef typename std::map<pthread_t,RequestBuffer*, pthread_cmp>::iterator RequestBufferMapIterator;
-	typedef std::map<pthread_t,RequestBuffer*, pthread_cmp> RequestBufferMap;
-#else
-	typedef typename std::map<pthread_t,RequestBuffer*>::iterator RequestBufferMapIterator;
-	typedef std::map<pthread_t,RequestBuffer*> RequestBufferMap;
-#endif
+	/** The per-thread request buffers that this UI reads from.  Slots are
+	 *  filled by registering threads and emptied by the UI thread once a
+	 *  buffer is dead, without a lock; so there is a fixed limit on the
+	 *  number of threads that can have their own buffer.
+	 */
+	enum { max_request_buffers = 256 };
+	mutable volatile gpointer request_buffers[max_request_buffers];
+
+	RequestBuffer* request_buffer (int n) const {
+		return static_cast<RequestBuffer*> (g_atomic_pointer_get (&request_buffers[n]));
+	}
+	bool add_request_buffer (RequestBuffer*);
 
-	RequestBufferMap request_buffers;
 	static Glib::Threads::Private<RequestBuffer> per_thread_request_buffer;
 
 	std::list<RequestObject*> request_list;
@@ -101,6 +103,10 @@ protected:
 
 	virtual void do_request (RequestObject *) = 0;
 	PBD::ScopedConnection new_thread_connection;
+
+private:
+	void handle_buffered_requests (RequestBuffer*, Glib::Threads::Mutex::Lock&);
+	void handle_heap_requests (Glib::Threads::Mutex::Lock&);
 };
 
 #endif /* __pbd_abstract_ui_h__ */
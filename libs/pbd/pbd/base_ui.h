@@ -108,6 +108,7 @@ class LIBPBD_API BaseUI : public sigc::trackable, public PBD::EventLoop
 	BaseUI* base_ui_instance;
 
 	CrossThreadChannel request_channel;
+	volatile gint _wakeup_pending;
 
 	static uint64_t rt_bit;
 
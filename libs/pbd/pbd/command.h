@@ -23,11 +23,16 @@
 #define __lib_pbd_command_h__
 
 #include <string>
+#include <vector>
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/signals.h"
 #include "pbd/statefuldestructible.h"
 
+namespace PBD {
+	class XMLSnapshot;
+}
+
 /** Base class for Undo/Redo commands and changesets */
 class LIBPBD_API Command : public PBD::StatefulDestructible, public PBD::ScopedConnectionList
 {
@@ -49,6 +54,16 @@ public:
 		return false;
 	}
 
+	/** @return an estimate of the memory, in bytes, held by this command,
+	 *  not counting the contents of any XMLSnapshots (see snapshots())
+	 */
+	virtual size_t memory_size () const {
+		return sizeof (*this);
+	}
+
+	/** Add the XMLSnapshots held by this command to @param s */
+	virtual void snapshots (std::vector<PBD::XMLSnapshot const *>& /*s*/) const {}
+
 protected:
 	Command() {}
 	Command(const std::string& name) : _name(name) {}
@@ -79,8 +79,12 @@ public:
 		RequestType             type;
 		InvalidationRecord*     invalidation;
 		boost::function<void()> the_slot;
+		/** if non-0, a later queued request with the same key and
+		 *  invalidation record supersedes this one.
+		 */
+		void const *            coalesce_key;
 
-		BaseRequestObject() : invalidation (0) {}
+		BaseRequestObject() : invalidation (0), coalesce_key (0) {}
 		~BaseRequestObject() {
 			if (invalidation) {
 				invalidation->unref ();
@@ -88,7 +92,11 @@ public:
 		}
 	};
 
-	virtual void call_slot (InvalidationRecord*, const boost::function<void()>&) = 0;
+	/** Queue @param f to be called by this event loop.  If @param coalesce_key
+	 *  is given, and an earlier call with the same key and invalidation
+	 *  record is still waiting when this one arrives, only this one is made.
+	 */
+	virtual void call_slot (InvalidationRecord*, const boost::function<void()>&, void const * coalesce_key = 0) = 0;
 	virtual Glib::Threads::Mutex& slot_invalidation_mutex() = 0;
 
 	std::string event_loop_name() const { return _name; }
@@ -27,6 +27,7 @@
 #include "pbd/command.h"
 #include "pbd/stacktrace.h"
 #include "pbd/xml++.h"
+#include "pbd/xml_snapshot.h"
 #include "pbd/demangle.h"
 
 #include <sigc++/slot.h>
@@ -98,20 +99,23 @@ private:
 /** This command class is initialized with before and after mementos
  * (from Stateful::get_state()), so undo becomes restoring the before
  * memento, and redo is restoring the after memento.
+ *
+ * The mementos are kept as PBD::XMLSnapshots, so that the many commands
+ * in a long undo history which hold nearly identical state share it.
  */
 template <class obj_T>
 class LIBPBD_TEMPLATE_API MementoCommand : public Command
 {
 public:
 	MementoCommand (obj_T& a_object, XMLNode* a_before, XMLNode* a_after)
-		: _binder (new SimpleMementoCommandBinder<obj_T> (a_object)), before (a_before), after (a_after)
+		: _binder (new SimpleMementoCommandBinder<obj_T> (a_object)), before (snapshot (a_before)), after (snapshot (a_after))
 	{
 		/* The binder's object died, so we must die */
 		_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&MementoCommand::binder_dying, this));
 	}
 
 	MementoCommand (MementoCommandBinder<obj_T>* b, XMLNode* a_before, XMLNode* a_after)
-		: _binder (b), before (a_before), after (a_after)
+		: _binder (b), before (snapshot (a_before)), after (snapshot (a_after))
 	{
 		/* The binder's object died, so we must die */
 		_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&MementoCommand::binder_dying, this));
@@ -130,13 +134,33 @@ public:
 
 	void operator() () {
 		if (after) {
-			_binder->get()->set_state(*after, Stateful::current_state_version);
+			XMLNode* n = after->node ();
+			_binder->get()->set_state(*n, Stateful::current_state_version);
+			delete n;
 		}
 	}
 
 	void undo() {
 		if (before) {
-			_binder->get()->set_state(*before, Stateful::current_state_version);
+			XMLNode* n = before->node ();
+			_binder->get()->set_state(*n, Stateful::current_state_version);
+			delete n;
+		}
+	}
+
+	size_t memory_size () const {
+		/* the snapshots' contents may be shared, so they are accounted
+		 * for by whoever holds this command; see snapshots().
+		 */
+		return sizeof (*this) + (before ? sizeof (PBD::XMLSnapshot) : 0) + (after ? sizeof (PBD::XMLSnapshot) : 0);
+	}
+
+	void snapshots (std::vector<PBD::XMLSnapshot const *>& s) const {
+		if (before) {
+			s.push_back (before);
+		}
+		if (after) {
+			s.push_back (after);
 		}
 	}
 
@@ -156,20 +180,30 @@ public:
 		node->set_property ("type-name", _binder->type_name ());
 
 		if (before) {
-			node->add_child_copy(*before);
+			node->add_child_nocopy(*before->node ());
 		}
 
 		if (after) {
-			node->add_child_copy(*after);
+			node->add_child_nocopy(*after->node ());
 		}
 
 		return *node;
 	}
 
 protected:
+	/** Take a snapshot of @param n and delete it */
+	static PBD::XMLSnapshot* snapshot (XMLNode* n) {
+		if (!n) {
+			return 0;
+		}
+		PBD::XMLSnapshot* s = new PBD::XMLSnapshot (*n);
+		delete n;
+		return s;
+	}
+
 	MementoCommandBinder<obj_T>* _binder;
-	XMLNode* before;
-	XMLNode* after;
+	PBD::XMLSnapshot* before;
+	PBD::XMLSnapshot* after;
 	PBD::ScopedConnection _binder_death_connection;
 };
 
@@ -122,26 +122,7 @@ public:
 
 	boost::shared_ptr<T> write_copy ()
 	{
-		m_lock.lock();
-
-		// clean out any dead wood
-
-		typename std::list<boost::shared_ptr<T> >::iterator i;
-
-		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
-			if ((*i).unique()) {
-				i = m_dead_wood.erase (i);
-			} else {
-				++i;
-			}
-		}
-
-		/* store the current so that we can do compare and exchange
-		   when someone calls update(). Notice that we hold
-		   a lock, so this store of m_rcu_value is atomic.
-		*/
-
-		current_write_old = RCUManager<T>::x.m_rcu_value;
+		write_copy_locked ();
 
 		boost::shared_ptr<T> new_copy (new T(**current_write_old));
 
@@ -188,12 +169,45 @@ public:
 		return ret;
 	}
 
+	/** Publish @a new_value without copying the current value first,
+	 *  for writers that build the new value from scratch. Equivalent to
+	 *  write_copy() followed by update (new_value).
+	 */
+	bool replace (boost::shared_ptr<T> new_value)
+	{
+		write_copy_locked ();
+		return update (new_value);
+	}
+
 	void flush () {
 		Glib::Threads::Mutex::Lock lm (m_lock);
 		m_dead_wood.clear ();
 	}
 
 private:
+	/* lock out other writers, clean out dead wood and note the current value */
+	void write_copy_locked ()
+	{
+		m_lock.lock();
+
+		typename std::list<boost::shared_ptr<T> >::iterator i;
+
+		for (i = m_dead_wood.begin(); i != m_dead_wood.end(); ) {
+			if ((*i).unique()) {
+				i = m_dead_wood.erase (i);
+			} else {
+				++i;
+			}
+		}
+
+		/* store the current so that we can do compare and exchange
+		   when someone calls update(). Notice that we hold
+		   a lock, so this store of m_rcu_value is atomic.
+		*/
+
+		current_write_old = RCUManager<T>::x.m_rcu_value;
+	}
+
 	Glib::Threads::Mutex                      m_lock;
 	boost::shared_ptr<T>*            current_write_old;
 	std::list<boost::shared_ptr<T> > m_dead_wood;
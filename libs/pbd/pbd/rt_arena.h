@@ -0,0 +1,179 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __libpbd_rt_arena_h__
+#define __libpbd_rt_arena_h__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <glib.h>
+#include <glibmm/threads.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** A block of memory owned by one (realtime) thread, from which that thread
+ *  can allocate without calling malloc or taking a lock.
+ *
+ *  Threads that need one call create_per_thread_arena() once, before they
+ *  start realtime work; after that rt_alloc() and friends use the calling
+ *  thread's arena, and fall back to malloc (which is counted) only when the
+ *  arena is exhausted or the request is too large for it.  Threads without
+ *  an arena simply use malloc.
+ *
+ *  Memory may be freed by any thread.  Every block starts with a header
+ *  naming the arena it came from (or none, for malloc), so rt_free() finds
+ *  the owner directly.  Frees from threads other than the owner are handed
+ *  back to the owner without locking, and reused on its next allocation.  An arena whose thread has exited is kept until another
+ *  thread adopts it, so memory handed to other threads stays valid.
+ */
+class LIBPBD_API RTArena
+{
+  public:
+	struct Stats {
+		std::string name;
+		size_t      size;       ///< size of the arena in bytes
+		size_t      used;       ///< bytes currently allocated from it
+		size_t      high_water; ///< the most bytes ever allocated from it at once
+		uint64_t    n_alloc;    ///< allocations served from the arena
+		uint64_t    n_fallback; ///< allocations that had to use malloc instead
+		bool        active;     ///< true if a thread currently owns the arena
+	};
+
+	/** Give the calling thread an arena of (at least) @param bytes,
+	 *  if it does not have one already.  Not realtime safe.
+	 */
+	static void create_per_thread_arena (std::string const & name, size_t bytes);
+
+	/** Give up the calling thread's arena; this also happens
+	 *  automatically when the thread exits.
+	 */
+	static void drop_per_thread_arena ();
+
+	/** @return the calling thread's arena, or 0 */
+	static RTArena* per_thread_arena ();
+
+	/** Fill @param stats with the state of every arena */
+	static void get_stats (std::vector<Stats>& stats);
+
+	/** Forget high-water marks and counts in all arenas */
+	static void reset_stats ();
+
+	Stats stats () const;
+
+	void* alloc (size_t);
+	void release (void*);
+
+	bool contains (void const * p) const {
+		return (char const *) p >= _block && (char const *) p < _block + _size;
+	}
+
+	static size_t usable_size (void const *);
+
+	void count_fallback () { ++_n_fallback; }
+
+  private:
+	RTArena (std::string const & name, size_t bytes, uint32_t index);
+	~RTArena ();
+
+	struct Chunk {
+		Chunk* next;
+	};
+
+  public:
+	/** Precedes every block from rt_alloc(); padded to keep blocks aligned */
+	struct Header {
+		uint32_t size_class; ///< n_classes for blocks from malloc
+		uint32_t arena;      ///< index of the owning arena, or no_arena
+	};
+
+	static const size_t header_size = 16;
+	static const uint32_t n_classes = 13; /* 16 bytes .. 64 kB */
+	static const uint32_t no_arena = ~0U;
+
+	static Header* header (void const * p) {
+		return (Header*) ((char*) p - header_size);
+	}
+
+	/** @return the arena registered at @param index */
+	static RTArena* arena (uint32_t index);
+
+  private:
+	std::string _name;
+	uint32_t    _index;
+	char*       _block;
+	size_t      _size;
+	size_t      _bump;
+	Chunk*      _free[n_classes];
+
+	/* pushed by other threads, taken by the owner */
+	mutable volatile gpointer _remote;
+
+	/* whether a thread owns this arena */
+	mutable volatile gint _active;
+	/* set by reset_stats(), applied by the owner */
+	mutable volatile gint _reset;
+
+	size_t   _used;
+	size_t   _high_water;
+	uint64_t _n_alloc;
+	uint64_t _n_fallback;
+
+	static Glib::Threads::Private<RTArena> _thread_arena;
+
+	void take_remote ();
+	static void thread_exit (void*);
+	static uint32_t size_class (size_t);
+};
+
+/** Allocate @param size bytes, from the calling thread's arena if it has one */
+LIBPBD_API void* rt_alloc (size_t size);
+
+/** Resize memory from rt_alloc(); as realloc(), @param ptr may be 0 */
+LIBPBD_API void* rt_realloc (void* ptr, size_t size);
+
+/** Free memory from rt_alloc() or rt_realloc() */
+LIBPBD_API void rt_free (void* ptr);
+
+/** A scratch array of POD values allocated with rt_alloc() for the
+ *  lifetime of the object, in the manner of boost::scoped_array.
+ */
+template<typename T>
+class /*LIBPBD_API*/ RTScratch
+{
+  public:
+	RTScratch (size_t n) : _p (static_cast<T*> (rt_alloc (n * sizeof (T)))) {}
+	~RTScratch () { rt_free (_p); }
+
+	T* get () const { return _p; }
+	T& operator[] (size_t i) const { return _p[i]; }
+
+  private:
+	RTScratch (RTScratch const &);
+	RTScratch& operator= (RTScratch const &);
+
+	T* _p;
+};
+
+} /* namespace PBD */
+
+#endif /* __libpbd_rt_arena_h__ */
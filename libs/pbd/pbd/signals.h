@@ -24,11 +24,13 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #ifdef nil
 #undef nil
 #endif
 
+#include <glib.h>
 #include <glibmm/threads.h>
 
 #include <boost/noncopyable.hpp>
@@ -70,6 +72,14 @@ public:
 
 protected:
 	mutable Glib::Threads::Mutex _mutex;
+
+	/** Used by connect_coalesced(): @param f takes none of the signal's
+	 *  arguments, so every call queued for a connection is the same, and
+	 *  the connection itself (@param key) identifies them.
+	 */
+	static void coalescing_compositor (boost::function<void()> f, EventLoop* event_loop, EventLoop::InvalidationRecord* ir, void const * key) {
+		event_loop->call_slot (ir, f, key);
+	}
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	bool _debug_connection;
 #endif
@@ -116,6 +126,221 @@ private:
 	PBD::EventLoop::InvalidationRecord* _invalidation_record;
 };
 
+/** The slots connected to a signal.  These are kept in an immutable list
+ *  which is replaced, rather than modified, when a connection is made or
+ *  broken, so that emitting the signal needs neither a lock nor a copy of
+ *  the list: it only has to stop the list that it is using from being
+ *  deleted, which it does by creating an Emission.
+ *
+ *  Lists which have been replaced are deleted by reclaim() if no emission
+ *  is in progress, or else by the last emission in progress to finish.
+ *  A slot may delete the signal that is calling it; what the emission
+ *  still uses then goes when the emission ends.
+ *
+ *  Changes must be serialized by the caller; SignalN holds its _mutex.
+ *  It calls reclaim() after releasing that, because deleting a list may
+ *  delete the last reference to an object whose destructor disconnects
+ *  from this signal.
+ */
+template<typename F>
+class /*LIBPBD_API*/ SignalSlots
+{
+public:
+	typedef std::pair<boost::shared_ptr<Connection>, boost::shared_ptr<F> > Slot;
+	typedef std::vector<Slot> List;
+
+	SignalSlots ()
+		: _state (new State)
+	{
+	}
+
+	~SignalSlots ()
+	{
+		g_atomic_int_set (&_state->gone, 1);
+		_state->unref ();
+	}
+
+	/** @return the current list; only to be used while changes are
+	 *  locked out, or during an Emission.
+	 */
+	List const & list () const { return *_state->current (); }
+
+	void add (boost::shared_ptr<Connection> c, F const & f)
+	{
+		List* l = new List (list ());
+		l->push_back (Slot (c, boost::shared_ptr<F> (new F (f))));
+		_state->replace (l);
+	}
+
+	bool remove (boost::shared_ptr<Connection> c)
+	{
+		List const & o (list ());
+		typename List::const_iterator i = find (o, c);
+
+		if (i == o.end ()) {
+			return false;
+		}
+
+		List* l = new List;
+		l->reserve (o.size () - 1);
+		l->insert (l->end (), o.begin (), i);
+		l->insert (l->end (), i + 1, o.end ());
+		_state->replace (l);
+
+		return true;
+	}
+
+	/** Delete the lists replaced by add() and remove(), unless an
+	 *  emission is using them.  Must not be called with the caller's
+	 *  lock held.
+	 */
+	void reclaim ()
+	{
+		_state->reclaim ();
+	}
+
+private:
+	/** Everything that an Emission uses, which outlives the SignalSlots
+	 *  if a slot deletes the signal while it is being emitted.
+	 */
+	struct State {
+		State ()
+			: refs (1)
+			, gone (0)
+			, emitting (0)
+			, n_dead (0)
+			, list (new List)
+		{}
+
+		~State ()
+		{
+			delete current ();
+			drop (dead);
+		}
+
+		volatile gint refs; ///< the SignalSlots, and each Emission
+		volatile gint gone; ///< the SignalSlots has been deleted
+		volatile gint emitting;
+		volatile gint n_dead;
+		volatile gpointer list;
+		Glib::Threads::Mutex dead_lock;
+		std::list<List*> dead;
+
+		List* current () const
+		{
+			return (List*) g_atomic_pointer_get (&list);
+		}
+
+		void unref ()
+		{
+			if (g_atomic_int_dec_and_test (&refs)) {
+				delete this;
+			}
+		}
+
+		void replace (List* l)
+		{
+			Glib::Threads::Mutex::Lock lm (dead_lock);
+			dead.push_back (current ());
+			g_atomic_int_inc (&n_dead);
+			g_atomic_pointer_set (&list, l);
+		}
+
+		void reclaim ()
+		{
+			std::list<List*> d;
+
+			{
+				/* An emission which begins after this test will see
+				 * the current list, so if none is in progress now the
+				 * old lists can go.  Otherwise the last emission in
+				 * progress frees them.
+				 */
+				Glib::Threads::Mutex::Lock lm (dead_lock);
+				if (g_atomic_int_get (&emitting) == 0) {
+					d.swap (dead);
+					g_atomic_int_set (&n_dead, 0);
+				}
+			}
+
+			/* deleting their slots may disconnect others, which
+			 * needs dead_lock.
+			 */
+			drop (d);
+		}
+
+		static void drop (std::list<List*>& d)
+		{
+			for (typename std::list<List*>::iterator i = d.begin (); i != d.end (); ++i) {
+				delete *i;
+			}
+			d.clear ();
+		}
+	};
+
+public:
+	/** Keeps the list of slots as it was when the Emission was
+	 *  created alive for as long as the Emission exists.
+	 */
+	class Emission
+	{
+	public:
+		Emission (SignalSlots const & s)
+			: _state (s._state)
+		{
+			g_atomic_int_inc (&_state->refs);
+			g_atomic_int_inc (&_state->emitting);
+			_list = _state->current ();
+		}
+
+		~Emission ()
+		{
+			if (g_atomic_int_dec_and_test (&_state->emitting) && g_atomic_int_get (&_state->n_dead) > 0) {
+				/* the last emission to finish frees the lists
+				 * replaced while it was running */
+				_state->reclaim ();
+			}
+			_state->unref ();
+		}
+
+		List const & list () const { return *_list; }
+
+		/** @return true if @a c is still connected.  A slot called
+		 *  earlier in this emission (or another thread) may have
+		 *  disconnected it, or deleted the signal, since the emission
+		 *  began.
+		 */
+		bool still_there (boost::shared_ptr<Connection> const & c) const
+		{
+			if (g_atomic_int_get (&_state->gone)) {
+				return false;
+			}
+			List const * now = _state->current ();
+			return now == _list || find (*now, c) != now->end ();
+		}
+
+	private:
+		State* _state;
+		List const * _list;
+	};
+
+private:
+	/* not copyable */
+	SignalSlots (SignalSlots const &);
+	SignalSlots& operator= (SignalSlots const &);
+
+	State* _state;
+
+	static typename List::const_iterator find (List const & l, boost::shared_ptr<Connection> const & c)
+	{
+		typename List::const_iterator i = l.begin ();
+		while (i != l.end () && i->first != c) {
+			++i;
+		}
+		return i;
+	}
+};
+
 template<typename R>
 class /*LIBPBD_API*/ OptionalLastValue
 {
@@ -102,7 +102,7 @@ def signal(f, n, v):
 
     print("""
 	/** The slots that this signal will call on emission */
-	typedef std::map<boost::shared_ptr<Connection>, slot_function_type> Slots;
+	typedef SignalSlots<slot_function_type> Slots;
 	Slots _slots;
 """, file=f)
 
@@ -112,7 +112,7 @@ def signal(f, n, v):
 
     print("\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
     print("\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = _slots.begin(); i != _slots.end(); ++i) {" % typename, file=f)
+    print("\t\tfor (%sSlots::List::const_iterator i = _slots.list().begin(); i != _slots.list().end(); ++i) {" % typename, file=f)
 
     print("\t\t\ti->first->signal_going_away ();", file=f)
     print("\t\t}", file=f)
@@ -218,6 +218,32 @@ def signal(f, n, v):
     print("\t\tc = _connect (ir, boost::bind (&compositor, slot, event_loop, ir%s));" % p, file=f)
     print("\t}", file=f)
 
+    if v:
+        print("""
+	/** Arrange for @a slot to be executed in the context of @a event_loop
+	    whenever this signal is emitted, as for connect(), except that
+	    @a slot takes none of the signal's arguments, and if a call is
+	    still waiting in @a event_loop when the signal is emitted again,
+	    only the later one is made. This is meant for slots which just
+	    redisplay some current state, for which a burst of emissions
+	    needs only one call. Calls are only coalesced if @a ir is given.
+	*/
+
+	void connect_coalesced (ScopedConnectionList& clist,
+				PBD::EventLoop::InvalidationRecord* ir,
+				const boost::function<void()>& slot,
+				PBD::EventLoop* event_loop) {
+		clist.add_connection (_connect_coalesced (ir, slot, event_loop));
+	}
+
+	void connect_coalesced (ScopedConnection& c,
+				PBD::EventLoop::InvalidationRecord* ir,
+				const boost::function<void()>& slot,
+				PBD::EventLoop* event_loop) {
+		c = _connect_coalesced (ir, slot, event_loop);
+	}
+""", file=f)
+
     print("""
 	/** Emit this signal. This will cause all slots connected to it be executed
 	    in the order that they were connected (cross-thread issues may alter
@@ -230,34 +256,27 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
+    print("\t\t/* First, hold on to our list of slots as it is now. Connections and", file=f)
+    print("\t\t   disconnections replace the list rather than changing it, so this", file=f)
+    print("\t\t   needs neither a lock nor a copy.", file=f)
+    print("\t\t*/", file=f)
     print("", file=f)
-    print("\t\tSlots s;", file=f)
-    print("\t\t{", file=f)
-    print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
-    print("\t\t}", file=f)
+    print("\t\t%sSlots::Emission e (_slots);" % typename, file=f)
     print("", file=f)
     if not v:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+    print("\t\tfor (%sSlots::List::const_iterator i = e.list().begin(); i != e.list().end(); ++i) {" % typename, file=f)
     print("""
 			/* We may have just called a slot, and this may have resulted in
-			   disconnection of other slots from us.  The list copy means that
-			   this won't cause any problems with invalidated iterators, but we
-			   must check to see if the slot we are about to call is still on the list.
+			   disconnection of other slots from us.  The list we are using
+			   is not changed by that, but we must check to see if the slot
+			   we are about to call is still connected.
 			*/
-			bool still_there = false;
-			{
-				Glib::Threads::Mutex::Lock lm (_mutex);
-				still_there = _slots.find (i->first) != _slots.end ();
-			}
-
-			if (still_there) {""", file=f)
+			if (e.still_there (i->first)) {""", file=f)
     if v:
-        print("\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
+        print("\t\t\t\t(*i->second)(%s);" % comma_separated(an), file=f)
     else:
-        print("\t\t\t\tr.push_back ((i->second)(%s));" % comma_separated(an), file=f)
+        print("\t\t\t\tr.push_back ((*i->second)(%s));" % comma_separated(an), file=f)
     print("\t\t\t}", file=f)
     print("\t\t}", file=f)
     print("", file=f)
@@ -270,13 +289,13 @@ def signal(f, n, v):
     print("""
 	bool empty () const {
 		Glib::Threads::Mutex::Lock lm (_mutex);
-		return _slots.empty ();
+		return _slots.list().empty ();
 	}
 """, file=f)
     print("""
 	bool size () const {
 		Glib::Threads::Mutex::Lock lm (_mutex);
-		return _slots.size ();
+		return _slots.list().size ();
 	}
 """, file=f)
 
@@ -293,14 +312,33 @@ def signal(f, n, v):
 	boost::shared_ptr<Connection> _connect (PBD::EventLoop::InvalidationRecord* ir, slot_function_type f)
 	{
 		boost::shared_ptr<Connection> c (new Connection (this, ir));
-		Glib::Threads::Mutex::Lock lm (_mutex);
-		_slots[c] = f;
+		{
+			Glib::Threads::Mutex::Lock lm (_mutex);
+			_slots.add (c, f);
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
-                if (_debug_connection) {
-                        std::cerr << "+++++++ CONNECT " << this << " size now " << _slots.size() << std::endl;
-                        PBD::stacktrace (std::cerr, 10);
-                }
+			if (_debug_connection) {
+				std::cerr << "+++++++ CONNECT " << this << " size now " << _slots.list().size() << std::endl;
+				PBD::stacktrace (std::cerr, 10);
+			}
 #endif
+		}
+		_slots.reclaim ();
+		return c;
+	}""", file=f)
+
+    if v:
+        print("""
+	boost::shared_ptr<Connection> _connect_coalesced (PBD::EventLoop::InvalidationRecord* ir, const boost::function<void()>& slot, PBD::EventLoop* event_loop)
+	{
+		if (ir) {
+			ir->event_loop = event_loop;
+		}
+		boost::shared_ptr<Connection> c (new Connection (this, ir));
+		{
+			Glib::Threads::Mutex::Lock lm (_mutex);
+			_slots.add (c, boost::bind (&coalescing_compositor, slot, event_loop, ir, c.get ()));
+		}
+		_slots.reclaim ();
 		return c;
 	}""", file=f)
 
@@ -309,12 +347,14 @@ def signal(f, n, v):
 	{
 		{
 			Glib::Threads::Mutex::Lock lm (_mutex);
-    			_slots.erase (c);
+    			_slots.remove (c);
     		}
+		_slots.reclaim ();
 		c->disconnected ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
                	if (_debug_connection) {
-    			std::cerr << "------- DISCCONNECT " << this << " size now " << _slots.size() << std::endl;
+    			Glib::Threads::Mutex::Lock lm (_mutex);
+    			std::cerr << "------- DISCCONNECT " << this << " size now " << _slots.list().size() << std::endl;
                         PBD::stacktrace (std::cerr, 10);
 		}
 #endif
@@ -33,6 +33,7 @@
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/command.h"
+#include "pbd/xml_snapshot.h"
 
 typedef sigc::slot<void> UndoAction;
 
@@ -57,6 +58,9 @@ class LIBPBD_API UndoTransaction : public Command
 
 	XMLNode &get_state();
 
+	size_t memory_size () const;
+	void snapshots (std::vector<PBD::XMLSnapshot const *>&) const;
+
 	void set_timestamp (struct timeval &t) {
 		_timestamp = t;
 	}
@@ -108,6 +112,18 @@ class LIBPBD_API UndoHistory : public PBD::ScopedConnectionList
 
 	void set_depth (uint32_t);
 
+	/** Limit the memory used by the undo list to (roughly) @param bytes,
+	 *  dropping the oldest transactions as necessary; the most recent
+	 *  transaction is always kept.  0 means no limit.
+	 */
+	void set_memory_budget (size_t bytes);
+
+	/** @return an estimate of the memory, in bytes, used by the undo
+	 *  and redo lists, including the snapshotted state that they hold;
+	 *  state shared between transactions is counted once.
+	 */
+	size_t memory_size () const;
+
 	PBD::Signal0<void> Changed;
 	PBD::Signal0<void> BeginUndoRedo;
 	PBD::Signal0<void> EndUndoRedo;
@@ -115,10 +131,13 @@ class LIBPBD_API UndoHistory : public PBD::ScopedConnectionList
   private:
 	bool _clearing;
 	uint32_t _depth;
+	size_t _memory_budget;
 	std::list<UndoTransaction*> UndoList;
 	std::list<UndoTransaction*> RedoList;
 
 	void remove (UndoTransaction*);
+	void trim_to_memory_budget ();
+	size_t own_memory_size (PBD::XMLSnapshot::Usage&) const;
 };
 
 
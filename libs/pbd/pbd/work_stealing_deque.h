@@ -0,0 +1,161 @@
+/*
+    Copyright (C) 2016 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __pbd_work_stealing_deque_h__
+#define __pbd_work_stealing_deque_h__
+
+#include <cassert>
+#include <glib.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** A fixed-capacity, lock-free work-stealing deque of pointers
+ *  (Chase & Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005).
+ *
+ *  Exactly one thread (the owner) may call push() and pop(); they operate
+ *  LIFO at the bottom end. Any number of other threads may call steal(),
+ *  which takes items FIFO from the top end.
+ *
+ *  The deque never grows: push() returns false if it is full. This keeps
+ *  all operations free of memory allocation so that it can be used from
+ *  realtime threads.
+ *
+ *  Indices are free-running unsigned counters; all comparisons are done
+ *  on their (signed) difference so that wrapping around is harmless.
+ */
+template<class T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+  public:
+	WorkStealingDeque (guint sz) {
+		guint power_of_two;
+		for (power_of_two = 1; 1U<<power_of_two < sz; power_of_two++) {}
+		_size = 1<<power_of_two;
+		_size_mask = _size - 1;
+		_buf = new T*[_size];
+		for (guint i = 0; i < _size; ++i) {
+			_buf[i] = 0;
+		}
+		g_atomic_int_set (&_top, 0);
+		g_atomic_int_set (&_bottom, 0);
+	}
+
+	~WorkStealingDeque () {
+		delete [] _buf;
+	}
+
+	guint capacity () const { return _size; }
+
+	/** Owner only: add an item at the bottom.
+	 *  @return false if the deque is full.
+	 */
+	bool push (T* item) {
+		guint const b = (guint) g_atomic_int_get (&_bottom);
+		guint const t = (guint) g_atomic_int_get (&_top);
+		if ((gint) (b - t) >= (gint) _size) {
+			return false;
+		}
+		g_atomic_pointer_set (&_buf[b & _size_mask], item);
+		/* publish the item to thieves */
+		g_atomic_int_set (&_bottom, (gint) (b + 1));
+		return true;
+	}
+
+	/** Owner only: take the most recently pushed item.
+	 *  @return the item, or 0 if the deque is empty.
+	 */
+	T* pop () {
+		guint const b = (guint) g_atomic_int_get (&_bottom) - 1;
+		/* reserve the bottom slot before looking at top, so that a
+		 * concurrent steal() cannot take it without us noticing.
+		 */
+		g_atomic_int_set (&_bottom, (gint) b);
+		guint const t = (guint) g_atomic_int_get (&_top);
+
+		if ((gint) (b - t) < 0) {
+			/* empty */
+			g_atomic_int_set (&_bottom, (gint) (b + 1));
+			return 0;
+		}
+
+		T* item = (T*) g_atomic_pointer_get (&_buf[b & _size_mask]);
+
+		if (b == t) {
+			/* last item: race against thieves for it */
+			if (!g_atomic_int_compare_and_exchange (&_top, (gint) t, (gint) (t + 1))) {
+				item = 0;
+			}
+			g_atomic_int_set (&_bottom, (gint) (b + 1));
+		}
+
+		return item;
+	}
+
+	/** Any thread: take the oldest item.
+	 *  @param item set to the stolen item on success.
+	 *  @return true if an item was taken. false is returned both when
+	 *  the deque is empty and when another thread won a race for the
+	 *  item; use empty() to tell them apart if required.
+	 */
+	bool steal (T*& item) {
+		guint const t = (guint) g_atomic_int_get (&_top);
+		guint const b = (guint) g_atomic_int_get (&_bottom);
+
+		if ((gint) (b - t) <= 0) {
+			return false;
+		}
+
+		T* i = (T*) g_atomic_pointer_get (&_buf[t & _size_mask]);
+
+		if (!g_atomic_int_compare_and_exchange (&_top, (gint) t, (gint) (t + 1))) {
+			return false;
+		}
+
+		item = i;
+		return true;
+	}
+
+	/** Any thread: approximate check; the answer may be stale by the
+	 *  time the caller looks at it.
+	 */
+	bool empty () const {
+		guint const t = (guint) g_atomic_int_get (const_cast<gint*> (&_top));
+		guint const b = (guint) g_atomic_int_get (const_cast<gint*> (&_bottom));
+		return (gint) (b - t) <= 0;
+	}
+
+  private:
+	WorkStealingDeque (WorkStealingDeque const&);
+	WorkStealingDeque& operator= (WorkStealingDeque const&);
+
+	T**   _buf;
+	guint _size;
+	guint _size_mask;
+
+	/* keep the owner's and the thieves' index on separate cache lines */
+	volatile gint _top;
+	char          _pad[64 - sizeof (gint)];
+	volatile gint _bottom;
+};
+
+} // namespace PBD
+
+#endif /* __pbd_work_stealing_deque_h__ */
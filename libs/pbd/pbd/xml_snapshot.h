@@ -0,0 +1,103 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __libpbd_xml_snapshot_h__
+#define __libpbd_xml_snapshot_h__
+
+#include <cstddef>
+#include <map>
+#include <stdint.h>
+
+#include "pbd/libpbd_visibility.h"
+
+class XMLNode;
+
+namespace PBD {
+
+/** A compact, read-only copy of an XMLNode tree, for holding state that
+ *  is rarely looked at again, such as the before and after states kept
+ *  by undo history.
+ *
+ *  Each node of the tree is packed into a single string, and packed nodes
+ *  are shared by every snapshot that contains an identical subtree.  So
+ *  consecutive snapshots of, say, a playlist in which one region has
+ *  changed share the nodes of all the other regions, and cost little more
+ *  than the changed region itself.
+ */
+class LIBPBD_API XMLSnapshot
+{
+  public:
+	XMLSnapshot (XMLNode const &);
+	~XMLSnapshot ();
+
+	/** @return a new copy of the tree that was snapshotted, which the
+	 *  caller must delete.
+	 */
+	XMLNode* node () const;
+
+	/** @return an estimate of the memory, in bytes, that this snapshot
+	 *  added when it was taken; parts that it shared with snapshots
+	 *  which already existed are not counted.
+	 */
+	size_t memory_size () const { return _memory_size; }
+
+	/** @return an estimate of the memory, in bytes, held by all existing
+	 *  snapshots together.  Unlike the sum of their memory_size()s, this
+	 *  still counts the parts that a deleted snapshot shared with others.
+	 */
+	static size_t shared_memory_size ();
+
+	/** The memory held by some set of snapshots, counting each part that
+	 *  several of them share only once.  Snapshots must be removed from
+	 *  the set before they are deleted.
+	 */
+	class LIBPBD_API Usage {
+	  public:
+		Usage () : _size (0) {}
+
+		void add (XMLSnapshot const &);
+		void remove (XMLSnapshot const &);
+
+		/** @return an estimate of the memory, in bytes, held by the set */
+		size_t size () const { return _size; }
+
+	  private:
+		std::map<void const *, uint32_t> _refs;
+		size_t _size;
+	};
+
+  private:
+	/* not copyable */
+	XMLSnapshot (XMLSnapshot const &);
+	XMLSnapshot& operator= (XMLSnapshot const &);
+
+	struct Piece;
+	friend class Usage;
+	Piece* _root;
+	size_t _memory_size;
+
+	static Piece* intern (XMLNode const &, size_t& added);
+	static void release (Piece*);
+	static size_t memory_size (Piece const *);
+	static XMLNode* build (Piece const *);
+};
+
+} /* namespace PBD */
+
+#endif /* __libpbd_xml_snapshot_h__ */
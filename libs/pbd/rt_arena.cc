@@ -0,0 +1,385 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <cstdlib>
+#include <cstring>
+
+#include <glibmm/threads.h>
+
+#include "pbd/rt_arena.h"
+#include "pbd/malign.h"
+#include "pbd/error.h"
+#include "pbd/compose.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace PBD;
+
+namespace {
+
+/* Arenas are registered here so that rt_free() can find the owner of a
+ * block, by the index in its header, without a lock.  Slots are only ever
+ * filled, never emptied.
+ */
+const int max_arenas = 64;
+volatile gpointer arenas[max_arenas];
+volatile gint n_arenas = 0;
+
+Glib::Threads::Mutex&
+registry_lock ()
+{
+	static Glib::Threads::Mutex* m = new Glib::Threads::Mutex;
+	return *m;
+}
+
+RTArena*
+arena_at (int n)
+{
+	return static_cast<RTArena*> (g_atomic_pointer_get (&arenas[n]));
+}
+
+/** malloc() a block with a header that says so */
+void*
+heap_alloc (size_t size)
+{
+	char* h = static_cast<char*> (malloc (RTArena::header_size + size));
+	if (!h) {
+		return 0;
+	}
+	RTArena::Header* hdr = reinterpret_cast<RTArena::Header*> (h);
+	hdr->size_class = RTArena::n_classes;
+	hdr->arena = RTArena::no_arena;
+	return h + RTArena::header_size;
+}
+
+}
+
+/* the destructor function is only called for threads that still own an
+ * arena when they exit.
+ */
+Glib::Threads::Private<RTArena> RTArena::_thread_arena (RTArena::thread_exit);
+
+RTArena::RTArena (string const & name, size_t bytes, uint32_t index)
+	: _name (name)
+	, _index (index)
+	, _block (0)
+	, _size (bytes)
+	, _bump (0)
+	, _remote (0)
+	, _active (1)
+	, _reset (0)
+	, _used (0)
+	, _high_water (0)
+	, _n_alloc (0)
+	, _n_fallback (0)
+{
+	memset (_free, 0, sizeof (_free));
+	cache_aligned_malloc ((void**) &_block, _size);
+}
+
+RTArena::~RTArena ()
+{
+	cache_aligned_free (_block);
+}
+
+void
+RTArena::create_per_thread_arena (string const & name, size_t bytes)
+{
+	if (per_thread_arena ()) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (registry_lock ());
+
+	/* adopt the arena of a thread which has gone away, if there is one
+	 * big enough, rather than leave it unused.
+	 */
+	const int n = g_atomic_int_get (&n_arenas);
+
+	for (int i = 0; i < n; ++i) {
+		RTArena* a = arena_at (i);
+		if (a->_size >= bytes && g_atomic_int_compare_and_exchange (&a->_active, 0, 1)) {
+			a->_name = name;
+			_thread_arena.set (a);
+			return;
+		}
+	}
+
+	if (n == max_arenas) {
+		warning << string_compose (_("Too many realtime memory arenas, thread \"%1\" will use malloc()"), name) << endmsg;
+		return;
+	}
+
+	RTArena* a = new RTArena (name, bytes, n);
+	g_atomic_pointer_set (&arenas[n], a);
+	g_atomic_int_set (&n_arenas, n + 1);
+	_thread_arena.set (a);
+}
+
+void
+RTArena::drop_per_thread_arena ()
+{
+	RTArena* a = per_thread_arena ();
+	if (a) {
+		_thread_arena.set (0);
+		thread_exit (a);
+	}
+}
+
+void
+RTArena::thread_exit (void* arg)
+{
+	RTArena* a = static_cast<RTArena*> (arg);
+	g_atomic_int_set (&a->_active, 0);
+}
+
+RTArena*
+RTArena::per_thread_arena ()
+{
+	return _thread_arena.get ();
+}
+
+RTArena*
+RTArena::arena (uint32_t index)
+{
+	return arena_at (index);
+}
+
+void
+RTArena::get_stats (vector<Stats>& stats)
+{
+	Glib::Threads::Mutex::Lock lm (registry_lock ());
+
+	stats.clear ();
+
+	const int n = g_atomic_int_get (&n_arenas);
+	for (int i = 0; i < n; ++i) {
+		stats.push_back (arena_at (i)->stats ());
+	}
+}
+
+void
+RTArena::reset_stats ()
+{
+	const int n = g_atomic_int_get (&n_arenas);
+	for (int i = 0; i < n; ++i) {
+		g_atomic_int_set (&arena_at (i)->_reset, 1);
+	}
+}
+
+/* The counts are only written by the owning thread, and may be slightly
+ * out of date when read here.
+ */
+RTArena::Stats
+RTArena::stats () const
+{
+	Stats s;
+	s.name = _name;
+	s.size = _size;
+	s.used = _used;
+	s.high_water = _high_water;
+	s.n_alloc = _n_alloc;
+	s.n_fallback = _n_fallback;
+	s.active = g_atomic_int_get (&_active);
+	return s;
+}
+
+uint32_t
+RTArena::size_class (size_t size)
+{
+	uint32_t c = 0;
+	while (c < n_classes && ((size_t) 16 << c) < size) {
+		++c;
+	}
+	return c;
+}
+
+size_t
+RTArena::usable_size (void const * p)
+{
+	return (size_t) 16 << header (p)->size_class;
+}
+
+void*
+RTArena::alloc (size_t size)
+{
+	if (g_atomic_int_get (&_reset)) {
+		_high_water = _used;
+		_n_alloc = 0;
+		_n_fallback = 0;
+		g_atomic_int_set (&_reset, 0);
+	}
+
+	take_remote ();
+
+	if (_used == 0 && _bump != 0) {
+		/* everything has been given back, so start again from an
+		 * empty block rather than keep it split into size classes.
+		 */
+		_bump = 0;
+		memset (_free, 0, sizeof (_free));
+	}
+
+	const uint32_t c = size_class (size);
+
+	if (c == n_classes) {
+		return 0;
+	}
+
+	char* p;
+
+	if (_free[c]) {
+		p = (char*) _free[c];
+		_free[c] = _free[c]->next;
+	} else {
+		const size_t need = header_size + ((size_t) 16 << c);
+		if (_bump + need > _size) {
+			return 0;
+		}
+		char* h = _block + _bump;
+		_bump += need;
+		p = h + header_size;
+		/* the header stays valid while the chunk is reused */
+		header (p)->size_class = c;
+		header (p)->arena = _index;
+	}
+
+	_used += (size_t) 16 << c;
+	if (_used > _high_water) {
+		_high_water = _used;
+	}
+	++_n_alloc;
+
+	return p;
+}
+
+void
+RTArena::release (void* p)
+{
+	Chunk* chunk = static_cast<Chunk*> (p);
+
+	if (per_thread_arena () == this) {
+		const uint32_t c = header (p)->size_class;
+		chunk->next = _free[c];
+		_free[c] = chunk;
+		_used -= (size_t) 16 << c;
+		return;
+	}
+
+	/* another thread's memory: push it onto the owner's remote list,
+	 * which only the owner ever empties.
+	 */
+	gpointer head;
+	do {
+		head = g_atomic_pointer_get (&_remote);
+		chunk->next = static_cast<Chunk*> (head);
+	} while (!g_atomic_pointer_compare_and_exchange (&_remote, head, chunk));
+}
+
+void
+RTArena::take_remote ()
+{
+	if (!g_atomic_pointer_get (&_remote)) {
+		return;
+	}
+
+	gpointer head;
+	do {
+		head = g_atomic_pointer_get (&_remote);
+	} while (!g_atomic_pointer_compare_and_exchange (&_remote, head, 0));
+
+	Chunk* chunk = static_cast<Chunk*> (head);
+
+	while (chunk) {
+		Chunk* next = chunk->next;
+		const uint32_t c = header (chunk)->size_class;
+		chunk->next = _free[c];
+		_free[c] = chunk;
+		_used -= (size_t) 16 << c;
+		chunk = next;
+	}
+}
+
+void*
+PBD::rt_alloc (size_t size)
+{
+	RTArena* a = RTArena::per_thread_arena ();
+
+	if (!a) {
+		return heap_alloc (size);
+	}
+
+	void* p = a->alloc (size);
+
+	if (!p) {
+		a->count_fallback ();
+		p = heap_alloc (size);
+	}
+
+	return p;
+}
+
+void*
+PBD::rt_realloc (void* ptr, size_t size)
+{
+	if (!ptr) {
+		return rt_alloc (size);
+	}
+
+	RTArena::Header* h = RTArena::header (ptr);
+
+	if (h->arena == RTArena::no_arena) {
+		RTArena* a = RTArena::per_thread_arena ();
+		if (a) {
+			a->count_fallback ();
+		}
+		char* n = static_cast<char*> (realloc (h, RTArena::header_size + size));
+		return n ? n + RTArena::header_size : 0;
+	}
+
+	const size_t have = RTArena::usable_size (ptr);
+
+	if (size <= have) {
+		return ptr;
+	}
+
+	void* p = rt_alloc (size);
+	if (p) {
+		memcpy (p, ptr, have);
+		rt_free (ptr);
+	}
+	return p;
+}
+
+void
+PBD::rt_free (void* ptr)
+{
+	if (!ptr) {
+		return;
+	}
+
+	RTArena::Header* h = RTArena::header (ptr);
+
+	if (h->arena == RTArena::no_arena) {
+		free (h);
+	} else {
+		RTArena::arena (h->arena)->release (ptr);
+	}
+}
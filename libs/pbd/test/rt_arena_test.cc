@@ -0,0 +1,130 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "rt_arena_test.h"
+#include "pbd/rt_arena.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (RTArenaTest);
+
+using namespace std;
+using namespace PBD;
+
+static void*
+basic (void*)
+{
+	/* no arena yet: plain malloc, which is not counted anywhere */
+	void* m = rt_alloc (32);
+	CPPUNIT_ASSERT (m);
+	rt_free (m);
+
+	RTArena::create_per_thread_arena ("basic", 64 * 1024);
+	RTArena* a = RTArena::per_thread_arena ();
+	CPPUNIT_ASSERT (a);
+
+	char* p = static_cast<char*> (rt_alloc (100));
+	CPPUNIT_ASSERT (a->contains (p));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 128, a->stats ().used);
+	memset (p, 0x5a, 100);
+
+	/* growing within the size class keeps the same memory */
+	CPPUNIT_ASSERT (rt_realloc (p, 120) == p);
+
+	/* growing beyond it moves, keeping the contents */
+	char* q = static_cast<char*> (rt_realloc (p, 300));
+	CPPUNIT_ASSERT (q != p);
+	CPPUNIT_ASSERT (a->contains (q));
+	CPPUNIT_ASSERT (q[0] == 0x5a && q[99] == 0x5a);
+
+	rt_free (q);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, a->stats ().used);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 128 + 512, a->stats ().high_water);
+
+	/* freed memory is reused */
+	CPPUNIT_ASSERT (rt_alloc (100) == p);
+	rt_free (p);
+
+	/* too large for the arena */
+	void* big = rt_alloc (1024 * 1024);
+	CPPUNIT_ASSERT (big && !a->contains (big));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, a->stats ().n_fallback);
+	rt_free (big);
+
+	/* until the arena runs out */
+	void* blocks[128];
+	int n = 0;
+	while (n < 128) {
+		blocks[n] = rt_alloc (1000);
+		if (!a->contains (blocks[n++])) {
+			break;
+		}
+	}
+	CPPUNIT_ASSERT (n < 128);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, a->stats ().n_fallback);
+	while (n) {
+		rt_free (blocks[--n]);
+	}
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, a->stats ().used);
+
+	RTArena::drop_per_thread_arena ();
+	CPPUNIT_ASSERT (!a->stats ().active);
+
+	return 0;
+}
+
+void
+RTArenaTest::testBasic ()
+{
+	pthread_t t;
+	CPPUNIT_ASSERT (pthread_create (&t, 0, basic, 0) == 0);
+	pthread_join (t, 0);
+}
+
+namespace {
+
+const int n_blocks = 256;
+void* blocks[n_blocks];
+
+void*
+cross_free (void*)
+{
+	for (int i = 0; i < n_blocks; ++i) {
+		rt_free (blocks[i]);
+	}
+	return 0;
+}
+
+void*
+cross_alloc (void*)
+{
+	RTArena::create_per_thread_arena ("cross", 64 * 1024);
+	RTArena* a = RTArena::per_thread_arena ();
+
+	for (int i = 0; i < n_blocks; ++i) {
+		blocks[i] = rt_alloc (64);
+		CPPUNIT_ASSERT (a->contains (blocks[i]));
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) n_blocks * 64, a->stats ().used);
+
+	pthread_t t;
+	CPPUNIT_ASSERT (pthread_create (&t, 0, cross_free, 0) == 0);
+	pthread_join (t, 0);
+
+	/* the other thread's frees are taken back on our next allocation */
+	void* p = rt_alloc (64);
+	CPPUNIT_ASSERT (a->contains (p));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 64, a->stats ().used);
+	rt_free (p);
+
+	return 0;
+}
+
+}
+
+void
+RTArenaTest::testCrossThreadFree ()
+{
+	pthread_t t;
+	CPPUNIT_ASSERT (pthread_create (&t, 0, cross_alloc, 0) == 0);
+	pthread_join (t, 0);
+}
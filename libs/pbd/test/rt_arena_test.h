@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RTArenaTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (RTArenaTest);
+	CPPUNIT_TEST (testBasic);
+	CPPUNIT_TEST (testCrossThreadFree);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testBasic ();
+	void testCrossThreadFree ();
+};
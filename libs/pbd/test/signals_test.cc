@@ -89,3 +89,150 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+/* A receiver which, when called, disconnects another receiver and
+   connects a new one.
+*/
+class Rearranger
+{
+public:
+	Rearranger (Emitter* e, PBD::ScopedConnection* victim)
+		: _emitter (e), _victim (victim) {}
+
+	void receiver () {
+		++N;
+		_victim->disconnect ();
+		_emitter->Fred.connect_same_thread (_added, boost::bind (&::receiver));
+	}
+
+private:
+	Emitter* _emitter;
+	PBD::ScopedConnection* _victim;
+	PBD::ScopedConnection _added;
+};
+
+void
+SignalsTest::testChangeDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection a;
+	PBD::ScopedConnection b;
+	PBD::ScopedConnection c;
+
+	Rearranger ra (e, &b);
+	Rearranger rb (e, &a);
+
+	/* slots are called in the order they were connected, so a
+	   disconnects b before b is called, and the slot that a adds
+	   is not called by the emission it was added during
+	*/
+	e->Fred.connect_same_thread (a, boost::bind (&Rearranger::receiver, &ra));
+	e->Fred.connect_same_thread (b, boost::bind (&Rearranger::receiver, &rb));
+	e->Fred.connect_same_thread (c, boost::bind (&receiver));
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (2, N);
+
+	/* a replaces the slot it added last time before that is reached */
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (2, N);
+
+	N = 0;
+	a.disconnect ();
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (2, N);
+
+	CPPUNIT_ASSERT (e->Fred.size ());
+
+	delete e;
+}
+
+static void
+disconnect_self (PBD::ScopedConnection* c, boost::shared_ptr<int>)
+{
+	c->disconnect ();
+}
+
+void
+SignalsTest::testReclaimAfterEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection a;
+	boost::shared_ptr<int> p (new int (0));
+	boost::weak_ptr<int> w (p);
+
+	/* the slot disconnects itself during the emission; the functor
+	   that it was bound with goes once the emission is over
+	*/
+	e->Fred.connect_same_thread (a, boost::bind (&disconnect_self, &a, p));
+	p.reset ();
+
+	CPPUNIT_ASSERT (!w.expired ());
+	e->emit ();
+	CPPUNIT_ASSERT (w.expired ());
+
+	delete e;
+}
+
+class Disconnector {
+public:
+	Disconnector (PBD::ScopedConnection* c) : _c (c) {}
+	~Disconnector () { _c->disconnect (); }
+private:
+	PBD::ScopedConnection* _c;
+};
+
+static void
+hold (boost::shared_ptr<Disconnector>)
+{
+}
+
+void
+SignalsTest::testDisconnectFromDestructor ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection a;
+	PBD::ScopedConnection b;
+
+	/* freeing the slot for a (after disconnecting it, or after an emission
+	   in which it was disconnected) disconnects b
+	*/
+	e->Fred.connect_same_thread (a, boost::bind (&hold, boost::shared_ptr<Disconnector> (new Disconnector (&b))));
+	e->Fred.connect_same_thread (b, boost::bind (&receiver));
+
+	a.disconnect ();
+	CPPUNIT_ASSERT (e->Fred.empty ());
+
+	e->Fred.connect_same_thread (a, boost::bind (&disconnect_self, &a, boost::shared_ptr<int> ()));
+	e->Fred.connect_same_thread (b, boost::bind (&hold, boost::shared_ptr<Disconnector> (new Disconnector (&a))));
+
+	e->emit ();
+	b.disconnect ();
+	CPPUNIT_ASSERT (e->Fred.empty ());
+
+	delete e;
+}
+
+static void
+delete_emitter (Emitter* e)
+{
+	delete e;
+}
+
+void
+SignalsTest::testDeleteDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection a;
+	PBD::ScopedConnection b;
+
+	/* slots after the one that deletes the signal are not called */
+	e->Fred.connect_same_thread (a, boost::bind (&delete_emitter, e));
+	e->Fred.connect_same_thread (b, boost::bind (&receiver));
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (0, N);
+}
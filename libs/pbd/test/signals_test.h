@@ -7,6 +7,10 @@ class SignalsTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (testEmission);
 	CPPUNIT_TEST (testDestruction);
 	CPPUNIT_TEST (testScopedConnectionList);
+	CPPUNIT_TEST (testChangeDuringEmission);
+	CPPUNIT_TEST (testReclaimAfterEmission);
+	CPPUNIT_TEST (testDisconnectFromDestructor);
+	CPPUNIT_TEST (testDeleteDuringEmission);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -14,4 +18,8 @@ public:
 	void testEmission ();
 	void testDestruction ();
 	void testScopedConnectionList ();
+	void testChangeDuringEmission ();
+	void testReclaimAfterEmission ();
+	void testDisconnectFromDestructor ();
+	void testDeleteDuringEmission ();
 };
@@ -0,0 +1,135 @@
+#include "undo_test.h"
+
+#include "pbd/memento_command.h"
+#include "pbd/compose.h"
+#include "pbd/statefuldestructible.h"
+#include "pbd/undo.h"
+#include "pbd/xml++.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (UndoTest);
+
+using namespace std;
+using namespace PBD;
+
+namespace {
+
+/** Something with a large state, only a little of which changes with
+ *  each edit; as many things in a session are.
+ */
+class Thing : public StatefulDestructible
+{
+public:
+	Thing (string const & name) : _name (name), _version (0) {}
+	~Thing () { drop_references (); }
+
+	XMLNode& get_state () {
+		XMLNode* node = new XMLNode ("Thing");
+		node->set_property ("version", _version);
+		for (int i = 0; i < 100; ++i) {
+			XMLNode* child = node->add_child ("Part");
+			child->set_property ("name", string_compose ("%1 part %2, which has a rather long name", _name, i));
+		}
+		return *node;
+	}
+
+	int set_state (XMLNode const & node, int) {
+		node.get_property ("version", _version);
+		return 0;
+	}
+
+	void edit () { ++_version; }
+
+private:
+	string _name;
+	int _version;
+};
+
+void
+add_edit (UndoHistory& history, Thing& thing)
+{
+	XMLNode* before = &thing.get_state ();
+	thing.edit ();
+	XMLNode* after = &thing.get_state ();
+
+	UndoTransaction* ut = new UndoTransaction;
+	ut->add_command (new MementoCommand<Thing> (thing, before, after));
+	history.add (ut);
+}
+
+}
+
+void
+UndoTest::testMemorySize ()
+{
+	Thing a ("a");
+	UndoHistory ha;
+
+	add_edit (ha, a);
+	const size_t one = ha.memory_size ();
+
+	for (int i = 0; i < 19; ++i) {
+		add_edit (ha, a);
+	}
+
+	/* later edits share nearly all of their state with the first */
+	const size_t twenty = ha.memory_size ();
+	CPPUNIT_ASSERT (twenty > one);
+	CPPUNIT_ASSERT (twenty < one * 4);
+
+	/* snapshots held by another history are not ours */
+	Thing b ("b");
+	UndoHistory hb;
+	for (int i = 0; i < 20; ++i) {
+		add_edit (hb, b);
+	}
+	CPPUNIT_ASSERT_EQUAL (twenty, ha.memory_size ());
+
+	/* undone transactions still hold their state */
+	ha.undo (10);
+	CPPUNIT_ASSERT_EQUAL (twenty, ha.memory_size ());
+
+	ha.clear ();
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, ha.memory_size ());
+}
+
+void
+UndoTest::testMemoryBudget ()
+{
+	Thing a ("a");
+	UndoHistory ha;
+
+	for (int i = 0; i < 20; ++i) {
+		add_edit (ha, a);
+	}
+
+	const size_t full = ha.memory_size ();
+
+	/* a larger budget does not drop anything, however much memory
+	 * other histories hold
+	 */
+	Thing b ("b");
+	UndoHistory hb;
+	for (int i = 0; i < 20; ++i) {
+		add_edit (hb, b);
+	}
+
+	ha.set_memory_budget (full + 1);
+	CPPUNIT_ASSERT_EQUAL (20UL, ha.undo_depth ());
+
+	/* a smaller one drops the oldest transactions until we fit */
+	const size_t budget = full - 1;
+	ha.set_memory_budget (budget);
+	CPPUNIT_ASSERT (ha.undo_depth () < 20);
+	CPPUNIT_ASSERT (ha.undo_depth () > 1);
+	CPPUNIT_ASSERT (ha.memory_size () <= budget);
+
+	/* adding to the history keeps it within budget */
+	for (int i = 0; i < 20; ++i) {
+		add_edit (ha, a);
+		CPPUNIT_ASSERT (ha.memory_size () <= budget);
+	}
+
+	/* but the latest transaction is always kept */
+	ha.set_memory_budget (1);
+	CPPUNIT_ASSERT_EQUAL (1UL, ha.undo_depth ());
+}
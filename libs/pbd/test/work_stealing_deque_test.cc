@@ -0,0 +1,140 @@
+#include <pthread.h>
+#include <vector>
+
+#include "work_stealing_deque_test.h"
+#include "pbd/work_stealing_deque.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (WorkStealingDequeTest);
+
+using namespace std;
+using namespace PBD;
+
+void
+WorkStealingDequeTest::testOwner ()
+{
+	WorkStealingDeque<int> d (4);
+	int v[5];
+
+	CPPUNIT_ASSERT_EQUAL (4U, d.capacity ());
+	CPPUNIT_ASSERT (d.empty ());
+	CPPUNIT_ASSERT (d.pop () == 0);
+
+	for (int i = 0; i < 4; ++i) {
+		CPPUNIT_ASSERT (d.push (&v[i]));
+	}
+	/* full */
+	CPPUNIT_ASSERT (!d.push (&v[4]));
+
+	/* owner pops LIFO */
+	for (int i = 3; i >= 0; --i) {
+		CPPUNIT_ASSERT (d.pop () == &v[i]);
+	}
+	CPPUNIT_ASSERT (d.empty ());
+	CPPUNIT_ASSERT (d.pop () == 0);
+}
+
+void
+WorkStealingDequeTest::testSteal ()
+{
+	WorkStealingDeque<int> d (8);
+	int v[3];
+	int* s = 0;
+
+	CPPUNIT_ASSERT (!d.steal (s));
+
+	for (int i = 0; i < 3; ++i) {
+		d.push (&v[i]);
+	}
+
+	/* thieves take FIFO */
+	CPPUNIT_ASSERT (d.steal (s));
+	CPPUNIT_ASSERT (s == &v[0]);
+	CPPUNIT_ASSERT (d.pop () == &v[2]);
+	CPPUNIT_ASSERT (d.steal (s));
+	CPPUNIT_ASSERT (s == &v[1]);
+	CPPUNIT_ASSERT (d.empty ());
+
+	/* indices keep running; make sure wrapping the ring is harmless */
+	for (int n = 0; n < 100; ++n) {
+		CPPUNIT_ASSERT (d.push (&v[n % 3]));
+		CPPUNIT_ASSERT (d.pop () == &v[n % 3]);
+	}
+}
+
+namespace {
+
+static const int n_items = 100000;
+static const int n_thieves = 3;
+
+struct Shared {
+	WorkStealingDeque<int>* deque;
+	gint taken[n_items];
+	volatile gint done;
+};
+
+static void*
+thief (void* arg)
+{
+	Shared* sh = static_cast<Shared*> (arg);
+	while (!g_atomic_int_get (&sh->done)) {
+		int* item;
+		if (sh->deque->steal (item)) {
+			g_atomic_int_inc (&sh->taken[*item]);
+		}
+	}
+	return 0;
+}
+
+}
+
+void
+WorkStealingDequeTest::testConcurrent ()
+{
+	WorkStealingDeque<int> d (256);
+	vector<int> values (n_items);
+	Shared* sh = new Shared;
+
+	sh->deque = &d;
+	sh->done = 0;
+	for (int i = 0; i < n_items; ++i) {
+		values[i] = i;
+		sh->taken[i] = 0;
+	}
+
+	pthread_t threads[n_thieves];
+	for (int i = 0; i < n_thieves; ++i) {
+		pthread_create (&threads[i], 0, thief, sh);
+	}
+
+	int next = 0;
+	while (next < n_items) {
+		/* push a few, pop one, to exercise the last-item race */
+		for (int k = 0; k < 3 && next < n_items; ++k) {
+			if (!d.push (&values[next])) {
+				break;
+			}
+			++next;
+		}
+		int* item = d.pop ();
+		if (item) {
+			g_atomic_int_inc (&sh->taken[*item]);
+		}
+	}
+
+	int* item;
+	while ((item = d.pop ()) != 0) {
+		g_atomic_int_inc (&sh->taken[*item]);
+	}
+
+	g_atomic_int_set (&sh->done, 1);
+	for (int i = 0; i < n_thieves; ++i) {
+		pthread_join (threads[i], 0);
+	}
+
+	/* every item must have been taken exactly once */
+	for (int i = 0; i < n_items; ++i) {
+		CPPUNIT_ASSERT_EQUAL (1, (int) sh->taken[i]);
+	}
+
+	delete sh;
+}
@@ -0,0 +1,16 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class WorkStealingDequeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (WorkStealingDequeTest);
+	CPPUNIT_TEST (testOwner);
+	CPPUNIT_TEST (testSteal);
+	CPPUNIT_TEST (testConcurrent);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testOwner ();
+	void testSteal ();
+	void testConcurrent ();
+};
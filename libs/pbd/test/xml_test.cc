@@ -3,6 +3,7 @@
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 #include "pbd/xml++.h"
+#include "pbd/xml_snapshot.h"
 
 #include <stdint.h>
 #include <unistd.h>
@@ -20,6 +21,7 @@
 
 #include <libxml/xpath.h>
 
+#include "pbd/compose.h"
 #include "pbd/file_utils.h"
 #include "pbd/timing.h"
 
@@ -304,3 +306,65 @@ XMLTest::testPerfLargeXMLDocument ()
 
 	test_xml_document ("testPerfLargeXMLDocument", node_options);
 }
+
+namespace {
+
+XMLNode*
+make_playlist (int n_regions, int changed)
+{
+	XMLNode* playlist = new XMLNode ("Playlist");
+	playlist->set_property ("name", "Audio 1");
+
+	for (int i = 0; i < n_regions; ++i) {
+		XMLNode* region = playlist->add_child ("Region");
+		region->set_property ("name", string_compose ("Audio 1.%1", i));
+		region->set_property ("position", i * 48000 + (i == changed ? 1 : 0));
+		region->add_child ("Extra")->add_content ("some text");
+	}
+
+	return playlist;
+}
+
+}
+
+void
+XMLTest::testSnapshot ()
+{
+	XMLNode* a = make_playlist (1000, -1);
+	XMLNode* b = make_playlist (1000, 500);
+
+	const size_t shared = XMLSnapshot::shared_memory_size ();
+
+	XMLSnapshot* sa = new XMLSnapshot (*a);
+	XMLSnapshot* sb = new XMLSnapshot (*b);
+
+	/* the second snapshot shares all but one region with the first */
+	CPPUNIT_ASSERT (sb->memory_size () * 10 < sa->memory_size ());
+	CPPUNIT_ASSERT_EQUAL (shared + sa->memory_size () + sb->memory_size (), XMLSnapshot::shared_memory_size ());
+
+	XMLNode* ra = sa->node ();
+	XMLNode* rb = sb->node ();
+	CPPUNIT_ASSERT (*ra == *a);
+	CPPUNIT_ASSERT (*rb == *b);
+	CPPUNIT_ASSERT (*ra != *rb);
+	delete ra;
+	delete rb;
+
+	/* dropping the first snapshot leaves the second intact, and
+	 * the state that they shared still counted.
+	 */
+	delete sa;
+	rb = sb->node ();
+	CPPUNIT_ASSERT (*rb == *b);
+	delete rb;
+	CPPUNIT_ASSERT (XMLSnapshot::shared_memory_size () > shared + sb->memory_size () * 10);
+
+	/* and once both have gone, nothing is shared any more */
+	delete sb;
+	CPPUNIT_ASSERT_EQUAL (shared, XMLSnapshot::shared_memory_size ());
+	XMLSnapshot sc (*b);
+	CPPUNIT_ASSERT (sc.memory_size () * 10 > XMLSnapshot (*a).memory_size ());
+
+	delete a;
+	delete b;
+}
@@ -24,6 +24,7 @@
 
 #include "pbd/undo.h"
 #include "pbd/xml++.h"
+#include "pbd/xml_snapshot.h"
 
 #include <sigc++/bind.h>
 
@@ -146,6 +147,26 @@ XMLNode &UndoTransaction::get_state()
     return *node;
 }
 
+size_t
+UndoTransaction::memory_size () const
+{
+	size_t sz = sizeof (*this);
+
+	for (list<Command*>::const_iterator i = actions.begin(); i != actions.end(); ++i) {
+		sz += (*i)->memory_size ();
+	}
+
+	return sz;
+}
+
+void
+UndoTransaction::snapshots (std::vector<PBD::XMLSnapshot const *>& s) const
+{
+	for (list<Command*>::const_iterator i = actions.begin(); i != actions.end(); ++i) {
+		(*i)->snapshots (s);
+	}
+}
+
 class UndoRedoSignaller {
 public:
     UndoRedoSignaller (UndoHistory& uh)
@@ -164,6 +185,7 @@ UndoHistory::UndoHistory ()
 {
 	_clearing = false;
 	_depth = 0;
+	_memory_budget = 0;
 }
 
 void
@@ -191,6 +213,75 @@ UndoHistory::set_depth (uint32_t d)
 	}
 }
 
+void
+UndoHistory::set_memory_budget (size_t bytes)
+{
+	_memory_budget = bytes;
+	trim_to_memory_budget ();
+}
+
+size_t
+UndoHistory::memory_size () const
+{
+	PBD::XMLSnapshot::Usage usage;
+	return own_memory_size (usage) + usage.size ();
+}
+
+/** @return the memory held by our transactions themselves, having added
+ *  the snapshots that they hold to @param usage.
+ */
+size_t
+UndoHistory::own_memory_size (PBD::XMLSnapshot::Usage& usage) const
+{
+	size_t sz = 0;
+	std::vector<PBD::XMLSnapshot const *> s;
+
+	for (list<UndoTransaction*>::const_iterator i = UndoList.begin(); i != UndoList.end(); ++i) {
+		sz += (*i)->memory_size ();
+		(*i)->snapshots (s);
+	}
+
+	for (list<UndoTransaction*>::const_iterator i = RedoList.begin(); i != RedoList.end(); ++i) {
+		sz += (*i)->memory_size ();
+		(*i)->snapshots (s);
+	}
+
+	for (std::vector<PBD::XMLSnapshot const *>::const_iterator i = s.begin(); i != s.end(); ++i) {
+		usage.add (**i);
+	}
+
+	return sz;
+}
+
+void
+UndoHistory::trim_to_memory_budget ()
+{
+	if (_memory_budget == 0) {
+		return;
+	}
+
+	/* snapshot state may be shared between transactions, so dropping
+	 * one only frees the parts that no other one holds.
+	 */
+	PBD::XMLSnapshot::Usage usage;
+	size_t sz = own_memory_size (usage);
+	std::vector<PBD::XMLSnapshot const *> s;
+
+	while (sz + usage.size () > _memory_budget && UndoList.size() > 1) {
+		UndoTransaction* ut = UndoList.front ();
+		UndoList.pop_front ();
+		sz -= min (sz, ut->memory_size ());
+
+		s.clear ();
+		ut->snapshots (s);
+		for (std::vector<PBD::XMLSnapshot const *>::const_iterator i = s.begin(); i != s.end(); ++i) {
+			usage.remove (**i);
+		}
+
+		delete ut;
+	}
+}
+
 void
 UndoHistory::add (UndoTransaction* const ut)
 {
@@ -224,6 +315,8 @@ UndoHistory::add (UndoTransaction* const ut)
 	RedoList.clear ();
 	_clearing = false;
 
+	trim_to_memory_budget ();
+
 	/* we are now owners of the transaction and must delete it when finished with it */
 
 	Changed (); /* EMIT SIGNAL */
@@ -0,0 +1,297 @@
+/*
+    Copyright (C) 2017 Paul Davis
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <glibmm/threads.h>
+
+#include "pbd/xml++.h"
+#include "pbd/xml_snapshot.h"
+
+using namespace PBD;
+using std::string;
+using std::vector;
+
+/** One node of a snapshotted tree: its name, content and properties
+ *  packed into `bytes', and its children, which are themselves shared.
+ *  Pieces are never changed once they are in the table; the reference
+ *  count is protected by the table's lock.
+ */
+struct XMLSnapshot::Piece {
+	string         bytes;
+	vector<Piece*> children;
+	uint64_t       hash;
+	uint32_t       refs;
+};
+
+namespace {
+
+struct PieceLess {
+	template<typename P>
+	bool operator() (P const * a, P const * b) const {
+		if (a->hash != b->hash) {
+			return a->hash < b->hash;
+		}
+		if (a->children != b->children) {
+			return a->children < b->children;
+		}
+		return a->bytes < b->bytes;
+	}
+};
+
+/* The table is never destroyed, so that snapshots which outlive static
+ * destruction (in undo history owned by something static) are harmless.
+ */
+Glib::Threads::Mutex&
+table_lock ()
+{
+	static Glib::Threads::Mutex* m = new Glib::Threads::Mutex;
+	return *m;
+}
+
+/** Memory held by the pieces in the table, protected by its lock */
+size_t&
+table_size ()
+{
+	static size_t s = 0;
+	return s;
+}
+
+template<typename P>
+std::set<P*, PieceLess>&
+table ()
+{
+	static std::set<P*, PieceLess>* t = new std::set<P*, PieceLess>;
+	return *t;
+}
+
+void
+put (string& b, string const & s)
+{
+	const uint32_t len = s.length ();
+	b.append ((char const *) &len, sizeof (len));
+	b.append (s);
+}
+
+string
+get (string const & b, size_t& pos)
+{
+	uint32_t len;
+	memcpy (&len, b.data() + pos, sizeof (len));
+	pos += sizeof (len);
+	string s (b, pos, len);
+	pos += len;
+	return s;
+}
+
+/* FNV-1a */
+uint64_t
+hash_bytes (char const * p, size_t n, uint64_t h)
+{
+	while (n--) {
+		h = (h ^ (uint8_t) *p++) * 1099511628211ULL;
+	}
+	return h;
+}
+
+}
+
+XMLSnapshot::XMLSnapshot (XMLNode const & node)
+	: _memory_size (0)
+{
+	Glib::Threads::Mutex::Lock lm (table_lock ());
+	_root = intern (node, _memory_size);
+}
+
+XMLSnapshot::~XMLSnapshot ()
+{
+	Glib::Threads::Mutex::Lock lm (table_lock ());
+	release (_root);
+}
+
+size_t
+XMLSnapshot::shared_memory_size ()
+{
+	Glib::Threads::Mutex::Lock lm (table_lock ());
+	return table_size ();
+}
+
+size_t
+XMLSnapshot::memory_size (Piece const * p)
+{
+	return sizeof (Piece) + p->bytes.capacity () + p->children.capacity () * sizeof (Piece*);
+}
+
+XMLNode*
+XMLSnapshot::node () const
+{
+	/* no lock needed: our pieces can not change or go away */
+	return build (_root);
+}
+
+/** Find or add the piece for @param node, and take a reference to it.
+ *  Must be called with the table lock held.
+ */
+XMLSnapshot::Piece*
+XMLSnapshot::intern (XMLNode const & node, size_t& added)
+{
+	Piece* p = new Piece;
+
+	p->bytes.reserve (64);
+	put (p->bytes, node.name ());
+	p->bytes.push_back (node.is_content () ? 1 : 0);
+	put (p->bytes, node.content ());
+
+	const XMLPropertyList& props (node.properties ());
+	for (XMLPropertyConstIterator i = props.begin(); i != props.end(); ++i) {
+		put (p->bytes, (*i)->name ());
+		put (p->bytes, (*i)->value ());
+	}
+
+	const XMLNodeList& children (node.children ());
+	p->children.reserve (children.size ());
+	for (XMLNodeConstIterator i = children.begin(); i != children.end(); ++i) {
+		p->children.push_back (intern (**i, added));
+	}
+
+	/* children are already shared, so equal subtrees have the same
+	 * child pointers, and those can stand in for their contents.
+	 */
+	p->hash = hash_bytes (p->bytes.data (), p->bytes.length (), 14695981039346656037ULL);
+	if (!p->children.empty ()) {
+		p->hash = hash_bytes ((char const *) &p->children[0], p->children.size () * sizeof (Piece*), p->hash);
+	}
+
+	std::set<Piece*, PieceLess>& t (table<Piece> ());
+	std::set<Piece*, PieceLess>::iterator existing = t.find (p);
+
+	if (existing != t.end ()) {
+		/* the existing piece holds its own references to these */
+		for (vector<Piece*>::iterator c = p->children.begin(); c != p->children.end(); ++c) {
+			--(*c)->refs;
+		}
+		delete p;
+		++(*existing)->refs;
+		return *existing;
+	}
+
+	p->refs = 1;
+	t.insert (p);
+
+	added += memory_size (p);
+	table_size () += memory_size (p);
+
+	return p;
+}
+
+/** Drop a reference to @param p, deleting it and releasing its children
+ *  if it was the last.  Must be called with the table lock held.
+ */
+void
+XMLSnapshot::release (Piece* p)
+{
+	vector<Piece*> dead;
+	dead.push_back (p);
+
+	while (!dead.empty ()) {
+		Piece* d = dead.back ();
+		dead.pop_back ();
+
+		if (--d->refs == 0) {
+			table<Piece> ().erase (d);
+			table_size () -= memory_size (d);
+			dead.insert (dead.end (), d->children.begin (), d->children.end ());
+			delete d;
+		}
+	}
+}
+
+/* A snapshot's pieces can not change or go away while it exists, so
+ * walking them needs no lock.  Within the set, each piece is counted by
+ * the number of snapshots and pieces that refer to it, and its memory
+ * (and its children) are only counted while that is not zero.
+ */
+
+void
+XMLSnapshot::Usage::add (XMLSnapshot const & s)
+{
+	vector<Piece const *> todo;
+	todo.push_back (s._root);
+
+	while (!todo.empty ()) {
+		Piece const * p = todo.back ();
+		todo.pop_back ();
+
+		if (++_refs[p] == 1) {
+			_size += XMLSnapshot::memory_size (p);
+			todo.insert (todo.end (), p->children.begin (), p->children.end ());
+		}
+	}
+}
+
+void
+XMLSnapshot::Usage::remove (XMLSnapshot const & s)
+{
+	vector<Piece const *> todo;
+	todo.push_back (s._root);
+
+	while (!todo.empty ()) {
+		Piece const * p = todo.back ();
+		todo.pop_back ();
+
+		std::map<void const *, uint32_t>::iterator r = _refs.find (p);
+
+		if (r == _refs.end ()) {
+			continue;
+		}
+
+		if (--r->second == 0) {
+			_refs.erase (r);
+			_size -= XMLSnapshot::memory_size (p);
+			todo.insert (todo.end (), p->children.begin (), p->children.end ());
+		}
+	}
+}
+
+XMLNode*
+XMLSnapshot::build (Piece const * p)
+{
+	size_t pos = 0;
+
+	const string name (get (p->bytes, pos));
+	const bool is_content = p->bytes[pos++];
+	const string content (get (p->bytes, pos));
+
+	XMLNode* node = is_content ? new XMLNode (name, content) : new XMLNode (name);
+
+	while (pos < p->bytes.length ()) {
+		const string prop (get (p->bytes, pos));
+		node->set_property (prop.c_str (), get (p->bytes, pos));
+	}
+
+	for (vector<Piece*>::const_iterator c = p->children.begin(); c != p->children.end(); ++c) {
+		node->add_child_nocopy (*build (*c));
+	}
+
+	return node;
+}
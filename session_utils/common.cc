@@ -70,7 +70,7 @@ class MyEventLoop : public sigc::trackable, public EventLoop
 			run_loop_thread = Glib::Threads::Thread::self();
 		}
 
-		void call_slot (InvalidationRecord*, const boost::function<void()>& f) {
+		void call_slot (InvalidationRecord*, const boost::function<void()>& f, void const *) {
 			if (Glib::Threads::Thread::self() == run_loop_thread) {
 				f ();
 			}
@@ -93,7 +93,7 @@ class MyEventLoop : public sigc::trackable, public EventLoop
 			run_loop_thread = Glib::Threads::Thread::self ();
 		}
 
-		void call_slot (InvalidationRecord* ir, const boost::function<void()>& f) {
+		void call_slot (InvalidationRecord* ir, const boost::function<void()>& f, void const *) {
 			if (Glib::Threads::Thread::self () == run_loop_thread) {
 				cout << string_compose ("%1/%2 direct dispatch of call slot via functor @ %3, invalidation %4\n", event_loop_name(), pthread_name(), &f, ir);
 				f ();